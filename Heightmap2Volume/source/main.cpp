@@ -21,8 +21,9 @@ freely, subject to the following restrictions:
     distribution. 	
 *******************************************************************************/
 
-#include "Volume.h"
-#include "Serialization.h"
+#include "PolyVoxCore/ColumnVolume.h"
+#include "PolyVoxCore/Material.h"
+#include "PolyVoxUtil/Serialization.h"
 
 #include <QCoreApplication>
 #include <QFile>
@@ -179,53 +180,27 @@ int main(int argc, char *argv[])
 		return 1;
 	}
 
-	//Create a volume
-	Volume<uint8_t> volData(image.width(),256,image.height());
-
-	//Clear volume to zeros.
-	//FIXME - Add function to PolyVox for this.
-	for(unsigned int z = 0; z < volData.getDepth(); ++z)
-	{
-		for(unsigned int y = 0; y < volData.getHeight(); ++y)
-		{
-			for(unsigned int x = 0; x < volData.getWidth(); ++x)
-			{
-				volData.setVoxelAt(x,y,z,0);
-			}
-		}
-	}
+	//Create a volume. Every column starts off empty, so there is no need to clear it.
+	ColumnVolume<Material8> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(image.width()-1, 255, image.height()-1)));
 
+	//The faces of the volume are left empty so that the terrain is closed off.
+	const int maxY = volData.getHeight() - 2;
 	for(int z = 1; z < volData.getDepth()-1; ++z)
 	{
-		for(int y = 1; y < volData.getHeight()-1; ++y)
+		for(int x = 1; x < volData.getWidth()-1; ++x)
 		{
-			for(int x = 1; x < volData.getWidth()-1; ++x)
-			{
-				//We check the red channel, but in a greyscale image they should all be the same.
-				int height = qRed(image.pixel(x,z)); 
-
-				//Set the voxel based on the height.
-				if(y <= height - arguments.surfaceThickness)
-				{
-					volData.setVoxelAt(x,y,z,arguments.undergroundMaterialID);
-				}
-				else if(y <= height)
-				{
-					volData.setVoxelAt(x,y,z,arguments.surfaceMaterialID);
-				}
-
-				//Zero the faces
-				//FIXME - looks like a bug - shouldn't be -2?
-				//if((x == 0) || (y == 0) || (z == 0) || (x == volumeSideLength-2) || (y == volumeSideLength-2) || (z == volumeSideLength-2))
-				//{
-				//	volIter.setVoxel(0);
-				//}
-			}
+			//We check the red channel, but in a greyscale image they should all be the same.
+			int height = qRed(image.pixel(x,z)); 
+
+			//Write the underground and surface parts of the column directly, rather than voxel by voxel.
+			volData.setColumnSpan(x, z, 1, (std::min)(height - arguments.surfaceThickness, maxY), Material8(arguments.undergroundMaterialID));
+			volData.setColumnSpan(x, z, (std::max)(height - arguments.surfaceThickness + 1, 1), (std::min)(height, maxY), Material8(arguments.surfaceMaterialID));
 		}
 	}
+	volData.tidy();
 
 	ofstream file (arguments.outputFilename.toStdString().c_str(), ios::out|ios::binary);
-	saveVolumeRle(file, volData);
+	saveVolume(file, volData);
 	file.close();
 
 	//return app.exec();
@@ -24,11 +24,10 @@ freely, subject to the following restrictions:
 #include "OpenGLWidget.h"
 
 #include "PolyVoxCore/Density.h"
+#include "PolyVoxCore/LodSurfaceExtractor.h"
 #include "PolyVoxCore/SurfaceExtractor.h"
 #include "PolyVoxCore/SurfaceMesh.h"
-#include "PolyVoxCore/RawVolume.h"
 #include "PolyVoxCore/SimpleVolume.h"
-#include "PolyVoxCore/VolumeResampler.h"
 
 #include <QApplication>
 
@@ -91,22 +90,17 @@ int main(int argc, char *argv[])
 	//smoothRegion<SimpleVolume, Density8>(volData, volData.getEnclosingRegion());
 	//smoothRegion<SimpleVolume, Density8>(volData, volData.getEnclosingRegion());
 
-	RawVolume<Density8> volDataLowLOD(PolyVox::Region(Vector3DInt32(0,0,0), Vector3DInt32(15, 31, 31)));
-
-	VolumeResampler<SimpleVolume, RawVolume, Density8> volumeResampler(&volData, PolyVox::Region(Vector3DInt32(0,0,0), Vector3DInt32(31, 63, 63)), &volDataLowLOD, volDataLowLOD.getEnclosingRegion());
-	volumeResampler.execute();
-
-	//Extract the surface
+	//Extract the left half of the sphere at half resolution. Its right face borders the full resolution
+	//half, so it also needs transition cells there to close up the cracks between the two.
 	SurfaceMesh<PositionMaterialNormal> meshLowLOD;
-	SurfaceExtractor<RawVolume, Density8 > surfaceExtractor(&volDataLowLOD, volDataLowLOD.getEnclosingRegion(), &meshLowLOD);
+	LodSurfaceExtractor<SimpleVolume, Density8 > surfaceExtractor(&volData, PolyVox::Region(Vector3DInt32(0,0,0), Vector3DInt32(32, 64, 64)), &meshLowLOD, 1, TransitionPositiveX);
 	surfaceExtractor.execute();
-	meshLowLOD.scaleVertices(/*2.0f*/63.0f / 31.0f);
 
 	//Extract the surface
 	SurfaceMesh<PositionMaterialNormal> meshHighLOD;
-	SurfaceExtractor<SimpleVolume, Density8 > surfaceExtractorHigh(&volData, PolyVox::Region(Vector3DInt32(30,0,0), Vector3DInt32(63, 63, 63)), &meshHighLOD);
+	SurfaceExtractor<SimpleVolume, Density8 > surfaceExtractorHigh(&volData, PolyVox::Region(Vector3DInt32(32,0,0), Vector3DInt32(63, 63, 63)), &meshHighLOD);
 	surfaceExtractorHigh.execute();
-	meshHighLOD.translateVertices(Vector3DFloat(30, 0, 0));
+	meshHighLOD.translateVertices(Vector3DFloat(32, 0, 0));
 
 	//Pass the surface to the OpenGL window
 	openGLWidget.setSurfaceMeshToRender(meshHighLOD);
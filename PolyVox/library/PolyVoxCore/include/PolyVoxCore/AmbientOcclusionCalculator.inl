@@ -76,6 +76,11 @@ namespace PolyVox
 		RaycastResult raycastResult;
 		Raycast<VolumeType, VoxelType> raycast(m_volInput, Vector3DFloat(0.0f,0.0f,0.0f), Vector3DFloat(1.0f,1.0f,1.0f), raycastResult);
 
+		//How far outside its cell a ray can reach, allowing an extra voxel for rounding.
+		const int32_t iRayReach = static_cast<int32_t>(ceilf(m_fRayLength)) + 1;
+		typename VolumeType<VoxelType>::DensityType tMin;
+		typename VolumeType<VoxelType>::DensityType tMax;
+
 		//This loop iterates over the bottom-lower-left voxel in each of the cells in the output array
 		for(uint16_t z = m_region.getLowerCorner().getZ(); z <= m_region.getUpperCorner().getZ(); z += iRatioZ)
 		{
@@ -92,6 +97,12 @@ namespace PolyVox
 					//Keep track of how many rays did not hit anything
 					uint8_t uVisibleDirections = 0;
 
+					//The rays only stop at voxels above the threshold, so if there are none within reach then we already
+					//know that every ray will get through. The sample loop still runs so that the random vectors used by
+					//the following cells are the same as they would otherwise have been.
+					const Region regReach(Vector3DInt32(x - iRayReach, y - iRayReach, z - iRayReach), Vector3DInt32(x + iRatioX + iRayReach, y + iRatioY + iRayReach, z + iRatioZ + iRayReach));
+					const bool bNothingToHit = m_volInput->getDensityRange(regReach, tMin, tMax) && (tMax <= VoxelType::getThreshold());
+
 					for(int ct = 0; ct < m_uNoOfSamplesPerOutputElement; ct++)
 					{						
 						//We take a random vector with components going from -1 to 1 and scale it to go from -halfRatio to +halfRatio.
@@ -102,6 +113,12 @@ namespace PolyVox
 
 						Vector3DFloat v3dRayDirection = randomUnitVectors[(mRandomUnitVectorIndex += (++mIndexIncreament)) % 1021]; //Differenct prime number.
 						v3dRayDirection *= m_fRayLength;
+
+						if(bNothingToHit)
+						{
+							++uVisibleDirections;
+							continue;
+						}
 						
 						raycast.setStart(v3dRayStart);
 						raycast.setDirection(v3dRayDirection);
@@ -28,6 +28,8 @@ freely, subject to the following restrictions:
 
 #include "PolyVoxCore/ArraySizes.h" //Not strictly required, but convienient
 
+#include <algorithm>
+
 namespace PolyVox
 {
 	///Provides an efficient implementation of a multidimensional array.
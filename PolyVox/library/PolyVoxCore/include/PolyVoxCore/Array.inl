@@ -122,7 +122,9 @@ namespace PolyVox
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	/// Please note that the existing contents of the array will be lost.
+	/// Please note that the existing contents of the array will be lost. If the
+	/// dimensions are unchanged the existing memory is simply reused, so an array
+	/// which is resized to the same size each time it is used does not touch the heap.
 	/// \param pDimensions The new dimensions of the array. You can also use the
 	/// ArraySizes class to specify this more easily.
 	/// \sa ArraySizes
@@ -130,6 +132,11 @@ namespace PolyVox
 	template <uint32_t noOfDims, typename ElementType>
 	void Array<noOfDims, ElementType>::resize(const uint32_t (&pDimensions)[noOfDims])
 	{
+		if(m_pDimensions && std::equal(pDimensions, pDimensions + noOfDims, m_pDimensions))
+		{
+			return;
+		}
+
 		deallocate();
 
 		m_pDimensions = new uint32_t[noOfDims];
@@ -277,6 +284,11 @@ namespace PolyVox
 	template <typename ElementType>
 	void Array<1, ElementType>::resize(const uint32_t (&pDimensions)[1])
 	{
+		if(m_pDimensions && (m_pDimensions[0] == pDimensions[0]))
+		{
+			return;
+		}
+
 		deallocate();
 
 		m_pDimensions = new uint32_t[1];
@@ -24,6 +24,8 @@ freely, subject to the following restrictions:
 #ifndef __PolyVox_BaseVolume_H__
 #define __PolyVox_BaseVolume_H__
 
+#include "PolyVoxImpl/DensityRange.h"
+
 #include "PolyVoxCore/Log.h"
 #include "PolyVoxCore/Region.h"
 #include "PolyVoxCore/Vector.h"
@@ -97,6 +99,11 @@ namespace PolyVox
 			inline VoxelType peekVoxel1px1py0pz(void) const;
 			inline VoxelType peekVoxel1px1py1pz(void) const;
 
+			/// Reads the 3x3x3 neighbourhood of the current position, indexed by <tt>(x+1) + (y+1)*3 + (z+1)*9</tt>.
+			inline void peekNeighbourhood(VoxelType pStencil[27]) const;
+			/// Reads the 2x2x2 cell whose lower corner is the current position, indexed by <tt>x + y*2 + z*4</tt>.
+			inline void peekCell(VoxelType pCell[8]) const;
+
 		protected:
 			DerivedVolumeType* mVolume;
 
@@ -108,6 +115,9 @@ namespace PolyVox
 		#endif
 
 	public:
+		/// The type of the voxel densities, which for primitive voxel types is the voxel type itself.
+		typedef typename VoxelDensity<VoxelType>::DensityType DensityType;
+
 		/// Gets the value used for voxels which are outside the volume
 		VoxelType getBorderValue(void) const;
 		/// Gets a Region representing the extents of the Volume.
@@ -135,6 +145,15 @@ namespace PolyVox
 		bool setVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue);
 		/// Sets the voxel at the position given by a 3D vector
 		bool setVoxelAt(const Vector3DInt32& v3dPos, VoxelType tValue);
+		/// Gets a pointer to a run of voxels along the \c x axis starting at <tt>x,y,z</tt>
+		const VoxelType* getSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength) const;
+		/// Gets a writable pointer to a run of voxels along the \c x axis starting at <tt>x,y,z</tt>
+		VoxelType* getWritableSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength);
+
+		/// Gets the smallest and largest densities which the voxels in a region might have
+		bool getDensityRange(const Region& region, DensityType& tMin, DensityType& tMax) const;
+		/// Recalculates the density ranges invalidated by writing through getWritableSpanAt()
+		void recalculateDensityRanges(void);
 
 		/// Calculates approximatly how many bytes of memory the volume is currently using.
 		uint32_t calculateSizeInBytes(void);
@@ -148,6 +167,9 @@ namespace PolyVox
 		/// Destructor
 		~BaseVolume();
 
+		/// Gets the number of voxels from <tt>x,y,z</tt> along the \c x axis which lie outside the volume
+		int32_t getBorderSpanLength(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength) const;
+
 		//The size of the volume
 		Region m_regValidRegion;
 
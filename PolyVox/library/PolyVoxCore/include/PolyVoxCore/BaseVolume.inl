@@ -184,6 +184,90 @@ namespace PolyVox
 		return false;
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// The returned run holds \a iLength consecutive voxels along the \c x axis, where \a iLength is never
+	/// more than \a iMaxLength. A null pointer means the voxels are outside the volume or are not stored
+	/// contiguously, and should be read through getVoxelAt() instead. \a iLength is set in either case.
+	///
+	/// The pointer is only valid until the volume is next accessed.
+	/// \param uXPos The \c x position of the first voxel in the run
+	/// \param uYPos The \c y position of the run
+	/// \param uZPos The \c z position of the run
+	/// \param iMaxLength The largest number of voxels the run may contain
+	/// \param iLength Set to the number of voxels in the run
+	/// \return A pointer to the first voxel in the run, or null
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	const VoxelType* BaseVolume<VoxelType>::getSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength) const
+	{
+		iLength = iMaxLength;
+		return 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// As getSpanAt(), except that the voxels may be modified through the returned pointer. A null pointer
+	/// means the voxels should be written through setVoxelAt() instead.
+	/// \param uXPos The \c x position of the first voxel in the run
+	/// \param uYPos The \c y position of the run
+	/// \param uZPos The \c z position of the run
+	/// \param iMaxLength The largest number of voxels the run may contain
+	/// \param iLength Set to the number of voxels in the run
+	/// \return A pointer to the first voxel in the run, or null
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType* BaseVolume<VoxelType>::getWritableSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength)
+	{
+		iLength = iMaxLength;
+		return 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Volumes which are divided into blocks keep track of the smallest and largest density in each block as it
+	/// is written to. This lets algorithms skip regions which cannot produce any output, such as regions which
+	/// are entirely above or entirely below the threshold of a surface extractor. The range covers whole blocks
+	/// (and the border value, if the region extends outside the volume) so may be wider than the densities
+	/// which are actually in the region, but it never excludes any of them.
+	///
+	/// Voxels written through getWritableSpanAt() invalidate the range of their block, and regions containing
+	/// such blocks have no known range until recalculateDensityRanges() is called.
+	/// \param region The region to find the range for
+	/// \param tMin Set to the smallest density in the region
+	/// \param tMax Set to the largest density in the region
+	/// \return Whether the range is known. This is always false for volumes which don't keep track of it.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool BaseVolume<VoxelType>::getDensityRange(const Region& region, DensityType& tMin, DensityType& tMax) const
+	{
+		return false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Code which writes voxels through getWritableSpanAt() should call this once it has finished, so that
+	/// getDensityRange() can be used on the modified region again.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void BaseVolume<VoxelType>::recalculateDensityRanges(void)
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Used by subclasses to size the runs returned by getSpanAt() when they begin outside the volume.
+	/// \param uXPos The \c x position of the first voxel in the run
+	/// \param uYPos The \c y position of the run
+	/// \param uZPos The \c z position of the run
+	/// \param iMaxLength The largest number of voxels the run may contain
+	/// \return The number of voxels before the run enters the volume, or \a iMaxLength if it never does
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	int32_t BaseVolume<VoxelType>::getBorderSpanLength(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength) const
+	{
+		if(m_regValidRegion.containsPointInY(uYPos) && m_regValidRegion.containsPointInZ(uZPos) && (uXPos < m_regValidRegion.getLowerCorner().getX()))
+		{
+			return (std::min)(iMaxLength, m_regValidRegion.getLowerCorner().getX() - uXPos);
+		}
+		return iMaxLength;
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/// Note: This function needs reviewing for accuracy...
 	////////////////////////////////////////////////////////////////////////////////
@@ -326,4 +326,36 @@ namespace PolyVox
 	{
 		return mVolume->getVoxelAt(mXPosInVolume + 1, mYPosInVolume + 1, mZPosInVolume + 1);
 	}
+
+	template <typename VoxelType>
+	template <typename DerivedVolumeType>
+	void BaseVolume<VoxelType>::Sampler<DerivedVolumeType>::peekNeighbourhood(VoxelType pStencil[27]) const
+	{
+		for(int32_t z = 0; z < 3; z++)
+		{
+			for(int32_t y = 0; y < 3; y++)
+			{
+				for(int32_t x = 0; x < 3; x++)
+				{
+					pStencil[x + y * 3 + z * 9] = mVolume->getVoxelAt(mXPosInVolume + x - 1, mYPosInVolume + y - 1, mZPosInVolume + z - 1);
+				}
+			}
+		}
+	}
+
+	template <typename VoxelType>
+	template <typename DerivedVolumeType>
+	void BaseVolume<VoxelType>::Sampler<DerivedVolumeType>::peekCell(VoxelType pCell[8]) const
+	{
+		for(int32_t z = 0; z < 2; z++)
+		{
+			for(int32_t y = 0; y < 2; y++)
+			{
+				for(int32_t x = 0; x < 2; x++)
+				{
+					pCell[x + y * 2 + z * 4] = mVolume->getVoxelAt(mXPosInVolume + x, mYPosInVolume + y, mZPosInVolume + z);
+				}
+			}
+		}
+	}
 }
@@ -0,0 +1,165 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#ifndef __PolyVox_ColumnVolume_H__
+#define __PolyVox_ColumnVolume_H__
+
+#include "PolyVoxCore/BaseVolume.h"
+#include "PolyVoxCore/Log.h"
+#include "PolyVoxCore/Region.h"
+#include "PolyVoxCore/Vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <stdexcept> //For invalid_argument
+#include <vector>
+
+namespace PolyVox
+{
+	///The ColumnVolume class stores each vertical column of voxels as a list of runs.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// Terrain generated from a heightmap typically consists of columns which are solid up to some height, have a few voxels of a
+	/// surface material, and are then empty up to the top of the volume. Storing such data in three dimensional blocks wastes a lot of
+	/// memory, so the ColumnVolume instead stores a short list of runs for each (x,z) column. Each run has a value and the y position
+	/// (relative to the bottom of the volume) at which it ends. A column which has never been written to stores no runs at all and reads
+	/// back as the default voxel value.
+	///
+	/// The runs of all the columns are kept in a single pool to avoid the overhead of a separate allocation per column. When a column
+	/// outgrows its space in the pool it is moved to the end, and the space left behind is reclaimed automatically once enough of it has
+	/// built up. Calling tidy() after generating or loading the volume reclaims it straight away.
+	///
+	/// Individual voxels can be modified with setVoxelAt(), but when generating terrain it is much faster to write a whole span of a
+	/// column at once with setColumnSpan(). The Sampler keeps track of the run it is in, so stepping up and down a column (as the
+	/// surface extractors and Raycast do) does not require a search.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	class ColumnVolume : public BaseVolume<VoxelType>
+	{
+	public:
+		/// A run of identical voxels within a column.
+		struct Run
+		{
+			//The y position (relative to the bottom of the volume) one past the end of the run.
+			uint16_t uEnd;
+			VoxelType value;
+		};
+
+		#ifndef SWIG
+		//See the comments in SimpleVolume.h regarding the Visual Studio and GCC differences here.
+#if defined(_MSC_VER)
+		class Sampler : public BaseVolume<VoxelType>::Sampler< ColumnVolume<VoxelType> > //This line works on VS2010
+#else
+                class Sampler : public BaseVolume<VoxelType>::template Sampler< ColumnVolume<VoxelType> > //This line works on GCC
+#endif
+		{
+		public:
+			Sampler(ColumnVolume<VoxelType>* volume);
+			~Sampler();
+
+			inline VoxelType getVoxel(void) const;			
+
+			void setPosition(const Vector3DInt32& v3dNewPos);
+			void setPosition(int32_t xPos, int32_t yPos, int32_t zPos);
+			inline bool setVoxel(VoxelType tValue);
+
+			void movePositiveX(void);
+			void movePositiveY(void);
+			void movePositiveZ(void);
+
+			void moveNegativeX(void);
+			void moveNegativeY(void);
+			void moveNegativeZ(void);
+
+			//Peeks which stay within the current column can use the cached run. The others are inherited from BaseVolume::Sampler.
+			inline VoxelType peekVoxel0px1ny0pz(void) const;
+			inline VoxelType peekVoxel0px0py0pz(void) const;
+			inline VoxelType peekVoxel0px1py0pz(void) const;
+
+		private:
+			//The value of the run containing the current position, and the (inclusive) range of y positions which it covers.
+			VoxelType mCurrentValue;
+			int32_t mRunLowerY;
+			int32_t mRunUpperY;
+		};
+		#endif
+
+	public:
+		/// Constructor for creating a fixed size volume.
+		ColumnVolume(const Region& regValid);
+		/// Destructor
+		~ColumnVolume();
+
+		/// Gets the value used for voxels which are outside the volume
+		VoxelType getBorderValue(void) const;
+		/// Gets a voxel at the position given by <tt>x,y,z</tt> coordinates
+		VoxelType getVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos) const;
+		/// Gets a voxel at the position given by a 3D vector
+		VoxelType getVoxelAt(const Vector3DInt32& v3dPos) const;
+
+		/// Sets the value used for voxels which are outside the volume
+		void setBorderValue(const VoxelType& tBorder);
+		/// Sets the voxel at the position given by <tt>x,y,z</tt> coordinates
+		bool setVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue);
+		/// Sets the voxel at the position given by a 3D vector
+		bool setVoxelAt(const Vector3DInt32& v3dPos, VoxelType tValue);
+		/// Sets all the voxels between two heights in a single column
+		bool setColumnSpan(int32_t uXPos, int32_t uZPos, int32_t uLowerYPos, int32_t uUpperYPos, VoxelType tValue);
+
+		/// Removes unused space from the pool of runs, returning the number of bytes reclaimed
+		uint32_t tidy(void);
+
+		/// Calculates approximatly how many bytes of memory the volume is currently using.
+		uint32_t calculateSizeInBytes(void);
+
+	private:
+		/// Where the runs of a column can be found in the pool.
+		struct Column
+		{
+			uint32_t uFirstRun;
+			uint16_t uNoOfRuns;
+			uint16_t uCapacity;
+		};
+
+		uint32_t getColumnIndex(int32_t uXPos, int32_t uZPos) const;
+		VoxelType getRunAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t& iRunLowerY, int32_t& iRunUpperY) const;
+		void appendRun(std::vector<Run>& vecRuns, uint16_t uEnd, const VoxelType& tValue) const;
+
+		//The columns, indexed by x + z * width.
+		std::vector<Column> m_vecColumns;
+
+		//The runs of all the columns, and how many of them are no longer used by any column.
+		std::vector<Run> m_vecRuns;
+		uint32_t m_uNoOfUnusedRuns;
+
+		//Used by setColumnSpan() to build the new runs for a column.
+		std::vector<Run> m_vecNewColumn;
+
+		VoxelType m_tBorderValue;
+	};
+}
+
+#include "PolyVoxCore/ColumnVolume.inl"
+#include "PolyVoxCore/ColumnVolumeSampler.inl"
+
+#endif //__PolyVox_ColumnVolume_H__
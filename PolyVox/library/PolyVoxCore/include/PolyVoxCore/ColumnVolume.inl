@@ -0,0 +1,347 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+namespace PolyVox
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/// This constructor creates a volume with a fixed size which is specified as a parameter.
+	/// \param regValid Specifies the minimum and maximum valid voxel positions.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	ColumnVolume<VoxelType>::ColumnVolume(const Region& regValid)
+	:BaseVolume<VoxelType>(regValid)
+	{
+		//Run ends are stored relative to the bottom of the volume as 16-bit values.
+		if(this->getHeight() > (std::numeric_limits<uint16_t>::max)())
+		{
+			throw std::invalid_argument("ColumnVolume height cannot exceed 65535 voxels.");
+		}
+
+		setBorderValue(VoxelType());
+
+		//Every column starts off empty, which means it holds the default voxel value.
+		Column emptyColumn;
+		emptyColumn.uFirstRun = 0;
+		emptyColumn.uNoOfRuns = 0;
+		emptyColumn.uCapacity = 0;
+		m_vecColumns.resize(this->getWidth() * this->getDepth(), emptyColumn);
+		m_uNoOfUnusedRuns = 0;
+
+		//Other properties we might find useful later
+		this->m_uLongestSideLength = (std::max)((std::max)(this->getWidth(),this->getHeight()),this->getDepth());
+		this->m_uShortestSideLength = (std::min)((std::min)(this->getWidth(),this->getHeight()),this->getDepth());
+		this->m_fDiagonalLength = sqrtf(static_cast<float>(this->getWidth() * this->getWidth() + this->getHeight() * this->getHeight() + this->getDepth() * this->getDepth()));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Destroys the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	ColumnVolume<VoxelType>::~ColumnVolume()
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The border value is returned whenever an attempt is made to read a voxel which
+	/// is outside the extents of the volume.
+	/// \return The value used for voxels outside of the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType ColumnVolume<VoxelType>::getBorderValue(void) const
+	{
+		return m_tBorderValue;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param uXPos The \c x position of the voxel
+	/// \param uYPos The \c y position of the voxel
+	/// \param uZPos The \c z position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType ColumnVolume<VoxelType>::getVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos) const
+	{
+		int32_t iRunLowerY;
+		int32_t iRunUpperY;
+		return getRunAt(uXPos, uYPos, uZPos, iRunLowerY, iRunUpperY);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos The 3D position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType ColumnVolume<VoxelType>::getVoxelAt(const Vector3DInt32& v3dPos) const
+	{
+		return getVoxelAt(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param tBorder The value to use for voxels outside the volume.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void ColumnVolume<VoxelType>::setBorderValue(const VoxelType& tBorder) 
+	{
+		m_tBorderValue = tBorder;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param uXPos the \c x position of the voxel
+	/// \param uYPos the \c y position of the voxel
+	/// \param uZPos the \c z position of the voxel
+	/// \param tValue the value to which the voxel will be set
+	/// \return whether the requested position is inside the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool ColumnVolume<VoxelType>::setVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue)
+	{
+		return setColumnSpan(uXPos, uZPos, uYPos, uYPos, tValue);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos the 3D position of the voxel
+	/// \param tValue the value to which the voxel will be set
+	/// \return whether the requested position is inside the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool ColumnVolume<VoxelType>::setVoxelAt(const Vector3DInt32& v3dPos, VoxelType tValue)
+	{
+		return setVoxelAt(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ(), tValue);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Sets every voxel in the column at (x,z) whose y position lies between the given
+	/// bounds (inclusive) to the same value. This only touches the runs of a single
+	/// column, so it is much faster than setting the voxels individually and is the
+	/// preferred way of writing heightmap data into the volume. Any part of the span
+	/// which lies outside the volume is ignored.
+	/// \param uXPos the \c x position of the column
+	/// \param uZPos the \c z position of the column
+	/// \param uLowerYPos the lowest \c y position to be set
+	/// \param uUpperYPos the highest \c y position to be set
+	/// \param tValue the value to which the voxels will be set
+	/// \return whether any voxels were inside the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool ColumnVolume<VoxelType>::setColumnSpan(int32_t uXPos, int32_t uZPos, int32_t uLowerYPos, int32_t uUpperYPos, VoxelType tValue)
+	{
+		const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
+		const Vector3DInt32& v3dUpperCorner = this->m_regValidRegion.getUpperCorner();
+
+		uLowerYPos = (std::max)(uLowerYPos, v3dLowerCorner.getY());
+		uUpperYPos = (std::min)(uUpperYPos, v3dUpperCorner.getY());
+		if((uLowerYPos > uUpperYPos) ||
+			(uXPos < v3dLowerCorner.getX()) || (uXPos > v3dUpperCorner.getX()) ||
+			(uZPos < v3dLowerCorner.getZ()) || (uZPos > v3dUpperCorner.getZ()))
+		{
+			return false;
+		}
+
+		Column& column = m_vecColumns[getColumnIndex(uXPos, uZPos)];
+
+		//An empty column is a single run of default voxels.
+		Run defaultRun;
+		defaultRun.uEnd = static_cast<uint16_t>(this->getHeight());
+		defaultRun.value = VoxelType();
+		const Run* pRuns = (column.uNoOfRuns > 0) ? &(m_vecRuns[column.uFirstRun]) : &defaultRun;
+		const uint16_t uNoOfRuns = (column.uNoOfRuns > 0) ? column.uNoOfRuns : 1;
+
+		const uint16_t uSpanStart = static_cast<uint16_t>(uLowerYPos - v3dLowerCorner.getY());
+		const uint16_t uSpanEnd = static_cast<uint16_t>(uUpperYPos - v3dLowerCorner.getY() + 1);
+
+		//Copy the parts of the existing runs which lie outside the span, and insert
+		//the new run in the right place. Neighbouring runs with the same value are merged.
+		m_vecNewColumn.clear();
+		uint16_t uRunStart = 0;
+		for(uint16_t ct = 0; ct < uNoOfRuns; ct++)
+		{
+			const Run& run = pRuns[ct];
+			if(uRunStart < uSpanStart)
+			{
+				appendRun(m_vecNewColumn, (std::min)(run.uEnd, uSpanStart), run.value);
+			}
+			if((uRunStart <= uSpanStart) && (run.uEnd > uSpanStart))
+			{
+				appendRun(m_vecNewColumn, uSpanEnd, tValue);
+			}
+			if(run.uEnd > uSpanEnd)
+			{
+				appendRun(m_vecNewColumn, run.uEnd, run.value);
+			}
+			uRunStart = run.uEnd;
+		}
+
+		if((m_vecNewColumn.size() == 1) && (m_vecNewColumn[0].value == VoxelType()))
+		{
+			//A column which is entirely default voxels doesn't need any storage.
+			m_uNoOfUnusedRuns += column.uNoOfRuns;
+			column.uFirstRun = 0;
+			column.uNoOfRuns = 0;
+			column.uCapacity = 0;
+		}
+		else if(m_vecNewColumn.size() <= column.uCapacity)
+		{
+			//The new runs fit in the space the column already has.
+			std::copy(m_vecNewColumn.begin(), m_vecNewColumn.end(), m_vecRuns.begin() + column.uFirstRun);
+			m_uNoOfUnusedRuns += column.uNoOfRuns;
+			m_uNoOfUnusedRuns -= m_vecNewColumn.size();
+			column.uNoOfRuns = static_cast<uint16_t>(m_vecNewColumn.size());
+		}
+		else
+		{
+			//Otherwise move the column to the end of the pool.
+			m_uNoOfUnusedRuns += column.uNoOfRuns;
+			column.uFirstRun = static_cast<uint32_t>(m_vecRuns.size());
+			column.uNoOfRuns = static_cast<uint16_t>(m_vecNewColumn.size());
+			column.uCapacity = column.uNoOfRuns;
+			m_vecRuns.insert(m_vecRuns.end(), m_vecNewColumn.begin(), m_vecNewColumn.end());
+
+			//Don't let the unused space grow without limit.
+			if(m_uNoOfUnusedRuns > m_vecRuns.size() / 2)
+			{
+				tidy();
+			}
+		}
+
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Rebuilds the pool of runs so that each column only takes up the space it needs,
+	/// releasing the space left behind by columns which have grown or been emptied.
+	/// \return The approximate number of bytes which were released.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t ColumnVolume<VoxelType>::tidy(void)
+	{
+		const uint32_t uSizeBefore = calculateSizeInBytes();
+
+		std::vector<Run> vecRuns;
+		vecRuns.reserve(m_vecRuns.size() - m_uNoOfUnusedRuns);
+		for(typename std::vector<Column>::iterator itColumn = m_vecColumns.begin(); itColumn != m_vecColumns.end(); ++itColumn)
+		{
+			const uint32_t uFirstRun = static_cast<uint32_t>(vecRuns.size());
+			vecRuns.insert(vecRuns.end(), m_vecRuns.begin() + itColumn->uFirstRun, m_vecRuns.begin() + itColumn->uFirstRun + itColumn->uNoOfRuns);
+			itColumn->uFirstRun = uFirstRun;
+			itColumn->uCapacity = itColumn->uNoOfRuns;
+		}
+		m_vecRuns.swap(vecRuns);
+		m_uNoOfUnusedRuns = 0;
+
+		//The temporary storage can be released too.
+		std::vector<Run>().swap(m_vecNewColumn);
+
+		const uint32_t uSizeAfter = calculateSizeInBytes();
+		return uSizeBefore > uSizeAfter ? uSizeBefore - uSizeAfter : 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Note: This function needs reviewing for accuracy...
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t ColumnVolume<VoxelType>::calculateSizeInBytes(void)
+	{
+		uint32_t uSizeInBytes = sizeof(ColumnVolume);
+
+		uSizeInBytes += m_vecColumns.capacity() * sizeof(Column);
+		uSizeInBytes += m_vecRuns.capacity() * sizeof(Run);
+		uSizeInBytes += m_vecNewColumn.capacity() * sizeof(Run);
+
+		return uSizeInBytes;
+	}
+
+	template <typename VoxelType>
+	uint32_t ColumnVolume<VoxelType>::getColumnIndex(int32_t uXPos, int32_t uZPos) const
+	{
+		const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
+		return (uXPos - v3dLowerCorner.getX()) + (uZPos - v3dLowerCorner.getZ()) * this->getWidth();
+	}
+
+	template <typename VoxelType>
+	VoxelType ColumnVolume<VoxelType>::getRunAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t& iRunLowerY, int32_t& iRunUpperY) const
+	{
+		const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
+		const Vector3DInt32& v3dUpperCorner = this->m_regValidRegion.getUpperCorner();
+
+		//Outside the columns everything is border.
+		if((uXPos < v3dLowerCorner.getX()) || (uXPos > v3dUpperCorner.getX()) ||
+			(uZPos < v3dLowerCorner.getZ()) || (uZPos > v3dUpperCorner.getZ()))
+		{
+			iRunLowerY = (std::numeric_limits<int32_t>::min)();
+			iRunUpperY = (std::numeric_limits<int32_t>::max)();
+			return getBorderValue();
+		}
+
+		//Above and below the column are border too.
+		if(uYPos < v3dLowerCorner.getY())
+		{
+			iRunLowerY = (std::numeric_limits<int32_t>::min)();
+			iRunUpperY = v3dLowerCorner.getY() - 1;
+			return getBorderValue();
+		}
+		if(uYPos > v3dUpperCorner.getY())
+		{
+			iRunLowerY = v3dUpperCorner.getY() + 1;
+			iRunUpperY = (std::numeric_limits<int32_t>::max)();
+			return getBorderValue();
+		}
+
+		const Column& column = m_vecColumns[getColumnIndex(uXPos, uZPos)];
+		if(column.uNoOfRuns == 0)
+		{
+			iRunLowerY = v3dLowerCorner.getY();
+			iRunUpperY = v3dUpperCorner.getY();
+			return VoxelType();
+		}
+
+		//Find the first run which ends above the requested position. Columns rarely have more
+		//than a handful of runs so a linear search is quicker than a binary one.
+		const Run* pRuns = &(m_vecRuns[column.uFirstRun]);
+		const uint16_t uLocalYPos = static_cast<uint16_t>(uYPos - v3dLowerCorner.getY());
+		uint32_t uRun = 0;
+		while(pRuns[uRun].uEnd <= uLocalYPos)
+		{
+			++uRun;
+		}
+
+		iRunLowerY = v3dLowerCorner.getY() + ((uRun == 0) ? 0 : pRuns[uRun - 1].uEnd);
+		iRunUpperY = v3dLowerCorner.getY() + pRuns[uRun].uEnd - 1;
+		return pRuns[uRun].value;
+	}
+
+	template <typename VoxelType>
+	void ColumnVolume<VoxelType>::appendRun(std::vector<Run>& vecRuns, uint16_t uEnd, const VoxelType& tValue) const
+	{
+		if((!vecRuns.empty()) && (vecRuns.back().value == tValue))
+		{
+			vecRuns.back().uEnd = uEnd;
+		}
+		else
+		{
+			Run run;
+			run.uEnd = uEnd;
+			run.value = tValue;
+			vecRuns.push_back(run);
+		}
+	}
+}
@@ -0,0 +1,140 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+namespace PolyVox
+{
+	template <typename VoxelType>
+	ColumnVolume<VoxelType>::Sampler::Sampler(ColumnVolume<VoxelType>* volume)
+		:BaseVolume<VoxelType>::template Sampler< ColumnVolume<VoxelType> >(volume)
+	{
+		setPosition(0,0,0);
+	}
+
+	template <typename VoxelType>
+	ColumnVolume<VoxelType>::Sampler::~Sampler()
+	{
+	}
+
+	template <typename VoxelType>
+	VoxelType ColumnVolume<VoxelType>::Sampler::getVoxel(void) const
+	{
+		return mCurrentValue;
+	}
+
+	template <typename VoxelType>
+	void ColumnVolume<VoxelType>::Sampler::setPosition(const Vector3DInt32& v3dNewPos)
+	{
+		setPosition(v3dNewPos.getX(), v3dNewPos.getY(), v3dNewPos.getZ());
+	}
+
+	template <typename VoxelType>
+	void ColumnVolume<VoxelType>::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos)
+	{
+		this->mXPosInVolume = xPos;
+		this->mYPosInVolume = yPos;
+		this->mZPosInVolume = zPos;
+
+		mCurrentValue = this->mVolume->getRunAt(xPos, yPos, zPos, mRunLowerY, mRunUpperY);
+	}
+
+	template <typename VoxelType>
+	bool ColumnVolume<VoxelType>::Sampler::setVoxel(VoxelType tValue)
+	{
+		bool bResult = this->mVolume->setVoxelAt(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume, tValue);
+
+		//The runs in this column have changed so the cached one may no longer be valid.
+		setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+
+		return bResult;
+	}
+
+	template <typename VoxelType>
+	void ColumnVolume<VoxelType>::Sampler::movePositiveX(void)
+	{
+		setPosition(this->mXPosInVolume + 1, this->mYPosInVolume, this->mZPosInVolume);
+	}
+
+	template <typename VoxelType>
+	void ColumnVolume<VoxelType>::Sampler::movePositiveY(void)
+	{
+		//Only look up the run again if we have left the current one.
+		if((++this->mYPosInVolume) > mRunUpperY)
+		{
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	void ColumnVolume<VoxelType>::Sampler::movePositiveZ(void)
+	{
+		setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume + 1);
+	}
+
+	template <typename VoxelType>
+	void ColumnVolume<VoxelType>::Sampler::moveNegativeX(void)
+	{
+		setPosition(this->mXPosInVolume - 1, this->mYPosInVolume, this->mZPosInVolume);
+	}
+
+	template <typename VoxelType>
+	void ColumnVolume<VoxelType>::Sampler::moveNegativeY(void)
+	{
+		//Only look up the run again if we have left the current one.
+		if((--this->mYPosInVolume) < mRunLowerY)
+		{
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType>
+	void ColumnVolume<VoxelType>::Sampler::moveNegativeZ(void)
+	{
+		setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume - 1);
+	}
+
+	template <typename VoxelType>
+	VoxelType ColumnVolume<VoxelType>::Sampler::peekVoxel0px1ny0pz(void) const
+	{
+		if(this->mYPosInVolume - 1 >= mRunLowerY)
+		{
+			return mCurrentValue;
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume,this->mYPosInVolume-1,this->mZPosInVolume);
+	}
+
+	template <typename VoxelType>
+	VoxelType ColumnVolume<VoxelType>::Sampler::peekVoxel0px0py0pz(void) const
+	{
+		return mCurrentValue;
+	}
+
+	template <typename VoxelType>
+	VoxelType ColumnVolume<VoxelType>::Sampler::peekVoxel0px1py0pz(void) const
+	{
+		if(this->mYPosInVolume + 1 <= mRunUpperY)
+		{
+			return mCurrentValue;
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume,this->mYPosInVolume+1,this->mZPosInVolume);
+	}
+}
@@ -25,46 +25,168 @@ freely, subject to the following restrictions:
 #define __PolyVox_CubicSurfaceExtractor_H__
 
 #include "PolyVoxImpl/TypeDef.h"
+#include "PolyVoxImpl/Utility.h"
 
-#include "PolyVoxCore/Array.h"
+#include "PolyVoxCore/SpanIterator.h"
 #include "PolyVoxCore/SurfaceMesh.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace PolyVox
 {
 	template< template<typename> class VolumeType, typename VoxelType>
 	class CubicSurfaceExtractor
 	{
-		struct IndexAndMaterial
+		struct Quad
 		{
-			int32_t iIndex;
-			int32_t uMaterial; //Should actually use the material type here, but this is ok for now.
+			uint32_t vertices[4];
 		};
 
-		enum FaceNames
+		//An entry in the table which is used to avoid creating duplicate vertices. It is
+		//only in use if its generation matches that of the slice of the table it is in.
+		struct VertexTableEntry
 		{
-			PositiveX,
-			PositiveY,
-			PositiveZ,
-			NegativeX,
-			NegativeY,
-			NegativeZ,
-			NoOfFaces
+			uint32_t uGeneration;
+			int32_t iFirstVertex;
 		};
 
-		struct Quad
+	public:
+		/// Holds the working buffers which are used during extraction.
+		////////////////////////////////////////////////////////////////////////////////
+		/// By default each extractor allocates its own buffers the first time it is
+		/// executed. When many regions are extracted one after another the same Context
+		/// can instead be given to each extractor through setContext(), in which case
+		/// the buffers grow to fit the largest region seen so far and are then reused.
+		/// A Context must only be used by one extractor at a time.
+		////////////////////////////////////////////////////////////////////////////////
+		class Context
 		{
-			uint32_t vertices[4];
+		public:
+			Context();
+
+		private:
+			friend class CubicSurfaceExtractor;
+
+			//Makes sure the buffers can hold a region of the given size. They are never made smaller.
+			void reserve(uint32_t uWidth, uint32_t uHeight, uint32_t uDepth);
+
+			//Prepares the vertex table to hold the given number of slices, all of which start off empty.
+			void beginVertexTable(uint32_t uNoOfSlices, uint32_t uSliceSize);
+			//Empties one slice of the vertex table, so that it can be used for a different plane of vertices.
+			void clearVertexSlice(uint32_t uSlice);
+
+			//The region size which the buffers can currently hold.
+			uint32_t m_uWidth;
+			uint32_t m_uHeight;
+			uint32_t m_uDepth;
+
+			//During extraction we create a number of different lists of quads. All the 
+			//quads in a given list are in the same plane and facing in the same direction.
+			//The lists are emptied after use, but keep their memory for the next region.
+			std::vector< std::vector<Quad> > m_vecQuads[NoOfFacingDirections];
+
+			//Used when merging quads. The voxels of the region (and the layer around it) are read
+			//once into m_vecVoxelMaterials and into two sets of bit columns saying which voxels are
+			//solid. The faces in each plane are then found as bits in m_vecFaceBits, and their
+			//materials, directions and corner occlusions written to m_vecFaceMask, before being
+			//covered by rectangles.
+			std::vector<uint32_t> m_vecVoxelMaterials;
+			std::vector<uint64_t> m_vecSolidColumnsX;
+			std::vector<uint64_t> m_vecSolidColumnsY;
+			std::vector<uint64_t> m_vecValidBits;
+			std::vector<uint64_t> m_vecFaceBits;
+			std::vector<int32_t> m_vecFaceMask;
+
+			//The merged quads for each axis are found together, so their triangles are collected here
+			//for each direction and then copied to the mesh, where each direction has its own range.
+			std::vector<uint32_t> m_vecFacingIndices[NoOfFacingDirections];
+
+			//Used to avoid creating duplicate vertices. The table has an entry for each vertex position
+			//in a number of slices, each of which holds the positions with a given z. When merging quads
+			//there is a slice for every z, and otherwise there are only two which are reused as the
+			//extraction moves through the region. Rather than being cleared, a slice is given a new
+			//generation which makes the entries from its previous use look empty. The entries point to
+			//the first vertex at their position, and vertices at the same position but with different
+			//materials or occlusions (which are not duplicates) are chained together through m_vecNextVertex.
+			std::vector<VertexTableEntry> m_vecVertexTable;
+			std::vector<uint32_t> m_vecSliceGenerations;
+			uint32_t m_uGeneration;
+			uint32_t m_uVertexSliceSize;
+			std::vector<int32_t> m_vecNextVertex;
+			std::vector<uint32_t> m_vecVertexMaterials;
+			std::vector<uint8_t> m_vecVertexOcclusions;
 		};
 
-	public:
+		/// \param volData The volume to extract the surface from
+		/// \param region The region of the volume which the mesh should cover
+		/// \param result The mesh which the surface is written to
+		/// \param bMergeQuads If true, adjacent faces which lie in the same plane, face in the same direction and
+		/// have the same material are merged into larger rectangles. This is done by a greedy sweep over each plane
+		/// of the region, so the cost is roughly linear in the size of the region. If false, each face of each voxel
+		/// gives its own quad, which is useful if per-vertex attributes (such as lighting) are to be added later.
 		CubicSurfaceExtractor(VolumeType<VoxelType>* volData, Region region, SurfaceMesh<PositionMaterial>* result, bool bMergeQuads = true);
 
+		/// Extracts a mesh which also has per-vertex ambient occlusion.
+		////////////////////////////////////////////////////////////////////////////////
+		/// The occlusion of each corner of each face is found from the voxels in front of
+		/// the face while they are being read for the extraction, so there is no need for
+		/// a separate pass over the volume. Vertices at the same position are only shared
+		/// if they also have the same occlusion, and faces are only merged if their corners
+		/// have the same occlusions as each other. Merging therefore never changes how the
+		/// occlusion is interpolated across the surface, though it does merge fewer faces.
+		/// The quads are split along whichever diagonal stops the darkening of a single
+		/// corner spreading across to the opposite one.
+		/// 
+		/// \param volData The volume to extract the surface from
+		/// \param region The region of the volume which the mesh should cover
+		/// \param result The mesh which the surface is written to
+		/// \param bMergeQuads Whether to merge faces, as for the other constructor.
+		////////////////////////////////////////////////////////////////////////////////
+		CubicSurfaceExtractor(VolumeType<VoxelType>* volData, Region region, SurfaceMesh<PositionMaterialAO>* result, bool bMergeQuads = true);
+
+		/// Makes the extractor use the buffers held by the given Context, rather than
+		/// its own. The Context must outlive any calls to execute(). Passing null makes
+		/// the extractor go back to using its own buffers.
+		void setContext(Context* pContext);
+
 		void execute();		
 
 	private:
-		int32_t addVertex(float fX, float fY, float fZ, uint32_t uMaterial, Array<3, IndexAndMaterial>& existingVertices);
-		bool performQuadMerging(std::list<Quad>& quads);
-		bool mergeQuads(Quad& q1, Quad& q2);
+		//Whether the volume reports that all the voxels read by the extraction are on the same side of
+		//the threshold. Such regions (entirely air or entirely rock) can't contain any faces.
+		bool isRegionUniform(void) const;
+
+		//Fills the given mesh, which is one of the two kinds the extractor can be constructed with.
+		template <typename VertexType>
+		void extractSurface(SurfaceMesh<VertexType>* pMesh);
+
+		//Builds one quad for each face of each voxel.
+		template <typename VertexType>
+		void extractQuads(SurfaceMesh<VertexType>* pMesh);
+
+		//Builds a mask of the faces in each plane of the region and covers it with as few rectangles as it can.
+		template <typename VertexType>
+		void extractMergedQuads(SurfaceMesh<VertexType>* pMesh);
+		template <typename VertexType>
+		void addMergedQuad(SurfaceMesh<VertexType>* pMesh, uint32_t uAxis, uint32_t uPlane, uint32_t uStartU, uint32_t uEndU, uint32_t uStartV, uint32_t uEndV, bool bPositive, uint32_t uMaterial, uint32_t uOcclusions);
+
+		//Adds the two triangles of a quad, choosing the diagonal to split it along from the occlusions of its corners.
+		void addQuad(std::vector<uint32_t>& vecIndices, uint32_t v0, uint32_t v1, uint32_t v2, uint32_t v3);
+
+		//Returns the vertex at the given corner of the voxels, which has the given material and occlusion, creating it if needed.
+		template <typename VertexType>
+		int32_t addVertex(SurfaceMesh<VertexType>* pMesh, uint32_t uX, uint32_t uY, uint32_t uZ, uint32_t uMaterial, uint32_t uOcclusion);
+
+		//The occlusions of the four corners of a face, packed two bits each. The voxel given is the
+		//(empty) one in front of the face, and the face lies across the other two axes.
+		uint32_t getFaceOcclusions(int32_t iX, int32_t iY, int32_t iZ, uint32_t uAxis) const;
+		//As above, but from whether the voxels around the one in front of the face are solid, indexed by u and then v.
+		static uint32_t packFaceOcclusions(const bool (&abSolid)[3][3]);
+
+		//The vertex types only differ in whether they have an occlusion.
+		static void setVertexOcclusion(PositionMaterial& vertex, uint32_t uOcclusion);
+		static void setVertexOcclusion(PositionMaterialAO& vertex, uint32_t uOcclusion);
 
 		//The volume data and a sampler to access it.
 		VolumeType<VoxelType>* m_volData;
@@ -72,24 +194,20 @@ namespace PolyVox
 		//Information about the region we are currently processing
 		Region m_regSizeInVoxels;
 
-		//The surface patch we are currently filling.
+		//The surface patch we are currently filling. Only one of these is set.
 		SurfaceMesh<PositionMaterial>* m_meshCurrent;
+		SurfaceMesh<PositionMaterialAO>* m_meshWithOcclusion;
 
-		//Used to avoid creating duplicate vertices.
-		Array<3, IndexAndMaterial> m_previousSliceVertices;
-		Array<3, IndexAndMaterial> m_currentSliceVertices;
-
-		//During extraction we create a number of different lists of quads. All the 
-		//quads in a given list are in the same plane and facing in the same direction.
-		std::vector< std::list<Quad> > m_vecQuads[NoOfFaces];
+		//The buffers used when no other context has been provided, and the ones actually in use.
+		Context m_defaultContext;
+		Context* m_pContext;
 
 		//Controls whether quad merging should be performed. This might be undesirable
 		//is the user needs per-vertex attributes, or to perform per vertex lighting.
 		bool m_bMergeQuads;
 
-		//This constant defines the maximum number of quads which can share a
-		//vertex in a cubic style mesh. See the initialisation for more details.
-		static const uint32_t MaxVerticesPerPosition;
+		//Whether the occlusions of the vertices are being found. If not, they are all treated as unoccluded.
+		bool m_bAmbientOcclusion;
 	};
 }
 
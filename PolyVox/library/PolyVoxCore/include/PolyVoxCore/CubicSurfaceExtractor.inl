@@ -23,52 +23,184 @@ freely, subject to the following restrictions:
 
 namespace PolyVox
 {
-	// We try to avoid duplicate vertices by checking whether a vertex has already been added at a given position.
-	// However, it is possible that vertices have the same position but different materials. In this case, the
-	// vertices are not true duplicates and both must be added to the mesh. As far as I can tell, it is possible to have
-	// at most six vertices with the same position but different materials. This worst-case scenario happens when we
-	// have a 2x2x2 group of voxels (all with different materials) and then we delete two voxels from opposing corners.
-	// The vertex position at the center of this group is then going to be used by six quads all with different materials.
-	// One futher note - we can actually have eight quads sharing a vertex position (imagine two 1x1x10 rows of voxels
-	// sharing a common edge) but in this case all eight quads will not have different materials.
 	template< template<typename> class VolumeType, typename VoxelType>
-	const uint32_t CubicSurfaceExtractor<VolumeType, VoxelType>::MaxVerticesPerPosition = 6;
+	CubicSurfaceExtractor<VolumeType, VoxelType>::Context::Context()
+		:m_uWidth(0)
+		,m_uHeight(0)
+		,m_uDepth(0)
+		,m_uGeneration(0)
+		,m_uVertexSliceSize(0)
+	{
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void CubicSurfaceExtractor<VolumeType, VoxelType>::Context::reserve(uint32_t uWidth, uint32_t uHeight, uint32_t uDepth)
+	{
+		//Regions of different sizes share the largest buffers, as unused quad lists are
+		//empty. Growing the vectors of lists keeps the existing lists (and their memory).
+		m_uWidth = (std::max)(m_uWidth, uWidth);
+		m_uHeight = (std::max)(m_uHeight, uHeight);
+		m_uDepth = (std::max)(m_uDepth, uDepth);
+
+		//The faces lie between the voxels, so there is one more plane of them in each direction.
+		m_vecQuads[FacingNegativeX].resize(m_uWidth + 1);
+		m_vecQuads[FacingPositiveX].resize(m_uWidth + 1);
+
+		m_vecQuads[FacingNegativeY].resize(m_uHeight + 1);
+		m_vecQuads[FacingPositiveY].resize(m_uHeight + 1);
+
+		m_vecQuads[FacingNegativeZ].resize(m_uDepth + 1);
+		m_vecQuads[FacingPositiveZ].resize(m_uDepth + 1);
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void CubicSurfaceExtractor<VolumeType, VoxelType>::Context::beginVertexTable(uint32_t uNoOfSlices, uint32_t uSliceSize)
+	{
+		//Each extraction uses far fewer generations than this, so the counter can't wrap round part way through one.
+		if(m_uGeneration > 0xF0000000u)
+		{
+			for(typename std::vector<VertexTableEntry>::iterator iter = m_vecVertexTable.begin(); iter != m_vecVertexTable.end(); iter++)
+			{
+				iter->uGeneration = 0;
+			}
+			m_uGeneration = 0;
+		}
+
+		//Entries from earlier extractions may be laid out differently, but their generations are all older.
+		m_uVertexSliceSize = uSliceSize;
+		if(m_vecVertexTable.size() < uNoOfSlices * uSliceSize)
+		{
+			VertexTableEntry emptyEntry = {0, -1};
+			m_vecVertexTable.resize(uNoOfSlices * uSliceSize, emptyEntry);
+		}
+
+		m_vecSliceGenerations.resize(uNoOfSlices);
+		for(uint32_t uSlice = 0; uSlice < uNoOfSlices; uSlice++)
+		{
+			clearVertexSlice(uSlice);
+		}
+
+		m_vecNextVertex.clear();
+		m_vecVertexMaterials.clear();
+		m_vecVertexOcclusions.clear();
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void CubicSurfaceExtractor<VolumeType, VoxelType>::Context::clearVertexSlice(uint32_t uSlice)
+	{
+		m_uGeneration++;
+		m_vecSliceGenerations[uSlice] = m_uGeneration;
+	}
 
 	template< template<typename> class VolumeType, typename VoxelType>
 	CubicSurfaceExtractor<VolumeType, VoxelType>::CubicSurfaceExtractor(VolumeType<VoxelType>* volData, Region region, SurfaceMesh<PositionMaterial>* result, bool bMergeQuads)
 		:m_volData(volData)
 		,m_regSizeInVoxels(region)
 		,m_meshCurrent(result)
+		,m_meshWithOcclusion(0)
+		,m_pContext(&m_defaultContext)
+		,m_bMergeQuads(bMergeQuads)
+		,m_bAmbientOcclusion(false)
+	{
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	CubicSurfaceExtractor<VolumeType, VoxelType>::CubicSurfaceExtractor(VolumeType<VoxelType>* volData, Region region, SurfaceMesh<PositionMaterialAO>* result, bool bMergeQuads)
+		:m_volData(volData)
+		,m_regSizeInVoxels(region)
+		,m_meshCurrent(0)
+		,m_meshWithOcclusion(result)
+		,m_pContext(&m_defaultContext)
 		,m_bMergeQuads(bMergeQuads)
+		,m_bAmbientOcclusion(true)
+	{
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void CubicSurfaceExtractor<VolumeType, VoxelType>::setContext(Context* pContext)
 	{
+		m_pContext = (pContext != 0) ? pContext : &m_defaultContext;
 	}
 
 	template< template<typename> class VolumeType, typename VoxelType>
 	void CubicSurfaceExtractor<VolumeType, VoxelType>::execute()
 	{
-		m_meshCurrent->clear();
+		if(m_bAmbientOcclusion)
+		{
+			extractSurface(m_meshWithOcclusion);
+		}
+		else
+		{
+			extractSurface(m_meshCurrent);
+		}
+	}
 
-		uint32_t uArrayWidth = m_regSizeInVoxels.getUpperCorner().getX() - m_regSizeInVoxels.getLowerCorner().getX() + 2;
-		uint32_t uArrayHeight = m_regSizeInVoxels.getUpperCorner().getY() - m_regSizeInVoxels.getLowerCorner().getY() + 2;
+	template< template<typename> class VolumeType, typename VoxelType>
+	template <typename VertexType>
+	void CubicSurfaceExtractor<VolumeType, VoxelType>::extractSurface(SurfaceMesh<VertexType>* pMesh)
+	{
+		pMesh->clear();
+
+		if(isRegionUniform())
+		{
+			pMesh->m_Region = m_regSizeInVoxels;
+
+			pMesh->m_vecLodRecords.clear();
+			LodRecord lodRecord;
+			lodRecord.beginIndex = 0;
+			lodRecord.endIndex = 0;
+			pMesh->m_vecLodRecords.push_back(lodRecord);
+			pMesh->m_vecFacingRecords.assign(NoOfFacingDirections, lodRecord);
+			return;
+		}
+
+		if(m_bMergeQuads)
+		{
+			extractMergedQuads(pMesh);
+		}
+		else
+		{
+			extractQuads(pMesh);
+		}
+
+		pMesh->m_Region = m_regSizeInVoxels;
+
+		pMesh->m_vecLodRecords.clear();
+		LodRecord lodRecord;
+		lodRecord.beginIndex = 0;
+		lodRecord.endIndex = pMesh->getNoOfIndices();
+		pMesh->m_vecLodRecords.push_back(lodRecord);
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	bool CubicSurfaceExtractor<VolumeType, VoxelType>::isRegionUniform(void) const
+	{
+		//Faces on the lower sides of the region come from comparing with the voxels just outside it, and
+		//those on the upper sides from the voxels one beyond the upper corner.
+		const Region regVoxels(m_regSizeInVoxels.getLowerCorner() - Vector3DInt32(1,1,1), m_regSizeInVoxels.getUpperCorner() + Vector3DInt32(1,1,1));
 
-		uint32_t arraySize[3]= {uArrayWidth, uArrayHeight, MaxVerticesPerPosition};
-		m_previousSliceVertices.resize(arraySize);
-		m_currentSliceVertices.resize(arraySize);
-		memset(m_previousSliceVertices.getRawData(), 0xff, m_previousSliceVertices.getNoOfElements() * sizeof(IndexAndMaterial));
-		memset(m_currentSliceVertices.getRawData(), 0xff, m_currentSliceVertices.getNoOfElements() * sizeof(IndexAndMaterial));
+		typename VolumeType<VoxelType>::DensityType tMin;
+		typename VolumeType<VoxelType>::DensityType tMax;
+		if(m_volData->getDensityRange(regVoxels, tMin, tMax))
+		{
+			return (tMin >= VoxelType::getThreshold()) || (tMax < VoxelType::getThreshold());
+		}
+
+		return false;
+	}
 
+	template< template<typename> class VolumeType, typename VoxelType>
+	template <typename VertexType>
+	void CubicSurfaceExtractor<VolumeType, VoxelType>::extractQuads(SurfaceMesh<VertexType>* pMesh)
+	{
 		uint32_t uRegionWidth  = m_regSizeInVoxels.getUpperCorner().getX() - m_regSizeInVoxels.getLowerCorner().getX() + 1;
 		uint32_t uRegionHeight = m_regSizeInVoxels.getUpperCorner().getY() - m_regSizeInVoxels.getLowerCorner().getY() + 1;
 		uint32_t uRegionDepth  = m_regSizeInVoxels.getUpperCorner().getZ() - m_regSizeInVoxels.getLowerCorner().getZ() + 1;
 
-		m_vecQuads[NegativeX].resize(m_regSizeInVoxels.getUpperCorner().getX() - m_regSizeInVoxels.getLowerCorner().getX() + 2);
-		m_vecQuads[PositiveX].resize(m_regSizeInVoxels.getUpperCorner().getX() - m_regSizeInVoxels.getLowerCorner().getX() + 2);
-
-		m_vecQuads[NegativeY].resize(m_regSizeInVoxels.getUpperCorner().getY() - m_regSizeInVoxels.getLowerCorner().getY() + 2);
-		m_vecQuads[PositiveY].resize(m_regSizeInVoxels.getUpperCorner().getY() - m_regSizeInVoxels.getLowerCorner().getY() + 2);
-
-		m_vecQuads[NegativeZ].resize(m_regSizeInVoxels.getUpperCorner().getZ() - m_regSizeInVoxels.getLowerCorner().getZ() + 2);
-		m_vecQuads[PositiveZ].resize(m_regSizeInVoxels.getUpperCorner().getZ() - m_regSizeInVoxels.getLowerCorner().getZ() + 2);
+		Context& context = *m_pContext;
+		context.reserve(uRegionWidth, uRegionHeight, uRegionDepth);
+		context.beginVertexTable(2, (uRegionWidth + 1) * (uRegionHeight + 1));
+		std::vector< std::vector<Quad> >* m_vecQuads = context.m_vecQuads;
 
 		typename VolumeType<VoxelType>::Sampler volumeSampler(m_volData);	
 		Quad quad;
@@ -78,6 +210,12 @@ namespace PolyVox
 			uint32_t regZ = z - m_regSizeInVoxels.getLowerCorner().getZ();
 			bool finalZ = (z == m_regSizeInVoxels.getUpperCorner().getZ() + 1);
 
+			//The vertices are at regZ and regZ + 1, so the slice last used for regZ - 1 can be reused.
+			if(regZ > 0)
+			{
+				context.clearVertexSlice((regZ + 1) & 1);
+			}
+
 			for(int32_t y = m_regSizeInVoxels.getLowerCorner().getY(); y <= m_regSizeInVoxels.getUpperCorner().getY() + 1; y++)
 			{
 				uint32_t regY = y - m_regSizeInVoxels.getLowerCorner().getY();
@@ -103,10 +241,13 @@ namespace PolyVox
 						// Check to ensure that when a voxel solid/non-solid change is right on a region border, the vertices are generated on the solid side of the region border
 						if(((currentVoxelIsSolid > negXVoxelIsSolid) && finalX == false) || ((currentVoxelIsSolid < negXVoxelIsSolid) && regX != 0))
 						{
-							uint32_t v0 = addVertex(regX - 0.5f, regY - 0.5f, regZ - 0.5f, material, m_previousSliceVertices);
-							uint32_t v1 = addVertex(regX - 0.5f, regY - 0.5f, regZ + 0.5f, material, m_currentSliceVertices);	
-							uint32_t v2 = addVertex(regX - 0.5f, regY + 0.5f, regZ + 0.5f, material, m_currentSliceVertices);							
-							uint32_t v3 = addVertex(regX - 0.5f, regY + 0.5f, regZ - 0.5f, material, m_previousSliceVertices);
+							//The occlusion comes from the voxels around the empty one in front of the face.
+							uint32_t occlusions = m_bAmbientOcclusion ? getFaceOcclusions(currentVoxelIsSolid ? x - 1 : x, y, z, 0) : 0xFF;
+
+							uint32_t v0 = addVertex(pMesh, regX, regY, regZ, material, occlusions & 3);
+							uint32_t v1 = addVertex(pMesh, regX, regY, regZ + 1, material, (occlusions >> 4) & 3);	
+							uint32_t v2 = addVertex(pMesh, regX, regY + 1, regZ + 1, material, (occlusions >> 6) & 3);							
+							uint32_t v3 = addVertex(pMesh, regX, regY + 1, regZ, material, (occlusions >> 2) & 3);
 
 							if(currentVoxelIsSolid > negXVoxelIsSolid)
 							{								
@@ -115,7 +256,7 @@ namespace PolyVox
 								quad.vertices[2] = v2;
 								quad.vertices[3] = v3;
 
-								m_vecQuads[NegativeX][regX].push_back(quad);
+								m_vecQuads[FacingNegativeX][regX].push_back(quad);
 							}
 							else											
 							{
@@ -124,7 +265,7 @@ namespace PolyVox
 								quad.vertices[2] = v2;
 								quad.vertices[3] = v1;
 
-								m_vecQuads[PositiveX][regX].push_back(quad);
+								m_vecQuads[FacingPositiveX][regX].push_back(quad);
 							}
 
 						}
@@ -139,10 +280,12 @@ namespace PolyVox
 
 						if(((currentVoxelIsSolid > negYVoxelIsSolid) && finalY == false) || ((currentVoxelIsSolid < negYVoxelIsSolid) && regY != 0))
 						{
-							uint32_t v0 = addVertex(regX - 0.5f, regY - 0.5f, regZ - 0.5f, material, m_previousSliceVertices);
-							uint32_t v1 = addVertex(regX - 0.5f, regY - 0.5f, regZ + 0.5f, material, m_currentSliceVertices);							
-							uint32_t v2 = addVertex(regX + 0.5f, regY - 0.5f, regZ + 0.5f, material, m_currentSliceVertices);
-							uint32_t v3 = addVertex(regX + 0.5f, regY - 0.5f, regZ - 0.5f, material, m_previousSliceVertices);
+							uint32_t occlusions = m_bAmbientOcclusion ? getFaceOcclusions(x, currentVoxelIsSolid ? y - 1 : y, z, 1) : 0xFF;
+
+							uint32_t v0 = addVertex(pMesh, regX, regY, regZ, material, occlusions & 3);
+							uint32_t v1 = addVertex(pMesh, regX, regY, regZ + 1, material, (occlusions >> 4) & 3);							
+							uint32_t v2 = addVertex(pMesh, regX + 1, regY, regZ + 1, material, (occlusions >> 6) & 3);
+							uint32_t v3 = addVertex(pMesh, regX + 1, regY, regZ, material, (occlusions >> 2) & 3);
 
 							if(currentVoxelIsSolid > negYVoxelIsSolid)
 							{
@@ -152,7 +295,7 @@ namespace PolyVox
 								quad.vertices[2] = v2;
 								quad.vertices[3] = v1;
 
-								m_vecQuads[NegativeY][regY].push_back(quad);
+								m_vecQuads[FacingNegativeY][regY].push_back(quad);
 							}
 							else
 							{
@@ -162,7 +305,7 @@ namespace PolyVox
 								quad.vertices[2] = v2;
 								quad.vertices[3] = v3;
 
-								m_vecQuads[PositiveY][regY].push_back(quad);
+								m_vecQuads[FacingPositiveY][regY].push_back(quad);
 							}
 						}
 					}
@@ -176,10 +319,12 @@ namespace PolyVox
 
 						if(((currentVoxelIsSolid > negZVoxelIsSolid) && finalZ == false) || ((currentVoxelIsSolid < negZVoxelIsSolid) && regZ != 0))
 						{
-							uint32_t v0 = addVertex(regX - 0.5f, regY - 0.5f, regZ - 0.5f, material, m_previousSliceVertices);
-							uint32_t v1 = addVertex(regX - 0.5f, regY + 0.5f, regZ - 0.5f, material, m_previousSliceVertices);
-							uint32_t v2 = addVertex(regX + 0.5f, regY + 0.5f, regZ - 0.5f, material, m_previousSliceVertices);
-							uint32_t v3 = addVertex(regX + 0.5f, regY - 0.5f, regZ - 0.5f, material, m_previousSliceVertices);							
+							uint32_t occlusions = m_bAmbientOcclusion ? getFaceOcclusions(x, y, currentVoxelIsSolid ? z - 1 : z, 2) : 0xFF;
+
+							uint32_t v0 = addVertex(pMesh, regX, regY, regZ, material, occlusions & 3);
+							uint32_t v1 = addVertex(pMesh, regX, regY + 1, regZ, material, (occlusions >> 4) & 3);
+							uint32_t v2 = addVertex(pMesh, regX + 1, regY + 1, regZ, material, (occlusions >> 6) & 3);
+							uint32_t v3 = addVertex(pMesh, regX + 1, regY, regZ, material, (occlusions >> 2) & 3);							
 	
 							if(currentVoxelIsSolid > negZVoxelIsSolid)
 							{
@@ -188,7 +333,7 @@ namespace PolyVox
 								quad.vertices[2] = v2;
 								quad.vertices[3] = v3;
 
-								m_vecQuads[NegativeZ][regZ].push_back(quad);
+								m_vecQuads[FacingNegativeZ][regZ].push_back(quad);
 							}
 							else
 							{
@@ -197,151 +342,399 @@ namespace PolyVox
 								quad.vertices[2] = v2;
 								quad.vertices[3] = v1;
 
-								m_vecQuads[PositiveZ][regZ].push_back(quad);
+								m_vecQuads[FacingPositiveZ][regZ].push_back(quad);
 							}
 						}
 					}
 				}
 			}
-
-			m_previousSliceVertices.swap(m_currentSliceVertices);
-			memset(m_currentSliceVertices.getRawData(), 0xff, m_currentSliceVertices.getNoOfElements() * sizeof(IndexAndMaterial));
 		}
 
-		for(uint32_t uFace = 0; uFace < NoOfFaces; uFace++)
+		pMesh->m_vecFacingRecords.resize(NoOfFacingDirections);
+		for(uint32_t uFace = 0; uFace < NoOfFacingDirections; uFace++)
 		{
-			std::vector< std::list<Quad> >& vecListQuads = m_vecQuads[uFace];
+			std::vector< std::vector<Quad> >& vecListQuads = m_vecQuads[uFace];
+			pMesh->m_vecFacingRecords[uFace].beginIndex = pMesh->getNoOfIndices();
 
 			for(uint32_t slice = 0; slice < vecListQuads.size(); slice++)
 			{
-				std::list<Quad>& listQuads = vecListQuads[slice];
+				std::vector<Quad>& listQuads = vecListQuads[slice];
 
-				if(m_bMergeQuads)
-				{
-					//Repeatedly call this function until it returns
-					//false to indicate nothing more can be done.
-					while(performQuadMerging(listQuads)){}
-				}
-
-				typename std::list<Quad>::iterator iterEnd = listQuads.end();
-				for(typename std::list<Quad>::iterator quadIter = listQuads.begin(); quadIter != iterEnd; quadIter++)
+				typename std::vector<Quad>::iterator iterEnd = listQuads.end();
+				for(typename std::vector<Quad>::iterator quadIter = listQuads.begin(); quadIter != iterEnd; quadIter++)
 				{
 					Quad& quad = *quadIter;				
-					m_meshCurrent->addTriangleCubic(quad.vertices[0], quad.vertices[1],quad.vertices[2]);
-					m_meshCurrent->addTriangleCubic(quad.vertices[0], quad.vertices[2],quad.vertices[3]);
+					addQuad(pMesh->m_vecTriangleIndices, quad.vertices[0], quad.vertices[1], quad.vertices[2], quad.vertices[3]);
 				}			
+
+				//The context may be used for another region, so leave the list empty (but with its memory).
+				listQuads.clear();
 			}
-		}
 
-		m_meshCurrent->m_Region = m_regSizeInVoxels;
-		m_meshCurrent->removeUnusedVertices();
+			pMesh->m_vecFacingRecords[uFace].endIndex = pMesh->getNoOfIndices();
+		}
 
-		m_meshCurrent->m_vecLodRecords.clear();
-		LodRecord lodRecord;
-		lodRecord.beginIndex = 0;
-		lodRecord.endIndex = m_meshCurrent->getNoOfIndices();
-		m_meshCurrent->m_vecLodRecords.push_back(lodRecord);
+		pMesh->removeUnusedVertices();
 	}
 
 	template< template<typename> class VolumeType, typename VoxelType>
-	int32_t CubicSurfaceExtractor<VolumeType, VoxelType>::addVertex(float fX, float fY, float fZ, uint32_t uMaterialIn, Array<3, IndexAndMaterial>& existingVertices)
+	template <typename VertexType>
+	void CubicSurfaceExtractor<VolumeType, VoxelType>::extractMergedQuads(SurfaceMesh<VertexType>* pMesh)
 	{
-		uint32_t uX = static_cast<uint32_t>(fX + 0.75f);
-		uint32_t uY = static_cast<uint32_t>(fY + 0.75f);
-
-		for(uint32_t ct = 0; ct < MaxVerticesPerPosition; ct++)
+		const uint32_t uRegionSize[3] =
 		{
-			IndexAndMaterial& rEntry = existingVertices[uX][uY][ct];
-
-			if(rEntry.iIndex == -1)
-			{
-				//No vertices matched and we've now hit an empty space. Fill it by creating a vertex.
-				rEntry.iIndex = m_meshCurrent->addVertex(PositionMaterial(Vector3DFloat(fX, fY, fZ), uMaterialIn));
-				rEntry.uMaterial = uMaterialIn;
+			static_cast<uint32_t>(m_regSizeInVoxels.getUpperCorner().getX() - m_regSizeInVoxels.getLowerCorner().getX() + 1),
+			static_cast<uint32_t>(m_regSizeInVoxels.getUpperCorner().getY() - m_regSizeInVoxels.getLowerCorner().getY() + 1),
+			static_cast<uint32_t>(m_regSizeInVoxels.getUpperCorner().getZ() - m_regSizeInVoxels.getLowerCorner().getZ() + 1)
+		};
+
+		Context& context = *m_pContext;
+
+		//The faces on the sides of the region come from comparing with the voxels just outside it, so a layer of
+		//voxels around the region is read as well. Voxel (x,y,z) of the region is stored at index x+1, y+1, z+1.
+		const uint32_t uPaddedWidth = uRegionSize[0] + 2;
+		const uint32_t uPaddedHeight = uRegionSize[1] + 2;
+		const uint32_t uPaddedDepth = uRegionSize[2] + 2;
+		const uint32_t uVoxelStrides[3] = {1, uPaddedWidth, uPaddedWidth * uPaddedHeight};
+
+		//Which voxels are solid is held as bits, in columns running along x (one for each y and z) and in columns
+		//running along y (one for each x and z). Comparing neighbouring columns then finds up to 64 faces at once.
+		const uint32_t uWordsPerColumnX = (uPaddedWidth + 63) / 64;
+		const uint32_t uWordsPerColumnY = (uPaddedHeight + 63) / 64;
+
+		context.m_vecVoxelMaterials.resize(uPaddedWidth * uPaddedHeight * uPaddedDepth);
+		context.m_vecSolidColumnsX.assign(uPaddedHeight * uPaddedDepth * uWordsPerColumnX, 0);
+		context.m_vecSolidColumnsY.assign(uPaddedWidth * uPaddedDepth * uWordsPerColumnY, 0);
+
+		uint32_t* pMaterials = &(context.m_vecVoxelMaterials[0]);
+		uint64_t* pSolidColumnsX = &(context.m_vecSolidColumnsX[0]);
+		uint64_t* pSolidColumnsY = &(context.m_vecSolidColumnsY[0]);
+
+		const Region regVoxels(m_regSizeInVoxels.getLowerCorner() - Vector3DInt32(1,1,1), m_regSizeInVoxels.getUpperCorner() + Vector3DInt32(1,1,1));
+		for(ConstSpanIterator<VolumeType, VoxelType> iter(m_volData, regVoxels); iter.isValid(); iter.moveForward())
+		{
+			const uint32_t uX = iter.getPosX() - regVoxels.getLowerCorner().getX();
+			const uint32_t uY = iter.getPosY() - regVoxels.getLowerCorner().getY();
+			const uint32_t uZ = iter.getPosZ() - regVoxels.getLowerCorner().getZ();
 
-				return rEntry.iIndex;
-			}
+			uint32_t* pSpanMaterials = pMaterials + (uZ * uPaddedHeight + uY) * uPaddedWidth + uX;
+			uint64_t* pColumnX = pSolidColumnsX + (uZ * uPaddedHeight + uY) * uWordsPerColumnX;
+			uint64_t* pColumnsY = pSolidColumnsY + (uZ * uPaddedWidth + uX) * uWordsPerColumnY + (uY >> 6);
+			const uint64_t uBitY = static_cast<uint64_t>(1) << (uY & 63);
 
-			//If we have an existing vertex and the material matches then we can return it.
-			if(rEntry.uMaterial == uMaterialIn)
+			const VoxelType* pVoxels = iter.getSpan();
+			for(int32_t i = 0; i < iter.getLength(); i++)
 			{
-				return rEntry.iIndex;
+				pSpanMaterials[i] = pVoxels[i].getMaterial();
+				if(pVoxels[i].getDensity() >= VoxelType::getThreshold())
+				{
+					pColumnX[(uX + i) >> 6] |= static_cast<uint64_t>(1) << ((uX + i) & 63);
+					pColumnsY[i * uWordsPerColumnY] |= uBitY;
+				}
 			}
 		}
 
-		// If we exit the loop here then apparently all the slots were full but none of them matched. I don't think
-		// this can happen so let's put an assert to make sure. If you hit this assert then please report it to us!
-		assert(false);
-		return -1; //Should never happen.
-	}
+		//The vertices lie on the corners of the voxels, so there is one more of them in each direction.
+		context.beginVertexTable(uRegionSize[2] + 1, (uRegionSize[0] + 1) * (uRegionSize[1] + 1));
 
-	template< template<typename> class VolumeType, typename VoxelType>
-	bool CubicSurfaceExtractor<VolumeType, VoxelType>::performQuadMerging(std::list<Quad>& quads)
-	{
-		bool bDidMerge = false;
-		for(typename std::list<Quad>::iterator outerIter = quads.begin(); outerIter != quads.end(); outerIter++)
+		for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
 		{
-			typename std::list<Quad>::iterator innerIter = outerIter;
-			innerIter++;
-			while(innerIter != quads.end())
+			//The two axes which lie in the planes of the faces. The faces are swept along u and then along v.
+			const uint32_t uAxisU = (uAxis == 0) ? 1 : 0;
+			const uint32_t uAxisV = (uAxis == 2) ? 1 : 2;
+			const uint32_t uSizeU = uRegionSize[uAxisU];
+			const uint32_t uSizeV = uRegionSize[uAxisV];
+
+			//The x faces are found from the columns running along y, and the others from those running along x.
+			//In both cases the bits of a column are indexed by u, and the strides give the column to compare.
+			const uint64_t* pColumns = (uAxis == 0) ? pSolidColumnsY : pSolidColumnsX;
+			const uint32_t uWords = (uAxis == 0) ? uWordsPerColumnY : uWordsPerColumnX;
+			const uint32_t uPlaneStride = (uAxis == 0) ? uWords : ((uAxis == 1) ? uWords : uPaddedHeight * uWords);
+			const uint32_t uRowStride = (uAxis == 1) ? uPaddedHeight * uWords : ((uAxis == 0) ? uPaddedWidth * uWords : uWords);
+
+			//Bits for the voxels in the layer around the region never give faces.
+			context.m_vecValidBits.assign(uWords, 0);
+			for(uint32_t u = 0; u < uSizeU; u++)
 			{
-				Quad& q1 = *outerIter;
-				Quad& q2 = *innerIter;
+				context.m_vecValidBits[(u + 1) >> 6] |= static_cast<uint64_t>(1) << ((u + 1) & 63);
+			}
 
-				bool result = mergeQuads(q1,q2);
+			//Each entry of the mask is -1 if there is no face, or else holds the material of the face shifted up by nine
+			//bits, then the occlusions of its corners, with the bottom bit set if the face points in the positive direction
+			//along the axis. Only faces with equal entries are merged, so the occlusion is the same along any direction in
+			//which a rectangle is more than one face across. Covering faces with rectangles sets their entries back to -1,
+			//so the mask only needs filling once for each axis.
+			context.m_vecFaceMask.assign(uSizeU * uSizeV, -1);
+			context.m_vecFaceBits.resize(uSizeV * uWords);
+			int32_t* pFaceMask = &(context.m_vecFaceMask[0]);
+			uint64_t* pFaceBits = &(context.m_vecFaceBits[0]);
+
+			//Each plane lies between the voxels at uPlane - 1 and uPlane along the axis.
+			for(uint32_t uPlane = 0; uPlane <= uRegionSize[uAxis]; uPlane++)
+			{
+				// Check to ensure that when a voxel solid/non-solid change is right on a region border, the faces are generated on the solid side of the region border
+				const uint64_t uNegativeFacesAllowed = (uPlane != uRegionSize[uAxis]) ? ~static_cast<uint64_t>(0) : 0;
+				const uint64_t uPositiveFacesAllowed = (uPlane != 0) ? ~static_cast<uint64_t>(0) : 0;
 
-				if(result)
+				bool bPlaneHasFaces = false;
+				for(uint32_t v = 0; v < uSizeV; v++)
 				{
-					bDidMerge = true;
-					innerIter = quads.erase(innerIter);
+					const uint64_t* pCurrent = pColumns + (uPlane + 1) * uPlaneStride + (v + 1) * uRowStride;
+					const uint64_t* pNeg = pCurrent - uPlaneStride;
+					uint64_t* pRowBits = pFaceBits + v * uWords;
+
+					for(uint32_t uWord = 0; uWord < uWords; uWord++)
+					{
+						const uint64_t uPositiveFaces = pNeg[uWord] & ~pCurrent[uWord] & uPositiveFacesAllowed;
+						uint64_t uFaces = ((pCurrent[uWord] & ~pNeg[uWord] & uNegativeFacesAllowed) | uPositiveFaces) & context.m_vecValidBits[uWord];
+						pRowBits[uWord] = uFaces;
+
+						while(uFaces != 0)
+						{
+							const uint32_t uBit = countTrailingZeros(uFaces);
+							uFaces &= uFaces - 1;
+
+							const uint32_t u = uWord * 64 + uBit - 1;
+							const uint32_t uCurrent = (uPlane + 1) * uVoxelStrides[uAxis] + (u + 1) * uVoxelStrides[uAxisU] + (v + 1) * uVoxelStrides[uAxisV];
+							const uint32_t uMaterial = (std::max)(pMaterials[uCurrent], pMaterials[uCurrent - uVoxelStrides[uAxis]]);
+							const uint32_t uPositive = (uPositiveFaces >> uBit) & 1;
+							assert(uMaterial < (1u << 22));
+
+							uint32_t uOcclusions = 0xFF;
+							if(m_bAmbientOcclusion)
+							{
+								//The voxels in front of the face are in the layer on its empty side.
+								uint32_t uPosition[3];
+								uPosition[uAxis] = uPlane + uPositive;
+								bool abSolid[3][3];
+								for(uint32_t uOffsetV = 0; uOffsetV < 3; uOffsetV++)
+								{
+									for(uint32_t uOffsetU = 0; uOffsetU < 3; uOffsetU++)
+									{
+										uPosition[uAxisU] = u + uOffsetU;
+										uPosition[uAxisV] = v + uOffsetV;
+										const uint64_t uWord = pSolidColumnsX[(uPosition[2] * uPaddedHeight + uPosition[1]) * uWordsPerColumnX + (uPosition[0] >> 6)];
+										abSolid[uOffsetU][uOffsetV] = ((uWord >> (uPosition[0] & 63)) & 1) != 0;
+									}
+								}
+								uOcclusions = packFaceOcclusions(abSolid);
+							}
+
+							pFaceMask[v * uSizeU + u] = static_cast<int32_t>((uMaterial << 9) | (uOcclusions << 1) | uPositive);
+							bPlaneHasFaces = true;
+						}
+					}
 				}
-				else
+
+				if(!bPlaneHasFaces)
 				{
-					innerIter++;
+					continue;
+				}
+
+				//Cover the faces with rectangles, each of which is made as wide as it can be and then as tall as it can be.
+				for(uint32_t v = 0; v < uSizeV; v++)
+				{
+					uint64_t* pRowBits = pFaceBits + v * uWords;
+					for(uint32_t uWord = 0; uWord < uWords; uWord++)
+					{
+						//Covering a rectangle clears its bits, including at least the one which started it.
+						while(pRowBits[uWord] != 0)
+						{
+							const uint32_t u = uWord * 64 + countTrailingZeros(pRowBits[uWord]) - 1;
+							const int32_t iFace = pFaceMask[v * uSizeU + u];
+
+							uint32_t uEndU = u + 1;
+							while((uEndU < uSizeU) && (pFaceMask[v * uSizeU + uEndU] == iFace))
+							{
+								uEndU++;
+							}
+
+							uint32_t uEndV = v + 1;
+							while(uEndV < uSizeV)
+							{
+								const int32_t* pRow = pFaceMask + uEndV * uSizeU;
+								uint32_t uMatching = u;
+								while((uMatching < uEndU) && (pRow[uMatching] == iFace))
+								{
+									uMatching++;
+								}
+
+								if(uMatching < uEndU)
+								{
+									break;
+								}
+								uEndV++;
+							}
+
+							//The faces which are covered must not be used again.
+							for(uint32_t uRow = v; uRow < uEndV; uRow++)
+							{
+								std::fill(pFaceMask + uRow * uSizeU + u, pFaceMask + uRow * uSizeU + uEndU, -1);
+								for(uint32_t uCovered = u + 1; uCovered <= uEndU; uCovered++)
+								{
+									pFaceBits[uRow * uWords + (uCovered >> 6)] &= ~(static_cast<uint64_t>(1) << (uCovered & 63));
+								}
+							}
+
+							addMergedQuad(pMesh, uAxis, uPlane, u, uEndU, v, uEndV, (iFace & 1) != 0, static_cast<uint32_t>(iFace) >> 9, (static_cast<uint32_t>(iFace) >> 1) & 0xFF);
+						}
+					}
 				}
 			}
 		}
 
-		return bDidMerge;
+		//Give the faces for each direction their own range of the mesh's indices.
+		pMesh->m_vecFacingRecords.resize(NoOfFacingDirections);
+		for(uint32_t uFace = 0; uFace < NoOfFacingDirections; uFace++)
+		{
+			std::vector<uint32_t>& vecFacingIndices = context.m_vecFacingIndices[uFace];
+			pMesh->m_vecFacingRecords[uFace].beginIndex = pMesh->getNoOfIndices();
+			pMesh->m_vecTriangleIndices.insert(pMesh->m_vecTriangleIndices.end(), vecFacingIndices.begin(), vecFacingIndices.end());
+			pMesh->m_vecFacingRecords[uFace].endIndex = pMesh->getNoOfIndices();
+			vecFacingIndices.clear();
+		}
 	}
 
 	template< template<typename> class VolumeType, typename VoxelType>
-	bool CubicSurfaceExtractor<VolumeType, VoxelType>::mergeQuads(Quad& q1, Quad& q2)
+	template <typename VertexType>
+	void CubicSurfaceExtractor<VolumeType, VoxelType>::addMergedQuad(SurfaceMesh<VertexType>* pMesh, uint32_t uAxis, uint32_t uPlane, uint32_t uStartU, uint32_t uEndU, uint32_t uStartV, uint32_t uEndV, bool bPositive, uint32_t uMaterial, uint32_t uOcclusions)
 	{
-		//All four vertices of a given quad have the same material,
-		//so just check that the first pair of vertices match.
-		if(std::abs(m_meshCurrent->getVertices()[q1.vertices[0]].getMaterial() - m_meshCurrent->getVertices()[q2.vertices[0]].getMaterial()) < 0.001)
+		const uint32_t uAxisU = (uAxis == 0) ? 1 : 0;
+		const uint32_t uAxisV = (uAxis == 2) ? 1 : 2;
+
+		//Walk round the corners of the rectangle.
+		uint32_t uCorner[3];
+		uCorner[uAxis] = uPlane;
+		uCorner[uAxisU] = uStartU;
+		uCorner[uAxisV] = uStartV;
+		const uint32_t v0 = addVertex(pMesh, uCorner[0], uCorner[1], uCorner[2], uMaterial, uOcclusions & 3);
+		uCorner[uAxisV] = uEndV;
+		const uint32_t v1 = addVertex(pMesh, uCorner[0], uCorner[1], uCorner[2], uMaterial, (uOcclusions >> 4) & 3);
+		uCorner[uAxisU] = uEndU;
+		const uint32_t v2 = addVertex(pMesh, uCorner[0], uCorner[1], uCorner[2], uMaterial, (uOcclusions >> 6) & 3);
+		uCorner[uAxisV] = uStartV;
+		const uint32_t v3 = addVertex(pMesh, uCorner[0], uCorner[1], uCorner[2], uMaterial, (uOcclusions >> 2) & 3);
+
+		//The winding matches that of the unmerged quads, where the y faces wind the opposite way to the x and z faces.
+		std::vector<uint32_t>& vecIndices = m_pContext->m_vecFacingIndices[(bPositive ? FacingPositiveX : FacingNegativeX) + uAxis];
+		if((uAxis == 1) == bPositive)
 		{
-			//Now check whether quad 2 is adjacent to quad one by comparing vertices.
-			//Adjacent quads must share two vertices, and the second quad could be to the
-			//top, bottom, left, of right of the first one. This gives four combinations to test.
-			if((q1.vertices[0] == q2.vertices[1]) && ((q1.vertices[3] == q2.vertices[2])))
-			{
-				q1.vertices[0] = q2.vertices[0];
-				q1.vertices[3] = q2.vertices[3];
-				return true;
-			}
-			else if((q1.vertices[3] == q2.vertices[0]) && ((q1.vertices[2] == q2.vertices[1])))
+			addQuad(vecIndices, v0, v1, v2, v3);
+		}
+		else
+		{
+			addQuad(vecIndices, v0, v3, v2, v1);
+		}
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void CubicSurfaceExtractor<VolumeType, VoxelType>::addQuad(std::vector<uint32_t>& vecIndices, uint32_t v0, uint32_t v1, uint32_t v2, uint32_t v3)
+	{
+		//Splitting along the diagonal between the brighter pair of corners keeps the darkness of a single occluded
+		//corner from reaching the middle of the quad. Without occlusion the corners are equal and nothing changes.
+		const std::vector<uint8_t>& vecOcclusions = m_pContext->m_vecVertexOcclusions;
+		const uint32_t uIndices[6] = {v0, v1, v2, v0, v2, v3};
+		const uint32_t uFlippedIndices[6] = {v1, v2, v3, v1, v3, v0};
+		const uint32_t* pIndices = uIndices;
+		if(vecOcclusions[v0] + vecOcclusions[v2] < vecOcclusions[v1] + vecOcclusions[v3])
+		{
+			pIndices = uFlippedIndices;
+		}
+		vecIndices.insert(vecIndices.end(), pIndices, pIndices + 6);
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	template <typename VertexType>
+	int32_t CubicSurfaceExtractor<VolumeType, VoxelType>::addVertex(SurfaceMesh<VertexType>* pMesh, uint32_t uX, uint32_t uY, uint32_t uZ, uint32_t uMaterial, uint32_t uOcclusion)
+	{
+		Context& context = *m_pContext;
+
+		//Without merging, only the two most recent slices are kept.
+		const uint32_t uSlice = m_bMergeQuads ? uZ : (uZ & 1);
+		const uint32_t uCornersWidth = m_regSizeInVoxels.getUpperCorner().getX() - m_regSizeInVoxels.getLowerCorner().getX() + 2;
+		VertexTableEntry& entry = context.m_vecVertexTable[uSlice * context.m_uVertexSliceSize + uY * uCornersWidth + uX];
+		if(entry.uGeneration != context.m_vecSliceGenerations[uSlice])
+		{
+			entry.uGeneration = context.m_vecSliceGenerations[uSlice];
+			entry.iFirstVertex = -1;
+		}
+
+		//Vertices at the same position but with different materials or occlusions are not duplicates.
+		for(int32_t iVertex = entry.iFirstVertex; iVertex != -1; iVertex = context.m_vecNextVertex[iVertex])
+		{
+			if((context.m_vecVertexMaterials[iVertex] == uMaterial) && (context.m_vecVertexOcclusions[iVertex] == uOcclusion))
 			{
-				q1.vertices[3] = q2.vertices[3];
-				q1.vertices[2] = q2.vertices[2];
-				return true;
+				return iVertex;
 			}
-			else if((q1.vertices[1] == q2.vertices[0]) && ((q1.vertices[2] == q2.vertices[3])))
+		}
+
+		VertexType vertex(Vector3DFloat(uX - 0.5f, uY - 0.5f, uZ - 0.5f), static_cast<float>(uMaterial));
+		setVertexOcclusion(vertex, uOcclusion);
+		const int32_t iVertex = pMesh->addVertex(vertex);
+		assert(iVertex == static_cast<int32_t>(context.m_vecVertexMaterials.size()));
+		context.m_vecNextVertex.push_back(entry.iFirstVertex);
+		context.m_vecVertexMaterials.push_back(uMaterial);
+		context.m_vecVertexOcclusions.push_back(static_cast<uint8_t>(uOcclusion));
+		entry.iFirstVertex = iVertex;
+
+		return iVertex;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	uint32_t CubicSurfaceExtractor<VolumeType, VoxelType>::getFaceOcclusions(int32_t iX, int32_t iY, int32_t iZ, uint32_t uAxis) const
+	{
+		const uint32_t uAxisU = (uAxis == 0) ? 1 : 0;
+		const uint32_t uAxisV = (uAxis == 2) ? 1 : 2;
+
+		bool abSolid[3][3];
+		for(uint32_t uOffsetV = 0; uOffsetV < 3; uOffsetV++)
+		{
+			for(uint32_t uOffsetU = 0; uOffsetU < 3; uOffsetU++)
 			{
-				q1.vertices[1] = q2.vertices[1];
-				q1.vertices[2] = q2.vertices[2];
-				return true;
+				int32_t iPosition[3] = {iX, iY, iZ};
+				iPosition[uAxisU] += static_cast<int32_t>(uOffsetU) - 1;
+				iPosition[uAxisV] += static_cast<int32_t>(uOffsetV) - 1;
+				abSolid[uOffsetU][uOffsetV] = m_volData->getVoxelAt(iPosition[0], iPosition[1], iPosition[2]).getDensity() >= VoxelType::getThreshold();
 			}
-			else if((q1.vertices[0] == q2.vertices[3]) && ((q1.vertices[1] == q2.vertices[2])))
+		}
+
+		return packFaceOcclusions(abSolid);
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	uint32_t CubicSurfaceExtractor<VolumeType, VoxelType>::packFaceOcclusions(const bool (&abSolid)[3][3])
+	{
+		//Each corner is touched by two voxels which share an edge with the one in front of the face, and one which
+		//only shares the corner. If both of the first two are solid then the corner is fully occluded whatever the
+		//third is. The corner at the upper u and lower v is stored in bits 2 and 3, and so on.
+		uint32_t uOcclusions = 0;
+		for(uint32_t uCornerV = 0; uCornerV < 2; uCornerV++)
+		{
+			for(uint32_t uCornerU = 0; uCornerU < 2; uCornerU++)
 			{
-				q1.vertices[0] = q2.vertices[0];
-				q1.vertices[1] = q2.vertices[1];
-				return true;
+				const bool bSideU = abSolid[uCornerU * 2][1];
+				const bool bSideV = abSolid[1][uCornerV * 2];
+				const bool bCorner = abSolid[uCornerU * 2][uCornerV * 2];
+
+				uint32_t uOcclusion = 0;
+				if(!(bSideU && bSideV))
+				{
+					uOcclusion = 3 - bSideU - bSideV - bCorner;
+				}
+				uOcclusions |= uOcclusion << ((uCornerV * 2 + uCornerU) * 2);
 			}
 		}
-		
-		//Quads cannot be merged.
-		return false;
+		return uOcclusions;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void CubicSurfaceExtractor<VolumeType, VoxelType>::setVertexOcclusion(PositionMaterial& /*vertex*/, uint32_t /*uOcclusion*/)
+	{
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void CubicSurfaceExtractor<VolumeType, VoxelType>::setVertexOcclusion(PositionMaterialAO& vertex, uint32_t uOcclusion)
+	{
+		vertex.setAmbientOcclusion(static_cast<uint8_t>(uOcclusion));
 	}
-}
\ No newline at end of file
+}
@@ -35,11 +35,25 @@ namespace PolyVox
 	class CubicSurfaceExtractorWithNormals
 	{
 	public:
+		/// This extractor writes straight into the mesh and needs no working buffers,
+		/// so its Context is empty. It is provided so that code such as extractRegions()
+		/// can treat all the extractors in the same way.
+		class Context
+		{
+		};
+
 		CubicSurfaceExtractorWithNormals(VolumeType<VoxelType>* volData, Region region, SurfaceMesh<PositionMaterialNormal>* result);
 
+		/// Does nothing, as there are no buffers to share. See the Context class.
+		void setContext(Context* /*pContext*/) {}
+
 		void execute();
 
 	private:
+		//Whether the volume reports that all the voxels read by the extraction are on the same side of
+		//the threshold. Such regions (entirely air or entirely rock) can't contain any faces.
+		bool isRegionUniform(void) const;
+
 		//The volume data and a sampler to access it.
 		VolumeType<VoxelType>* m_volData;
 		typename VolumeType<VoxelType>::Sampler m_sampVolume;
@@ -37,6 +37,18 @@ namespace PolyVox
 	{		
 		m_meshCurrent->clear();
 
+		if(isRegionUniform())
+		{
+			m_meshCurrent->m_Region = m_regSizeInVoxels;
+
+			m_meshCurrent->m_vecLodRecords.clear();
+			LodRecord lodRecord;
+			lodRecord.beginIndex = 0;
+			lodRecord.endIndex = 0;
+			m_meshCurrent->m_vecLodRecords.push_back(lodRecord);
+			return;
+		}
+
 		for(int32_t z = m_regSizeInVoxels.getLowerCorner().getZ(); z < m_regSizeInVoxels.getUpperCorner().getZ(); z++)
 		{
 			for(int32_t y = m_regSizeInVoxels.getLowerCorner().getY(); y < m_regSizeInVoxels.getUpperCorner().getY(); y++)
@@ -139,4 +151,18 @@ namespace PolyVox
 		lodRecord.endIndex = m_meshCurrent->getNoOfIndices();
 		m_meshCurrent->m_vecLodRecords.push_back(lodRecord);
 	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	bool CubicSurfaceExtractorWithNormals<VolumeType, VoxelType>::isRegionUniform(void) const
+	{
+		//Each voxel is only compared with its neighbours in the positive directions, none of which are beyond the upper corner.
+		typename VolumeType<VoxelType>::DensityType tMin;
+		typename VolumeType<VoxelType>::DensityType tMax;
+		if(m_volData->getDensityRange(m_regSizeInVoxels, tMin, tMax))
+		{
+			return (tMin >= VoxelType::getThreshold()) || (tMax < VoxelType::getThreshold());
+		}
+
+		return false;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#ifndef __PolyVox_DensityPyramid_H__
+#define __PolyVox_DensityPyramid_H__
+
+#include "PolyVoxImpl/DensityRange.h"
+#include "PolyVoxImpl/Utility.h"
+
+#include "PolyVoxCore/Region.h"
+#include "PolyVoxCore/SpanIterator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept> //For invalid_argument
+#include <vector>
+
+namespace PolyVox
+{
+	/// The DensityPyramid keeps track of where the empty parts of a volume are.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// The volume is divided into small cubic bricks, and the smallest and largest density of each brick is stored. These bricks
+	/// form the first level of the pyramid. Each further level stores the ranges of nodes which are twice as large in each direction,
+	/// until the last level contains a single node covering the whole volume. Algorithms which are only interested in voxels above
+	/// (or below) some density can then pass over large parts of the volume with a single test. The HierarchicalRaycast uses it
+	/// in this way to leap over empty space.
+	///
+	/// The pyramid does not watch the volume for changes. After voxels have been modified, regionChanged() should be called with
+	/// a region containing them. Only the bricks in that region and the nodes above them are recalculated, so this is cheap for
+	/// the kind of small edits made while a game is running. Where the volume itself keeps track of density ranges (see
+	/// BaseVolume::getDensityRange()) bricks which lie in a uniform block are not scanned at all.
+	///
+	/// Parts of a node which lie outside the volume hold the border value, and so do the positions beyond the top of the pyramid.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	class DensityPyramid
+	{
+	public:
+		typedef typename VoxelDensity<VoxelType>::DensityType DensityType;
+
+		/// Constructor
+		DensityPyramid(const VolumeType<VoxelType>* pVolume, uint16_t uBrickSideLength = 8);
+
+		/// Gets the side length of the bricks forming the first level of the pyramid
+		uint16_t getBrickSideLength(void) const;
+		/// Gets the number of levels in the pyramid
+		uint32_t getNoOfLevels(void) const;
+
+		/// Finds the largest node containing a voxel in which no density is above the given value
+		bool getLargestNodeAt(int32_t iXPos, int32_t iYPos, int32_t iZPos, DensityType tMaxDensity, Region& regNode) const;
+
+		/// Recalculates the part of the pyramid covering voxels which have been modified
+		void regionChanged(const Region& regChanged);
+
+		/// Calculates approximatly how many bytes of memory the pyramid is using.
+		uint32_t calculateSizeInBytes(void) const;
+
+	private:
+		struct Node
+		{
+			DensityType tMin;
+			DensityType tMax;
+		};
+
+		void calculateBrick(int32_t iBrickX, int32_t iBrickY, int32_t iBrickZ);
+		void calculateNode(uint32_t uLevel, int32_t iNodeX, int32_t iNodeY, int32_t iNodeZ);
+		Region getNodeRegion(uint32_t uLevel, int32_t iNodeX, int32_t iNodeY, int32_t iNodeZ) const;
+		uint32_t getNodeIndex(uint32_t uLevel, int32_t iNodeX, int32_t iNodeY, int32_t iNodeZ) const;
+
+		const VolumeType<VoxelType>* m_pVolume;
+		Region m_regValidRegion;
+
+		uint16_t m_uBrickSideLength;
+		uint8_t m_uBrickSideLengthPower;
+
+		DensityType m_tBorderDensity;
+
+		//The nodes of each level, and the size of each level in nodes.
+		std::vector< std::vector<Node> > m_vecLevels;
+		std::vector<Vector3DInt32> m_vecLevelSizes;
+	};
+}
+
+#include "PolyVoxCore/DensityPyramid.inl"
+
+#endif //__PolyVox_DensityPyramid_H__
@@ -0,0 +1,328 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+namespace PolyVox
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/// Builds the pyramid for the whole volume. The volume must outlive the pyramid.
+	/// \param pVolume The volume to build the pyramid for
+	/// \param uBrickSideLength The side length of the bricks forming the first level
+	/// of the pyramid. This must be a power of two. Smaller bricks find empty space more
+	/// tightly around the surface, at the cost of more memory and more levels to search.
+	////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	DensityPyramid<VolumeType, VoxelType>::DensityPyramid(const VolumeType<VoxelType>* pVolume, uint16_t uBrickSideLength)
+		:m_pVolume(pVolume)
+		,m_regValidRegion(pVolume->getEnclosingRegion())
+		,m_uBrickSideLength(uBrickSideLength)
+	{
+		//Debug mode validation
+		assert(uBrickSideLength > 0);
+		assert(isPowerOf2(uBrickSideLength));
+
+		//Release mode validation
+		if(uBrickSideLength == 0)
+		{
+			throw std::invalid_argument("Brick side length cannot be zero.");
+		}
+		if(!isPowerOf2(uBrickSideLength))
+		{
+			throw std::invalid_argument("Brick side length must be a power of two.");
+		}
+
+		m_uBrickSideLengthPower = logBase2(m_uBrickSideLength);
+
+		//Each level has half as many nodes as the one below it in each direction (rounding up),
+		//and the last level is the first one with a single node.
+		Vector3DInt32 v3dLevelSize
+		(
+			((m_regValidRegion.getUpperCorner().getX() - m_regValidRegion.getLowerCorner().getX()) >> m_uBrickSideLengthPower) + 1,
+			((m_regValidRegion.getUpperCorner().getY() - m_regValidRegion.getLowerCorner().getY()) >> m_uBrickSideLengthPower) + 1,
+			((m_regValidRegion.getUpperCorner().getZ() - m_regValidRegion.getLowerCorner().getZ()) >> m_uBrickSideLengthPower) + 1
+		);
+		for(;;)
+		{
+			m_vecLevelSizes.push_back(v3dLevelSize);
+			m_vecLevels.push_back(std::vector<Node>(v3dLevelSize.getX() * v3dLevelSize.getY() * v3dLevelSize.getZ()));
+
+			if((v3dLevelSize.getX() == 1) && (v3dLevelSize.getY() == 1) && (v3dLevelSize.getZ() == 1))
+			{
+				break;
+			}
+
+			v3dLevelSize = Vector3DInt32((v3dLevelSize.getX() + 1) / 2, (v3dLevelSize.getY() + 1) / 2, (v3dLevelSize.getZ() + 1) / 2);
+		}
+
+		m_tBorderDensity = VoxelDensity<VoxelType>::get(m_pVolume->getBorderValue());
+		regionChanged(m_regValidRegion);
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	uint16_t DensityPyramid<VolumeType, VoxelType>::getBrickSideLength(void) const
+	{
+		return m_uBrickSideLength;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	uint32_t DensityPyramid<VolumeType, VoxelType>::getNoOfLevels(void) const
+	{
+		return m_vecLevels.size();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The nodes containing the voxel are tested from the top of the pyramid down, so
+	/// the node which is found is the largest one which can be skipped over by an
+	/// algorithm which is only looking for densities above \a tMaxDensity.
+	/// \param iXPos The \c x position of the voxel
+	/// \param iYPos The \c y position of the voxel
+	/// \param iZPos The \c z position of the voxel
+	/// \param tMaxDensity The largest density which the node may contain
+	/// \param regNode Set to the node which was found. If there is no such node then
+	/// this is set to the smallest node containing the voxel instead.
+	/// \return Whether a node was found
+	////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	bool DensityPyramid<VolumeType, VoxelType>::getLargestNodeAt(int32_t iXPos, int32_t iYPos, int32_t iZPos, DensityType tMaxDensity, Region& regNode) const
+	{
+		const uint32_t uTopLevel = m_vecLevels.size() - 1;
+		const uint8_t uTopLevelPower = m_uBrickSideLengthPower + uTopLevel;
+
+		const int32_t iXOffset = iXPos - m_regValidRegion.getLowerCorner().getX();
+		const int32_t iYOffset = iYPos - m_regValidRegion.getLowerCorner().getY();
+		const int32_t iZOffset = iZPos - m_regValidRegion.getLowerCorner().getZ();
+
+		//Beyond the top of the pyramid the volume is treated as a grid of nodes the
+		//same size as the top one, all of which are outside the volume.
+		const int32_t iTopX = iXOffset >> uTopLevelPower;
+		const int32_t iTopY = iYOffset >> uTopLevelPower;
+		const int32_t iTopZ = iZOffset >> uTopLevelPower;
+		if((iTopX != 0) || (iTopY != 0) || (iTopZ != 0))
+		{
+			regNode = getNodeRegion(uTopLevel, iTopX, iTopY, iTopZ);
+			return m_tBorderDensity <= tMaxDensity;
+		}
+
+		for(int32_t iLevel = uTopLevel; iLevel >= 0; iLevel--)
+		{
+			const uint8_t uLevelPower = m_uBrickSideLengthPower + iLevel;
+			const int32_t iNodeX = iXOffset >> uLevelPower;
+			const int32_t iNodeY = iYOffset >> uLevelPower;
+			const int32_t iNodeZ = iZOffset >> uLevelPower;
+
+			//Nodes beyond the end of a level are entirely outside the volume.
+			const Vector3DInt32& v3dLevelSize = m_vecLevelSizes[iLevel];
+			if((iNodeX >= v3dLevelSize.getX()) || (iNodeY >= v3dLevelSize.getY()) || (iNodeZ >= v3dLevelSize.getZ()))
+			{
+				regNode = getNodeRegion(iLevel, iNodeX, iNodeY, iNodeZ);
+				return m_tBorderDensity <= tMaxDensity;
+			}
+
+			const bool bBelowMaxDensity = m_vecLevels[iLevel][getNodeIndex(iLevel, iNodeX, iNodeY, iNodeZ)].tMax <= tMaxDensity;
+			if(bBelowMaxDensity || (iLevel == 0))
+			{
+				regNode = getNodeRegion(iLevel, iNodeX, iNodeY, iNodeZ);
+				return bBelowMaxDensity;
+			}
+		}
+
+		//Never gets here, as the loop always returns on the first level.
+		assert(false);
+		return false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// This should be called whenever voxels have been modified (or the border value
+	/// has been changed). The region may extend outside the volume.
+	/// \param regChanged A region containing all the voxels which have been modified
+	////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	void DensityPyramid<VolumeType, VoxelType>::regionChanged(const Region& regChanged)
+	{
+		Region regToUpdate(regChanged);
+		regToUpdate.cropTo(m_regValidRegion);
+
+		//A new border value affects every node which reaches outside the volume.
+		const DensityType tBorderDensity = VoxelDensity<VoxelType>::get(m_pVolume->getBorderValue());
+		if(tBorderDensity != m_tBorderDensity)
+		{
+			m_tBorderDensity = tBorderDensity;
+			regToUpdate = m_regValidRegion;
+		}
+
+		if((regToUpdate.getLowerCorner().getX() > regToUpdate.getUpperCorner().getX()) ||
+			(regToUpdate.getLowerCorner().getY() > regToUpdate.getUpperCorner().getY()) ||
+			(regToUpdate.getLowerCorner().getZ() > regToUpdate.getUpperCorner().getZ()))
+		{
+			//The region is entirely outside the volume.
+			return;
+		}
+
+		Vector3DInt32 v3dLowerNode = (regToUpdate.getLowerCorner() - m_regValidRegion.getLowerCorner());
+		Vector3DInt32 v3dUpperNode = (regToUpdate.getUpperCorner() - m_regValidRegion.getLowerCorner());
+		v3dLowerNode = Vector3DInt32(v3dLowerNode.getX() >> m_uBrickSideLengthPower, v3dLowerNode.getY() >> m_uBrickSideLengthPower, v3dLowerNode.getZ() >> m_uBrickSideLengthPower);
+		v3dUpperNode = Vector3DInt32(v3dUpperNode.getX() >> m_uBrickSideLengthPower, v3dUpperNode.getY() >> m_uBrickSideLengthPower, v3dUpperNode.getZ() >> m_uBrickSideLengthPower);
+
+		for(int32_t iBrickZ = v3dLowerNode.getZ(); iBrickZ <= v3dUpperNode.getZ(); iBrickZ++)
+		{
+			for(int32_t iBrickY = v3dLowerNode.getY(); iBrickY <= v3dUpperNode.getY(); iBrickY++)
+			{
+				for(int32_t iBrickX = v3dLowerNode.getX(); iBrickX <= v3dUpperNode.getX(); iBrickX++)
+				{
+					calculateBrick(iBrickX, iBrickY, iBrickZ);
+				}
+			}
+		}
+
+		//Now work up through the levels, recalculating the parents of the nodes which changed.
+		for(uint32_t uLevel = 1; uLevel < m_vecLevels.size(); uLevel++)
+		{
+			v3dLowerNode = Vector3DInt32(v3dLowerNode.getX() >> 1, v3dLowerNode.getY() >> 1, v3dLowerNode.getZ() >> 1);
+			v3dUpperNode = Vector3DInt32(v3dUpperNode.getX() >> 1, v3dUpperNode.getY() >> 1, v3dUpperNode.getZ() >> 1);
+
+			for(int32_t iNodeZ = v3dLowerNode.getZ(); iNodeZ <= v3dUpperNode.getZ(); iNodeZ++)
+			{
+				for(int32_t iNodeY = v3dLowerNode.getY(); iNodeY <= v3dUpperNode.getY(); iNodeY++)
+				{
+					for(int32_t iNodeX = v3dLowerNode.getX(); iNodeX <= v3dUpperNode.getX(); iNodeX++)
+					{
+						calculateNode(uLevel, iNodeX, iNodeY, iNodeZ);
+					}
+				}
+			}
+		}
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	uint32_t DensityPyramid<VolumeType, VoxelType>::calculateSizeInBytes(void) const
+	{
+		uint32_t uSizeInBytes = sizeof(DensityPyramid);
+		for(uint32_t uLevel = 0; uLevel < m_vecLevels.size(); uLevel++)
+		{
+			uSizeInBytes += m_vecLevels[uLevel].capacity() * sizeof(Node);
+		}
+		uSizeInBytes += m_vecLevelSizes.capacity() * sizeof(Vector3DInt32);
+		return uSizeInBytes;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void DensityPyramid<VolumeType, VoxelType>::calculateBrick(int32_t iBrickX, int32_t iBrickY, int32_t iBrickZ)
+	{
+		Node& node = m_vecLevels[0][getNodeIndex(0, iBrickX, iBrickY, iBrickZ)];
+
+		const Region regBrick = getNodeRegion(0, iBrickX, iBrickY, iBrickZ);
+		Region regInside(regBrick);
+		regInside.cropTo(m_regValidRegion);
+
+		//If the volume already knows that the brick is uniform then there is no need to look at the voxels.
+		if((!m_pVolume->getDensityRange(regInside, node.tMin, node.tMax)) || (node.tMin != node.tMax))
+		{
+			ConstSpanIterator<VolumeType, VoxelType> iter(m_pVolume, regInside);
+			node.tMin = VoxelDensity<VoxelType>::get(*(iter.getSpan()));
+			node.tMax = node.tMin;
+			for(; iter.isValid(); iter.moveForward())
+			{
+				const VoxelType* pVoxels = iter.getSpan();
+				for(int32_t i = 0; i < iter.getLength(); i++)
+				{
+					const DensityType tDensity = VoxelDensity<VoxelType>::get(pVoxels[i]);
+					node.tMin = (std::min)(node.tMin, tDensity);
+					node.tMax = (std::max)(node.tMax, tDensity);
+				}
+			}
+		}
+
+		if(regInside != regBrick)
+		{
+			node.tMin = (std::min)(node.tMin, m_tBorderDensity);
+			node.tMax = (std::max)(node.tMax, m_tBorderDensity);
+		}
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void DensityPyramid<VolumeType, VoxelType>::calculateNode(uint32_t uLevel, int32_t iNodeX, int32_t iNodeY, int32_t iNodeZ)
+	{
+		assert(uLevel > 0);
+
+		Node& node = m_vecLevels[uLevel][getNodeIndex(uLevel, iNodeX, iNodeY, iNodeZ)];
+		const Vector3DInt32& v3dChildLevelSize = m_vecLevelSizes[uLevel - 1];
+
+		//Children which would lie beyond the end of the level below are entirely outside the
+		//volume. The children which do exist already include the border where they need to.
+		bool bFoundRange = false;
+		bool bHasMissingChildren = false;
+		for(int32_t iChildZ = iNodeZ * 2; iChildZ <= iNodeZ * 2 + 1; iChildZ++)
+		{
+			for(int32_t iChildY = iNodeY * 2; iChildY <= iNodeY * 2 + 1; iChildY++)
+			{
+				for(int32_t iChildX = iNodeX * 2; iChildX <= iNodeX * 2 + 1; iChildX++)
+				{
+					if((iChildX >= v3dChildLevelSize.getX()) || (iChildY >= v3dChildLevelSize.getY()) || (iChildZ >= v3dChildLevelSize.getZ()))
+					{
+						bHasMissingChildren = true;
+						continue;
+					}
+
+					const Node& child = m_vecLevels[uLevel - 1][getNodeIndex(uLevel - 1, iChildX, iChildY, iChildZ)];
+					if(bFoundRange)
+					{
+						node.tMin = (std::min)(node.tMin, child.tMin);
+						node.tMax = (std::max)(node.tMax, child.tMax);
+					}
+					else
+					{
+						node.tMin = child.tMin;
+						node.tMax = child.tMax;
+						bFoundRange = true;
+					}
+				}
+			}
+		}
+
+		//There is always at least the first child.
+		assert(bFoundRange);
+
+		if(bHasMissingChildren)
+		{
+			node.tMin = (std::min)(node.tMin, m_tBorderDensity);
+			node.tMax = (std::max)(node.tMax, m_tBorderDensity);
+		}
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	Region DensityPyramid<VolumeType, VoxelType>::getNodeRegion(uint32_t uLevel, int32_t iNodeX, int32_t iNodeY, int32_t iNodeZ) const
+	{
+		const int32_t iNodeSideLength = 1 << (m_uBrickSideLengthPower + uLevel);
+		const Vector3DInt32 v3dLowerCorner = m_regValidRegion.getLowerCorner() + Vector3DInt32(iNodeX * iNodeSideLength, iNodeY * iNodeSideLength, iNodeZ * iNodeSideLength);
+		return Region(v3dLowerCorner, v3dLowerCorner + Vector3DInt32(iNodeSideLength - 1, iNodeSideLength - 1, iNodeSideLength - 1));
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	uint32_t DensityPyramid<VolumeType, VoxelType>::getNodeIndex(uint32_t uLevel, int32_t iNodeX, int32_t iNodeY, int32_t iNodeZ) const
+	{
+		const Vector3DInt32& v3dLevelSize = m_vecLevelSizes[uLevel];
+		assert((iNodeX >= 0) && (iNodeX < v3dLevelSize.getX()));
+		assert((iNodeY >= 0) && (iNodeY < v3dLevelSize.getY()));
+		assert((iNodeZ >= 0) && (iNodeZ < v3dLevelSize.getZ()));
+		return iNodeX + iNodeY * v3dLevelSize.getX() + iNodeZ * v3dLevelSize.getX() * v3dLevelSize.getY();
+	}
+}
@@ -0,0 +1,234 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#ifndef __PolyVox_FixedBlockVolume_H__
+#define __PolyVox_FixedBlockVolume_H__
+
+#include "PolyVoxImpl/Utility.h"
+#include "PolyVoxCore/BaseVolume.h"
+#include "PolyVoxCore/Log.h"
+#include "PolyVoxCore/Region.h"
+#include "PolyVoxCore/Vector.h"
+
+#include <cassert>
+#include <cstdlib> //For abort()
+#include <cstring> //For memcpy
+#include <limits>
+#include <memory>
+#include <stdexcept> //For invalid_argument
+
+namespace PolyVox
+{
+	///The FixedBlockVolume class is a SimpleVolume whose block size is fixed at compile time.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// The SimpleVolume stores its block side length as a member variable, so every voxel access (and every peek performed by
+	/// a Sampler) has to perform shifts and multiplies by values which are not known until runtime. The FixedBlockVolume takes the
+	/// base two logarithm of the block side length as a template parameter instead, which allows the compiler to turn all of these
+	/// into constants. In all other respects it behaves just like the SimpleVolume, including allocating blocks when they are first
+	/// written to.
+	///
+	/// The surface extractors and other algorithms expect a volume template taking a single parameter, so the block size needs to be
+	/// bound before the volume can be passed to them. The FixedBlockVolume16 and FixedBlockVolume32 classes are provided for this:
+	///
+	/// \code
+	/// FixedBlockVolume32<Material8> volume(Region(Vector3DInt32(0,0,0), Vector3DInt32(255,255,255)));
+	/// CubicSurfaceExtractor<FixedBlockVolume32, Material8> extractor(&volume, volume.getEnclosingRegion(), &mesh);
+	/// \endcode
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	class FixedBlockVolume : public BaseVolume<VoxelType>
+	{
+	public:
+		/// The side length of each block, in voxels
+		static const uint16_t BlockSideLength = 1 << BlockSideLengthPower;
+		/// The number of voxels in each block
+		static const uint32_t NoOfVoxelsPerBlock = BlockSideLength * BlockSideLength * BlockSideLength;
+
+		#ifndef SWIG
+		//See the comments in SimpleVolume.h regarding the Visual Studio and GCC differences here.
+#if defined(_MSC_VER)
+		class Sampler : public BaseVolume<VoxelType>::Sampler< FixedBlockVolume<VoxelType, BlockSideLengthPower> > //This line works on VS2010
+#else
+                class Sampler : public BaseVolume<VoxelType>::template Sampler< FixedBlockVolume<VoxelType, BlockSideLengthPower> > //This line works on GCC
+#endif
+		{
+		public:
+			Sampler(FixedBlockVolume<VoxelType, BlockSideLengthPower>* volume);
+			~Sampler();
+
+			Sampler& operator=(const Sampler& rhs) throw();
+
+			int32_t getPosX(void) const;
+			int32_t getPosY(void) const;
+			int32_t getPosZ(void) const;
+			VoxelType getSubSampledVoxel(uint8_t uLevel) const;
+			inline VoxelType getVoxel(void) const;			
+
+			void setPosition(const Vector3DInt32& v3dNewPos);
+			void setPosition(int32_t xPos, int32_t yPos, int32_t zPos);
+			inline bool setVoxel(VoxelType tValue);
+
+			void movePositiveX(void);
+			void movePositiveY(void);
+			void movePositiveZ(void);
+
+			void moveNegativeX(void);
+			void moveNegativeY(void);
+			void moveNegativeZ(void);
+
+			inline VoxelType peekVoxel1nx1ny1nz(void) const;
+			inline VoxelType peekVoxel1nx1ny0pz(void) const;
+			inline VoxelType peekVoxel1nx1ny1pz(void) const;
+
+			inline VoxelType peekVoxel1nx0py1nz(void) const;
+			inline VoxelType peekVoxel1nx0py0pz(void) const;
+			inline VoxelType peekVoxel1nx0py1pz(void) const;
+
+			inline VoxelType peekVoxel1nx1py1nz(void) const;
+			inline VoxelType peekVoxel1nx1py0pz(void) const;
+			inline VoxelType peekVoxel1nx1py1pz(void) const;
+
+			inline VoxelType peekVoxel0px1ny1nz(void) const;
+			inline VoxelType peekVoxel0px1ny0pz(void) const;
+			inline VoxelType peekVoxel0px1ny1pz(void) const;
+
+			inline VoxelType peekVoxel0px0py1nz(void) const;
+			inline VoxelType peekVoxel0px0py0pz(void) const;
+			inline VoxelType peekVoxel0px0py1pz(void) const;
+
+			inline VoxelType peekVoxel0px1py1nz(void) const;
+			inline VoxelType peekVoxel0px1py0pz(void) const;
+			inline VoxelType peekVoxel0px1py1pz(void) const;
+
+			inline VoxelType peekVoxel1px1ny1nz(void) const;
+			inline VoxelType peekVoxel1px1ny0pz(void) const;
+			inline VoxelType peekVoxel1px1ny1pz(void) const;
+
+			inline VoxelType peekVoxel1px0py1nz(void) const;
+			inline VoxelType peekVoxel1px0py0pz(void) const;
+			inline VoxelType peekVoxel1px0py1pz(void) const;
+
+			inline VoxelType peekVoxel1px1py1nz(void) const;
+			inline VoxelType peekVoxel1px1py0pz(void) const;
+			inline VoxelType peekVoxel1px1py1pz(void) const;
+
+			/// Reads the 3x3x3 neighbourhood of the current position, indexed by <tt>(x+1) + (y+1)*3 + (z+1)*9</tt>.
+			inline void peekNeighbourhood(VoxelType pStencil[27]) const;
+			/// Reads the 2x2x2 cell whose lower corner is the current position, indexed by <tt>x + y*2 + z*4</tt>.
+			inline void peekCell(VoxelType pCell[8]) const;
+
+		private:			
+			//Other current position information
+			VoxelType* mCurrentVoxel;
+		};
+		#endif
+
+	public:
+		/// Constructor for creating a fixed size volume.
+		FixedBlockVolume(const Region& regValid);
+		/// Destructor
+		~FixedBlockVolume();
+
+		/// Gets the value used for voxels which are outside the volume
+		VoxelType getBorderValue(void) const;
+		/// Gets a voxel at the position given by <tt>x,y,z</tt> coordinates
+		VoxelType getVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos) const;
+		/// Gets a voxel at the position given by a 3D vector
+		VoxelType getVoxelAt(const Vector3DInt32& v3dPos) const;
+
+		/// Sets the value used for voxels which are outside the volume
+		void setBorderValue(const VoxelType& tBorder);
+		/// Sets the voxel at the position given by <tt>x,y,z</tt> coordinates
+		bool setVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue);
+		/// Sets the voxel at the position given by a 3D vector
+		bool setVoxelAt(const Vector3DInt32& v3dPos, VoxelType tValue);
+		/// Gets a pointer to a run of voxels along the \c x axis starting at <tt>x,y,z</tt>
+		const VoxelType* getSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength) const;
+		/// Gets a writable pointer to a run of voxels along the \c x axis starting at <tt>x,y,z</tt>
+		VoxelType* getWritableSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength);
+
+		/// Gets the smallest and largest densities which the voxels in a region might have
+		bool getDensityRange(const Region& region, typename BaseVolume<VoxelType>::DensityType& tMin, typename BaseVolume<VoxelType>::DensityType& tMax) const;
+		/// Recalculates the density ranges invalidated by writing through getWritableSpanAt()
+		void recalculateDensityRanges(void);
+
+		/// Calculates approximatly how many bytes of memory the volume is currently using.
+		uint32_t calculateSizeInBytes(void);
+
+	private:	
+		void resize(const Region& regValidRegion);
+
+		VoxelType* getUncompressedBlock(uint32_t uBlockIndex) const;
+		VoxelType* getBlockDataForReading(int32_t uBlockX, int32_t uBlockY, int32_t uBlockZ) const;
+		uint32_t getBlockIndex(int32_t uBlockX, int32_t uBlockY, int32_t uBlockZ) const;
+
+		//The block data. Each entry is null until the corresponding block is first written to.
+		VoxelType** m_pBlocks;
+
+		//The range of densities in each block, only meaningful once the block has been allocated.
+		DensityRange<VoxelType>* m_pBlockDensityRanges;
+
+		//As in the SimpleVolume, the border is a whole block of data so that the
+		//Sampler can do it's usual pointer arithmetic outside the volume.
+		VoxelType* m_pUncompressedBorderData;
+
+		//Shared by all blocks which have not yet been allocated.
+		VoxelType* m_pUncompressedDefaultData;
+
+		//The size of the volume in vlocks
+		Region m_regValidRegionInBlocks;
+
+		//Volume size measured in blocks.
+		uint32_t m_uNoOfBlocksInVolume;
+		uint16_t m_uWidthInBlocks;
+		uint16_t m_uHeightInBlocks;
+		uint16_t m_uDepthInBlocks;
+	};
+
+	//Volumes with the block size bound, for use with the surface extractors and other algorithms.
+	//These are derived classes rather than alias templates so that they work with pre-C++11 compilers.
+	template <typename VoxelType>
+	class FixedBlockVolume16 : public FixedBlockVolume<VoxelType, 4>
+	{
+	public:
+		FixedBlockVolume16(const Region& regValid)
+			:FixedBlockVolume<VoxelType, 4>(regValid)
+		{
+		}
+	};
+
+	template <typename VoxelType>
+	class FixedBlockVolume32 : public FixedBlockVolume<VoxelType, 5>
+	{
+	public:
+		FixedBlockVolume32(const Region& regValid)
+			:FixedBlockVolume<VoxelType, 5>(regValid)
+		{
+		}
+	};
+}
+
+#include "PolyVoxCore/FixedBlockVolume.inl"
+#include "PolyVoxCore/FixedBlockVolumeSampler.inl"
+
+#endif //__PolyVox_FixedBlockVolume_H__
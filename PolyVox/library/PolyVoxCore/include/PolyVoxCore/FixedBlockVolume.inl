@@ -0,0 +1,439 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+namespace PolyVox
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/// This constructor creates a volume with a fixed size which is specified as a parameter.
+	/// \param regValid Specifies the minimum and maximum valid voxel positions.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	FixedBlockVolume<VoxelType, BlockSideLengthPower>::FixedBlockVolume(const Region& regValid)
+	:BaseVolume<VoxelType>(regValid)
+	{
+		//Create a volume of the right size.
+		resize(regValid);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Destroys the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	FixedBlockVolume<VoxelType, BlockSideLengthPower>::~FixedBlockVolume()
+	{
+		for(uint32_t i = 0; i < m_uNoOfBlocksInVolume; ++i)
+		{
+			delete[] m_pBlocks[i];
+		}
+		delete[] m_pBlocks;
+		delete[] m_pBlockDensityRanges;
+		delete[] m_pUncompressedBorderData;
+		delete[] m_pUncompressedDefaultData;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The border value is returned whenever an atempt is made to read a voxel which
+	/// is outside the extents of the volume.
+	/// \return The value used for voxels outside of the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::getBorderValue(void) const
+	{
+		return *m_pUncompressedBorderData;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param uXPos The \c x position of the voxel
+	/// \param uYPos The \c y position of the voxel
+	/// \param uZPos The \c z position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::getVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos) const
+	{
+		if(this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)))
+		{
+			const int32_t blockX = uXPos >> BlockSideLengthPower;
+			const int32_t blockY = uYPos >> BlockSideLengthPower;
+			const int32_t blockZ = uZPos >> BlockSideLengthPower;
+
+			const uint16_t xOffset = uXPos - (blockX << BlockSideLengthPower);
+			const uint16_t yOffset = uYPos - (blockY << BlockSideLengthPower);
+			const uint16_t zOffset = uZPos - (blockZ << BlockSideLengthPower);
+
+			const VoxelType* pBlockData = getBlockDataForReading(blockX, blockY, blockZ);
+
+			return pBlockData
+				[
+					xOffset + 
+					yOffset * BlockSideLength + 
+					zOffset * BlockSideLength * BlockSideLength
+				];
+		}
+		else
+		{
+			return getBorderValue();
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos The 3D position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::getVoxelAt(const Vector3DInt32& v3dPos) const
+	{
+		return getVoxelAt(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param tBorder The value to use for voxels outside the volume.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::setBorderValue(const VoxelType& tBorder) 
+	{
+		std::fill(m_pUncompressedBorderData, m_pUncompressedBorderData + NoOfVoxelsPerBlock, tBorder);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param uXPos the \c x position of the voxel
+	/// \param uYPos the \c y position of the voxel
+	/// \param uZPos the \c z position of the voxel
+	/// \param tValue the value to which the voxel will be set
+	/// \return whether the requested position is inside the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	bool FixedBlockVolume<VoxelType, BlockSideLengthPower>::setVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue)
+	{
+		assert(this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)));
+
+		const int32_t blockX = uXPos >> BlockSideLengthPower;
+		const int32_t blockY = uYPos >> BlockSideLengthPower;
+		const int32_t blockZ = uZPos >> BlockSideLengthPower;
+
+		const uint16_t xOffset = uXPos - (blockX << BlockSideLengthPower);
+		const uint16_t yOffset = uYPos - (blockY << BlockSideLengthPower);
+		const uint16_t zOffset = uZPos - (blockZ << BlockSideLengthPower);
+
+		const uint32_t uBlockIndex = getBlockIndex(blockX, blockY, blockZ);
+		VoxelType* pBlockData = getUncompressedBlock(uBlockIndex);
+
+		VoxelType& tVoxel = pBlockData
+		[
+			xOffset + 
+			yOffset * BlockSideLength + 
+			zOffset * BlockSideLength * BlockSideLength
+		];
+
+		const VoxelType tOldValue = tVoxel;
+		tVoxel = tValue;
+
+		m_pBlockDensityRanges[uBlockIndex].voxelChanged(tOldValue, tValue, pBlockData, NoOfVoxelsPerBlock);
+
+		//Return true to indicate that we modified a voxel.
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos the 3D position of the voxel
+	/// \param tValue the value to which the voxel will be set
+	/// \return whether the requested position is inside the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	bool FixedBlockVolume<VoxelType, BlockSideLengthPower>::setVoxelAt(const Vector3DInt32& v3dPos, VoxelType tValue)
+	{
+		return setVoxelAt(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ(), tValue);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The returned run holds \a iLength consecutive voxels along the \c x axis, where \a iLength is never
+	/// more than \a iMaxLength. A null pointer means the voxels are outside the volume or are not stored
+	/// contiguously, and should be read through getVoxelAt() instead. \a iLength is set in either case.
+	///
+	/// The pointer is only valid until the volume is next accessed.
+	/// \param uXPos The \c x position of the first voxel in the run
+	/// \param uYPos The \c y position of the run
+	/// \param uZPos The \c z position of the run
+	/// \param iMaxLength The largest number of voxels the run may contain
+	/// \param iLength Set to the number of voxels in the run
+	/// \return A pointer to the first voxel in the run, or null
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	const VoxelType* FixedBlockVolume<VoxelType, BlockSideLengthPower>::getSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength) const
+	{
+		if(this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)))
+		{
+			const int32_t blockX = uXPos >> BlockSideLengthPower;
+			const int32_t blockY = uYPos >> BlockSideLengthPower;
+			const int32_t blockZ = uZPos >> BlockSideLengthPower;
+
+			const uint16_t xOffset = uXPos - (blockX << BlockSideLengthPower);
+			const uint16_t yOffset = uYPos - (blockY << BlockSideLengthPower);
+			const uint16_t zOffset = uZPos - (blockZ << BlockSideLengthPower);
+
+			//The run stops at the end of the block, at the edge of the volume, or when it is long enough.
+			iLength = (std::min)((std::min)(iMaxLength, static_cast<int32_t>(BlockSideLength - xOffset)), this->m_regValidRegion.getUpperCorner().getX() - uXPos + 1);
+
+			const VoxelType* pBlockData = getBlockDataForReading(blockX, blockY, blockZ);
+
+			return pBlockData + xOffset + yOffset * BlockSideLength + zOffset * BlockSideLength * BlockSideLength;
+		}
+		else
+		{
+			iLength = this->getBorderSpanLength(uXPos, uYPos, uZPos, iMaxLength);
+			return 0;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// As getSpanAt(), except that the voxels may be modified through the returned pointer. A null pointer
+	/// means the voxels should be written through setVoxelAt() instead.
+	/// \param uXPos The \c x position of the first voxel in the run
+	/// \param uYPos The \c y position of the run
+	/// \param uZPos The \c z position of the run
+	/// \param iMaxLength The largest number of voxels the run may contain
+	/// \param iLength Set to the number of voxels in the run
+	/// \return A pointer to the first voxel in the run, or null
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType* FixedBlockVolume<VoxelType, BlockSideLengthPower>::getWritableSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength)
+	{
+		if(this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)))
+		{
+			const int32_t blockX = uXPos >> BlockSideLengthPower;
+			const int32_t blockY = uYPos >> BlockSideLengthPower;
+			const int32_t blockZ = uZPos >> BlockSideLengthPower;
+
+			const uint16_t xOffset = uXPos - (blockX << BlockSideLengthPower);
+			const uint16_t yOffset = uYPos - (blockY << BlockSideLengthPower);
+			const uint16_t zOffset = uZPos - (blockZ << BlockSideLengthPower);
+
+			//The run stops at the end of the block, at the edge of the volume, or when it is long enough.
+			iLength = (std::min)((std::min)(iMaxLength, static_cast<int32_t>(BlockSideLength - xOffset)), this->m_regValidRegion.getUpperCorner().getX() - uXPos + 1);
+
+			//This allocates the block if it has not been written to before. We can't
+			//see what is written through the pointer, so the range has to be recalculated.
+			const uint32_t uBlockIndex = getBlockIndex(blockX, blockY, blockZ);
+			VoxelType* pBlockData = getUncompressedBlock(uBlockIndex);
+			m_pBlockDensityRanges[uBlockIndex].invalidate();
+
+			return pBlockData + xOffset + yOffset * BlockSideLength + zOffset * BlockSideLength * BlockSideLength;
+		}
+		else
+		{
+			iLength = this->getBorderSpanLength(uXPos, uYPos, uZPos, iMaxLength);
+			return 0;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The range is built from the ranges of the blocks which the region touches, which are kept up to date as
+	/// voxels are written. See BaseVolume::getDensityRange() for more details.
+	/// \param region The region to find the range for
+	/// \param tMin Set to the smallest density in the region
+	/// \param tMax Set to the largest density in the region
+	/// \return Whether the range is known
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	bool FixedBlockVolume<VoxelType, BlockSideLengthPower>::getDensityRange(const Region& region, typename BaseVolume<VoxelType>::DensityType& tMin, typename BaseVolume<VoxelType>::DensityType& tMax) const
+	{
+		typedef typename BaseVolume<VoxelType>::DensityType DensityType;
+
+		Region regInside(region);
+		regInside.cropTo(this->m_regValidRegion);
+
+		//Any part of the region which is outside the volume contains the border value.
+		bool bFoundRange = false;
+		if(regInside != region)
+		{
+			tMin = VoxelDensity<VoxelType>::get(getBorderValue());
+			tMax = tMin;
+			bFoundRange = true;
+		}
+
+		const Vector3DInt32& v3dLowerCorner = regInside.getLowerCorner();
+		const Vector3DInt32& v3dUpperCorner = regInside.getUpperCorner();
+		if((v3dLowerCorner.getX() > v3dUpperCorner.getX()) || (v3dLowerCorner.getY() > v3dUpperCorner.getY()) || (v3dLowerCorner.getZ() > v3dUpperCorner.getZ()))
+		{
+			//The region is entirely outside the volume.
+			return bFoundRange;
+		}
+
+		for(int32_t iBlockZ = v3dLowerCorner.getZ() >> BlockSideLengthPower; iBlockZ <= (v3dUpperCorner.getZ() >> BlockSideLengthPower); iBlockZ++)
+		{
+			for(int32_t iBlockY = v3dLowerCorner.getY() >> BlockSideLengthPower; iBlockY <= (v3dUpperCorner.getY() >> BlockSideLengthPower); iBlockY++)
+			{
+				for(int32_t iBlockX = v3dLowerCorner.getX() >> BlockSideLengthPower; iBlockX <= (v3dUpperCorner.getX() >> BlockSideLengthPower); iBlockX++)
+				{
+					const uint32_t uBlockIndex = getBlockIndex(iBlockX, iBlockY, iBlockZ);
+					const DensityRange<VoxelType>& densityRange = m_pBlockDensityRanges[uBlockIndex];
+
+					DensityType tBlockMin;
+					DensityType tBlockMax;
+					if(m_pBlocks[uBlockIndex] == 0)
+					{
+						//Blocks which have never been written to all hold the default value.
+						tBlockMin = VoxelDensity<VoxelType>::get(*m_pUncompressedDefaultData);
+						tBlockMax = tBlockMin;
+					}
+					else if(densityRange.isValid())
+					{
+						tBlockMin = densityRange.getMin();
+						tBlockMax = densityRange.getMax();
+					}
+					else
+					{
+						return false;
+					}
+
+					if(bFoundRange)
+					{
+						tMin = (std::min)(tMin, tBlockMin);
+						tMax = (std::max)(tMax, tBlockMax);
+					}
+					else
+					{
+						tMin = tBlockMin;
+						tMax = tBlockMax;
+						bFoundRange = true;
+					}
+				}
+			}
+		}
+
+		return bFoundRange;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Code which writes voxels through getWritableSpanAt() should call this once it has finished, so that
+	/// getDensityRange() can be used on the modified region again.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::recalculateDensityRanges(void)
+	{
+		for(uint32_t i = 0; i < m_uNoOfBlocksInVolume; ++i)
+		{
+			if((m_pBlocks[i] != 0) && (!m_pBlockDensityRanges[i].isValid()))
+			{
+				m_pBlockDensityRanges[i].calculate(m_pBlocks[i], NoOfVoxelsPerBlock);
+			}
+		}
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::resize(const Region& regValidRegion)
+	{
+		this->m_regValidRegion = regValidRegion;
+
+		m_regValidRegionInBlocks.setLowerCorner(this->m_regValidRegion.getLowerCorner()  / static_cast<int32_t>(BlockSideLength));
+		m_regValidRegionInBlocks.setUpperCorner(this->m_regValidRegion.getUpperCorner()  / static_cast<int32_t>(BlockSideLength));
+
+		//Compute the size of the volume in blocks (and note +1 at the end)
+		m_uWidthInBlocks = m_regValidRegionInBlocks.getUpperCorner().getX() - m_regValidRegionInBlocks.getLowerCorner().getX() + 1;
+		m_uHeightInBlocks = m_regValidRegionInBlocks.getUpperCorner().getY() - m_regValidRegionInBlocks.getLowerCorner().getY() + 1;
+		m_uDepthInBlocks = m_regValidRegionInBlocks.getUpperCorner().getZ() - m_regValidRegionInBlocks.getLowerCorner().getZ() + 1;
+		m_uNoOfBlocksInVolume = m_uWidthInBlocks * m_uHeightInBlocks * m_uDepthInBlocks;
+
+		//Create the block table. The blocks themselves are allocated when they are first written to.
+		m_pBlocks = new VoxelType*[m_uNoOfBlocksInVolume];
+		std::fill(m_pBlocks, m_pBlocks + m_uNoOfBlocksInVolume, static_cast<VoxelType*>(0));
+		m_pBlockDensityRanges = new DensityRange<VoxelType>[m_uNoOfBlocksInVolume];
+
+		//Create the block which is shared by all unallocated blocks
+		m_pUncompressedDefaultData = new VoxelType[NoOfVoxelsPerBlock];
+		std::fill(m_pUncompressedDefaultData, m_pUncompressedDefaultData + NoOfVoxelsPerBlock, VoxelType());
+
+		//Create the border block
+		m_pUncompressedBorderData = new VoxelType[NoOfVoxelsPerBlock];
+		std::fill(m_pUncompressedBorderData, m_pUncompressedBorderData + NoOfVoxelsPerBlock, VoxelType());
+
+		//Other properties we might find useful later
+		this->m_uLongestSideLength = (std::max)((std::max)(this->getWidth(),this->getHeight()),this->getDepth());
+		this->m_uShortestSideLength = (std::min)((std::min)(this->getWidth(),this->getHeight()),this->getDepth());
+		this->m_fDiagonalLength = sqrtf(static_cast<float>(this->getWidth() * this->getWidth() + this->getHeight() * this->getHeight() + this->getDepth() * this->getDepth()));
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	uint32_t FixedBlockVolume<VoxelType, BlockSideLengthPower>::getBlockIndex(int32_t uBlockX, int32_t uBlockY, int32_t uBlockZ) const
+	{
+		//The lower left corner of the volume could be
+		//anywhere, but array indices need to start at zero.
+		uBlockX -= m_regValidRegionInBlocks.getLowerCorner().getX();
+		uBlockY -= m_regValidRegionInBlocks.getLowerCorner().getY();
+		uBlockZ -= m_regValidRegionInBlocks.getLowerCorner().getZ();
+
+		return uBlockX + 
+			uBlockY * m_uWidthInBlocks + 
+			uBlockZ * m_uWidthInBlocks * m_uHeightInBlocks;
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType* FixedBlockVolume<VoxelType, BlockSideLengthPower>::getUncompressedBlock(uint32_t uBlockIndex) const
+	{
+		VoxelType*& pBlockData = m_pBlocks[uBlockIndex];
+
+		//Allocate the block the first time it is requested for writing
+		if(pBlockData == 0)
+		{
+			pBlockData = new VoxelType[NoOfVoxelsPerBlock];
+			std::fill(pBlockData, pBlockData + NoOfVoxelsPerBlock, VoxelType());
+			m_pBlockDensityRanges[uBlockIndex].fill(VoxelType(), NoOfVoxelsPerBlock);
+		}
+
+		return pBlockData;
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType* FixedBlockVolume<VoxelType, BlockSideLengthPower>::getBlockDataForReading(int32_t uBlockX, int32_t uBlockY, int32_t uBlockZ) const
+	{
+		//Blocks which have never been written to all share the default data.
+		VoxelType* pBlockData = m_pBlocks[getBlockIndex(uBlockX, uBlockY, uBlockZ)];
+		return (pBlockData != 0) ? pBlockData : m_pUncompressedDefaultData;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Note: This function needs reviewing for accuracy...
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	uint32_t FixedBlockVolume<VoxelType, BlockSideLengthPower>::calculateSizeInBytes(void)
+	{
+		uint32_t uSizeInBytes = sizeof(FixedBlockVolume);
+
+		uint32_t uSizeOfBlockInBytes = NoOfVoxelsPerBlock * sizeof(VoxelType);
+
+		//Memory used by the block table, the density ranges and the allocated blocks
+		uSizeInBytes += m_uNoOfBlocksInVolume * (sizeof(VoxelType*) + sizeof(DensityRange<VoxelType>));
+		for(uint32_t i = 0; i < m_uNoOfBlocksInVolume; ++i)
+		{
+			if(m_pBlocks[i])
+			{
+				uSizeInBytes += uSizeOfBlockInBytes;
+			}
+		}
+
+		//Memory used by the border and default data
+		uSizeInBytes += uSizeOfBlockInBytes * 2;
+
+		return uSizeInBytes;
+	}
+}
@@ -0,0 +1,641 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#define BORDER_LOW(x) (((x) & (BlockSideLength - 1)) != 0)
+#define BORDER_HIGH(x) (((x) & (BlockSideLength - 1)) != (BlockSideLength - 1))
+
+namespace PolyVox
+{
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::Sampler(FixedBlockVolume<VoxelType, BlockSideLengthPower>* volume)
+		:BaseVolume<VoxelType>::template Sampler< FixedBlockVolume<VoxelType, BlockSideLengthPower> >(volume)
+	{
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::~Sampler()
+	{
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	typename FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler& FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::operator=(const typename FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler& rhs) throw()
+	{
+		if(this == &rhs)
+		{
+			return *this;
+		}
+        this->mVolume = rhs.mVolume;
+		this->mXPosInVolume = rhs.mXPosInVolume;
+		this->mYPosInVolume = rhs.mYPosInVolume;
+		this->mZPosInVolume = rhs.mZPosInVolume;
+		mCurrentVoxel = rhs.mCurrentVoxel;
+        return *this;
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	int32_t FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::getPosX(void) const
+	{
+		return this->mXPosInVolume;
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	int32_t FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::getPosY(void) const
+	{
+		return this->mYPosInVolume;
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	int32_t FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::getPosZ(void) const
+	{
+		return this->mZPosInVolume;
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::getSubSampledVoxel(uint8_t uLevel) const
+	{		
+		if(uLevel == 0)
+		{
+			return getVoxel();
+		}
+		else if(uLevel == 1)
+		{
+			VoxelType tValue = getVoxel();
+			tValue = (std::min)(tValue, peekVoxel1px0py0pz());
+			tValue = (std::min)(tValue, peekVoxel0px1py0pz());
+			tValue = (std::min)(tValue, peekVoxel1px1py0pz());
+			tValue = (std::min)(tValue, peekVoxel0px0py1pz());
+			tValue = (std::min)(tValue, peekVoxel1px0py1pz());
+			tValue = (std::min)(tValue, peekVoxel0px1py1pz());
+			tValue = (std::min)(tValue, peekVoxel1px1py1pz());
+			return tValue;
+		}
+		else
+		{
+			const uint8_t uSize = 1 << uLevel;
+
+			VoxelType tValue = (std::numeric_limits<VoxelType>::max)();
+			for(uint8_t z = 0; z < uSize; ++z)
+			{
+				for(uint8_t y = 0; y < uSize; ++y)
+				{
+					for(uint8_t x = 0; x < uSize; ++x)
+					{
+						tValue = (std::min)(tValue, this->mVolume->getVoxelAt(this->mXPosInVolume + x, this->mYPosInVolume + y, this->mZPosInVolume + z));
+					}
+				}
+			}
+			return tValue;
+		}
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::getVoxel(void) const
+	{
+		return *mCurrentVoxel;
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::setPosition(const Vector3DInt32& v3dNewPos)
+	{
+		setPosition(v3dNewPos.getX(), v3dNewPos.getY(), v3dNewPos.getZ());
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos)
+	{
+		this->mXPosInVolume = xPos;
+		this->mYPosInVolume = yPos;
+		this->mZPosInVolume = zPos;
+
+		const int32_t uXBlock = this->mXPosInVolume >> BlockSideLengthPower;
+		const int32_t uYBlock = this->mYPosInVolume >> BlockSideLengthPower;
+		const int32_t uZBlock = this->mZPosInVolume >> BlockSideLengthPower;
+
+		const uint16_t uXPosInBlock = this->mXPosInVolume - (uXBlock << BlockSideLengthPower);
+		const uint16_t uYPosInBlock = this->mYPosInVolume - (uYBlock << BlockSideLengthPower);
+		const uint16_t uZPosInBlock = this->mZPosInVolume - (uZBlock << BlockSideLengthPower);
+
+		const uint32_t uVoxelIndexInBlock = uXPosInBlock + 
+				uYPosInBlock * BlockSideLength + 
+				uZPosInBlock * BlockSideLength * BlockSideLength;
+
+		if(this->mVolume->m_regValidRegionInBlocks.containsPoint(Vector3DInt32(uXBlock, uYBlock, uZBlock)))
+		{
+			mCurrentVoxel = this->mVolume->getBlockDataForReading(uXBlock, uYBlock, uZBlock) + uVoxelIndexInBlock;
+		}
+		else
+		{
+			mCurrentVoxel = this->mVolume->m_pUncompressedBorderData + uVoxelIndexInBlock;
+		}
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	bool FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::setVoxel(VoxelType tValue)
+	{
+		VoxelType* pBorderDataEndPlusOne = this->mVolume->m_pUncompressedBorderData + NoOfVoxelsPerBlock;
+		VoxelType* pDefaultDataEndPlusOne = this->mVolume->m_pUncompressedDefaultData + NoOfVoxelsPerBlock;
+
+		//If we're pointing at the shared default data then the block has not been allocated yet. Writing
+		//through the volume allocates it, and we then need to point at the newly allocated voxel data.
+		if((mCurrentVoxel >= this->mVolume->m_pUncompressedDefaultData) && (mCurrentVoxel < pDefaultDataEndPlusOne))
+		{
+			this->mVolume->setVoxelAt(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume, tValue);
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+			return true;
+		}
+
+		//Make sure we're not trying to write to the border data
+		if((mCurrentVoxel < this->mVolume->m_pUncompressedBorderData) || (mCurrentVoxel >= pBorderDataEndPlusOne))
+		{
+			*mCurrentVoxel = tValue;
+			return true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::movePositiveX(void)
+	{
+		//Note the *pre* increament here
+		if((++this->mXPosInVolume) % BlockSideLength != 0)
+		{
+			//No need to compute new block.
+			++mCurrentVoxel;			
+		}
+		else
+		{
+			//We've hit the block boundary. Just calling setPosition() is the easiest way to resolve this.
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::movePositiveY(void)
+	{
+		//Note the *pre* increament here
+		if((++this->mYPosInVolume) % BlockSideLength != 0)
+		{
+			//No need to compute new block.
+			mCurrentVoxel += BlockSideLength;
+		}
+		else
+		{
+			//We've hit the block boundary. Just calling setPosition() is the easiest way to resolve this.
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::movePositiveZ(void)
+	{
+		//Note the *pre* increament here
+		if((++this->mZPosInVolume) % BlockSideLength != 0)
+		{
+			//No need to compute new block.
+			mCurrentVoxel += BlockSideLength * BlockSideLength;
+		}
+		else
+		{
+			//We've hit the block boundary. Just calling setPosition() is the easiest way to resolve this.
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::moveNegativeX(void)
+	{
+		//Note the *post* decreament here
+		if((this->mXPosInVolume--) % BlockSideLength != 0)
+		{
+			//No need to compute new block.
+			--mCurrentVoxel;			
+		}
+		else
+		{
+			//We've hit the block boundary. Just calling setPosition() is the easiest way to resolve this.
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::moveNegativeY(void)
+	{
+		//Note the *post* decreament here
+		if((this->mYPosInVolume--) % BlockSideLength != 0)
+		{
+			//No need to compute new block.
+			mCurrentVoxel -= BlockSideLength;
+		}
+		else
+		{
+			//We've hit the block boundary. Just calling setPosition() is the easiest way to resolve this.
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::moveNegativeZ(void)
+	{
+		//Note the *post* decreament here
+		if((this->mZPosInVolume--) % BlockSideLength != 0)
+		{
+			//No need to compute new block.
+			mCurrentVoxel -= BlockSideLength * BlockSideLength;
+		}
+		else
+		{
+			//We've hit the block boundary. Just calling setPosition() is the easiest way to resolve this.
+			setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+		}
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekNeighbourhood(VoxelType pStencil[27]) const
+	{
+		if(BORDER_LOW(this->mXPosInVolume) && BORDER_HIGH(this->mXPosInVolume) && BORDER_LOW(this->mYPosInVolume) && BORDER_HIGH(this->mYPosInVolume) && BORDER_LOW(this->mZPosInVolume) && BORDER_HIGH(this->mZPosInVolume))
+		{
+			//The whole neighbourhood is inside the current block, so every voxel is at a fixed offset from the current one.
+			const int32_t iRow = BlockSideLength;
+			const int32_t iSlice = BlockSideLength * BlockSideLength;
+			const VoxelType* pSlice = mCurrentVoxel - 1 - iRow - iSlice;
+			for(int32_t z = 0; z < 3; z++)
+			{
+				for(int32_t y = 0; y < 3; y++)
+				{
+					const VoxelType* pRow = pSlice + y * iRow;
+					pStencil[y * 3 + z * 9] = pRow[0];
+					pStencil[y * 3 + z * 9 + 1] = pRow[1];
+					pStencil[y * 3 + z * 9 + 2] = pRow[2];
+				}
+				pSlice += iSlice;
+			}
+		}
+		else
+		{
+			//Near a block border, so voxels in the current block are still read directly and only those in neighbouring blocks go through the volume.
+			const int32_t iRow = BlockSideLength;
+			const int32_t iSlice = BlockSideLength * BlockSideLength;
+			const bool bInBlockX[3] = {BORDER_LOW(this->mXPosInVolume), true, BORDER_HIGH(this->mXPosInVolume)};
+			const bool bInBlockY[3] = {BORDER_LOW(this->mYPosInVolume), true, BORDER_HIGH(this->mYPosInVolume)};
+			const bool bInBlockZ[3] = {BORDER_LOW(this->mZPosInVolume), true, BORDER_HIGH(this->mZPosInVolume)};
+			for(int32_t z = 0; z < 3; z++)
+			{
+				for(int32_t y = 0; y < 3; y++)
+				{
+					for(int32_t x = 0; x < 3; x++)
+					{
+						if(bInBlockX[x] && bInBlockY[y] && bInBlockZ[z])
+						{
+							pStencil[x + y * 3 + z * 9] = *(mCurrentVoxel + (x - 1) + (y - 1) * iRow + (z - 1) * iSlice);
+						}
+						else
+						{
+							pStencil[x + y * 3 + z * 9] = this->mVolume->getVoxelAt(this->mXPosInVolume + x - 1, this->mYPosInVolume + y - 1, this->mZPosInVolume + z - 1);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	void FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekCell(VoxelType pCell[8]) const
+	{
+		if(BORDER_HIGH(this->mXPosInVolume) && BORDER_HIGH(this->mYPosInVolume) && BORDER_HIGH(this->mZPosInVolume))
+		{
+			const int32_t iRow = BlockSideLength;
+			const int32_t iSlice = BlockSideLength * BlockSideLength;
+			pCell[0] = mCurrentVoxel[0];
+			pCell[1] = mCurrentVoxel[1];
+			pCell[2] = mCurrentVoxel[iRow];
+			pCell[3] = mCurrentVoxel[iRow + 1];
+			pCell[4] = mCurrentVoxel[iSlice];
+			pCell[5] = mCurrentVoxel[iSlice + 1];
+			pCell[6] = mCurrentVoxel[iSlice + iRow];
+			pCell[7] = mCurrentVoxel[iSlice + iRow + 1];
+		}
+		else
+		{
+			const int32_t iRow = BlockSideLength;
+			const int32_t iSlice = BlockSideLength * BlockSideLength;
+			const bool bInBlockX[2] = {true, BORDER_HIGH(this->mXPosInVolume)};
+			const bool bInBlockY[2] = {true, BORDER_HIGH(this->mYPosInVolume)};
+			const bool bInBlockZ[2] = {true, BORDER_HIGH(this->mZPosInVolume)};
+			for(int32_t z = 0; z < 2; z++)
+			{
+				for(int32_t y = 0; y < 2; y++)
+				{
+					for(int32_t x = 0; x < 2; x++)
+					{
+						if(bInBlockX[x] && bInBlockY[y] && bInBlockZ[z])
+						{
+							pCell[x + y * 2 + z * 4] = *(mCurrentVoxel + x + y * iRow + z * iSlice);
+						}
+						else
+						{
+							pCell[x + y * 2 + z * 4] = this->mVolume->getVoxelAt(this->mXPosInVolume + x, this->mYPosInVolume + y, this->mZPosInVolume + z);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1nx1ny1nz(void) const
+	{
+		if(	BORDER_LOW(this->mXPosInVolume) && BORDER_LOW(this->mYPosInVolume) && BORDER_LOW(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel - 1 - BlockSideLength - BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume-1,this->mYPosInVolume-1,this->mZPosInVolume-1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1nx1ny0pz(void) const
+	{
+		if(	BORDER_LOW(this->mXPosInVolume) && BORDER_LOW(this->mYPosInVolume) )
+		{
+			return *(mCurrentVoxel - 1 - BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume-1,this->mYPosInVolume-1,this->mZPosInVolume);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1nx1ny1pz(void) const
+	{
+		if(	BORDER_LOW(this->mXPosInVolume) && BORDER_LOW(this->mYPosInVolume) && BORDER_HIGH(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel - 1 - BlockSideLength + BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume-1,this->mYPosInVolume-1,this->mZPosInVolume+1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1nx0py1nz(void) const
+	{
+		if(	BORDER_LOW(this->mXPosInVolume) && BORDER_LOW(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel - 1 - BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume-1,this->mYPosInVolume,this->mZPosInVolume-1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1nx0py0pz(void) const
+	{
+		if( BORDER_LOW(this->mXPosInVolume) )
+		{
+			return *(mCurrentVoxel - 1);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume-1,this->mYPosInVolume,this->mZPosInVolume);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1nx0py1pz(void) const
+	{
+		if( BORDER_LOW(this->mXPosInVolume) && BORDER_HIGH(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel - 1 + BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume-1,this->mYPosInVolume,this->mZPosInVolume+1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1nx1py1nz(void) const
+	{
+		if( BORDER_LOW(this->mXPosInVolume) && BORDER_HIGH(this->mYPosInVolume) && BORDER_LOW(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel - 1 + BlockSideLength - BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume-1,this->mYPosInVolume+1,this->mZPosInVolume-1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1nx1py0pz(void) const
+	{
+		if( BORDER_LOW(this->mXPosInVolume) && BORDER_HIGH(this->mYPosInVolume) )
+		{
+			return *(mCurrentVoxel - 1 + BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume-1,this->mYPosInVolume+1,this->mZPosInVolume);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1nx1py1pz(void) const
+	{
+		if( BORDER_LOW(this->mXPosInVolume) && BORDER_HIGH(this->mYPosInVolume) && BORDER_HIGH(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel - 1 + BlockSideLength + BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume-1,this->mYPosInVolume+1,this->mZPosInVolume+1);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel0px1ny1nz(void) const
+	{
+		if( BORDER_LOW(this->mYPosInVolume) && BORDER_LOW(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel - BlockSideLength - BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume,this->mYPosInVolume-1,this->mZPosInVolume-1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel0px1ny0pz(void) const
+	{
+		if( BORDER_LOW(this->mYPosInVolume) )
+		{
+			return *(mCurrentVoxel - BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume,this->mYPosInVolume-1,this->mZPosInVolume);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel0px1ny1pz(void) const
+	{
+		if( BORDER_LOW(this->mYPosInVolume) && BORDER_HIGH(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel - BlockSideLength + BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume,this->mYPosInVolume-1,this->mZPosInVolume+1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel0px0py1nz(void) const
+	{
+		if( BORDER_LOW(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel - BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume,this->mYPosInVolume,this->mZPosInVolume-1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel0px0py0pz(void) const
+	{
+			return *mCurrentVoxel;
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel0px0py1pz(void) const
+	{
+		if( BORDER_HIGH(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel + BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume,this->mYPosInVolume,this->mZPosInVolume+1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel0px1py1nz(void) const
+	{
+		if( BORDER_HIGH(this->mYPosInVolume) && BORDER_LOW(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel + BlockSideLength - BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume,this->mYPosInVolume+1,this->mZPosInVolume-1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel0px1py0pz(void) const
+	{
+		if( BORDER_HIGH(this->mYPosInVolume) )
+		{
+			return *(mCurrentVoxel + BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume,this->mYPosInVolume+1,this->mZPosInVolume);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel0px1py1pz(void) const
+	{
+		if( BORDER_HIGH(this->mYPosInVolume) && BORDER_HIGH(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel + BlockSideLength + BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume,this->mYPosInVolume+1,this->mZPosInVolume+1);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1px1ny1nz(void) const
+	{
+		if( BORDER_HIGH(this->mXPosInVolume) && BORDER_LOW(this->mYPosInVolume) && BORDER_LOW(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel + 1 - BlockSideLength - BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume+1,this->mYPosInVolume-1,this->mZPosInVolume-1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1px1ny0pz(void) const
+	{
+		if( BORDER_HIGH(this->mXPosInVolume) && BORDER_LOW(this->mYPosInVolume) )
+		{
+			return *(mCurrentVoxel + 1 - BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume+1,this->mYPosInVolume-1,this->mZPosInVolume);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1px1ny1pz(void) const
+	{
+		if( BORDER_HIGH(this->mXPosInVolume) && BORDER_LOW(this->mYPosInVolume) && BORDER_HIGH(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel + 1 - BlockSideLength + BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume+1,this->mYPosInVolume-1,this->mZPosInVolume+1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1px0py1nz(void) const
+	{
+		if( BORDER_HIGH(this->mXPosInVolume) && BORDER_LOW(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel + 1 - BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume+1,this->mYPosInVolume,this->mZPosInVolume-1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1px0py0pz(void) const
+	{
+		if( BORDER_HIGH(this->mXPosInVolume) )
+		{
+			return *(mCurrentVoxel + 1);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume+1,this->mYPosInVolume,this->mZPosInVolume);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1px0py1pz(void) const
+	{
+		if( BORDER_HIGH(this->mXPosInVolume) && BORDER_HIGH(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel + 1 + BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume+1,this->mYPosInVolume,this->mZPosInVolume+1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1px1py1nz(void) const
+	{
+		if( BORDER_HIGH(this->mXPosInVolume) && BORDER_HIGH(this->mYPosInVolume) && BORDER_LOW(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel + 1 + BlockSideLength - BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume+1,this->mYPosInVolume+1,this->mZPosInVolume-1);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1px1py0pz(void) const
+	{
+		if( BORDER_HIGH(this->mXPosInVolume) && BORDER_HIGH(this->mYPosInVolume) )
+		{
+			return *(mCurrentVoxel + 1 + BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume+1,this->mYPosInVolume+1,this->mZPosInVolume);
+	}
+
+	template <typename VoxelType, uint8_t BlockSideLengthPower>
+	VoxelType FixedBlockVolume<VoxelType, BlockSideLengthPower>::Sampler::peekVoxel1px1py1pz(void) const
+	{
+		if( BORDER_HIGH(this->mXPosInVolume) && BORDER_HIGH(this->mYPosInVolume) && BORDER_HIGH(this->mZPosInVolume) )
+		{
+			return *(mCurrentVoxel + 1 + BlockSideLength + BlockSideLength*BlockSideLength);
+		}
+		return this->mVolume->getVoxelAt(this->mXPosInVolume+1,this->mYPosInVolume+1,this->mZPosInVolume+1);
+	}
+}
+
+#undef BORDER_LOW
+#undef BORDER_HIGH
@@ -106,35 +106,39 @@ namespace PolyVox
 		static const int weights[3][3][3] = {  {  {2,3,2}, {3,6,3}, {2,3,2}  },  {
 			{3,6,3},  {6,0,6},  {3,6,3} },  { {2,3,2},  {3,6,3},  {2,3,2} } };
 
-			const VoxelType pVoxel1nx1ny1nz = volIter.peekVoxel1nx1ny1nz() > 0 ? 1: 0;
-			const VoxelType pVoxel1nx1ny0pz = volIter.peekVoxel1nx1ny0pz() > 0 ? 1: 0;
-			const VoxelType pVoxel1nx1ny1pz = volIter.peekVoxel1nx1ny1pz() > 0 ? 1: 0;
-			const VoxelType pVoxel1nx0py1nz = volIter.peekVoxel1nx0py1nz() > 0 ? 1: 0;
-			const VoxelType pVoxel1nx0py0pz = volIter.peekVoxel1nx0py0pz() > 0 ? 1: 0;
-			const VoxelType pVoxel1nx0py1pz = volIter.peekVoxel1nx0py1pz() > 0 ? 1: 0;
-			const VoxelType pVoxel1nx1py1nz = volIter.peekVoxel1nx1py1nz() > 0 ? 1: 0;
-			const VoxelType pVoxel1nx1py0pz = volIter.peekVoxel1nx1py0pz() > 0 ? 1: 0;
-			const VoxelType pVoxel1nx1py1pz = volIter.peekVoxel1nx1py1pz() > 0 ? 1: 0;
-
-			const VoxelType pVoxel0px1ny1nz = volIter.peekVoxel0px1ny1nz() > 0 ? 1: 0;
-			const VoxelType pVoxel0px1ny0pz = volIter.peekVoxel0px1ny0pz() > 0 ? 1: 0;
-			const VoxelType pVoxel0px1ny1pz = volIter.peekVoxel0px1ny1pz() > 0 ? 1: 0;
-			const VoxelType pVoxel0px0py1nz = volIter.peekVoxel0px0py1nz() > 0 ? 1: 0;
-			//const VoxelType pVoxel0px0py0pz = volIter.peekVoxel0px0py0pz() > 0 ? 1: 0;
-			const VoxelType pVoxel0px0py1pz = volIter.peekVoxel0px0py1pz() > 0 ? 1: 0;
-			const VoxelType pVoxel0px1py1nz = volIter.peekVoxel0px1py1nz() > 0 ? 1: 0;
-			const VoxelType pVoxel0px1py0pz = volIter.peekVoxel0px1py0pz() > 0 ? 1: 0;
-			const VoxelType pVoxel0px1py1pz = volIter.peekVoxel0px1py1pz() > 0 ? 1: 0;
-
-			const VoxelType pVoxel1px1ny1nz = volIter.peekVoxel1px1ny1nz() > 0 ? 1: 0;
-			const VoxelType pVoxel1px1ny0pz = volIter.peekVoxel1px1ny0pz() > 0 ? 1: 0;
-			const VoxelType pVoxel1px1ny1pz = volIter.peekVoxel1px1ny1pz() > 0 ? 1: 0;
-			const VoxelType pVoxel1px0py1nz = volIter.peekVoxel1px0py1nz() > 0 ? 1: 0;
-			const VoxelType pVoxel1px0py0pz = volIter.peekVoxel1px0py0pz() > 0 ? 1: 0;
-			const VoxelType pVoxel1px0py1pz = volIter.peekVoxel1px0py1pz() > 0 ? 1: 0;
-			const VoxelType pVoxel1px1py1nz = volIter.peekVoxel1px1py1nz() > 0 ? 1: 0;
-			const VoxelType pVoxel1px1py0pz = volIter.peekVoxel1px1py0pz() > 0 ? 1: 0;
-			const VoxelType pVoxel1px1py1pz = volIter.peekVoxel1px1py1pz() > 0 ? 1: 0;
+			//Fetch the whole neighbourhood at once, rather than peeking at each voxel in turn.
+			VoxelType pStencil[27];
+			volIter.peekNeighbourhood(pStencil);
+
+			const VoxelType pVoxel1nx1ny1nz = pStencil[0] > 0 ? 1: 0;
+			const VoxelType pVoxel1nx1ny0pz = pStencil[9] > 0 ? 1: 0;
+			const VoxelType pVoxel1nx1ny1pz = pStencil[18] > 0 ? 1: 0;
+			const VoxelType pVoxel1nx0py1nz = pStencil[3] > 0 ? 1: 0;
+			const VoxelType pVoxel1nx0py0pz = pStencil[12] > 0 ? 1: 0;
+			const VoxelType pVoxel1nx0py1pz = pStencil[21] > 0 ? 1: 0;
+			const VoxelType pVoxel1nx1py1nz = pStencil[6] > 0 ? 1: 0;
+			const VoxelType pVoxel1nx1py0pz = pStencil[15] > 0 ? 1: 0;
+			const VoxelType pVoxel1nx1py1pz = pStencil[24] > 0 ? 1: 0;
+
+			const VoxelType pVoxel0px1ny1nz = pStencil[1] > 0 ? 1: 0;
+			const VoxelType pVoxel0px1ny0pz = pStencil[10] > 0 ? 1: 0;
+			const VoxelType pVoxel0px1ny1pz = pStencil[19] > 0 ? 1: 0;
+			const VoxelType pVoxel0px0py1nz = pStencil[4] > 0 ? 1: 0;
+			//const VoxelType pVoxel0px0py0pz = pStencil[13] > 0 ? 1: 0;
+			const VoxelType pVoxel0px0py1pz = pStencil[22] > 0 ? 1: 0;
+			const VoxelType pVoxel0px1py1nz = pStencil[7] > 0 ? 1: 0;
+			const VoxelType pVoxel0px1py0pz = pStencil[16] > 0 ? 1: 0;
+			const VoxelType pVoxel0px1py1pz = pStencil[25] > 0 ? 1: 0;
+
+			const VoxelType pVoxel1px1ny1nz = pStencil[2] > 0 ? 1: 0;
+			const VoxelType pVoxel1px1ny0pz = pStencil[11] > 0 ? 1: 0;
+			const VoxelType pVoxel1px1ny1pz = pStencil[20] > 0 ? 1: 0;
+			const VoxelType pVoxel1px0py1nz = pStencil[5] > 0 ? 1: 0;
+			const VoxelType pVoxel1px0py0pz = pStencil[14] > 0 ? 1: 0;
+			const VoxelType pVoxel1px0py1pz = pStencil[23] > 0 ? 1: 0;
+			const VoxelType pVoxel1px1py1nz = pStencil[8] > 0 ? 1: 0;
+			const VoxelType pVoxel1px1py0pz = pStencil[17] > 0 ? 1: 0;
+			const VoxelType pVoxel1px1py1pz = pStencil[26] > 0 ? 1: 0;
 
 			const int xGrad(- weights[0][0][0] * pVoxel1nx1ny1nz -
 				weights[1][0][0] * pVoxel1nx1ny0pz - weights[2][0][0] *
@@ -0,0 +1,90 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#ifndef __PolyVox_HierarchicalRaycast_H__
+#define __PolyVox_HierarchicalRaycast_H__
+
+#include "PolyVoxCore/DensityPyramid.h"
+#include "PolyVoxCore/Raycast.h"
+#include "PolyVoxCore/Vector.h"
+
+namespace PolyVox
+{
+	/// The HierarchicalRaycast finds the first filled voxel along a path, leaping over empty space.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// This class is used in the same way as the Raycast (see its documentation for the details), but it also takes a DensityPyramid
+	/// built for the volume. Whenever the ray enters a node of the pyramid which contains no solid voxels the ray jumps straight to
+	/// the point where it leaves that node, rather than examining each voxel on the way. Long rays through open space (such as those
+	/// used for picking) therefore only touch a handful of nodes, and only the voxels close to the surface are actually read.
+	///
+	/// The voxels are visited in the same order as a voxel by voxel walk, but the position along the ray is computed from the number
+	/// of steps taken rather than by adding up the steps one at a time as the Raycast does. This is more accurate over long rays, but
+	/// it means that where the ray passes (almost) exactly through the edge or corner of a voxel the two classes can disagree about
+	/// which neighbour is visited first. Results may then differ by a voxel.
+	///
+	/// The pyramid must be kept up to date as the volume is modified (see DensityPyramid::regionChanged()), otherwise solid voxels
+	/// placed in previously empty space will be missed.
+	///
+	/// \code
+	/// DensityPyramid<SimpleVolume, Material8> pyramid(&volume);
+	///
+	/// RaycastResult raycastResult;
+	/// HierarchicalRaycast<SimpleVolume, Material8> raycast(&volume, &pyramid, start, direction, raycastResult);
+	/// raycast.execute();
+	/// \endcode
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	class HierarchicalRaycast
+	{
+	public:
+		///Constructor
+		HierarchicalRaycast(VolumeType<VoxelType>* volData, const DensityPyramid<VolumeType, VoxelType>* pPyramid, const Vector3DFloat& v3dStart, const Vector3DFloat& v3dDirectionAndLength, RaycastResult& result);
+
+		///Sets the start position for the ray.
+		void setStart(const Vector3DFloat& v3dStart);
+		///Set the direction for the ray.
+		void setDirection(const Vector3DFloat& v3dDirectionAndLength);
+
+		///Performs the raycast.
+		void execute();
+
+	private:
+		RaycastResult& m_result;
+
+		void doRaycast(float x1, float y1, float z1, float x2, float y2, float z2);
+
+		static float getCrossing(float fFirstCrossing, float fDelta, int32_t iCrossing);
+		static bool isCrossedBefore(float fCrossing, uint32_t uAxis, float fOtherCrossing, uint32_t uOtherAxis);
+
+		VolumeType<VoxelType>* m_volData;
+		const DensityPyramid<VolumeType, VoxelType>* m_pPyramid;
+		typename VolumeType<VoxelType>::Sampler m_sampVolume;
+
+		Vector3DFloat m_v3dStart;
+		Vector3DFloat m_v3dDirectionAndLength;
+	};
+}
+
+#include "PolyVoxCore/HierarchicalRaycast.inl"
+
+#endif //__PolyVox_HierarchicalRaycast_H__
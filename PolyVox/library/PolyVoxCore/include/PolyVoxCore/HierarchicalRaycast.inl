@@ -0,0 +1,295 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+namespace PolyVox
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/// Builds a HierarchicalRaycast object.
+	/// \param volData A pointer to the volume through which the ray will be cast.
+	/// \param pPyramid A pointer to a DensityPyramid which has been built for the volume.
+	/// \param v3dStart The starting position of the ray.
+	/// \param v3dDirectionAndLength The direction of the ray. The length of this vector also
+	/// represents the length of the ray.
+	/// \param result An instance of RaycastResult in which the result will be stored.
+	////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	HierarchicalRaycast<VolumeType, VoxelType>::HierarchicalRaycast(VolumeType<VoxelType>* volData, const DensityPyramid<VolumeType, VoxelType>* pPyramid, const Vector3DFloat& v3dStart, const Vector3DFloat& v3dDirectionAndLength, RaycastResult& result)
+		:m_result(result)
+		,m_volData(volData)
+		,m_pPyramid(pPyramid)
+		,m_sampVolume(volData)
+		,m_v3dStart(v3dStart)
+		,m_v3dDirectionAndLength(v3dDirectionAndLength)
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dStart The starting position of the ray.
+	////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	void HierarchicalRaycast<VolumeType, VoxelType>::setStart(const Vector3DFloat& v3dStart)
+	{
+		m_v3dStart = v3dStart;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dDirectionAndLength The direction of the ray. The length of this vector also
+	/// represents the length of the ray.
+	////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	void HierarchicalRaycast<VolumeType, VoxelType>::setDirection(const Vector3DFloat& v3dDirectionAndLength)
+	{
+		m_v3dDirectionAndLength = v3dDirectionAndLength;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The result is stored in the RaycastResult instance which was passed to the constructor.
+	////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	void HierarchicalRaycast<VolumeType, VoxelType>::execute(void)
+	{
+		//As for the Raycast, this moves the boundaries between cells onto the voxel boundaries.
+		Vector3DFloat v3dStart = m_v3dStart + Vector3DFloat(0.5f, 0.5f, 0.5f);
+
+		//Compute the end point
+		Vector3DFloat v3dEnd = v3dStart + m_v3dDirectionAndLength;
+
+		//Do the raycast
+		doRaycast(v3dStart.getX(), v3dStart.getY(), v3dStart.getZ(), v3dEnd.getX(), v3dEnd.getY(), v3dEnd.getZ());
+	}
+
+	//This is the same grid walk as the one used by the Raycast (see the notes there), except that each axis keeps count of the
+	//boundaries it has crossed. The position along the ray (from 0 to 1) of any boundary can then be found directly, which is
+	//what allows the walk to jump across a whole node of the pyramid and still arrive in the same voxel, and in the same state,
+	//as it would have done by stepping through the node.
+	template< template<typename> class VolumeType, typename VoxelType>
+	void HierarchicalRaycast<VolumeType, VoxelType>::doRaycast(float x1, float y1, float z1, float x2, float y2, float z2)
+	{
+		const float afStart[3] = {x1, y1, z1};
+		const float afEnd[3] = {x2, y2, z2};
+
+		int32_t aiStart[3]; //The voxel the ray starts in
+		int32_t aiDirection[3]; //The direction of each step (-1, 0 or 1)
+		int32_t aiNoOfSteps[3]; //The number of steps to the voxel the ray ends in
+		float afFirstCrossing[3]; //The position along the ray of the first boundary
+		float afDelta[3]; //The distance along the ray between boundaries
+
+		int32_t aiStepsTaken[3];
+		int32_t aiPos[3];
+		float afNextCrossing[3];
+
+		for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
+		{
+			const float fStart = afStart[uAxis];
+			const float fEnd = afEnd[uAxis];
+
+			aiStart[uAxis] = static_cast<int32_t>(floorf(fStart));
+			aiDirection[uAxis] = ((fStart < fEnd) ? 1 : ((fStart > fEnd) ? -1 : 0));
+			aiNoOfSteps[uAxis] = std::abs(static_cast<int32_t>(floorf(fEnd)) - aiStart[uAxis]);
+
+			afDelta[uAxis] = 1.0f / std::abs(fEnd - fStart);
+			const float fMin = floorf(fStart);
+			const float fMax = fMin + 1.0f;
+			afFirstCrossing[uAxis] = ((fStart > fEnd) ? (fStart - fMin) : (fMax - fStart)) * afDelta[uAxis];
+
+			aiStepsTaken[uAxis] = 0;
+			aiPos[uAxis] = aiStart[uAxis];
+			afNextCrossing[uAxis] = afFirstCrossing[uAxis];
+		}
+
+		//The node of the pyramid which the current voxel is in. It starts out
+		//inside out, so that the first voxel is looked up in the pyramid.
+		int32_t aiNodeLower[3] = {0, 0, 0};
+		int32_t aiNodeUpper[3] = {-1, -1, -1};
+		bool bNodeIsEmpty = false;
+
+		m_result.previousVoxel = Vector3DInt32(aiPos[0], aiPos[1], aiPos[2]);
+
+		for(;;)
+		{
+			if((aiPos[0] < aiNodeLower[0]) || (aiPos[0] > aiNodeUpper[0]) ||
+				(aiPos[1] < aiNodeLower[1]) || (aiPos[1] > aiNodeUpper[1]) ||
+				(aiPos[2] < aiNodeLower[2]) || (aiPos[2] > aiNodeUpper[2]))
+			{
+				Region regNode;
+				bNodeIsEmpty = m_pPyramid->getLargestNodeAt(aiPos[0], aiPos[1], aiPos[2], VoxelType::getThreshold(), regNode);
+				for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
+				{
+					aiNodeLower[uAxis] = regNode.getLowerCorner().getElement(uAxis);
+					aiNodeUpper[uAxis] = regNode.getUpperCorner().getElement(uAxis);
+				}
+
+				if(!bNodeIsEmpty)
+				{
+					m_sampVolume.setPosition(aiPos[0], aiPos[1], aiPos[2]);
+				}
+			}
+
+			if(bNodeIsEmpty)
+			{
+				//Find the boundary at which the ray either leaves the node or comes to an end. For each axis
+				//this is after however many steps come first, and the ray then stops at the nearest of these.
+				int32_t aiStepsToStop[3];
+				uint32_t uStopAxis = 0;
+				float fStopCrossing = 0.0f;
+				for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
+				{
+					const int32_t iStepsToEnd = aiNoOfSteps[uAxis] - aiStepsTaken[uAxis] + 1;
+					int32_t iStepsToLeave = iStepsToEnd;
+					if(aiDirection[uAxis] == 1)
+					{
+						iStepsToLeave = aiNodeUpper[uAxis] - aiPos[uAxis] + 1;
+					}
+					else if(aiDirection[uAxis] == -1)
+					{
+						iStepsToLeave = aiPos[uAxis] - aiNodeLower[uAxis] + 1;
+					}
+					aiStepsToStop[uAxis] = (std::min)(iStepsToEnd, iStepsToLeave);
+
+					//Ties go to the earlier axis, as they do when stepping.
+					const float fCrossing = getCrossing(afFirstCrossing[uAxis], afDelta[uAxis], aiStepsTaken[uAxis] + aiStepsToStop[uAxis] - 1);
+					if((uAxis == 0) || (fCrossing < fStopCrossing))
+					{
+						uStopAxis = uAxis;
+						fStopCrossing = fCrossing;
+					}
+				}
+
+				if(aiStepsToStop[uStopAxis] == aiNoOfSteps[uStopAxis] - aiStepsTaken[uStopAxis] + 1)
+				{
+					//The ray ends inside the node.
+					break;
+				}
+
+				//Count the boundaries crossed along the other axes before that point.
+				for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
+				{
+					if(uAxis == uStopAxis)
+					{
+						continue;
+					}
+
+					const int32_t iMaxSteps = aiStepsToStop[uAxis] - 1;
+					int32_t iSteps = 0;
+					if(iMaxSteps > 0)
+					{
+						//Make an estimate, and then correct it against the exact positions of the boundaries.
+						const float fEstimate = (fStopCrossing - afNextCrossing[uAxis]) / afDelta[uAxis] + 1.0f;
+						iSteps = (fEstimate >= iMaxSteps) ? iMaxSteps : ((fEstimate > 0.0f) ? static_cast<int32_t>(fEstimate) : 0);
+						while((iSteps > 0) && (!isCrossedBefore(getCrossing(afFirstCrossing[uAxis], afDelta[uAxis], aiStepsTaken[uAxis] + iSteps - 1), uAxis, fStopCrossing, uStopAxis)))
+						{
+							iSteps--;
+						}
+						while((iSteps < iMaxSteps) && (isCrossedBefore(getCrossing(afFirstCrossing[uAxis], afDelta[uAxis], aiStepsTaken[uAxis] + iSteps), uAxis, fStopCrossing, uStopAxis)))
+						{
+							iSteps++;
+						}
+					}
+					aiStepsTaken[uAxis] += iSteps;
+				}
+				aiStepsTaken[uStopAxis] += aiStepsToStop[uStopAxis] - 1;
+
+				//The last voxel inside the node, and then the first one beyond it.
+				for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
+				{
+					aiPos[uAxis] = aiStart[uAxis] + aiDirection[uAxis] * aiStepsTaken[uAxis];
+				}
+				m_result.previousVoxel = Vector3DInt32(aiPos[0], aiPos[1], aiPos[2]);
+
+				aiStepsTaken[uStopAxis]++;
+				aiPos[uStopAxis] += aiDirection[uStopAxis];
+				for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
+				{
+					afNextCrossing[uAxis] = getCrossing(afFirstCrossing[uAxis], afDelta[uAxis], aiStepsTaken[uAxis]);
+				}
+				continue;
+			}
+
+			if(m_sampVolume.getVoxel().getDensity() > VoxelType::getThreshold())
+			{
+				m_result.foundIntersection = true;
+				m_result.intersectionVoxel = Vector3DInt32(aiPos[0], aiPos[1], aiPos[2]);
+				return;
+			}
+			m_result.previousVoxel = Vector3DInt32(aiPos[0], aiPos[1], aiPos[2]);
+
+			uint32_t uAxis = 2;
+			if((afNextCrossing[0] <= afNextCrossing[1]) && (afNextCrossing[0] <= afNextCrossing[2]))
+			{
+				uAxis = 0;
+			}
+			else if(afNextCrossing[1] <= afNextCrossing[2])
+			{
+				uAxis = 1;
+			}
+
+			if(aiStepsTaken[uAxis] == aiNoOfSteps[uAxis]) break;
+			aiStepsTaken[uAxis]++;
+			aiPos[uAxis] += aiDirection[uAxis];
+			afNextCrossing[uAxis] = getCrossing(afFirstCrossing[uAxis], afDelta[uAxis], aiStepsTaken[uAxis]);
+
+			switch(uAxis)
+			{
+			case 0:
+				if(aiDirection[0] == 1) m_sampVolume.movePositiveX();
+				if(aiDirection[0] == -1) m_sampVolume.moveNegativeX();
+				break;
+			case 1:
+				if(aiDirection[1] == 1) m_sampVolume.movePositiveY();
+				if(aiDirection[1] == -1) m_sampVolume.moveNegativeY();
+				break;
+			default:
+				if(aiDirection[2] == 1) m_sampVolume.movePositiveZ();
+				if(aiDirection[2] == -1) m_sampVolume.moveNegativeZ();
+				break;
+			}
+		}
+
+		//Didn't hit anything
+		m_result.foundIntersection = false;
+		m_result.intersectionVoxel = Vector3DInt32(0,0,0);
+		m_result.previousVoxel = Vector3DInt32(0,0,0);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Gets the position along the ray of a boundary along one axis. Every crossing
+	/// is computed this way, rather than by adding up the distances between them.
+	////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	float HierarchicalRaycast<VolumeType, VoxelType>::getCrossing(float fFirstCrossing, float fDelta, int32_t iCrossing)
+	{
+		//The delta is infinite along an axis which the ray doesn't move along,
+		//so avoid multiplying it by zero in the case of the first crossing.
+		return (iCrossing == 0) ? fFirstCrossing : fFirstCrossing + static_cast<float>(iCrossing) * fDelta;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Determines whether a boundary is crossed before another, with ties going to
+	/// the earlier axis as they do when stepping voxel by voxel.
+	////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	bool HierarchicalRaycast<VolumeType, VoxelType>::isCrossedBefore(float fCrossing, uint32_t uAxis, float fOtherCrossing, uint32_t uOtherAxis)
+	{
+		return (fCrossing < fOtherCrossing) || ((fCrossing == fOtherCrossing) && (uAxis < uOtherAxis));
+	}
+}
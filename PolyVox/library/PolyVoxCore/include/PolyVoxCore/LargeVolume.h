@@ -220,6 +220,11 @@ namespace PolyVox
 			inline VoxelType peekVoxel1px1py0pz(void) const;
 			inline VoxelType peekVoxel1px1py1pz(void) const;
 
+			/// Reads the 3x3x3 neighbourhood of the current position, indexed by <tt>(x+1) + (y+1)*3 + (z+1)*9</tt>.
+			inline void peekNeighbourhood(VoxelType pStencil[27]) const;
+			/// Reads the 2x2x2 cell whose lower corner is the current position, indexed by <tt>x + y*2 + z*4</tt>.
+			inline void peekCell(VoxelType pCell[8]) const;
+
 		private:
 			//Other current position information
 			VoxelType* mCurrentVoxel;
@@ -285,6 +290,10 @@ namespace PolyVox
 		bool setVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue);
 		/// Sets the voxel at the position given by a 3D vector
 		bool setVoxelAt(const Vector3DInt32& v3dPos, VoxelType tValue);
+		/// Gets a pointer to a run of voxels along the \c x axis starting at <tt>x,y,z</tt>
+		const VoxelType* getSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength) const;
+		/// Gets a writable pointer to a run of voxels along the \c x axis starting at <tt>x,y,z</tt>
+		VoxelType* getWritableSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength);
 		/// Tries to ensure that the voxels within the specified Region are loaded into memory.
 		void prefetch(Region regPrefetch);
 		/// Ensures that any voxels within the specified Region are removed from memory.
@@ -294,6 +303,8 @@ namespace PolyVox
 
 		/// Empties the cache of uncompressed blocks
 		void clearBlockCache(void);
+		/// Recompresses and compacts a limited number of blocks, returning the number of bytes reclaimed
+		uint32_t tidy(uint32_t uMaxNoOfBlocks = 64, uint32_t uMinimumAge = 256);
 		/// Calculates the approximate compression ratio of the store volume data
 		float calculateCompressionRatio(void);
 		/// Calculates approximatly how many bytes of memory the volume is currently using.
@@ -329,6 +340,9 @@ private:
 		mutable uint32_t m_uTimestamper;
 		mutable Vector3DInt32 m_v3dLastAccessedBlockPos;
 		mutable Block<VoxelType>* m_pLastAccessedBlock;
+
+		//The position of the next block to be visited by tidy(), so that successive calls work through the whole volume.
+		Vector3DInt32 m_v3dNextBlockToTidy;
 		uint32_t m_uMaxNumberOfUncompressedBlocks;
 		uint32_t m_uMaxNumberOfBlocksInMemory;
 
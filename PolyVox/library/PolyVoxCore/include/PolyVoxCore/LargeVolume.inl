@@ -258,6 +258,87 @@ namespace PolyVox
 		return setVoxelAt(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ(), tValue);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// The returned run holds \a iLength consecutive voxels along the \c x axis, where \a iLength is never
+	/// more than \a iMaxLength. A null pointer means the voxels are outside the volume or are not stored
+	/// contiguously, and should be read through getVoxelAt() instead. \a iLength is set in either case.
+	///
+	/// The pointer is only valid until the volume is next accessed.
+	/// \param uXPos The \c x position of the first voxel in the run
+	/// \param uYPos The \c y position of the run
+	/// \param uZPos The \c z position of the run
+	/// \param iMaxLength The largest number of voxels the run may contain
+	/// \param iLength Set to the number of voxels in the run
+	/// \return A pointer to the first voxel in the run, or null
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	const VoxelType* LargeVolume<VoxelType>::getSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength) const
+	{
+		if(this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)))
+		{
+			const int32_t blockX = uXPos >> m_uBlockSideLengthPower;
+			const int32_t blockY = uYPos >> m_uBlockSideLengthPower;
+			const int32_t blockZ = uZPos >> m_uBlockSideLengthPower;
+
+			const uint16_t xOffset = uXPos - (blockX << m_uBlockSideLengthPower);
+			const uint16_t yOffset = uYPos - (blockY << m_uBlockSideLengthPower);
+			const uint16_t zOffset = uZPos - (blockZ << m_uBlockSideLengthPower);
+
+			//The run stops at the end of the block, at the edge of the volume, or when it is long enough.
+			iLength = (std::min)((std::min)(iMaxLength, static_cast<int32_t>(m_uBlockSideLength - xOffset)), this->m_regValidRegion.getUpperCorner().getX() - uXPos + 1);
+
+			const VoxelType* pBlockData = getUncompressedBlock(blockX, blockY, blockZ)->m_tUncompressedData;
+
+			return pBlockData + xOffset + yOffset * m_uBlockSideLength + zOffset * m_uBlockSideLength * m_uBlockSideLength;
+		}
+		else
+		{
+			iLength = this->getBorderSpanLength(uXPos, uYPos, uZPos, iMaxLength);
+			return 0;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// As getSpanAt(), except that the voxels may be modified through the returned pointer. A null pointer
+	/// means the voxels should be written through setVoxelAt() instead.
+	/// \param uXPos The \c x position of the first voxel in the run
+	/// \param uYPos The \c y position of the run
+	/// \param uZPos The \c z position of the run
+	/// \param iMaxLength The largest number of voxels the run may contain
+	/// \param iLength Set to the number of voxels in the run
+	/// \return A pointer to the first voxel in the run, or null
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType* LargeVolume<VoxelType>::getWritableSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength)
+	{
+		if(this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)))
+		{
+			const int32_t blockX = uXPos >> m_uBlockSideLengthPower;
+			const int32_t blockY = uYPos >> m_uBlockSideLengthPower;
+			const int32_t blockZ = uZPos >> m_uBlockSideLengthPower;
+
+			const uint16_t xOffset = uXPos - (blockX << m_uBlockSideLengthPower);
+			const uint16_t yOffset = uYPos - (blockY << m_uBlockSideLengthPower);
+			const uint16_t zOffset = uZPos - (blockZ << m_uBlockSideLengthPower);
+
+			//The run stops at the end of the block, at the edge of the volume, or when it is long enough.
+			iLength = (std::min)((std::min)(iMaxLength, static_cast<int32_t>(m_uBlockSideLength - xOffset)), this->m_regValidRegion.getUpperCorner().getX() - uXPos + 1);
+
+			Block<VoxelType>* pUncompressedBlock = getUncompressedBlock(blockX, blockY, blockZ);
+
+			//We can't tell whether the caller will actually write, so assume it does.
+			pUncompressedBlock->m_bIsUncompressedDataModified = true;
+			VoxelType* pBlockData = pUncompressedBlock->m_tUncompressedData;
+
+			return pBlockData + xOffset + yOffset * m_uBlockSideLength + zOffset * m_uBlockSideLength * m_uBlockSideLength;
+		}
+		else
+		{
+			iLength = this->getBorderSpanLength(uXPos, uYPos, uZPos, iMaxLength);
+			return 0;
+		}
+	}
+
 
 	////////////////////////////////////////////////////////////////////////////////
 	/// Note that if MaxNumberOfBlocksInMemory is not large enough to support the region this function will only load part of the region. In this case it is undefined which parts will actually be loaded. If all the voxels in the given region are already loaded, this function will not do anything. Other voxels might be unloaded to make space for the new voxels.
@@ -387,6 +468,93 @@ namespace PolyVox
 		m_vecUncompressedBlockCache.clear();
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// Performs an incremental compaction pass over the blocks of the volume. Blocks
+	/// which are held uncompressed but have not been accessed recently are compressed
+	/// and removed from the cache (so blocks which have reverted to a single value
+	/// collapse to a single run), while compressed blocks have any spare capacity
+	/// released. Each call visits at most uMaxNoOfBlocks
+	/// blocks and the next call resumes where this one stopped, so it is cheap enough
+	/// to be called once per frame.
+	/// \param uMaxNoOfBlocks The maximum number of blocks to visit during this call.
+	/// \param uMinimumAge How many block accesses must have happened since an uncompressed
+	/// block was last touched before it is considered for recompression.
+	/// \return The approximate number of bytes which were released.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t LargeVolume<VoxelType>::tidy(uint32_t uMaxNoOfBlocks, uint32_t uMinimumAge)
+	{
+		const uint32_t uUncompressedBlockSizeInBytes = m_uBlockSideLength * m_uBlockSideLength * m_uBlockSideLength * sizeof(VoxelType);
+
+		uint32_t uSizeBefore = 0;
+		uint32_t uSizeAfter = 0;
+
+		//Don't visit any block twice in one call.
+		uint32_t uNoOfBlocksToVisit = (std::min)(uMaxNoOfBlocks, static_cast<uint32_t>(m_pBlocks.size()));
+
+		typename std::map<Vector3DInt32, LoadedBlock >::iterator itBlock = m_pBlocks.lower_bound(m_v3dNextBlockToTidy);
+		for(uint32_t ct = 0; ct < uNoOfBlocksToVisit; ct++)
+		{
+			if(itBlock == m_pBlocks.end())
+			{
+				itBlock = m_pBlocks.begin();
+			}
+
+			LoadedBlock& loadedBlock = itBlock->second;
+
+			uSizeBefore += loadedBlock.block.calculateSizeInBytes();
+			if(loadedBlock.block.m_bIsCompressed == false)
+			{
+				uSizeBefore += uUncompressedBlockSizeInBytes;
+
+				//The subtraction gives the right answer even if the timestamper has wrapped around.
+				if((m_bCompressionEnabled) && (m_uTimestamper - loadedBlock.timestamp >= uMinimumAge))
+				{
+					for(uint32_t uCacheIndex = 0; uCacheIndex < m_vecUncompressedBlockCache.size(); uCacheIndex++)
+					{
+						if(m_vecUncompressedBlockCache[uCacheIndex] == &loadedBlock)
+						{
+							m_vecUncompressedBlockCache[uCacheIndex] = m_vecUncompressedBlockCache.back();
+							m_vecUncompressedBlockCache.pop_back();
+							break;
+						}
+					}
+
+					loadedBlock.block.compress();
+
+					//Make sure the next access doesn't use the stale uncompressed data.
+					if(m_pLastAccessedBlock == &(loadedBlock.block))
+					{
+						m_pLastAccessedBlock = 0;
+					}
+				}
+			}
+
+			loadedBlock.block.tidy();
+
+			uSizeAfter += loadedBlock.block.calculateSizeInBytes();
+			if(loadedBlock.block.m_bIsCompressed == false)
+			{
+				uSizeAfter += uUncompressedBlockSizeInBytes;
+			}
+
+			++itBlock;
+		}
+
+		//Remember where to carry on from next time.
+		if(itBlock == m_pBlocks.end())
+		{
+			itBlock = m_pBlocks.begin();
+		}
+		if(itBlock != m_pBlocks.end())
+		{
+			m_v3dNextBlockToTidy = itBlock->first;
+		}
+
+		//Recompression can occasionally need more space than the slack it removed.
+		return uSizeBefore > uSizeAfter ? uSizeBefore - uSizeAfter : 0;
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/// This function should probably be made internal...
 	////////////////////////////////////////////////////////////////////////////////
@@ -413,6 +581,7 @@ namespace PolyVox
 		m_uMaxNumberOfBlocksInMemory = 1024;
 		m_v3dLastAccessedBlockPos = Vector3DInt32(0,0,0); //There are no invalid positions, but initially the m_pLastAccessedBlock pointer will be null;
 		m_pLastAccessedBlock = 0;
+		m_v3dNextBlockToTidy = Vector3DInt32(0,0,0);
 		m_bCompressionEnabled = true;
 
 		this->m_regValidRegion = regValidRegion;
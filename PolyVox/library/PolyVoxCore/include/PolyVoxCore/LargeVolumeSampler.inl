@@ -258,6 +258,100 @@ namespace PolyVox
 		}
 	}
 
+	template <typename VoxelType>
+	void LargeVolume<VoxelType>::Sampler::peekNeighbourhood(VoxelType pStencil[27]) const
+	{
+		if(BORDER_LOW(this->mXPosInVolume) && BORDER_HIGH(this->mXPosInVolume) && BORDER_LOW(this->mYPosInVolume) && BORDER_HIGH(this->mYPosInVolume) && BORDER_LOW(this->mZPosInVolume) && BORDER_HIGH(this->mZPosInVolume))
+		{
+			//The whole neighbourhood is inside the current block, so every voxel is at a fixed offset from the current one.
+			const int32_t iRow = this->mVolume->m_uBlockSideLength;
+			const int32_t iSlice = iRow * iRow;
+			const VoxelType* pSlice = mCurrentVoxel - 1 - iRow - iSlice;
+			for(int32_t z = 0; z < 3; z++)
+			{
+				for(int32_t y = 0; y < 3; y++)
+				{
+					const VoxelType* pRow = pSlice + y * iRow;
+					pStencil[y * 3 + z * 9] = pRow[0];
+					pStencil[y * 3 + z * 9 + 1] = pRow[1];
+					pStencil[y * 3 + z * 9 + 2] = pRow[2];
+				}
+				pSlice += iSlice;
+			}
+		}
+		else
+		{
+			//Near a block border, so voxels in the current block are still read directly and only those in neighbouring blocks go through the volume.
+			const int32_t iRow = this->mVolume->m_uBlockSideLength;
+			const int32_t iSlice = iRow * iRow;
+			const bool bInBlockX[3] = {BORDER_LOW(this->mXPosInVolume), true, BORDER_HIGH(this->mXPosInVolume)};
+			const bool bInBlockY[3] = {BORDER_LOW(this->mYPosInVolume), true, BORDER_HIGH(this->mYPosInVolume)};
+			const bool bInBlockZ[3] = {BORDER_LOW(this->mZPosInVolume), true, BORDER_HIGH(this->mZPosInVolume)};
+			for(int32_t z = 0; z < 3; z++)
+			{
+				for(int32_t y = 0; y < 3; y++)
+				{
+					for(int32_t x = 0; x < 3; x++)
+					{
+						if(bInBlockX[x] && bInBlockY[y] && bInBlockZ[z])
+						{
+							pStencil[x + y * 3 + z * 9] = *(mCurrentVoxel + (x - 1) + (y - 1) * iRow + (z - 1) * iSlice);
+						}
+						else
+						{
+							pStencil[x + y * 3 + z * 9] = this->mVolume->getVoxelAt(this->mXPosInVolume + x - 1, this->mYPosInVolume + y - 1, this->mZPosInVolume + z - 1);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	template <typename VoxelType>
+	void LargeVolume<VoxelType>::Sampler::peekCell(VoxelType pCell[8]) const
+	{
+		if(BORDER_HIGH(this->mXPosInVolume) && BORDER_HIGH(this->mYPosInVolume) && BORDER_HIGH(this->mZPosInVolume))
+		{
+			const int32_t iRow = this->mVolume->m_uBlockSideLength;
+			const int32_t iSlice = iRow * iRow;
+			pCell[0] = mCurrentVoxel[0];
+			pCell[1] = mCurrentVoxel[1];
+			pCell[2] = mCurrentVoxel[iRow];
+			pCell[3] = mCurrentVoxel[iRow + 1];
+			pCell[4] = mCurrentVoxel[iSlice];
+			pCell[5] = mCurrentVoxel[iSlice + 1];
+			pCell[6] = mCurrentVoxel[iSlice + iRow];
+			pCell[7] = mCurrentVoxel[iSlice + iRow + 1];
+		}
+		else
+		{
+			const int32_t iRow = this->mVolume->m_uBlockSideLength;
+			const int32_t iSlice = iRow * iRow;
+			const bool bInBlockX[2] = {true, BORDER_HIGH(this->mXPosInVolume)};
+			const bool bInBlockY[2] = {true, BORDER_HIGH(this->mYPosInVolume)};
+			const bool bInBlockZ[2] = {true, BORDER_HIGH(this->mZPosInVolume)};
+			for(int32_t z = 0; z < 2; z++)
+			{
+				for(int32_t y = 0; y < 2; y++)
+				{
+					for(int32_t x = 0; x < 2; x++)
+					{
+						if(bInBlockX[x] && bInBlockY[y] && bInBlockZ[z])
+						{
+							pCell[x + y * 2 + z * 4] = *(mCurrentVoxel + x + y * iRow + z * iSlice);
+						}
+						else
+						{
+							pCell[x + y * 2 + z * 4] = this->mVolume->getVoxelAt(this->mXPosInVolume + x, this->mYPosInVolume + y, this->mZPosInVolume + z);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
 	template <typename VoxelType>
 	VoxelType LargeVolume<VoxelType>::Sampler::peekVoxel1nx1ny1nz(void) const
 	{
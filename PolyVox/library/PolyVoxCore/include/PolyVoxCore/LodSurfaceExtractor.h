@@ -0,0 +1,159 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#ifndef __PolyVox_LodSurfaceExtractor_H__
+#define __PolyVox_LodSurfaceExtractor_H__
+
+#include "PolyVoxImpl/MarchingCubesTables.h"
+#include "PolyVoxImpl/TypeDef.h"
+
+#include "PolyVoxCore/SurfaceMesh.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept> //For invalid_argument
+#include <vector>
+
+namespace PolyVox
+{
+	/// The faces of a region which border a region extracted at the next finer level of detail.
+	/// These are combined as flags and passed to the LodSurfaceExtractor.
+	enum TransitionFace
+	{
+		TransitionNegativeX = 0x01,
+		TransitionPositiveX = 0x02,
+		TransitionNegativeY = 0x04,
+		TransitionPositiveY = 0x08,
+		TransitionNegativeZ = 0x10,
+		TransitionPositiveZ = 0x20
+	};
+
+	/// The LodSurfaceExtractor generates a smooth mesh at a reduced level of detail, for regions far from the camera.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// At level zero this generates the same surface as the SurfaceExtractor. At level n it only reads every 2^n th voxel along
+	/// each axis and runs Marching Cubes on the cells between these, each of which covers 2^n voxels along each side. So the number
+	/// of triangles falls by about a factor of four for each level. As in the Transvoxel algorithm the voxels are sampled directly
+	/// rather than averaged (or taken from getSubSampledVoxel(), which returns the minimum and so erodes the surface). This means that
+	/// the corners of the cells at one level are also corners of the cells at all the finer levels. The vertices are positioned in
+	/// voxels relative to the lower corner of the region, so the meshes for different levels line up with no further scaling.
+	///
+	/// Where two neighbouring regions are extracted at different levels their meshes meet the shared face along different contours,
+	/// leaving cracks. The faces of the coarser region for which this happens should be passed as transition faces, and for each of
+	/// these the extractor also generates transition cells. Within every cell face where the two contours can differ it adds a flat
+	/// patch closing off the solid on each side of the face, i.e. its own solid at this level and its neighbour's at the next finer
+	/// level. The patches lie in the face itself and between them cover exactly the part of it where one mesh is open and the other
+	/// is not, so the seam is watertight without the finer region having to do anything special. Unlike Lengyel's transition cells
+	/// this doesn't need the regular cells next to the face to be shrunk, but the patches show up as small vertical steps wherever the
+	/// two levels disagree.
+	///
+	/// For this to work the finer region must be extracted by a LodSurfaceExtractor at the next level down (or the SurfaceExtractor
+	/// if this is level one), and its lower corner must lie on the grid of this region's cells. The region extracted here must be
+	/// a whole number of cells across, i.e. its width, height and depth (measured from the lower to the upper corner) must all be
+	/// multiples of 2^n.
+	///
+	/// \code
+	/// //The region to the right of this one is extracted at level one.
+	/// LodSurfaceExtractor<SimpleVolume, Density8> extractor(&volume, Region(Vector3DInt32(0,0,0), Vector3DInt32(32,32,32)), &mesh, 2, TransitionPositiveX);
+	/// extractor.execute();
+	/// \endcode
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	class LodSurfaceExtractor
+	{
+	public:
+		/// Holds the working buffers which are used during extraction. As with the
+		/// SurfaceExtractor, a Context can be given to each of a series of extractors
+		/// through setContext() so that they reuse the same memory. A Context must only
+		/// be used by one extractor at a time.
+		class Context
+		{
+		private:
+			friend class LodSurfaceExtractor;
+
+			//The voxels at the corners of the cells, with an extra layer all round.
+			std::vector<VoxelType> m_vecSamples;
+
+			//The vertex (if any) on the edge leading from each sample along each axis.
+			std::vector<int32_t> m_vecVertexIndices[3];
+		};
+
+		LodSurfaceExtractor(VolumeType<VoxelType>* volData, Region region, SurfaceMesh<PositionMaterialNormal>* result, uint8_t uLodLevel, uint8_t uTransitionFaces = 0);
+
+		/// Makes the extractor use the buffers held by the given Context, rather than
+		/// its own. The Context must outlive any calls to execute(). Passing null makes
+		/// the extractor go back to using its own buffers.
+		void setContext(Context* pContext);
+
+		void execute();
+
+	private:
+		//Whether the volume reports that all the voxels in the region are on the same side of the threshold.
+		bool isRegionUniform(void) const;
+
+		//Read the samples for this level, including one beyond each side of the region for the gradients.
+		void readSamples(void);
+		const VoxelType& getSample(int32_t iX, int32_t iY, int32_t iZ) const;
+		Vector3DFloat computeCentralDifferenceGradient(int32_t iX, int32_t iY, int32_t iZ) const;
+		uint8_t computeCubeIndex(int32_t iX, int32_t iY, int32_t iZ) const;
+		int32_t& getVertexIndex(uint32_t uAxis, int32_t iX, int32_t iY, int32_t iZ);
+
+		void generateVertices(void);
+		void generateIndices(void);
+
+		//Adds the transition cells for one face of the region.
+		void generateTransitionCells(uint32_t uAxis, bool bPositive);
+
+		//Finds which of the crossings on one face of a cell are joined up by the triangles
+		//for that cell, so that the patches match the surface exactly.
+		static void findFacePartners(uint8_t uCubeIndex, uint32_t uAxis, uint32_t uFaceSide, int8_t aiPartners[4]);
+
+		//Covers the solid part of a square face with triangle fans. The corners are given anticlockwise
+		//and side i runs from corner i to corner i+1, with a crossing wherever exactly one of them is solid.
+		void addFacePolygons(const bool abSolid[4], const int32_t aiCornerVertices[4], const int32_t aiCrossingVertices[4], const int8_t aiPartners[4], bool bReverse);
+
+		//The volume data.
+		VolumeType<VoxelType>* m_volData;
+
+		//The surface patch we are currently filling.
+		SurfaceMesh<PositionMaterialNormal>* m_meshCurrent;
+
+		//Information about the region we are currently processing
+		Region m_regSizeInVoxels;
+		int32_t m_aiSizeInCells[3];
+
+		uint8_t m_uLodLevel;
+		int32_t m_iStep;
+		uint8_t m_uTransitionFaces;
+
+		//The buffers used when no other context has been provided, and the ones actually in use.
+		Context m_defaultContext;
+		Context* m_pContext;
+
+		//For each edge of a cell, its axis and the offset of the corner it starts from.
+		static const uint8_t EdgeOrigins[12][4];
+	};
+}
+
+#include "PolyVoxCore/LodSurfaceExtractor.inl"
+
+#endif
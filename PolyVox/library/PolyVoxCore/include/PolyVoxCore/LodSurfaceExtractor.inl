@@ -0,0 +1,562 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+namespace PolyVox
+{
+	template< template<typename> class VolumeType, typename VoxelType>
+	const uint8_t LodSurfaceExtractor<VolumeType, VoxelType>::EdgeOrigins[12][4] =
+	{
+		{0, 0,0,0}, {1, 1,0,0}, {0, 0,1,0}, {1, 0,0,0},
+		{0, 0,0,1}, {1, 1,0,1}, {0, 0,1,1}, {1, 0,0,1},
+		{2, 0,0,0}, {2, 1,0,0}, {2, 1,1,0}, {2, 0,1,0}
+	};
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	LodSurfaceExtractor<VolumeType, VoxelType>::LodSurfaceExtractor(VolumeType<VoxelType>* volData, Region region, SurfaceMesh<PositionMaterialNormal>* result, uint8_t uLodLevel, uint8_t uTransitionFaces)
+		:m_volData(volData)
+		,m_meshCurrent(result)
+		,m_regSizeInVoxels(region)
+		,m_uLodLevel(uLodLevel)
+		,m_iStep(1)
+		,m_uTransitionFaces(uTransitionFaces)
+		,m_pContext(&m_defaultContext)
+	{
+		if(uLodLevel > 15)
+		{
+			throw std::invalid_argument("Level of detail is too coarse");
+		}
+		if((uLodLevel == 0) && (uTransitionFaces != 0))
+		{
+			throw std::invalid_argument("There is no finer level to make a transition to");
+		}
+		m_iStep = 1 << uLodLevel;
+
+		for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
+		{
+			const int32_t iSize = region.getUpperCorner().getElement(uAxis) - region.getLowerCorner().getElement(uAxis);
+			if((iSize < 0) || ((iSize % m_iStep) != 0))
+			{
+				throw std::invalid_argument("Region must be a whole number of cells across");
+			}
+			m_aiSizeInCells[uAxis] = iSize / m_iStep;
+		}
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void LodSurfaceExtractor<VolumeType, VoxelType>::setContext(Context* pContext)
+	{
+		m_pContext = (pContext != 0) ? pContext : &m_defaultContext;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void LodSurfaceExtractor<VolumeType, VoxelType>::execute()
+	{
+		m_meshCurrent->clear();
+
+		if(!isRegionUniform())
+		{
+			readSamples();
+			generateVertices();
+			generateIndices();
+
+			for(uint32_t uFace = 0; uFace < 6; uFace++)
+			{
+				if(m_uTransitionFaces & (1 << uFace))
+				{
+					generateTransitionCells(uFace / 2, (uFace % 2) != 0);
+				}
+			}
+		}
+
+		m_meshCurrent->m_Region = m_regSizeInVoxels;
+
+		m_meshCurrent->m_vecLodRecords.clear();
+		LodRecord lodRecord;
+		lodRecord.beginIndex = 0;
+		lodRecord.endIndex = m_meshCurrent->getNoOfIndices();
+		m_meshCurrent->m_vecLodRecords.push_back(lodRecord);
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	bool LodSurfaceExtractor<VolumeType, VoxelType>::isRegionUniform(void) const
+	{
+		//Both the cells and the transition cells only meet the surface where the voxels inside the region differ.
+		typename VolumeType<VoxelType>::DensityType tMin;
+		typename VolumeType<VoxelType>::DensityType tMax;
+		if(m_volData->getDensityRange(m_regSizeInVoxels, tMin, tMax))
+		{
+			return (tMin >= VoxelType::getThreshold()) || (tMax < VoxelType::getThreshold());
+		}
+
+		return false;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void LodSurfaceExtractor<VolumeType, VoxelType>::readSamples(void)
+	{
+		const Vector3DInt32& v3dLowerCorner = m_regSizeInVoxels.getLowerCorner();
+
+		m_pContext->m_vecSamples.resize((m_aiSizeInCells[0] + 3) * (m_aiSizeInCells[1] + 3) * (m_aiSizeInCells[2] + 3));
+
+		uint32_t uIndex = 0;
+		for(int32_t iZ = -1; iZ <= m_aiSizeInCells[2] + 1; iZ++)
+		{
+			for(int32_t iY = -1; iY <= m_aiSizeInCells[1] + 1; iY++)
+			{
+				for(int32_t iX = -1; iX <= m_aiSizeInCells[0] + 1; iX++)
+				{
+					m_pContext->m_vecSamples[uIndex] = m_volData->getVoxelAt(v3dLowerCorner.getX() + iX * m_iStep, v3dLowerCorner.getY() + iY * m_iStep, v3dLowerCorner.getZ() + iZ * m_iStep);
+					uIndex++;
+				}
+			}
+		}
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	const VoxelType& LodSurfaceExtractor<VolumeType, VoxelType>::getSample(int32_t iX, int32_t iY, int32_t iZ) const
+	{
+		return m_pContext->m_vecSamples[((iZ + 1) * (m_aiSizeInCells[1] + 3) + (iY + 1)) * (m_aiSizeInCells[0] + 3) + (iX + 1)];
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	Vector3DFloat LodSurfaceExtractor<VolumeType, VoxelType>::computeCentralDifferenceGradient(int32_t iX, int32_t iY, int32_t iZ) const
+	{
+		//As in the SurfaceExtractor, but with the neighbours taken a whole cell away.
+		return Vector3DFloat
+		(
+			static_cast<float>(getSample(iX - 1, iY, iZ).getDensity()) - static_cast<float>(getSample(iX + 1, iY, iZ).getDensity()),
+			static_cast<float>(getSample(iX, iY - 1, iZ).getDensity()) - static_cast<float>(getSample(iX, iY + 1, iZ).getDensity()),
+			static_cast<float>(getSample(iX, iY, iZ - 1).getDensity()) - static_cast<float>(getSample(iX, iY, iZ + 1).getDensity())
+		);
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	uint8_t LodSurfaceExtractor<VolumeType, VoxelType>::computeCubeIndex(int32_t iX, int32_t iY, int32_t iZ) const
+	{
+		//Same bit layout as the SurfaceExtractor, i.e. v000 = 1, v100 = 2, v010 = 4, ... v111 = 128.
+		uint8_t uCubeIndex = 0;
+		for(uint32_t uCorner = 0; uCorner < 8; uCorner++)
+		{
+			if(getSample(iX + (uCorner & 1), iY + ((uCorner >> 1) & 1), iZ + (uCorner >> 2)).getDensity() < VoxelType::getThreshold())
+			{
+				uCubeIndex |= 1 << uCorner;
+			}
+		}
+		return uCubeIndex;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	int32_t& LodSurfaceExtractor<VolumeType, VoxelType>::getVertexIndex(uint32_t uAxis, int32_t iX, int32_t iY, int32_t iZ)
+	{
+		return m_pContext->m_vecVertexIndices[uAxis][(iZ * (m_aiSizeInCells[1] + 1) + iY) * (m_aiSizeInCells[0] + 1) + iX];
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void LodSurfaceExtractor<VolumeType, VoxelType>::generateVertices(void)
+	{
+		const uint32_t uNoOfSamples = (m_aiSizeInCells[0] + 1) * (m_aiSizeInCells[1] + 1) * (m_aiSizeInCells[2] + 1);
+		for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
+		{
+			m_pContext->m_vecVertexIndices[uAxis].assign(uNoOfSamples, -1);
+		}
+
+		for(int32_t iZ = 0; iZ <= m_aiSizeInCells[2]; iZ++)
+		{
+			for(int32_t iY = 0; iY <= m_aiSizeInCells[1]; iY++)
+			{
+				for(int32_t iX = 0; iX <= m_aiSizeInCells[0]; iX++)
+				{
+					const VoxelType& v000 = getSample(iX, iY, iZ);
+					const bool bEmpty = v000.getDensity() < VoxelType::getThreshold();
+
+					//Each sample owns the edges leading from it in the positive direction.
+					for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
+					{
+						int32_t aiNext[3] = {iX, iY, iZ};
+						if(aiNext[uAxis] == m_aiSizeInCells[uAxis])
+						{
+							continue;
+						}
+						aiNext[uAxis]++;
+
+						const VoxelType& v100 = getSample(aiNext[0], aiNext[1], aiNext[2]);
+						if((v100.getDensity() < VoxelType::getThreshold()) == bEmpty)
+						{
+							continue;
+						}
+
+						//The position and normal are computed exactly as in the SurfaceExtractor, so that
+						//at level zero (and on the faces shared with finer regions) the vertices coincide.
+						float fInterp = static_cast<float>(VoxelType::getThreshold() - v000.getDensity()) / static_cast<float>(v100.getDensity() - v000.getDensity());
+
+						float afPosition[3] = {static_cast<float>(iX * m_iStep), static_cast<float>(iY * m_iStep), static_cast<float>(iZ * m_iStep)};
+						afPosition[uAxis] += fInterp * static_cast<float>(m_iStep);
+
+						const Vector3DFloat n000 = computeCentralDifferenceGradient(iX, iY, iZ);
+						const Vector3DFloat n100 = computeCentralDifferenceGradient(aiNext[0], aiNext[1], aiNext[2]);
+						Vector3DFloat v3dNormal = (n100*fInterp) + (n000*(1-fInterp));
+						v3dNormal.normalise();
+
+						uint32_t uMaterial = 0;
+						if(VoxelTypeTraits<VoxelType>::HasMaterial)
+						{
+							uMaterial = (std::max)(v000.getMaterial(), v100.getMaterial());
+						}
+
+						PositionMaterialNormal surfaceVertex(Vector3DFloat(afPosition[0], afPosition[1], afPosition[2]), v3dNormal, static_cast<float>(uMaterial));
+						getVertexIndex(uAxis, iX, iY, iZ) = m_meshCurrent->addVertex(surfaceVertex);
+					}
+				}
+			}
+		}
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void LodSurfaceExtractor<VolumeType, VoxelType>::generateIndices(void)
+	{
+		for(int32_t iZ = 0; iZ < m_aiSizeInCells[2]; iZ++)
+		{
+			for(int32_t iY = 0; iY < m_aiSizeInCells[1]; iY++)
+			{
+				for(int32_t iX = 0; iX < m_aiSizeInCells[0]; iX++)
+				{
+					const uint8_t uCubeIndex = computeCubeIndex(iX, iY, iZ);
+					if(edgeTable[uCubeIndex] == 0)
+					{
+						continue;
+					}
+
+					for(int i = 0; triTable[uCubeIndex][i] != -1; i += 3)
+					{
+						int32_t aiIndices[3];
+						for(int j = 0; j < 3; j++)
+						{
+							const uint8_t* pEdge = EdgeOrigins[triTable[uCubeIndex][i + j]];
+							aiIndices[j] = getVertexIndex(pEdge[0], iX + pEdge[1], iY + pEdge[2], iZ + pEdge[3]);
+							assert(aiIndices[j] != -1);
+						}
+						m_meshCurrent->addTriangle(aiIndices[0], aiIndices[1], aiIndices[2]);
+					}
+				}
+			}
+		}
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void LodSurfaceExtractor<VolumeType, VoxelType>::generateTransitionCells(uint32_t uAxis, bool bPositive)
+	{
+		//The face is the plane at iPlane (in cells) along uAxis, and uAxisB and uAxisC are the axes across it. The three
+		//form a right handed set, so going round a square in the face from +B to +C is anticlockwise when seen from +uAxis.
+		const uint32_t uAxisB = (uAxis + 1) % 3;
+		const uint32_t uAxisC = (uAxis + 2) % 3;
+		const int32_t iPlane = bPositive ? m_aiSizeInCells[uAxis] : 0;
+		const int32_t iHalfStep = m_iStep / 2;
+		const int32_t iFineWidth = 2 * m_aiSizeInCells[uAxisB] + 1;
+		const int32_t iFineHeight = 2 * m_aiSizeInCells[uAxisC] + 1;
+
+		//Read the voxels in the face at the finer level, and those half a cell beyond it. Between them these
+		//give the cells of the neighbouring region which touch the face.
+		std::vector<VoxelType> vecFace(iFineWidth * iFineHeight);
+		std::vector<VoxelType> vecBeyond(iFineWidth * iFineHeight);
+		for(int32_t iV = 0; iV < iFineHeight; iV++)
+		{
+			for(int32_t iU = 0; iU < iFineWidth; iU++)
+			{
+				int32_t aiPos[3];
+				aiPos[uAxis] = m_regSizeInVoxels.getLowerCorner().getElement(uAxis) + iPlane * m_iStep;
+				aiPos[uAxisB] = m_regSizeInVoxels.getLowerCorner().getElement(uAxisB) + iU * iHalfStep;
+				aiPos[uAxisC] = m_regSizeInVoxels.getLowerCorner().getElement(uAxisC) + iV * iHalfStep;
+				vecFace[iV * iFineWidth + iU] = m_volData->getVoxelAt(aiPos[0], aiPos[1], aiPos[2]);
+
+				aiPos[uAxis] += bPositive ? iHalfStep : -iHalfStep;
+				vecBeyond[iV * iFineWidth + iU] = m_volData->getVoxelAt(aiPos[0], aiPos[1], aiPos[2]);
+			}
+		}
+
+		//The patch for this region's solid faces out of the region, and the one for the neighbour's faces into it.
+		Vector3DFloat v3dOutwards(0.0f, 0.0f, 0.0f);
+		v3dOutwards.setElement(uAxis, bPositive ? 1.0f : -1.0f);
+		const Vector3DFloat v3dInwards = v3dOutwards * -1.0f;
+
+		std::vector<int32_t> vecCoarseCorners((m_aiSizeInCells[uAxisB] + 1) * (m_aiSizeInCells[uAxisC] + 1), -1);
+		std::vector<int32_t> vecFineCorners(iFineWidth * iFineHeight, -1);
+		std::vector<int32_t> vecFineEdges[2];
+		vecFineEdges[0].assign(iFineWidth * iFineHeight, -1);
+		vecFineEdges[1].assign(iFineWidth * iFineHeight, -1);
+
+		static const int32_t aiCornerOffsets[4][2] = {{0,0}, {1,0}, {1,1}, {0,1}};
+		//The axis (0 for B, 1 for C) of each side of a square, and the offset of the corner it starts from.
+		static const int32_t aiSideOrigins[4][3] = {{0, 0,0}, {1, 1,0}, {0, 0,1}, {1, 0,0}};
+
+		bool abSolid[4];
+		int32_t aiCornerVertices[4];
+		int32_t aiCrossingVertices[4];
+		int8_t aiPartners[4];
+
+		for(int32_t iV = 0; iV < m_aiSizeInCells[uAxisC]; iV++)
+		{
+			for(int32_t iU = 0; iU < m_aiSizeInCells[uAxisB]; iU++)
+			{
+				//The two contours can only differ where the voxels in this part of the face do.
+				const bool bFirstEmpty = vecFace[(2 * iV) * iFineWidth + (2 * iU)].getDensity() < VoxelType::getThreshold();
+				bool bUniform = true;
+				for(int32_t iFineV = 2 * iV; iFineV <= 2 * iV + 2; iFineV++)
+				{
+					for(int32_t iFineU = 2 * iU; iFineU <= 2 * iU + 2; iFineU++)
+					{
+						if((vecFace[iFineV * iFineWidth + iFineU].getDensity() < VoxelType::getThreshold()) != bFirstEmpty)
+						{
+							bUniform = false;
+						}
+					}
+				}
+				if(bUniform)
+				{
+					continue;
+				}
+
+				//Patch over this region's own solid. The crossings are the vertices already generated for the cell next to the face.
+				int32_t aiCell[3];
+				aiCell[uAxis] = bPositive ? iPlane - 1 : 0;
+				aiCell[uAxisB] = iU;
+				aiCell[uAxisC] = iV;
+				findFacePartners(computeCubeIndex(aiCell[0], aiCell[1], aiCell[2]), uAxis, bPositive ? 1 : 0, aiPartners);
+
+				for(uint32_t uCorner = 0; uCorner < 4; uCorner++)
+				{
+					int32_t aiSample[3];
+					aiSample[uAxis] = iPlane;
+					aiSample[uAxisB] = iU + aiCornerOffsets[uCorner][0];
+					aiSample[uAxisC] = iV + aiCornerOffsets[uCorner][1];
+					const VoxelType& voxel = getSample(aiSample[0], aiSample[1], aiSample[2]);
+					abSolid[uCorner] = voxel.getDensity() >= VoxelType::getThreshold();
+
+					int32_t& iCornerVertex = vecCoarseCorners[aiSample[uAxisC] * (m_aiSizeInCells[uAxisB] + 1) + aiSample[uAxisB]];
+					if(abSolid[uCorner] && (iCornerVertex == -1))
+					{
+						uint32_t uMaterial = 0;
+						if(VoxelTypeTraits<VoxelType>::HasMaterial)
+						{
+							uMaterial = voxel.getMaterial();
+						}
+						const Vector3DFloat v3dPosition(static_cast<float>(aiSample[0] * m_iStep), static_cast<float>(aiSample[1] * m_iStep), static_cast<float>(aiSample[2] * m_iStep));
+						iCornerVertex = m_meshCurrent->addVertex(PositionMaterialNormal(v3dPosition, v3dOutwards, static_cast<float>(uMaterial)));
+					}
+					aiCornerVertices[uCorner] = iCornerVertex;
+				}
+
+				for(uint32_t uSide = 0; uSide < 4; uSide++)
+				{
+					aiCrossingVertices[uSide] = -1;
+					if(abSolid[uSide] != abSolid[(uSide + 1) % 4])
+					{
+						int32_t aiSample[3];
+						aiSample[uAxis] = iPlane;
+						aiSample[uAxisB] = iU + aiSideOrigins[uSide][1];
+						aiSample[uAxisC] = iV + aiSideOrigins[uSide][2];
+						aiCrossingVertices[uSide] = getVertexIndex((aiSideOrigins[uSide][0] == 0) ? uAxisB : uAxisC, aiSample[0], aiSample[1], aiSample[2]);
+					}
+				}
+
+				addFacePolygons(abSolid, aiCornerVertices, aiCrossingVertices, aiPartners, !bPositive);
+
+				//Patch over the neighbour's solid, one of its cells at a time. Its vertices are
+				//positioned exactly as the extractor for the neighbouring region will do it.
+				for(int32_t iFineV = 2 * iV; iFineV < 2 * iV + 2; iFineV++)
+				{
+					for(int32_t iFineU = 2 * iU; iFineU < 2 * iU + 2; iFineU++)
+					{
+						uint8_t uCubeIndex = 0;
+						for(uint32_t uCorner = 0; uCorner < 8; uCorner++)
+						{
+							int32_t aiOffset[3] = {static_cast<int32_t>(uCorner & 1), static_cast<int32_t>((uCorner >> 1) & 1), static_cast<int32_t>(uCorner >> 2)};
+							const bool bInFace = (aiOffset[uAxis] == (bPositive ? 0 : 1));
+							const VoxelType& voxel = (bInFace ? vecFace : vecBeyond)[(iFineV + aiOffset[uAxisC]) * iFineWidth + (iFineU + aiOffset[uAxisB])];
+							if(voxel.getDensity() < VoxelType::getThreshold())
+							{
+								uCubeIndex |= 1 << uCorner;
+							}
+						}
+						findFacePartners(uCubeIndex, uAxis, bPositive ? 0 : 1, aiPartners);
+
+						for(uint32_t uCorner = 0; uCorner < 4; uCorner++)
+						{
+							const int32_t iSampleU = iFineU + aiCornerOffsets[uCorner][0];
+							const int32_t iSampleV = iFineV + aiCornerOffsets[uCorner][1];
+							const VoxelType& voxel = vecFace[iSampleV * iFineWidth + iSampleU];
+							abSolid[uCorner] = voxel.getDensity() >= VoxelType::getThreshold();
+
+							int32_t& iCornerVertex = vecFineCorners[iSampleV * iFineWidth + iSampleU];
+							if(abSolid[uCorner] && (iCornerVertex == -1))
+							{
+								uint32_t uMaterial = 0;
+								if(VoxelTypeTraits<VoxelType>::HasMaterial)
+								{
+									uMaterial = voxel.getMaterial();
+								}
+								float afPosition[3];
+								afPosition[uAxis] = static_cast<float>(iPlane * m_iStep);
+								afPosition[uAxisB] = static_cast<float>(iSampleU * iHalfStep);
+								afPosition[uAxisC] = static_cast<float>(iSampleV * iHalfStep);
+								iCornerVertex = m_meshCurrent->addVertex(PositionMaterialNormal(Vector3DFloat(afPosition[0], afPosition[1], afPosition[2]), v3dInwards, static_cast<float>(uMaterial)));
+							}
+							aiCornerVertices[uCorner] = iCornerVertex;
+						}
+
+						for(uint32_t uSide = 0; uSide < 4; uSide++)
+						{
+							aiCrossingVertices[uSide] = -1;
+							if(abSolid[uSide] == abSolid[(uSide + 1) % 4])
+							{
+								continue;
+							}
+
+							const int32_t iEdgeAxis = aiSideOrigins[uSide][0];
+							const int32_t iOriginU = iFineU + aiSideOrigins[uSide][1];
+							const int32_t iOriginV = iFineV + aiSideOrigins[uSide][2];
+							int32_t& iCrossingVertex = vecFineEdges[iEdgeAxis][iOriginV * iFineWidth + iOriginU];
+							if(iCrossingVertex == -1)
+							{
+								const VoxelType& v000 = vecFace[iOriginV * iFineWidth + iOriginU];
+								const VoxelType& v100 = vecFace[(iOriginV + iEdgeAxis) * iFineWidth + (iOriginU + 1 - iEdgeAxis)];
+								float fInterp = static_cast<float>(VoxelType::getThreshold() - v000.getDensity()) / static_cast<float>(v100.getDensity() - v000.getDensity());
+
+								float afPosition[3];
+								afPosition[uAxis] = static_cast<float>(iPlane * m_iStep);
+								afPosition[uAxisB] = static_cast<float>(iOriginU * iHalfStep);
+								afPosition[uAxisC] = static_cast<float>(iOriginV * iHalfStep);
+								afPosition[(iEdgeAxis == 0) ? uAxisB : uAxisC] += fInterp * static_cast<float>(iHalfStep);
+
+								uint32_t uMaterial = 0;
+								if(VoxelTypeTraits<VoxelType>::HasMaterial)
+								{
+									uMaterial = (std::max)(v000.getMaterial(), v100.getMaterial());
+								}
+								iCrossingVertex = m_meshCurrent->addVertex(PositionMaterialNormal(Vector3DFloat(afPosition[0], afPosition[1], afPosition[2]), v3dInwards, static_cast<float>(uMaterial)));
+							}
+							aiCrossingVertices[uSide] = iCrossingVertex;
+						}
+
+						addFacePolygons(abSolid, aiCornerVertices, aiCrossingVertices, aiPartners, bPositive);
+					}
+				}
+			}
+		}
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void LodSurfaceExtractor<VolumeType, VoxelType>::findFacePartners(uint8_t uCubeIndex, uint32_t uAxis, uint32_t uFaceSide, int8_t aiPartners[4])
+	{
+		const uint32_t uAxisB = (uAxis + 1) % 3;
+		const uint32_t uAxisC = (uAxis + 2) % 3;
+
+		//Work out which side of the face (if any) each edge of the cell lies on.
+		int8_t aiEdgeSides[12];
+		for(uint32_t uEdge = 0; uEdge < 12; uEdge++)
+		{
+			const uint8_t* pEdge = EdgeOrigins[uEdge];
+			if((pEdge[0] == uAxis) || (pEdge[1 + uAxis] != uFaceSide))
+			{
+				aiEdgeSides[uEdge] = -1;
+			}
+			else if(pEdge[0] == uAxisB)
+			{
+				aiEdgeSides[uEdge] = (pEdge[1 + uAxisC] == 0) ? 0 : 2;
+			}
+			else
+			{
+				aiEdgeSides[uEdge] = (pEdge[1 + uAxisB] == 0) ? 3 : 1;
+			}
+		}
+
+		//No triangle lies in a face of its cell, so those sides of triangles which do are the contour in that face.
+		for(uint32_t uSide = 0; uSide < 4; uSide++)
+		{
+			aiPartners[uSide] = -1;
+		}
+		for(int i = 0; triTable[uCubeIndex][i] != -1; i += 3)
+		{
+			for(int j = 0; j < 3; j++)
+			{
+				const int8_t iSide0 = aiEdgeSides[triTable[uCubeIndex][i + j]];
+				const int8_t iSide1 = aiEdgeSides[triTable[uCubeIndex][i + (j + 1) % 3]];
+				if((iSide0 != -1) && (iSide1 != -1))
+				{
+					aiPartners[iSide0] = iSide1;
+					aiPartners[iSide1] = iSide0;
+				}
+			}
+		}
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void LodSurfaceExtractor<VolumeType, VoxelType>::addFacePolygons(const bool abSolid[4], const int32_t aiCornerVertices[4], const int32_t aiCrossingVertices[4], const int8_t aiPartners[4], bool bReverse)
+	{
+		//Walk anticlockwise round the edge of each solid piece, following the contour across the square
+		//wherever it meets a crossing. Each piece is convex (it is the square with some corners cut off)
+		//and has at most six vertices.
+		bool abVisited[4] = {false, false, false, false};
+		for(uint32_t uStart = 0; uStart < 4; uStart++)
+		{
+			if((!abSolid[uStart]) || abVisited[uStart])
+			{
+				continue;
+			}
+
+			int32_t aiPolygon[8];
+			uint32_t uNoOfVertices = 0;
+			uint32_t uCorner = uStart;
+			do
+			{
+				abVisited[uCorner] = true;
+				aiPolygon[uNoOfVertices++] = aiCornerVertices[uCorner];
+
+				if(abSolid[(uCorner + 1) % 4])
+				{
+					uCorner = (uCorner + 1) % 4;
+				}
+				else
+				{
+					const int8_t iOtherSide = aiPartners[uCorner];
+					assert((iOtherSide != -1) && (!abSolid[iOtherSide]) && abSolid[(iOtherSide + 1) % 4]);
+					aiPolygon[uNoOfVertices++] = aiCrossingVertices[uCorner];
+					aiPolygon[uNoOfVertices++] = aiCrossingVertices[iOtherSide];
+					uCorner = (iOtherSide + 1) % 4;
+				}
+			}
+			while(uCorner != uStart);
+
+			for(uint32_t uVertex = 1; uVertex + 1 < uNoOfVertices; uVertex++)
+			{
+				if(bReverse)
+				{
+					m_meshCurrent->addTriangle(aiPolygon[0], aiPolygon[uVertex + 1], aiPolygon[uVertex]);
+				}
+				else
+				{
+					m_meshCurrent->addTriangle(aiPolygon[0], aiPolygon[uVertex], aiPolygon[uVertex + 1]);
+				}
+			}
+		}
+	}
+}
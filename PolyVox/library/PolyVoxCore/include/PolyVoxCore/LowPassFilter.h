@@ -24,9 +24,12 @@ freely, subject to the following restrictions:
 #ifndef __PolyVox_LowPassFilter_H__
 #define __PolyVox_LowPassFilter_H__
 
-#include "PolyVoxCore/IteratorController.h"
 #include "PolyVoxCore/RawVolume.h" //Is this desirable?
 #include "PolyVoxCore/Region.h"
+#include "PolyVoxCore/SpanIterator.h"
+
+#include <algorithm>
+#include <vector>
 
 namespace PolyVox
 {
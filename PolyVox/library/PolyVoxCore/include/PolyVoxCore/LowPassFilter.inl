@@ -54,65 +54,84 @@ namespace PolyVox
 		int32_t iSrcMaxY = m_regSrc.getUpperCorner().getY();
 		int32_t iSrcMaxZ = m_regSrc.getUpperCorner().getZ();
 
-		int32_t iDstMinX = m_regDst.getLowerCorner().getX();
-		int32_t iDstMinY = m_regDst.getLowerCorner().getY();
-		int32_t iDstMinZ = m_regDst.getLowerCorner().getZ();
+		const int32_t iWidth = iSrcMaxX - iSrcMinX + 1;
 
-		//int32_t iDstMaxX = m_regDst.getUpperCorner().getX();
-		//int32_t iDstMaxY = m_regDst.getUpperCorner().getY();
-		//int32_t iDstMaxZ = m_regDst.getUpperCorner().getZ();
+		//The 3x3x3 box filter is separable. For each row we first sum the densities of the nine source rows around it
+		//into columns, and each output voxel is then the sum of three neighbouring columns. The columns extend one voxel
+		//beyond each end of the row.
+		std::vector<uint32_t> vecColumnSums(iWidth + 2);
+		std::vector<VoxelType> vecCentreRow(iWidth);
 
-		typename SrcVolumeType<VoxelType>::Sampler srcSampler(m_pVolSrc);
+		typename SrcVolumeType<VoxelType>::DensityType tMin;
+		typename SrcVolumeType<VoxelType>::DensityType tMax;
 
-		for(int32_t iSrcZ = iSrcMinZ, iDstZ = iDstMinZ; iSrcZ <= iSrcMaxZ; iSrcZ++, iDstZ++)
+		for(int32_t iSrcZ = iSrcMinZ; iSrcZ <= iSrcMaxZ; iSrcZ++)
 		{
-			for(int32_t iSrcY = iSrcMinY, iDstY = iDstMinY; iSrcY <= iSrcMaxY; iSrcY++, iDstY++)
+			for(int32_t iSrcY = iSrcMinY; iSrcY <= iSrcMaxY; iSrcY++)
 			{
-				for(int32_t iSrcX = iSrcMinX, iDstX = iDstMinX; iSrcX <= iSrcMaxX; iSrcX++, iDstX++)
+				Region regSrcRows(Vector3DInt32(iSrcMinX - 1, iSrcY - 1, iSrcZ - 1), Vector3DInt32(iSrcMaxX + 1, iSrcY + 1, iSrcZ + 1));
+				Region regDstRow(Vector3DInt32(iSrcMinX, iSrcY, iSrcZ), Vector3DInt32(iSrcMaxX, iSrcY, iSrcZ));
+
+				//If every voxel around the row has the same density then averaging them gives that density
+				//back again. The output voxels are then the same as the input ones, so the row is just copied.
+				if(m_pVolSrc->getDensityRange(regSrcRows, tMin, tMax) && (tMin == tMax))
+				{
+					for(ConstSpanIterator<SrcVolumeType, VoxelType> srcIter(m_pVolSrc, regDstRow); srcIter.isValid(); srcIter.moveForward())
+					{
+						std::copy(srcIter.getSpan(), srcIter.getSpan() + srcIter.getLength(), vecCentreRow.begin() + (srcIter.getPosX() - iSrcMinX));
+					}
+
+					for(SpanIterator<DestVolumeType, VoxelType> dstIter(m_pVolDst, regDstRow); dstIter.isValid(); dstIter.moveForward())
+					{
+						std::copy(vecCentreRow.begin() + (dstIter.getPosX() - iSrcMinX), vecCentreRow.begin() + (dstIter.getPosX() - iSrcMinX + dstIter.getLength()), dstIter.getSpan());
+					}
+					continue;
+				}
+
+				std::fill(vecColumnSums.begin(), vecColumnSums.end(), 0);
+
+				for(ConstSpanIterator<SrcVolumeType, VoxelType> srcIter(m_pVolSrc, regSrcRows); srcIter.isValid(); srcIter.moveForward())
+				{
+					const VoxelType* pSrc = srcIter.getSpan();
+					const int32_t iLength = srcIter.getLength();
+					uint32_t* pColumnSums = &(vecColumnSums[srcIter.getPosX() - (iSrcMinX - 1)]);
+					for(int32_t i = 0; i < iLength; i++)
+					{
+						pColumnSums[i] += pSrc[i].getDensity();
+					}
+
+					//The materials of the output come from the centre row.
+					if((srcIter.getPosY() == iSrcY) && (srcIter.getPosZ() == iSrcZ))
+					{
+						const int32_t iBegin = (std::max)(srcIter.getPosX(), iSrcMinX);
+						const int32_t iEnd = (std::min)(srcIter.getPosX() + iLength, iSrcMaxX + 1);
+						for(int32_t iX = iBegin; iX < iEnd; iX++)
+						{
+							vecCentreRow[iX - iSrcMinX] = pSrc[iX - srcIter.getPosX()];
+						}
+					}
+				}
+
+				for(SpanIterator<DestVolumeType, VoxelType> dstIter(m_pVolDst, regDstRow); dstIter.isValid(); dstIter.moveForward())
 				{
-					//VoxelType tSrcVoxel = m_pVolSrc->getVoxelAt(iSrcX, iSrcY, iSrcZ);
-					srcSampler.setPosition(iSrcX, iSrcY, iSrcZ);
-
-					VoxelType tSrcVoxel = srcSampler.getVoxel();
-
-					uint32_t uDensity = 0;
-					uDensity += srcSampler.peekVoxel1nx1ny1nz().getDensity();
-					uDensity += srcSampler.peekVoxel1nx1ny0pz().getDensity();
-					uDensity += srcSampler.peekVoxel1nx1ny1pz().getDensity();
-					uDensity += srcSampler.peekVoxel1nx0py1nz().getDensity();
-					uDensity += srcSampler.peekVoxel1nx0py0pz().getDensity();
-					uDensity += srcSampler.peekVoxel1nx0py1pz().getDensity();
-					uDensity += srcSampler.peekVoxel1nx1py1nz().getDensity();
-					uDensity += srcSampler.peekVoxel1nx1py0pz().getDensity();
-					uDensity += srcSampler.peekVoxel1nx1py1pz().getDensity();
-
-					uDensity += srcSampler.peekVoxel0px1ny1nz().getDensity();
-					uDensity += srcSampler.peekVoxel0px1ny0pz().getDensity();
-					uDensity += srcSampler.peekVoxel0px1ny1pz().getDensity();
-					uDensity += srcSampler.peekVoxel0px0py1nz().getDensity();
-					uDensity += srcSampler.peekVoxel0px0py0pz().getDensity();
-					uDensity += srcSampler.peekVoxel0px0py1pz().getDensity();
-					uDensity += srcSampler.peekVoxel0px1py1nz().getDensity();
-					uDensity += srcSampler.peekVoxel0px1py0pz().getDensity();
-					uDensity += srcSampler.peekVoxel0px1py1pz().getDensity();
-
-					uDensity += srcSampler.peekVoxel1px1ny1nz().getDensity();
-					uDensity += srcSampler.peekVoxel1px1ny0pz().getDensity();
-					uDensity += srcSampler.peekVoxel1px1ny1pz().getDensity();
-					uDensity += srcSampler.peekVoxel1px0py1nz().getDensity();
-					uDensity += srcSampler.peekVoxel1px0py0pz().getDensity();
-					uDensity += srcSampler.peekVoxel1px0py1pz().getDensity();
-					uDensity += srcSampler.peekVoxel1px1py1nz().getDensity();
-					uDensity += srcSampler.peekVoxel1px1py0pz().getDensity();
-					uDensity += srcSampler.peekVoxel1px1py1pz().getDensity();
-
-					uDensity /= 27;
-
-					tSrcVoxel.setDensity(uDensity);
-					m_pVolDst->setVoxelAt(iSrcX, iSrcY, iSrcZ, tSrcVoxel);
+					VoxelType* pDst = dstIter.getSpan();
+					const int32_t iOffset = dstIter.getPosX() - iSrcMinX;
+					for(int32_t i = 0; i < dstIter.getLength(); i++)
+					{
+						uint32_t uDensity = vecColumnSums[iOffset + i] + vecColumnSums[iOffset + i + 1] + vecColumnSums[iOffset + i + 2];
+
+						uDensity /= 27;
+
+						VoxelType tSrcVoxel = vecCentreRow[iOffset + i];
+						tSrcVoxel.setDensity(uDensity);
+						pDst[i] = tSrcVoxel;
+					}
 				}
 			}
 		}
+
+		//The output was written through spans, which the destination can't keep track of.
+		m_pVolDst->recalculateDensityRanges();
 	}
 
 	template< template<typename> class SrcVolumeType, template<typename> class DestVolumeType, typename VoxelType>
@@ -127,86 +146,52 @@ namespace PolyVox
 		//densities and with both integral and floating point input volumes.
 		RawVolume<float> satVolume(Region(satLowerCorner, satUpperCorner));
 
-		//Clear to zeros (necessary?)
-		//FIXME - use Volume::fill() method. Implemented in base class as below
-		//but with optimised implementations in subclasses?
-		for(int32_t z = satLowerCorner.getZ(); z <= satUpperCorner.getZ(); z++)
+		const int32_t satWidth = satUpperCorner.getX() - satLowerCorner.getX() + 1;
+
+		//Build SAT in three passes. The first sums along each row, reading the
+		//source a run at a time. The sum restarts at the beginning of each row.
+		std::vector<float> vecRowSums(satWidth);
+		for(SpanIterator<RawVolume, float> satIter(&satVolume, Region(satLowerCorner, satUpperCorner)); satIter.isValid(); satIter.moveForward())
 		{
-			for(int32_t y = satLowerCorner.getY(); y <= satUpperCorner.getY(); y++)
+			float previousSum = 0.0f;
+			Region regSrcRow(Vector3DInt32(satIter.getPosX(), satIter.getPosY(), satIter.getPosZ()), Vector3DInt32(satIter.getPosX() + satIter.getLength() - 1, satIter.getPosY(), satIter.getPosZ()));
+			for(ConstSpanIterator<SrcVolumeType, VoxelType> srcIter(m_pVolSrc, regSrcRow); srcIter.isValid(); srcIter.moveForward())
 			{
-				for(int32_t x = satLowerCorner.getX(); x <= satUpperCorner.getX(); x++)
+				const VoxelType* pSrc = srcIter.getSpan();
+				float* pSat = satIter.getSpan() + (srcIter.getPosX() - satIter.getPosX());
+				for(int32_t i = 0; i < srcIter.getLength(); i++)
 				{
-					satVolume.setVoxelAt(x,y,z,0);
+					previousSum += static_cast<float>(pSrc[i].getDensity());
+					pSat[i] = previousSum;
 				}
 			}
 		}
 
-		RawVolume<float>::Sampler satVolumeIter(&satVolume);
-
-		IteratorController<RawVolume<float>::Sampler> satIterCont;
-		satIterCont.m_regValid = Region(satLowerCorner, satUpperCorner);
-		satIterCont.m_Iter = &satVolumeIter;
-		satIterCont.reset();
-
-		typename SrcVolumeType<VoxelType>::Sampler srcVolumeIter(m_pVolSrc);
-
-		IteratorController<typename SrcVolumeType<VoxelType>::Sampler> srcIterCont;
-		srcIterCont.m_regValid = Region(satLowerCorner, satUpperCorner);
-		srcIterCont.m_Iter = &srcVolumeIter;
-		srcIterCont.reset();
-
-		do
+		//The second and third passes add each row to the one after it, first along y and then along z. The
+		//first row in each direction has nothing before it so is left as it is.
+		for(SpanIterator<RawVolume, float> satIter(&satVolume, Region(satLowerCorner + Vector3DInt32(0, 1, 0), satUpperCorner)); satIter.isValid(); satIter.moveForward())
 		{
-			float previousSum = satVolumeIter.peekVoxel1nx0py0pz();
-
-			float currentVal = static_cast<float>(srcVolumeIter.getVoxel().getDensity());
-
-			satVolumeIter.setVoxel(previousSum + currentVal);
-
-			srcIterCont.moveForward();
-
-		}while(satIterCont.moveForward());
+			int32_t iPreviousLength;
+			const float* pPrevious = satVolume.getSpanAt(satIter.getPosX(), satIter.getPosY() - 1, satIter.getPosZ(), satIter.getLength(), iPreviousLength);
+			assert(iPreviousLength == satIter.getLength());
 
-		//Build SAT in three passes
-		/*for(int32_t z = satLowerCorner.getZ(); z <= satUpperCorner.getZ(); z++)
-		{
-			for(int32_t y = satLowerCorner.getY(); y <= satUpperCorner.getY(); y++)
+			float* pCurrent = satIter.getSpan();
+			for(int32_t i = 0; i < satIter.getLength(); i++)
 			{
-				for(int32_t x = satLowerCorner.getX(); x <= satUpperCorner.getX(); x++)
-				{
-					uint32_t previousSum = satVolume.getVoxelAt(x-1,y,z);
-					uint32_t currentVal = m_pVolSrc->getVoxelAt(x,y,z).getDensity();
-
-					satVolume.setVoxelAt(x,y,z,previousSum + currentVal);
-				}
-			}
-		}*/
-
-		for(int32_t z = satLowerCorner.getZ(); z <= satUpperCorner.getZ(); z++)
-		{
-			for(int32_t y = satLowerCorner.getY(); y <= satUpperCorner.getY(); y++)
-			{
-				for(int32_t x = satLowerCorner.getX(); x <= satUpperCorner.getX(); x++)
-				{
-					float previousSum = satVolume.getVoxelAt(x,y-1,z);
-					float currentSum = satVolume.getVoxelAt(x,y,z);
-
-					satVolume.setVoxelAt(x,y,z,previousSum + currentSum);
-				}
+				pCurrent[i] += pPrevious[i];
 			}
 		}
 
-		for(int32_t z = satLowerCorner.getZ(); z <= satUpperCorner.getZ(); z++)
+		for(SpanIterator<RawVolume, float> satIter(&satVolume, Region(satLowerCorner + Vector3DInt32(0, 0, 1), satUpperCorner)); satIter.isValid(); satIter.moveForward())
 		{
-			for(int32_t y = satLowerCorner.getY(); y <= satUpperCorner.getY(); y++)
-			{
-				for(int32_t x = satLowerCorner.getX(); x <= satUpperCorner.getX(); x++)
-				{
-					float previousSum = satVolume.getVoxelAt(x,y,z-1);
-					float currentSum = satVolume.getVoxelAt(x,y,z);
+			int32_t iPreviousLength;
+			const float* pPrevious = satVolume.getSpanAt(satIter.getPosX(), satIter.getPosY(), satIter.getPosZ() - 1, satIter.getLength(), iPreviousLength);
+			assert(iPreviousLength == satIter.getLength());
 
-					satVolume.setVoxelAt(x,y,z,previousSum + currentSum);
-				}
+			float* pCurrent = satIter.getSpan();
+			for(int32_t i = 0; i < satIter.getLength(); i++)
+			{
+				pCurrent[i] += pPrevious[i];
 			}
 		}
 
@@ -215,55 +200,92 @@ namespace PolyVox
 		const Vector3DInt32& v3dDestUpperCorner = m_regDst.getUpperCorner();
 
 		const Vector3DInt32& v3dSrcLowerCorner = m_regSrc.getLowerCorner();
-		const Vector3DInt32& v3dSrcUpperCorner = m_regSrc.getUpperCorner();
+
+		const int32_t iDstWidth = v3dDestUpperCorner.getX() - v3dDestLowerCorner.getX() + 1;
+
+		const uint32_t sideLength = border * 2 + 1;
+
+		//Each output row needs four rows of the SAT. These are copied into buffers which start one voxel before
+		//the SAT does, because the lower corner of the kernel falls just outside it. Entries outside the SAT are zero,
+		//as they would be if read from the volume.
+		const int32_t iSatRowLength = (std::max)(satWidth, iDstWidth + static_cast<int32_t>(border * 2)) + 1;
+		std::vector<float> vecSatRows[4];
+		for(uint32_t uRow = 0; uRow < 4; uRow++)
+		{
+			vecSatRows[uRow].resize(iSatRowLength);
+		}
+		std::vector<VoxelType> vecSrcRow(iDstWidth);
 
 		for(int32_t iDstZ = v3dDestLowerCorner.getZ(), iSrcZ = v3dSrcLowerCorner.getZ(); iDstZ <= v3dDestUpperCorner.getZ(); iDstZ++, iSrcZ++)
 		{
 			for(int32_t iDstY = v3dDestLowerCorner.getY(), iSrcY = v3dSrcLowerCorner.getY(); iDstY <= v3dDestUpperCorner.getY(); iDstY++, iSrcY++)
 			{
-				for(int32_t iDstX = v3dDestLowerCorner.getX(), iSrcX = v3dSrcLowerCorner.getX(); iDstX <= v3dDestUpperCorner.getX(); iDstX++, iSrcX++)
+				const int32_t satLowerY = iSrcY - border - 1;
+				const int32_t satLowerZ = iSrcZ - border - 1;
+				const int32_t satUpperY = iSrcY + border;
+				const int32_t satUpperZ = iSrcZ + border;
+
+				const int32_t satRowY[4] = {satLowerY, satUpperY, satLowerY, satUpperY};
+				const int32_t satRowZ[4] = {satLowerZ, satLowerZ, satUpperZ, satUpperZ};
+				for(uint32_t uRow = 0; uRow < 4; uRow++)
 				{
-					int32_t satLowerX = iSrcX - border - 1;
-					int32_t satLowerY = iSrcY - border - 1;
-					int32_t satLowerZ = iSrcZ - border - 1;
-
-					int32_t satUpperX = iSrcX + border;
-					int32_t satUpperY = iSrcY + border;
-					int32_t satUpperZ = iSrcZ + border;
-
-					float a = satVolume.getVoxelAt(satLowerX,satLowerY,satLowerZ);
-					float b = satVolume.getVoxelAt(satUpperX,satLowerY,satLowerZ);
-					float c = satVolume.getVoxelAt(satLowerX,satUpperY,satLowerZ);
-					float d = satVolume.getVoxelAt(satUpperX,satUpperY,satLowerZ);
-					float e = satVolume.getVoxelAt(satLowerX,satLowerY,satUpperZ);
-					float f = satVolume.getVoxelAt(satUpperX,satLowerY,satUpperZ);
-					float g = satVolume.getVoxelAt(satLowerX,satUpperY,satUpperZ);
-					float h = satVolume.getVoxelAt(satUpperX,satUpperY,satUpperZ);
-
-					float sum = h+c-d-g-f-a+b+e;
-
-					uint32_t sideLength = border * 2 + 1;
+					float* pSatRow = &(vecSatRows[uRow][0]);
+					std::fill(pSatRow, pSatRow + iSatRowLength, 0.0f);
+
+					int32_t iLength;
+					const float* pSat = satVolume.getSpanAt(satLowerCorner.getX(), satRowY[uRow], satRowZ[uRow], satWidth, iLength);
+					if(pSat)
+					{
+						assert(iLength == satWidth);
+						std::copy(pSat, pSat + satWidth, pSatRow + 1);
+					}
+				}
 
-					float average = sum / (static_cast<float>(sideLength*sideLength*sideLength));
+				Region regRow(Vector3DInt32(v3dDestLowerCorner.getX(), iDstY, iDstZ), Vector3DInt32(v3dDestUpperCorner.getX(), iDstY, iDstZ));
+				for(ConstSpanIterator<SrcVolumeType, VoxelType> srcIter(m_pVolSrc, regRow); srcIter.isValid(); srcIter.moveForward())
+				{
+					std::copy(srcIter.getSpan(), srcIter.getSpan() + srcIter.getLength(), vecSrcRow.begin() + (srcIter.getPosX() - v3dDestLowerCorner.getX()));
+				}
 
-					VoxelType voxel = m_pVolSrc->getVoxelAt(iDstX, iDstY, iDstZ);
+				const float* pLowerYLowerZ = &(vecSatRows[0][0]);
+				const float* pUpperYLowerZ = &(vecSatRows[1][0]);
+				const float* pLowerYUpperZ = &(vecSatRows[2][0]);
+				const float* pUpperYUpperZ = &(vecSatRows[3][0]);
 
-					voxel.setDensity(static_cast<typename VoxelType::DensityType>(average));
+				for(SpanIterator<DestVolumeType, VoxelType> dstIter(m_pVolDst, regRow); dstIter.isValid(); dstIter.moveForward())
+				{
+					VoxelType* pDst = dstIter.getSpan();
+					const int32_t iOffset = dstIter.getPosX() - v3dDestLowerCorner.getX();
+					for(int32_t i = 0; i < dstIter.getLength(); i++)
+					{
+						//Index of the lower corner of the kernel in the row buffers.
+						const int32_t satLowerX = iOffset + i;
+						const int32_t satUpperX = satLowerX + sideLength;
 
-					m_pVolDst->setVoxelAt(iDstX, iDstY, iDstZ, voxel);
+						float a = pLowerYLowerZ[satLowerX];
+						float b = pLowerYLowerZ[satUpperX];
+						float c = pUpperYLowerZ[satLowerX];
+						float d = pUpperYLowerZ[satUpperX];
+						float e = pLowerYUpperZ[satLowerX];
+						float f = pLowerYUpperZ[satUpperX];
+						float g = pUpperYUpperZ[satLowerX];
+						float h = pUpperYUpperZ[satUpperX];
 
+						float sum = h+c-d-g-f-a+b+e;
 
-					//float maxSolid = border * 2/* + 1*/;
-					/*maxSolid = maxSolid * maxSolid * maxSolid;
+						float average = sum / (static_cast<float>(sideLength*sideLength*sideLength));
 
-					float percentSolid = noSolid / maxSolid;
-					float percentEmpty = 1.0f - percentSolid;
+						VoxelType voxel = vecSrcRow[iOffset + i];
 
-					(*mAmbientOcclusionVolume)[ambVolZ][ambVolY][ambVolX] = 255 * percentEmpty;*/
+						voxel.setDensity(static_cast<typename VoxelType::DensityType>(average));
 
-					//(*mAmbientOcclusionVolume)[ambVolZ][ambVolY][ambVolX] = 255 - ((h+c-d-g-f-a+b+e) * 19); //FIXME - should not be 9
+						pDst[i] = voxel;
+					}
 				}
 			}
 		}
+
+		//The output was written through spans, which the destination can't keep track of.
+		m_pVolDst->recalculateDensityRanges();
 	}
 }
@@ -0,0 +1,134 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#ifndef __PolyVox_MeshOptimiser_H__
+#define __PolyVox_MeshOptimiser_H__
+
+#include "PolyVoxCore/SurfaceMesh.h"
+#include "PolyVoxCore/Vector.h"
+#include "PolyVoxCore/VertexTypes.h"
+
+#include <vector>
+
+namespace PolyVox
+{
+	/// The MeshOptimiser reorders the triangles and vertices of a mesh so that it can be drawn faster.
+	////////////////////////////////////////////////////////////////////////////////
+	/// The extractors write triangles in the order in which they scan the volume, so
+	/// a vertex is often used by one triangle and then not again until the next row
+	/// or slice. By then the graphics card has dropped it from its cache of recently
+	/// transformed vertices and has to transform it again. The MeshOptimiser puts the
+	/// triangles in an order which reuses vertices while they are still in the cache,
+	/// using the 'Tipsify' algorithm of Sander, Nehab and Barczak. Where the algorithm
+	/// has to jump to an unconnected part of the mesh, the pieces on either side are
+	/// sorted so that those which face outwards from the middle of the mesh are drawn
+	/// first, as these tend to hide the others and so save on overdraw. Finally the
+	/// vertices are put in the order in which the triangles first use them, so that
+	/// they are fetched from memory in order, and any unused vertices are removed.
+	///
+	/// Triangles are only moved within the ranges given by the LOD records and facing
+	/// records of the mesh, so those records are still correct afterwards.
+	///
+	/// The cache is modelled as a first-in first-out queue of the given size. The
+	/// effect can be measured with computeAverageCacheMissRatio(), which is also
+	/// used to give the ratios before and after optimisation.
+	///
+	/// Given a mesh called 'mesh', you can optimise it in place as follows:
+	/// \code
+	/// MeshOptimiser<PositionMaterial> optimiser(&mesh, &mesh);
+	/// optimiser.execute();
+	/// \endcode
+	template <typename VertexType>
+	class MeshOptimiser
+	{
+	public:
+		///Constructor
+		MeshOptimiser(const SurfaceMesh<VertexType>* pInputMesh, SurfaceMesh<VertexType>* pOutputMesh, uint32_t uCacheSize = 16);
+
+		///Performs the optimisation.
+		void execute();
+
+		///Gets the average cache miss ratio of the mesh before it was optimised.
+		float getCacheMissRatioBefore(void) const;
+		///Gets the average cache miss ratio of the mesh after it was optimised.
+		float getCacheMissRatioAfter(void) const;
+
+	private:
+		void optimiseRange(uint32_t uBeginIndex, uint32_t uEndIndex);
+		uint32_t getNextVertex(void);
+		void sortClusters(uint32_t uBeginIndex);
+		void reorderVertices(void);
+
+		const SurfaceMesh<VertexType>* m_pInputMesh;
+		SurfaceMesh<VertexType>* m_pOutputMesh;
+
+		uint32_t m_uCacheSize;
+
+		float m_fCacheMissRatioBefore;
+		float m_fCacheMissRatioAfter;
+
+		//The triangles using each vertex within the range being optimised. The triangles using vertex 'v' are
+		//m_vecAdjacentTriangles[m_vecAdjacencyBegins[v]] up to (but not including) m_vecAdjacentTriangles[m_vecAdjacencyBegins[v+1]].
+		std::vector<uint32_t> m_vecAdjacencyBegins;
+		std::vector<uint32_t> m_vecAdjacentTriangles;
+
+		//Data about each vertex. The number of triangles using it which haven't been output yet, and
+		//the time at which it last entered the cache (the time goes up by one for each cache miss).
+		std::vector<uint32_t> m_vecLiveTriangles;
+		std::vector<uint32_t> m_vecCacheTimes;
+		uint32_t m_uTime;
+
+		//Tipsify state. The vertices of recently output triangles (the 'dead-end stack'), the
+		//vertices of the triangles output for the current vertex, and the next vertex to try
+		//when there is nothing else to go on.
+		std::vector<uint32_t> m_vecDeadEnds;
+		std::vector<uint32_t> m_vecCandidates;
+		uint32_t m_uCursor;
+
+		//The triangles in their new order (counting from the start of the range), whether each has been output
+		//yet, and where each cluster starts. A new cluster starts whenever the output jumps to an unconnected vertex.
+		std::vector<uint32_t> m_vecOrderedTriangles;
+		std::vector<uint8_t> m_vecEmitted;
+		std::vector<uint32_t> m_vecClusterBegins;
+	};
+
+	/// Works out how well a list of triangles would use the vertex cache.
+	////////////////////////////////////////////////////////////////////////////////
+	/// The cache is modelled as a first-in first-out queue holding the given number of
+	/// vertices, starting off empty. The result is the number of vertices which have to be
+	/// transformed for each triangle, so it is at most three. A mesh which is a regular
+	/// grid can get close to half of this, and the scan order of the extractors is usually
+	/// somewhere between one and two.
+	///
+	/// \param vecIndices The indices of the triangles, three for each triangle.
+	/// \param uBeginIndex The first index to draw.
+	/// \param uEndIndex One past the last index to draw.
+	/// \param uCacheSize The number of vertices which the cache holds.
+	/// \return The average number of cache misses for each triangle, or zero if there are no triangles.
+	////////////////////////////////////////////////////////////////////////////////
+	POLYVOX_API float computeAverageCacheMissRatio(const std::vector<uint32_t>& vecIndices, uint32_t uBeginIndex, uint32_t uEndIndex, uint32_t uCacheSize);
+}
+
+#include "PolyVoxCore/MeshOptimiser.inl"
+
+#endif //__PolyVox_MeshOptimiser_H__
@@ -0,0 +1,350 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#include <algorithm>
+#include <utility>
+
+namespace PolyVox
+{
+	template <typename VertexType>
+	MeshOptimiser<VertexType>::MeshOptimiser(const SurfaceMesh<VertexType>* pInputMesh, SurfaceMesh<VertexType>* pOutputMesh, uint32_t uCacheSize)
+		:m_pInputMesh(pInputMesh)
+		,m_pOutputMesh(pOutputMesh)
+		,m_uCacheSize((std::max)(uCacheSize, static_cast<uint32_t>(3)))
+		,m_fCacheMissRatioBefore(0.0f)
+		,m_fCacheMissRatioAfter(0.0f)
+		,m_uTime(0)
+		,m_uCursor(0)
+	{
+		if(m_pOutputMesh != m_pInputMesh)
+		{
+			*m_pOutputMesh = *m_pInputMesh;
+		}
+	}
+
+	template <typename VertexType>
+	void MeshOptimiser<VertexType>::execute()
+	{
+		std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+
+		m_fCacheMissRatioBefore = computeAverageCacheMissRatio(vecIndices, 0, vecIndices.size(), m_uCacheSize);
+
+		//Sanity check.
+		if((m_pOutputMesh->m_vecVertices.empty()) || (vecIndices.empty()))
+		{
+			m_fCacheMissRatioAfter = m_fCacheMissRatioBefore;
+			return;
+		}
+
+		//The ranges which are drawn separately are optimised separately, so that their records stay correct.
+		std::vector<uint32_t> vecBoundaries;
+		vecBoundaries.push_back(0);
+		vecBoundaries.push_back(vecIndices.size());
+		for(uint32_t ct = 0; ct < m_pOutputMesh->m_vecLodRecords.size(); ct++)
+		{
+			vecBoundaries.push_back(m_pOutputMesh->m_vecLodRecords[ct].beginIndex);
+			vecBoundaries.push_back(m_pOutputMesh->m_vecLodRecords[ct].endIndex);
+		}
+		for(uint32_t ct = 0; ct < m_pOutputMesh->m_vecFacingRecords.size(); ct++)
+		{
+			vecBoundaries.push_back(m_pOutputMesh->m_vecFacingRecords[ct].beginIndex);
+			vecBoundaries.push_back(m_pOutputMesh->m_vecFacingRecords[ct].endIndex);
+		}
+		std::sort(vecBoundaries.begin(), vecBoundaries.end());
+		vecBoundaries.erase(std::unique(vecBoundaries.begin(), vecBoundaries.end()), vecBoundaries.end());
+
+		for(uint32_t ct = 0; ct + 1 < vecBoundaries.size(); ct++)
+		{
+			optimiseRange(vecBoundaries[ct], vecBoundaries[ct + 1]);
+		}
+
+		reorderVertices();
+
+		m_fCacheMissRatioAfter = computeAverageCacheMissRatio(vecIndices, 0, vecIndices.size(), m_uCacheSize);
+	}
+
+	template <typename VertexType>
+	float MeshOptimiser<VertexType>::getCacheMissRatioBefore(void) const
+	{
+		return m_fCacheMissRatioBefore;
+	}
+
+	template <typename VertexType>
+	float MeshOptimiser<VertexType>::getCacheMissRatioAfter(void) const
+	{
+		return m_fCacheMissRatioAfter;
+	}
+
+	template <typename VertexType>
+	void MeshOptimiser<VertexType>::optimiseRange(uint32_t uBeginIndex, uint32_t uEndIndex)
+	{
+		const std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+		const uint32_t uNoOfVertices = m_pOutputMesh->m_vecVertices.size();
+		const uint32_t uNoOfTriangles = (uEndIndex - uBeginIndex) / 3;
+		if(uNoOfTriangles < 2)
+		{
+			return;
+		}
+
+		//Find the triangles using each vertex.
+		m_vecAdjacencyBegins.assign(uNoOfVertices + 1, 0);
+		for(uint32_t ct = uBeginIndex; ct < uEndIndex; ct++)
+		{
+			m_vecAdjacencyBegins[vecIndices[ct] + 1]++;
+		}
+		m_vecLiveTriangles.resize(uNoOfVertices);
+		for(uint32_t ct = 0; ct < uNoOfVertices; ct++)
+		{
+			m_vecLiveTriangles[ct] = m_vecAdjacencyBegins[ct + 1];
+			m_vecAdjacencyBegins[ct + 1] += m_vecAdjacencyBegins[ct];
+		}
+		m_vecAdjacentTriangles.resize(uEndIndex - uBeginIndex);
+		for(uint32_t ct = uBeginIndex; ct < uEndIndex; ct++)
+		{
+			const uint32_t v = vecIndices[ct];
+			m_vecAdjacentTriangles[m_vecAdjacencyBegins[v + 1] - m_vecLiveTriangles[v]] = (ct - uBeginIndex) / 3;
+			m_vecLiveTriangles[v]--;
+		}
+		for(uint32_t ct = 0; ct < uNoOfVertices; ct++)
+		{
+			m_vecLiveTriangles[ct] = m_vecAdjacencyBegins[ct + 1] - m_vecAdjacencyBegins[ct];
+		}
+
+		//The time starts past the cache size so that no vertex starts off in the cache.
+		m_vecCacheTimes.assign(uNoOfVertices, 0);
+		m_uTime = m_uCacheSize + 1;
+		m_uCursor = 0;
+		m_vecDeadEnds.clear();
+		m_vecEmitted.assign(uNoOfTriangles, 0);
+		m_vecOrderedTriangles.clear();
+		m_vecClusterBegins.clear();
+		m_vecClusterBegins.push_back(0);
+
+		//Output all the remaining triangles around a vertex, and then move on to a vertex nearby.
+		uint32_t uFanningVertex = vecIndices[uBeginIndex];
+		while(uFanningVertex != m_vecLiveTriangles.size())
+		{
+			m_vecCandidates.clear();
+			for(uint32_t uAdjacent = m_vecAdjacencyBegins[uFanningVertex]; uAdjacent < m_vecAdjacencyBegins[uFanningVertex + 1]; uAdjacent++)
+			{
+				const uint32_t uTriangle = m_vecAdjacentTriangles[uAdjacent];
+				if(m_vecEmitted[uTriangle])
+				{
+					continue;
+				}
+				m_vecEmitted[uTriangle] = 1;
+				m_vecOrderedTriangles.push_back(uTriangle);
+
+				for(uint32_t uCorner = 0; uCorner < 3; uCorner++)
+				{
+					const uint32_t v = vecIndices[uBeginIndex + uTriangle * 3 + uCorner];
+					m_vecDeadEnds.push_back(v);
+					m_vecCandidates.push_back(v);
+					m_vecLiveTriangles[v]--;
+					if(m_uTime - m_vecCacheTimes[v] > m_uCacheSize)
+					{
+						m_vecCacheTimes[v] = m_uTime;
+						m_uTime++;
+					}
+				}
+			}
+
+			uFanningVertex = getNextVertex();
+		}
+
+		sortClusters(uBeginIndex);
+
+		//Write the triangles back in their new order.
+		std::vector<uint32_t>& vecOutputIndices = m_pOutputMesh->m_vecTriangleIndices;
+		std::vector<uint32_t> vecRangeIndices(vecOutputIndices.begin() + uBeginIndex, vecOutputIndices.begin() + uEndIndex);
+		for(uint32_t ct = 0; ct < uNoOfTriangles; ct++)
+		{
+			const uint32_t uTriangle = m_vecOrderedTriangles[ct];
+			vecOutputIndices[uBeginIndex + ct * 3 + 0] = vecRangeIndices[uTriangle * 3 + 0];
+			vecOutputIndices[uBeginIndex + ct * 3 + 1] = vecRangeIndices[uTriangle * 3 + 1];
+			vecOutputIndices[uBeginIndex + ct * 3 + 2] = vecRangeIndices[uTriangle * 3 + 2];
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The best next vertex is one used by the triangles just output which will still be
+	/// in the cache once its own triangles have been output, and which has been in the
+	/// cache longest (as it will be the next to drop out). If none of them will still be
+	/// in the cache, the first of them is taken anyway. If none of them have any triangles
+	/// left then recently used vertices are tried, and then every vertex
+	/// in turn.
+	/// \return The next vertex, or the number of vertices if every triangle has been output.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VertexType>
+	uint32_t MeshOptimiser<VertexType>::getNextVertex(void)
+	{
+		const uint32_t uNoOfVertices = m_vecLiveTriangles.size();
+
+		uint32_t uBestVertex = uNoOfVertices;
+		int32_t iBestPriority = -1;
+		for(uint32_t ct = 0; ct < m_vecCandidates.size(); ct++)
+		{
+			const uint32_t v = m_vecCandidates[ct];
+			if(m_vecLiveTriangles[v] == 0)
+			{
+				continue;
+			}
+
+			//Each of its triangles can add up to two more vertices to the cache.
+			int32_t iPriority = 0;
+			const uint32_t uAge = m_uTime - m_vecCacheTimes[v];
+			if(uAge + 2 * m_vecLiveTriangles[v] <= m_uCacheSize)
+			{
+				iPriority = uAge;
+			}
+			if(iPriority > iBestPriority)
+			{
+				uBestVertex = v;
+				iBestPriority = iPriority;
+			}
+		}
+		if(uBestVertex != uNoOfVertices)
+		{
+			return uBestVertex;
+		}
+
+		while(!m_vecDeadEnds.empty())
+		{
+			const uint32_t v = m_vecDeadEnds.back();
+			m_vecDeadEnds.pop_back();
+			if(m_vecLiveTriangles[v] > 0)
+			{
+				return v;
+			}
+		}
+
+		//Nothing nearby is left, so this starts a new cluster.
+		while((m_uCursor < uNoOfVertices) && (m_vecLiveTriangles[m_uCursor] == 0))
+		{
+			m_uCursor++;
+		}
+		if(m_uCursor < uNoOfVertices)
+		{
+			m_vecClusterBegins.push_back(m_vecOrderedTriangles.size());
+		}
+		return m_uCursor;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Each cluster is a connected piece of the range. They are sorted by how far they
+	/// lie in front of the middle of the range (measured along their own average normal),
+	/// furthest first, as these are the most likely to hide the others from any point of
+	/// view. The clusters don't share any vertices, so their order doesn't affect cache use.
+	/// \param uBeginIndex The start of the range.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VertexType>
+	void MeshOptimiser<VertexType>::sortClusters(uint32_t uBeginIndex)
+	{
+		const uint32_t uNoOfClusters = m_vecClusterBegins.size();
+		if(uNoOfClusters < 2)
+		{
+			return;
+		}
+
+		const std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+		const std::vector<VertexType>& vecVertices = m_pOutputMesh->m_vecVertices;
+		m_vecClusterBegins.push_back(m_vecOrderedTriangles.size());
+
+		//The area weighted centre and normal of each cluster, and of the range as a whole.
+		std::vector<Vector3DFloat> vecCentres(uNoOfClusters, Vector3DFloat(0.0f, 0.0f, 0.0f));
+		std::vector<Vector3DFloat> vecNormals(uNoOfClusters, Vector3DFloat(0.0f, 0.0f, 0.0f));
+		std::vector<float> vecAreas(uNoOfClusters, 0.0f);
+		Vector3DFloat v3dRangeCentre(0.0f, 0.0f, 0.0f);
+		float fRangeArea = 0.0f;
+		for(uint32_t uCluster = 0; uCluster < uNoOfClusters; uCluster++)
+		{
+			for(uint32_t ct = m_vecClusterBegins[uCluster]; ct < m_vecClusterBegins[uCluster + 1]; ct++)
+			{
+				const uint32_t uIndex = uBeginIndex + m_vecOrderedTriangles[ct] * 3;
+				const Vector3DFloat& v3dPos0 = vecVertices[vecIndices[uIndex + 0]].getPosition();
+				const Vector3DFloat& v3dPos1 = vecVertices[vecIndices[uIndex + 1]].getPosition();
+				const Vector3DFloat& v3dPos2 = vecVertices[vecIndices[uIndex + 2]].getPosition();
+				const Vector3DFloat v3dNormal = (v3dPos1 - v3dPos0).cross(v3dPos2 - v3dPos0);
+				const float fArea = v3dNormal.length();
+
+				vecCentres[uCluster] += (v3dPos0 + v3dPos1 + v3dPos2) * (fArea / 3.0f);
+				vecNormals[uCluster] += v3dNormal;
+				vecAreas[uCluster] += fArea;
+			}
+			v3dRangeCentre += vecCentres[uCluster];
+			fRangeArea += vecAreas[uCluster];
+		}
+		if(fRangeArea <= 0.0f)
+		{
+			return;
+		}
+		v3dRangeCentre /= fRangeArea;
+
+		std::vector< std::pair<float, uint32_t> > vecOrder(uNoOfClusters);
+		for(uint32_t uCluster = 0; uCluster < uNoOfClusters; uCluster++)
+		{
+			float fDistance = 0.0f;
+			const float fNormalLength = vecNormals[uCluster].length();
+			if((vecAreas[uCluster] > 0.0f) && (fNormalLength > 0.0f))
+			{
+				fDistance = (vecCentres[uCluster] / vecAreas[uCluster] - v3dRangeCentre).dot(vecNormals[uCluster]) / fNormalLength;
+			}
+			vecOrder[uCluster] = std::make_pair(-fDistance, uCluster);
+		}
+		std::sort(vecOrder.begin(), vecOrder.end());
+
+		std::vector<uint32_t> vecSortedTriangles;
+		vecSortedTriangles.reserve(m_vecOrderedTriangles.size());
+		for(uint32_t ct = 0; ct < uNoOfClusters; ct++)
+		{
+			const uint32_t uCluster = vecOrder[ct].second;
+			vecSortedTriangles.insert(vecSortedTriangles.end(), m_vecOrderedTriangles.begin() + m_vecClusterBegins[uCluster], m_vecOrderedTriangles.begin() + m_vecClusterBegins[uCluster + 1]);
+		}
+		m_vecOrderedTriangles.swap(vecSortedTriangles);
+	}
+
+	template <typename VertexType>
+	void MeshOptimiser<VertexType>::reorderVertices(void)
+	{
+		std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+		const std::vector<VertexType>& vecVertices = m_pOutputMesh->m_vecVertices;
+
+		//Number the vertices in the order in which they are first used.
+		const uint32_t uUnused = vecVertices.size();
+		std::vector<uint32_t> vecNewIndices(vecVertices.size(), uUnused);
+		std::vector<VertexType> vecNewVertices;
+		vecNewVertices.reserve(vecVertices.size());
+		for(uint32_t ct = 0; ct < vecIndices.size(); ct++)
+		{
+			uint32_t& uNewIndex = vecNewIndices[vecIndices[ct]];
+			if(uNewIndex == uUnused)
+			{
+				uNewIndex = vecNewVertices.size();
+				vecNewVertices.push_back(vecVertices[vecIndices[ct]]);
+			}
+			vecIndices[ct] = uNewIndex;
+		}
+
+		m_pOutputMesh->m_vecVertices.swap(vecNewVertices);
+	}
+}
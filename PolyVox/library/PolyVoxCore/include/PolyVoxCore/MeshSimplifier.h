@@ -0,0 +1,212 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#ifndef __PolyVox_MeshSimplifier_H__
+#define __PolyVox_MeshSimplifier_H__
+
+#include "PolyVoxCore/SurfaceMesh.h"
+#include "PolyVoxCore/Vector.h"
+#include "PolyVoxCore/VertexTypes.h"
+
+#include <utility>
+#include <vector>
+
+namespace PolyVox
+{
+	/// The MeshSimplifier reduces the number of triangles in a mesh, cheapest collapses first.
+	////////////////////////////////////////////////////////////////////////////////
+	/// Like the MeshDecimator, the MeshSimplifier works by collapsing edges (moving a
+	/// vertex onto one of its neighbours, so that the triangles between them vanish)
+	/// and works with meshes from the SurfaceExtractor and the CubicSurfaceExtractor.
+	/// Rather than comparing normals it measures how far each collapse moves the surface,
+	/// using the quadric error metric of Garland and Heckbert: every vertex carries the
+	/// planes of the triangles which have been collapsed into it, and the error of a
+	/// collapse is the sum of the squared distances of the new position from those planes.
+	/// The possible collapses are kept in a priority queue so that the cheapest are done
+	/// first, and the simplification stops once the mesh is down to a target number of
+	/// triangles or once the cheapest remaining collapse is above an error bound.
+	///
+	/// With the default error bound of zero only collapses which leave the surface exactly
+	/// where it was are done. For a cubic mesh this merges each flat area into a few large
+	/// triangles, as the MeshDecimator does, but does it several times faster.
+	///
+	/// As with the MeshDecimator the boundaries between materials are left exactly as they
+	/// were, and vertices on the faces of the region only ever move along the face and only
+	/// when this doesn't change the surface, so that the meshes of neighbouring regions still
+	/// meet up without cracks.
+	///
+	/// Given a mesh called 'mesh', you can create a simplified version as follows:
+	/// \code
+	/// SurfaceMesh<PositionMaterial> simplifiedMesh;
+	/// MeshSimplifier<PositionMaterial> simplifier(&mesh, &simplifiedMesh);
+	/// simplifier.execute();
+	/// \endcode
+	///
+	/// To keep at most a quarter of the triangles of a Marching Cubes mesh, however much
+	/// the surface has to move to get there:
+	/// \code
+	/// MeshSimplifier<PositionMaterialNormal> simplifier(&mesh, &simplifiedMesh, mesh.getNoOfIndices() / 12, FLT_MAX);
+	/// \endcode
+	///
+	/// The simplifier can also build coarser levels of detail (see setNoOfLodLevels()), which
+	/// are stored one after another in the index buffer of the simplified mesh and described by
+	/// its LOD records. A renderer can then switch between them with selectLodLevel() without
+	/// uploading the mesh again.
+	///
+	/// The levels are separate ranges of the index buffer rather than nested prefixes of a
+	/// single progressive ordering. A coarser level is not a subset of the triangles of a finer
+	/// one, as each collapse replaces the triangles around the removed vertex with new ones,
+	/// so a prefix could only be drawn by also rewriting the indices as the level changes.
+	/// Storing each level whole costs at most about as much again as the first level, since
+	/// each level has roughly half the triangles of the one before.
+	template <typename VertexType>
+	class MeshSimplifier
+	{
+		//The plane equations of a set of planes summed into a symmetric 4x4 matrix, so that
+		//evaluate() gives the sum of the squared distances of a point from the planes.
+		struct Quadric
+		{
+			double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+
+			Quadric();
+			void addPlane(double a, double b, double c, double d);
+			void add(const Quadric& rhs);
+			double evaluate(const Vector3DFloat& v3dPos) const;
+		};
+
+		//The collapse of vertex 'src' onto its neighbour 'dst'. The comparison is reversed
+		//so that the top of the heap is the cheapest collapse.
+		struct Collapse
+		{
+			float cost;
+			uint32_t src;
+			uint32_t dst;
+
+			bool operator<(const Collapse& rhs) const
+			{
+				if(cost != rhs.cost)
+				{
+					return cost > rhs.cost;
+				}
+				return src > rhs.src;
+			}
+		};
+
+		//Orders vertices by position (first on z, then y, then x), so that vertices which are in the same place become neighbours.
+		struct PositionLess
+		{
+			PositionLess(const std::vector<VertexType>& vecVertices);
+			bool operator()(uint32_t lhs, uint32_t rhs) const;
+
+			const std::vector<VertexType>* m_pVertices;
+		};
+
+		//Used to keep track of what each vertex is allowed to do. The first
+		//two are found once at the start, the others change as collapses are done.
+		enum VertexFlags
+		{
+			VF_FIXED = 1, //On a material edge, or where several parts of the mesh meet. Never moves.
+			VF_ON_OPEN_EDGE = 2, //Has an edge which is used by only one triangle.
+			VF_COLLAPSED = 4, //Has been moved onto another vertex and is no longer used.
+			VF_QUEUED = 8 //Has a collapse in the queue.
+		};
+
+	public:
+		///Constructor
+		MeshSimplifier(const SurfaceMesh<VertexType>* pInputMesh, SurfaceMesh<VertexType>* pOutputMesh, uint32_t uTargetTriangleCount = 0, float fMaxError = 0.0f);
+
+		///Sets how many levels of detail to build.
+		void setNoOfLodLevels(uint32_t uNoOfLodLevels);
+
+		///Performs the simplification.
+		void execute();
+
+	private:
+		void fillVertexMetadata(void);
+		void computeQuadrics(void);
+		void buildAdjacency(void);
+		void findOpenEdges(void);
+
+		void buildCoarserLodLevels(void);
+
+		void gatherTriangles(uint32_t v, std::vector<uint32_t>& vecTriangles);
+		void queueCollapses(void);
+		void performCollapses(uint32_t uTargetTriangleCount);
+		void queueCollapse(uint32_t v);
+		bool findCollapse(uint32_t uSrc, Collapse& collapse);
+		float getCollapseError(uint32_t uSrc, uint32_t uDst);
+		bool canCollapse(uint32_t uSrc, uint32_t uDst);
+		bool collapseFlipsTriangles(uint32_t uSrc, uint32_t uDst);
+		void applyCollapse(uint32_t uSrc, uint32_t uDst);
+
+		void removeCollapsedTriangles(void);
+		void removeCollapsedTriangles(uint32_t& uRead, uint32_t uEnd, uint32_t& uWrite);
+
+		const SurfaceMesh<VertexType>* m_pInputMesh;
+		SurfaceMesh<VertexType>* m_pOutputMesh;
+
+		uint32_t m_uTargetTriangleCount;
+		float m_fMaxError;
+		uint32_t m_uNoOfLodLevels;
+
+		//Collapses with an error up to this are treated as leaving the surface where it was.
+		float m_fExactError;
+
+		//Set if every collapse so far has left the surface where it was.
+		bool m_bExact;
+
+		uint32_t m_uNoOfTriangles;
+		uint32_t m_uNoOfCollapsedTriangles; //Since the adjacency data was last built.
+
+		//Data about each vertex.
+		std::vector<Quadric> m_vecQuadrics;
+		std::vector<uint8_t> m_vecVertexFlags;
+		std::vector<uint8_t> m_vecRegionFaces; //One bit for each face of the region which the vertex lies on.
+
+		//The triangles using each vertex, in compressed sparse row form: the triangles using vertex 'v' are
+		//m_vecAdjacentTriangles[m_vecAdjacencyBegins[v]] up to (but not including) m_vecAdjacentTriangles[m_vecAdjacencyEnds[v]].
+		//This is built at the start with the ranges packed together. Each collapse appends a new range for its destination,
+		//and the whole thing is built again once many triangles have collapsed or the appended ranges have filled the spare space.
+		std::vector<uint32_t> m_vecAdjacencyBegins;
+		std::vector<uint32_t> m_vecAdjacencyEnds;
+		std::vector<uint32_t> m_vecAdjacentTriangles;
+
+		//Used for finding the neighbours which two vertices have in common. A vertex is marked by setting it to m_uMark.
+		std::vector<uint32_t> m_vecMarks;
+		uint32_t m_uMark;
+
+		//The priority queue of collapses, as a heap.
+		std::vector<Collapse> m_vecCollapses;
+
+		//Working space. The neighbours which a vertex could collapse onto (with the errors of doing so), the
+		//triangles using the source and destination of a collapse, and the vertices changed by a collapse.
+		std::vector< std::pair<float, uint32_t> > m_vecCandidates;
+		std::vector<uint32_t> m_vecSrcTriangles;
+		std::vector<uint32_t> m_vecDstTriangles;
+		std::vector<uint32_t> m_vecChangedVertices;
+	};
+}
+
+#include "PolyVoxCore/MeshSimplifier.inl"
+
+#endif //__PolyVox_MeshSimplifier_H__
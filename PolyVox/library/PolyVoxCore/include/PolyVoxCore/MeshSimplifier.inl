@@ -0,0 +1,807 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace PolyVox
+{
+	template <typename VertexType>
+	MeshSimplifier<VertexType>::Quadric::Quadric()
+		:a2(0.0), ab(0.0), ac(0.0), ad(0.0), b2(0.0), bc(0.0), bd(0.0), c2(0.0), cd(0.0), d2(0.0)
+	{
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::Quadric::addPlane(double a, double b, double c, double d)
+	{
+		a2 += a * a; ab += a * b; ac += a * c; ad += a * d;
+		b2 += b * b; bc += b * c; bd += b * d;
+		c2 += c * c; cd += c * d;
+		d2 += d * d;
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::Quadric::add(const Quadric& rhs)
+	{
+		a2 += rhs.a2; ab += rhs.ab; ac += rhs.ac; ad += rhs.ad;
+		b2 += rhs.b2; bc += rhs.bc; bd += rhs.bd;
+		c2 += rhs.c2; cd += rhs.cd;
+		d2 += rhs.d2;
+	}
+
+	template <typename VertexType>
+	double MeshSimplifier<VertexType>::Quadric::evaluate(const Vector3DFloat& v3dPos) const
+	{
+		const double x = v3dPos.getX();
+		const double y = v3dPos.getY();
+		const double z = v3dPos.getZ();
+
+		return x * (a2 * x + 2.0 * (ab * y + ac * z + ad))
+			+ y * (b2 * y + 2.0 * (bc * z + bd))
+			+ z * (c2 * z + 2.0 * cd)
+			+ d2;
+	}
+
+	template <typename VertexType>
+	MeshSimplifier<VertexType>::PositionLess::PositionLess(const std::vector<VertexType>& vecVertices)
+		:m_pVertices(&vecVertices)
+	{
+	}
+
+	template <typename VertexType>
+	bool MeshSimplifier<VertexType>::PositionLess::operator()(uint32_t lhs, uint32_t rhs) const
+	{
+		const Vector3DFloat& v3dLhs = (*m_pVertices)[lhs].getPosition();
+		const Vector3DFloat& v3dRhs = (*m_pVertices)[rhs].getPosition();
+
+		if(v3dLhs.getZ() != v3dRhs.getZ())
+			return v3dLhs.getZ() < v3dRhs.getZ();
+		if(v3dLhs.getY() != v3dRhs.getY())
+			return v3dLhs.getY() < v3dRhs.getY();
+		return v3dLhs.getX() < v3dRhs.getX();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Builds a MeshSimplifier.
+	/// \param pInputMesh A pointer to the mesh to be simplified.
+	/// \param pOutputMesh A pointer to where the result should be stored. Any existing
+	/// contents will be deleted.
+	/// \param uTargetTriangleCount The simplification stops once the mesh has this many
+	/// triangles or fewer. Zero means it carries on for as long as the error allows.
+	/// \param fMaxError No collapse which moves the surface by more than this is done. The
+	/// error is the sum of the squared distances of the new vertex position from the planes
+	/// of the triangles which have been collapsed into it, so an error of 0.01 lets a single
+	/// collapse move the surface by about 0.1 voxels. Zero means only collapses which leave
+	/// the surface where it was, and FLT_MAX means collapses are only limited by the target
+	/// triangle count.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VertexType>
+	MeshSimplifier<VertexType>::MeshSimplifier(const SurfaceMesh<VertexType>* pInputMesh, SurfaceMesh<VertexType>* pOutputMesh, uint32_t uTargetTriangleCount, float fMaxError)
+		:m_pInputMesh(pInputMesh)
+		,m_pOutputMesh(pOutputMesh)
+		,m_uTargetTriangleCount(uTargetTriangleCount)
+		,m_fMaxError(fMaxError)
+		,m_uNoOfLodLevels(1)
+		,m_fExactError(0.000001f)
+		,m_bExact(true)
+		,m_uNoOfTriangles(0)
+		,m_uNoOfCollapsedTriangles(0)
+		,m_uMark(0)
+	{
+		*m_pOutputMesh = *m_pInputMesh;
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::execute()
+	{
+		//Sanity check.
+		if((m_pOutputMesh->m_vecVertices.empty()) || (m_pOutputMesh->m_vecTriangleIndices.empty()))
+		{
+			return;
+		}
+
+		m_bExact = true;
+
+		//Only the first level of detail of the input is simplified.
+		if(m_pOutputMesh->m_vecLodRecords.size() > 1)
+		{
+			m_pOutputMesh->m_vecTriangleIndices.resize(m_pOutputMesh->m_vecLodRecords[0].endIndex);
+		}
+
+		//Any triangles which are degenerate to begin with are removed, so
+		//that every triangle in the adjacency data has three vertices.
+		removeCollapsedTriangles();
+
+		fillVertexMetadata();
+		computeQuadrics();
+		buildAdjacency();
+		findOpenEdges();
+
+		//Each vertex puts forward its cheapest collapse, and then the collapses are done cheapest first.
+		m_vecCollapses.clear();
+		queueCollapses();
+		performCollapses(m_uTargetTriangleCount);
+		removeCollapsedTriangles();
+
+		//Simplification will have invalidated LOD levels. The first one is the mesh which was asked for.
+		m_pOutputMesh->m_vecLodRecords.clear();
+		LodRecord lodRecord;
+		lodRecord.beginIndex = 0;
+		lodRecord.endIndex = m_pOutputMesh->getNoOfIndices();
+		m_pOutputMesh->m_vecLodRecords.push_back(lodRecord);
+
+		if(m_uNoOfLodLevels > 1)
+		{
+			buildCoarserLodLevels();
+		}
+
+		m_pOutputMesh->removeUnusedVertices();
+
+		//The facing records have been kept up to date as triangles were removed, but
+		//they are only still right if none of the remaining triangles has been tilted.
+		if(!m_bExact)
+		{
+			m_pOutputMesh->m_vecFacingRecords.clear();
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// By default only one level of detail is built. Asking for more makes the simplifier
+	/// carry on once it has the mesh which was asked for, with no limit on the error, and
+	/// store each coarser level after the previous one in the same index buffer. Each level
+	/// has about half the triangles of the one before, and the material boundaries and the
+	/// edges of the mesh on the faces of the region are kept exactly in all of them. Fewer
+	/// levels are built if the mesh can't be simplified that far.
+	/// \param uNoOfLodLevels The most levels of detail to build, including the first.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::setNoOfLodLevels(uint32_t uNoOfLodLevels)
+	{
+		m_uNoOfLodLevels = (std::max)(uNoOfLodLevels, static_cast<uint32_t>(1));
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::buildCoarserLodLevels(void)
+	{
+		std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+		std::vector<LodRecord>& vecLodRecords = m_pOutputMesh->m_vecLodRecords;
+
+		//The levels can't share triangles, as a collapse changes the triangles around it as well as removing some. So
+		//the indices of each level are copied out as it is finished. The facing records only apply to the first level.
+		std::vector<uint32_t> vecAllIndices(vecIndices);
+		const std::vector<LodRecord> vecFacingRecords(m_pOutputMesh->m_vecFacingRecords);
+		const bool bExact = m_bExact;
+
+		m_fMaxError = FLT_MAX;
+		for(uint32_t uLevel = 1; uLevel < m_uNoOfLodLevels; uLevel++)
+		{
+			const uint32_t uPreviousNoOfTriangles = m_uNoOfTriangles;
+
+			//Vertices whose collapses were too expensive before may have one now.
+			buildAdjacency();
+			queueCollapses();
+			performCollapses(uPreviousNoOfTriangles / 2);
+			removeCollapsedTriangles();
+
+			//A level which is barely smaller than the one before isn't worth having.
+			if(m_uNoOfTriangles * 4 > uPreviousNoOfTriangles * 3)
+			{
+				break;
+			}
+
+			LodRecord lodRecord;
+			lodRecord.beginIndex = vecAllIndices.size();
+			vecAllIndices.insert(vecAllIndices.end(), vecIndices.begin(), vecIndices.end());
+			lodRecord.endIndex = vecAllIndices.size();
+			vecLodRecords.push_back(lodRecord);
+		}
+
+		vecIndices.swap(vecAllIndices);
+		m_pOutputMesh->m_vecFacingRecords = vecFacingRecords;
+		m_bExact = bExact;
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::fillVertexMetadata(void)
+	{
+		const std::vector<VertexType>& vecVertices = m_pOutputMesh->m_vecVertices;
+		const std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+		const uint32_t uNoOfVertices = vecVertices.size();
+
+		m_vecVertexFlags.assign(uNoOfVertices, 0);
+		m_vecRegionFaces.assign(uNoOfVertices, 0);
+
+		//Identify vertices which are in the same place as another vertex. The CubicSurfaceExtractor gives each material
+		//its own vertices, so these are on a material edge. Sorting puts such vertices next to each other in the list.
+		std::vector<uint32_t> vecSortedVertices(uNoOfVertices);
+		for(uint32_t ct = 0; ct < uNoOfVertices; ct++)
+		{
+			vecSortedVertices[ct] = ct;
+		}
+		std::sort(vecSortedVertices.begin(), vecSortedVertices.end(), PositionLess(vecVertices));
+
+		for(uint32_t ct = 0; ct + 1 < uNoOfVertices; ct++)
+		{
+			const uint32_t v0 = vecSortedVertices[ct];
+			const uint32_t v1 = vecSortedVertices[ct + 1];
+			if(vecVertices[v0].getPosition() == vecVertices[v1].getPosition())
+			{
+				m_vecVertexFlags[v0] |= VF_FIXED;
+				m_vecVertexFlags[v1] |= VF_FIXED;
+			}
+		}
+
+		//The Marching Cubes surface shares vertices between materials instead, and if the vertices of a
+		//triangle don't all have the same material then all three of them are on a material edge.
+		for(uint32_t ct = 0; ct < vecIndices.size(); ct += 3)
+		{
+			const uint32_t v0 = vecIndices[ct];
+			const uint32_t v1 = vecIndices[ct + 1];
+			const uint32_t v2 = vecIndices[ct + 2];
+
+			if((vecVertices[v0].getMaterial() != vecVertices[v1].getMaterial()) || (vecVertices[v1].getMaterial() != vecVertices[v2].getMaterial()))
+			{
+				m_vecVertexFlags[v0] |= VF_FIXED;
+				m_vecVertexFlags[v1] |= VF_FIXED;
+				m_vecVertexFlags[v2] |= VF_FIXED;
+			}
+		}
+
+		//Identify those vertices on the faces of the region, in the same way as the MeshDecimator.
+		const float fUpperX = static_cast<float>(m_pOutputMesh->m_Region.getUpperCorner().getX() - m_pOutputMesh->m_Region.getLowerCorner().getX());
+		const float fUpperY = static_cast<float>(m_pOutputMesh->m_Region.getUpperCorner().getY() - m_pOutputMesh->m_Region.getLowerCorner().getY());
+		const float fUpperZ = static_cast<float>(m_pOutputMesh->m_Region.getUpperCorner().getZ() - m_pOutputMesh->m_Region.getLowerCorner().getZ());
+		for(uint32_t ct = 0; ct < uNoOfVertices; ct++)
+		{
+			const Vector3DFloat& v3dPos = vecVertices[ct].getPosition();
+			uint8_t uFaces = 0;
+			uFaces |= (v3dPos.getX() < 0.001f) ? 0x01 : 0;
+			uFaces |= (v3dPos.getX() > fUpperX - 0.001f) ? 0x02 : 0;
+			uFaces |= (v3dPos.getY() < 0.001f) ? 0x04 : 0;
+			uFaces |= (v3dPos.getY() > fUpperY - 0.001f) ? 0x08 : 0;
+			uFaces |= (v3dPos.getZ() < 0.001f) ? 0x10 : 0;
+			uFaces |= (v3dPos.getZ() > fUpperZ - 0.001f) ? 0x20 : 0;
+			m_vecRegionFaces[ct] = uFaces;
+		}
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::computeQuadrics(void)
+	{
+		const std::vector<VertexType>& vecVertices = m_pOutputMesh->m_vecVertices;
+		const std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+
+		m_vecQuadrics.assign(vecVertices.size(), Quadric());
+
+		//Each vertex starts off with the planes of the triangles which use it.
+		for(uint32_t ct = 0; ct < vecIndices.size(); ct += 3)
+		{
+			const Vector3DFloat& v0Pos = vecVertices[vecIndices[ct]].getPosition();
+			const Vector3DFloat& v1Pos = vecVertices[vecIndices[ct + 1]].getPosition();
+			const Vector3DFloat& v2Pos = vecVertices[vecIndices[ct + 2]].getPosition();
+
+			const double e1x = v1Pos.getX() - v0Pos.getX(), e1y = v1Pos.getY() - v0Pos.getY(), e1z = v1Pos.getZ() - v0Pos.getZ();
+			const double e2x = v2Pos.getX() - v0Pos.getX(), e2y = v2Pos.getY() - v0Pos.getY(), e2z = v2Pos.getZ() - v0Pos.getZ();
+			double a = e1y * e2z - e1z * e2y;
+			double b = e1z * e2x - e1x * e2z;
+			double c = e1x * e2y - e1y * e2x;
+			const double dLength = std::sqrt(a * a + b * b + c * c);
+			if(dLength == 0.0)
+			{
+				continue;
+			}
+
+			a /= dLength;
+			b /= dLength;
+			c /= dLength;
+			const double d = -(a * v0Pos.getX() + b * v0Pos.getY() + c * v0Pos.getZ());
+
+			m_vecQuadrics[vecIndices[ct]].addPlane(a, b, c, d);
+			m_vecQuadrics[vecIndices[ct + 1]].addPlane(a, b, c, d);
+			m_vecQuadrics[vecIndices[ct + 2]].addPlane(a, b, c, d);
+		}
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::buildAdjacency(void)
+	{
+		const std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+		const uint32_t uNoOfVertices = m_pOutputMesh->m_vecVertices.size();
+
+		//Count the triangles using each vertex and turn the counts into the end of each vertex's range. Filling
+		//the ranges in from the back then leaves the beginnings at the start of each range, with the triangles in order.
+		m_vecAdjacencyBegins.assign(uNoOfVertices, 0);
+		for(uint32_t ct = 0; ct < vecIndices.size(); ct++)
+		{
+			m_vecAdjacencyBegins[vecIndices[ct]]++;
+		}
+
+		uint32_t uEnd = 0;
+		for(uint32_t ct = 0; ct < uNoOfVertices; ct++)
+		{
+			uEnd += m_vecAdjacencyBegins[ct];
+			m_vecAdjacencyBegins[ct] = uEnd;
+		}
+		m_vecAdjacencyEnds = m_vecAdjacencyBegins;
+
+		//Leave room for the ranges which collapses append.
+		m_vecAdjacentTriangles.reserve(vecIndices.size() * 2);
+		m_vecAdjacentTriangles.resize(vecIndices.size());
+		for(uint32_t ct = vecIndices.size(); ct > 0; ct--)
+		{
+			m_vecAdjacentTriangles[--m_vecAdjacencyBegins[vecIndices[ct - 1]]] = (ct - 1) / 3;
+		}
+
+		m_vecMarks.assign(uNoOfVertices, 0);
+		m_uMark = 0;
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::findOpenEdges(void)
+	{
+		const std::vector<VertexType>& vecVertices = m_pOutputMesh->m_vecVertices;
+		const std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+		std::vector<uint32_t> vecEdgeUseCounts(vecVertices.size());
+
+		//An edge is used by two triangles unless it is on a hole in the mesh (such as where the mesh
+		//reaches the faces of the region) or where several parts of the mesh meet. Each neighbour of a
+		//vertex is seen once for every triangle which uses the edge between them.
+		for(uint32_t v = 0; v < m_vecVertexFlags.size(); v++)
+		{
+			m_uMark++;
+			for(uint32_t ct = m_vecAdjacencyBegins[v]; ct < m_vecAdjacencyEnds[v]; ct++)
+			{
+				for(uint32_t uCorner = 0; uCorner < 3; uCorner++)
+				{
+					const uint32_t n = vecIndices[m_vecAdjacentTriangles[ct] * 3 + uCorner];
+					if(m_vecMarks[n] != m_uMark)
+					{
+						m_vecMarks[n] = m_uMark;
+						vecEdgeUseCounts[n] = 0;
+					}
+					vecEdgeUseCounts[n]++;
+				}
+			}
+
+			for(uint32_t ct = m_vecAdjacencyBegins[v]; ct < m_vecAdjacencyEnds[v]; ct++)
+			{
+				const uint32_t* pTriangle = &vecIndices[m_vecAdjacentTriangles[ct] * 3];
+				for(uint32_t uCorner = 0; uCorner < 3; uCorner++)
+				{
+					const uint32_t n = pTriangle[uCorner];
+					if((n == v) || (vecEdgeUseCounts[n] == 2))
+					{
+						continue;
+					}
+
+					if(vecEdgeUseCounts[n] > 2)
+					{
+						m_vecVertexFlags[v] |= VF_FIXED;
+						continue;
+					}
+
+					m_vecVertexFlags[v] |= VF_ON_OPEN_EDGE;
+
+					//The edge of the hole must stay where it is, so the vertex also gets the plane which
+					//contains the edge and is at right angles to the triangle. It can then only move
+					//along a straight stretch of the edge without adding to its error.
+					const Vector3DFloat& v0Pos = vecVertices[pTriangle[0]].getPosition();
+					const Vector3DFloat v3dTriangleNormal = (vecVertices[pTriangle[1]].getPosition() - v0Pos).cross(vecVertices[pTriangle[2]].getPosition() - v0Pos);
+					const Vector3DFloat v3dEdge = vecVertices[n].getPosition() - vecVertices[v].getPosition();
+					const Vector3DFloat v3dPlaneNormal = v3dEdge.cross(v3dTriangleNormal);
+
+					double a = v3dPlaneNormal.getX();
+					double b = v3dPlaneNormal.getY();
+					double c = v3dPlaneNormal.getZ();
+					const double dLength = std::sqrt(a * a + b * b + c * c);
+					if(dLength == 0.0)
+					{
+						continue;
+					}
+
+					a /= dLength;
+					b /= dLength;
+					c /= dLength;
+					const Vector3DFloat& v3dPos = vecVertices[v].getPosition();
+					m_vecQuadrics[v].addPlane(a, b, c, -(a * v3dPos.getX() + b * v3dPos.getY() + c * v3dPos.getZ()));
+				}
+			}
+		}
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::gatherTriangles(uint32_t v, std::vector<uint32_t>& vecTriangles)
+	{
+		const std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+
+		//Triangles which have collapsed since the vertex's range was written are skipped
+		//until removeCollapsedTriangles() gets rid of them.
+		vecTriangles.clear();
+		for(uint32_t ct = m_vecAdjacencyBegins[v]; ct < m_vecAdjacencyEnds[v]; ct++)
+		{
+			const uint32_t uTriangle = m_vecAdjacentTriangles[ct];
+			const uint32_t v0 = vecIndices[uTriangle * 3];
+			const uint32_t v1 = vecIndices[uTriangle * 3 + 1];
+			const uint32_t v2 = vecIndices[uTriangle * 3 + 2];
+			if((v0 != v1) && (v1 != v2) && (v2 != v0))
+			{
+				vecTriangles.push_back(uTriangle);
+			}
+		}
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::queueCollapses(void)
+	{
+		for(uint32_t ct = 0; ct < m_vecVertexFlags.size(); ct++)
+		{
+			queueCollapse(ct);
+		}
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::performCollapses(uint32_t uTargetTriangleCount)
+	{
+		//The collapses of the vertices around each collapse aren't found again straight away. Instead each collapse
+		//is checked as it comes off the queue, and is only found again if it has become more expensive or can no longer be done.
+		while((!m_vecCollapses.empty()) && (m_uNoOfTriangles > uTargetTriangleCount))
+		{
+			std::pop_heap(m_vecCollapses.begin(), m_vecCollapses.end());
+			const Collapse collapse = m_vecCollapses.back();
+			m_vecCollapses.pop_back();
+			m_vecVertexFlags[collapse.src] &= ~VF_QUEUED;
+
+			bool bStillValid = ((m_vecVertexFlags[collapse.dst] & VF_COLLAPSED) == 0) && (getCollapseError(collapse.src, collapse.dst) == collapse.cost);
+			if(bStillValid)
+			{
+				gatherTriangles(collapse.src, m_vecSrcTriangles);
+				bStillValid = canCollapse(collapse.src, collapse.dst);
+			}
+			if(!bStillValid)
+			{
+				queueCollapse(collapse.src);
+				continue;
+			}
+
+			applyCollapse(collapse.src, collapse.dst);
+			if(collapse.cost > m_fExactError)
+			{
+				m_bExact = false;
+			}
+
+			//Vertices whose neighbourhood has changed may be able to collapse now even if they couldn't before.
+			std::sort(m_vecChangedVertices.begin(), m_vecChangedVertices.end());
+			m_vecChangedVertices.erase(std::unique(m_vecChangedVertices.begin(), m_vecChangedVertices.end()), m_vecChangedVertices.end());
+			for(uint32_t ct = 0; ct < m_vecChangedVertices.size(); ct++)
+			{
+				queueCollapse(m_vecChangedVertices[ct]);
+			}
+
+			//Once enough triangles have collapsed, or enough ranges have been appended, skipping over
+			//the dead entries costs more than building the adjacency data again.
+			if((m_uNoOfCollapsedTriangles * 2 > m_uNoOfTriangles) || (m_vecAdjacentTriangles.size() >= m_vecAdjacentTriangles.capacity()))
+			{
+				removeCollapsedTriangles();
+				buildAdjacency();
+			}
+		}
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::queueCollapse(uint32_t v)
+	{
+		//Each vertex has at most one collapse in the queue.
+		if(m_vecVertexFlags[v] & VF_QUEUED)
+		{
+			return;
+		}
+
+		Collapse collapse;
+		if(findCollapse(v, collapse))
+		{
+			m_vecCollapses.push_back(collapse);
+			std::push_heap(m_vecCollapses.begin(), m_vecCollapses.end());
+			m_vecVertexFlags[v] |= VF_QUEUED;
+		}
+	}
+
+	template <typename VertexType>
+	bool MeshSimplifier<VertexType>::findCollapse(uint32_t uSrc, Collapse& collapse)
+	{
+		const std::vector<VertexType>& vecVertices = m_pOutputMesh->m_vecVertices;
+		const std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+
+		if(m_vecVertexFlags[uSrc] & (VF_FIXED | VF_COLLAPSED))
+		{
+			return false;
+		}
+
+		//Vertices on the faces of the region may only move when it leaves the surface where it was, because
+		//the mesh of the neighbouring region can't move to match. The same goes for the other vertices on holes,
+		//which in a cubic mesh with merged quads are where a quad meets the side of a larger one.
+		const bool bExactOnly = (m_vecRegionFaces[uSrc] != 0) || (m_vecVertexFlags[uSrc] & VF_ON_OPEN_EDGE);
+		const float fMaxError = bExactOnly ? m_fExactError : (std::max)(m_fMaxError, m_fExactError);
+
+		gatherTriangles(uSrc, m_vecSrcTriangles);
+
+		m_vecCandidates.clear();
+		for(uint32_t ct = 0; ct < m_vecSrcTriangles.size(); ct++)
+		{
+			for(uint32_t uCorner = 0; uCorner < 3; uCorner++)
+			{
+				const uint32_t uDst = vecIndices[m_vecSrcTriangles[ct] * 3 + uCorner];
+				if(uDst == uSrc)
+				{
+					continue;
+				}
+
+				//Moving onto a vertex with a different material would change the material of the triangles.
+				if(vecVertices[uSrc].getMaterial() != vecVertices[uDst].getMaterial())
+				{
+					continue;
+				}
+
+				//We can collapse normal vertices onto face vertices, and face vertices onto edge or corner
+				//vertices, but not vice-versa. Hence all the faces of the source must also be faces of the destination.
+				if((m_vecRegionFaces[uSrc] & ~m_vecRegionFaces[uDst]) != 0)
+				{
+					continue;
+				}
+
+				//Most neighbours are seen twice, once from each of the triangles using the edge.
+				bool bAlreadySeen = false;
+				for(uint32_t uCandidate = 0; uCandidate < m_vecCandidates.size(); uCandidate++)
+				{
+					bAlreadySeen |= (m_vecCandidates[uCandidate].second == uDst);
+				}
+				if(bAlreadySeen)
+				{
+					continue;
+				}
+
+				const float fError = getCollapseError(uSrc, uDst);
+				if(fError <= fMaxError)
+				{
+					m_vecCandidates.push_back(std::make_pair(fError, uDst));
+				}
+			}
+		}
+
+		//The cheapest collapse might fold the mesh, in which case the next cheapest is tried.
+		std::sort(m_vecCandidates.begin(), m_vecCandidates.end());
+		for(uint32_t uCandidate = 0; uCandidate < m_vecCandidates.size(); uCandidate++)
+		{
+			if(canCollapse(uSrc, m_vecCandidates[uCandidate].second))
+			{
+				collapse.cost = m_vecCandidates[uCandidate].first;
+				collapse.src = uSrc;
+				collapse.dst = m_vecCandidates[uCandidate].second;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	template <typename VertexType>
+	float MeshSimplifier<VertexType>::getCollapseError(uint32_t uSrc, uint32_t uDst)
+	{
+		const Vector3DFloat& v3dDstPos = m_pOutputMesh->m_vecVertices[uDst].getPosition();
+		return static_cast<float>(m_vecQuadrics[uSrc].evaluate(v3dDstPos) + m_vecQuadrics[uDst].evaluate(v3dDstPos));
+	}
+
+	template <typename VertexType>
+	bool MeshSimplifier<VertexType>::canCollapse(uint32_t uSrc, uint32_t uDst)
+	{
+		const std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+
+		//Mark the neighbours of the source, and count the triangles using the edge (the ones which will vanish).
+		m_uMark += 2;
+		uint32_t uNoOfVanishingTriangles = 0;
+		for(uint32_t ct = 0; ct < m_vecSrcTriangles.size(); ct++)
+		{
+			for(uint32_t uCorner = 0; uCorner < 3; uCorner++)
+			{
+				const uint32_t n = vecIndices[m_vecSrcTriangles[ct] * 3 + uCorner];
+				if(n == uDst)
+				{
+					++uNoOfVanishingTriangles;
+				}
+				else if(n != uSrc)
+				{
+					m_vecMarks[n] = m_uMark;
+				}
+			}
+		}
+
+		//A vertex on a hole may only move along the edge of the hole.
+		if((m_vecVertexFlags[uSrc] & VF_ON_OPEN_EDGE) && (uNoOfVanishingTriangles != 1))
+		{
+			return false;
+		}
+
+		//The only neighbours which the two vertices have in common must be the third vertices of the
+		//vanishing triangles. Otherwise the collapse would join two parts of the mesh together.
+		gatherTriangles(uDst, m_vecDstTriangles);
+		uint32_t uNoOfSharedNeighbours = 0;
+		for(uint32_t ct = 0; ct < m_vecDstTriangles.size(); ct++)
+		{
+			for(uint32_t uCorner = 0; uCorner < 3; uCorner++)
+			{
+				const uint32_t n = vecIndices[m_vecDstTriangles[ct] * 3 + uCorner];
+				if(m_vecMarks[n] == m_uMark)
+				{
+					m_vecMarks[n] = m_uMark + 1;
+					++uNoOfSharedNeighbours;
+				}
+			}
+		}
+		if(uNoOfSharedNeighbours != uNoOfVanishingTriangles)
+		{
+			return false;
+		}
+
+		return !collapseFlipsTriangles(uSrc, uDst);
+	}
+
+	template <typename VertexType>
+	bool MeshSimplifier<VertexType>::collapseFlipsTriangles(uint32_t uSrc, uint32_t uDst)
+	{
+		const std::vector<VertexType>& vecVertices = m_pOutputMesh->m_vecVertices;
+		const std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+
+		for(uint32_t ct = 0; ct < m_vecSrcTriangles.size(); ct++)
+		{
+			const uint32_t uTriangle = m_vecSrcTriangles[ct];
+			const uint32_t v0 = vecIndices[uTriangle * 3];
+			const uint32_t v1 = vecIndices[uTriangle * 3 + 1];
+			const uint32_t v2 = vecIndices[uTriangle * 3 + 2];
+
+			//The triangles using the edge vanish, so it doesn't matter what happens to them.
+			if((v0 == uDst) || (v1 == uDst) || (v2 == uDst))
+			{
+				continue;
+			}
+
+			const Vector3DFloat& v0OldPos = vecVertices[v0].getPosition();
+			const Vector3DFloat& v1OldPos = vecVertices[v1].getPosition();
+			const Vector3DFloat& v2OldPos = vecVertices[v2].getPosition();
+
+			const Vector3DFloat& v0NewPos = vecVertices[(v0 == uSrc) ? uDst : v0].getPosition();
+			const Vector3DFloat& v1NewPos = vecVertices[(v1 == uSrc) ? uDst : v1].getPosition();
+			const Vector3DFloat& v2NewPos = vecVertices[(v2 == uSrc) ? uDst : v2].getPosition();
+
+			const Vector3DFloat v3dOldNormal = (v1OldPos - v0OldPos).cross(v2OldPos - v0OldPos);
+			const Vector3DFloat v3dNewNormal = (v1NewPos - v0NewPos).cross(v2NewPos - v0NewPos);
+
+			//Reject the collapse if any triangle turns over, becomes a sliver (so its normal vanishes)
+			//or turns by more than about 75 degrees, as a later collapse would probably turn it over.
+			const float fDotProduct = v3dOldNormal.dot(v3dNewNormal);
+			if((fDotProduct <= 0.0f) || (fDotProduct * fDotProduct < 0.0625f * v3dOldNormal.lengthSquared() * v3dNewNormal.lengthSquared()))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::applyCollapse(uint32_t uSrc, uint32_t uDst)
+	{
+		std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+
+		//The triangles using the edge end up using the destination twice. The rest now use the destination
+		//instead of the source, and the vertices of all of them have had their neighbourhoods changed.
+		m_vecChangedVertices.clear();
+		for(uint32_t ct = 0; ct < m_vecSrcTriangles.size(); ct++)
+		{
+			uint32_t* pTriangle = &vecIndices[m_vecSrcTriangles[ct] * 3];
+			if((pTriangle[0] == uDst) || (pTriangle[1] == uDst) || (pTriangle[2] == uDst))
+			{
+				--m_uNoOfTriangles;
+				++m_uNoOfCollapsedTriangles;
+			}
+
+			for(uint32_t uCorner = 0; uCorner < 3; uCorner++)
+			{
+				if(pTriangle[uCorner] == uSrc)
+				{
+					pTriangle[uCorner] = uDst;
+				}
+				m_vecChangedVertices.push_back(pTriangle[uCorner]);
+			}
+		}
+
+		//The destination's remaining triangles, and those it has taken over from the source, are
+		//given a new range at the end of the adjacency data. canCollapse() left the former in m_vecDstTriangles.
+		const uint32_t uBegin = m_vecAdjacentTriangles.size();
+		for(uint32_t ct = 0; ct < m_vecDstTriangles.size(); ct++)
+		{
+			const uint32_t* pTriangle = &vecIndices[m_vecDstTriangles[ct] * 3];
+			if((pTriangle[0] != pTriangle[1]) && (pTriangle[1] != pTriangle[2]) && (pTriangle[2] != pTriangle[0]))
+			{
+				m_vecAdjacentTriangles.push_back(m_vecDstTriangles[ct]);
+			}
+		}
+		for(uint32_t ct = 0; ct < m_vecSrcTriangles.size(); ct++)
+		{
+			const uint32_t* pTriangle = &vecIndices[m_vecSrcTriangles[ct] * 3];
+			if((pTriangle[0] != pTriangle[1]) && (pTriangle[1] != pTriangle[2]) && (pTriangle[2] != pTriangle[0]))
+			{
+				m_vecAdjacentTriangles.push_back(m_vecSrcTriangles[ct]);
+			}
+		}
+		m_vecAdjacencyBegins[uDst] = uBegin;
+		m_vecAdjacencyEnds[uDst] = m_vecAdjacentTriangles.size();
+
+		m_vecQuadrics[uDst].add(m_vecQuadrics[uSrc]);
+		m_vecVertexFlags[uSrc] |= VF_COLLAPSED;
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::removeCollapsedTriangles(void)
+	{
+		std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+		std::vector<LodRecord>& vecFacingRecords = m_pOutputMesh->m_vecFacingRecords;
+
+		//The facing records are moved down with the triangles they cover.
+		uint32_t uRead = 0;
+		uint32_t uWrite = 0;
+		for(uint32_t ct = 0; ct < vecFacingRecords.size(); ct++)
+		{
+			removeCollapsedTriangles(uRead, vecFacingRecords[ct].beginIndex, uWrite);
+			vecFacingRecords[ct].beginIndex = uWrite;
+			removeCollapsedTriangles(uRead, vecFacingRecords[ct].endIndex, uWrite);
+			vecFacingRecords[ct].endIndex = uWrite;
+		}
+		removeCollapsedTriangles(uRead, vecIndices.size(), uWrite);
+
+		vecIndices.resize(uWrite);
+		m_uNoOfTriangles = uWrite / 3;
+		m_uNoOfCollapsedTriangles = 0;
+	}
+
+	template <typename VertexType>
+	void MeshSimplifier<VertexType>::removeCollapsedTriangles(uint32_t& uRead, uint32_t uEnd, uint32_t& uWrite)
+	{
+		std::vector<uint32_t>& vecIndices = m_pOutputMesh->m_vecTriangleIndices;
+
+		for(; uRead < uEnd; uRead += 3)
+		{
+			const uint32_t v0 = vecIndices[uRead];
+			const uint32_t v1 = vecIndices[uRead + 1];
+			const uint32_t v2 = vecIndices[uRead + 2];
+
+			if((v0 != v1) && (v1 != v2) && (v2 != v0))
+			{
+				vecIndices[uWrite] = v0;
+				vecIndices[uWrite + 1] = v1;
+				vecIndices[uWrite + 2] = v2;
+				uWrite += 3;
+			}
+		}
+	}
+}
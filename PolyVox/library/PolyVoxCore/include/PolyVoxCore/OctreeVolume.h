@@ -0,0 +1,199 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#ifndef __PolyVox_OctreeVolume_H__
+#define __PolyVox_OctreeVolume_H__
+
+#include "PolyVoxCore/BaseVolume.h"
+#include "PolyVoxCore/Log.h"
+#include "PolyVoxCore/Region.h"
+#include "PolyVoxCore/Vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <stdexcept> //For invalid_argument
+#include <vector>
+
+namespace PolyVox
+{
+	///The OctreeVolume class stores voxels in a sparse octree.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// The SimpleVolume and LargeVolume both divide the volume into blocks of a fixed size, which means that memory usage grows with the
+	/// size of the volume even if most of it is empty. The OctreeVolume instead stores a tree in which each node covers a cube of voxels
+	/// and either has eight children or is a leaf holding a single value for the whole cube. Whenever all eight children of a node end up
+	/// as leaves with the same value they are collapsed back into their parent, so large homogeneous areas (such as empty space or solid
+	/// rock) cost a single node regardless of their size.
+	///
+	/// The root node covers the smallest power-of-two sized cube which encloses the volume. All the nodes are kept in a single pool, with
+	/// the eight children of a node stored consecutively. Groups of children released by collapsing are reused by later writes.
+	///
+	/// The Sampler caches the path from the root to the leaf containing its current position. Moving the sampler or peeking at a
+	/// neighbour only needs to climb that path as far as the first node which also contains the new position, and in the common case the
+	/// new position lies in the same leaf and no traversal is needed at all. Note that writing to the volume can restructure the tree, so
+	/// any other samplers should be repositioned with setPosition() after a write.
+	///
+	/// Each internal node also caches the minimum of the voxels beneath it. These are used by Sampler::getSubSampledVoxel(), which for a
+	/// suitably aligned position can simply read the value of the node at the requested level. The cached values are recomputed lazily,
+	/// so volumes which are never subsampled never pay for them.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	class OctreeVolume : public BaseVolume<VoxelType>
+	{
+	public:
+		#ifndef SWIG
+		//See the comments in SimpleVolume.h regarding the Visual Studio and GCC differences here.
+#if defined(_MSC_VER)
+		class Sampler : public BaseVolume<VoxelType>::Sampler< OctreeVolume<VoxelType> > //This line works on VS2010
+#else
+                class Sampler : public BaseVolume<VoxelType>::template Sampler< OctreeVolume<VoxelType> > //This line works on GCC
+#endif
+		{
+		public:
+			Sampler(OctreeVolume<VoxelType>* volume);
+			~Sampler();
+
+			VoxelType getSubSampledVoxel(uint8_t uLevel) const;
+			inline VoxelType getVoxel(void) const;			
+
+			void setPosition(const Vector3DInt32& v3dNewPos);
+			void setPosition(int32_t xPos, int32_t yPos, int32_t zPos);
+			inline bool setVoxel(VoxelType tValue);
+
+			void movePositiveX(void);
+			void movePositiveY(void);
+			void movePositiveZ(void);
+
+			void moveNegativeX(void);
+			void moveNegativeY(void);
+			void moveNegativeZ(void);
+
+			inline VoxelType peekVoxel1nx1ny1nz(void) const;
+			inline VoxelType peekVoxel1nx1ny0pz(void) const;
+			inline VoxelType peekVoxel1nx1ny1pz(void) const;
+			inline VoxelType peekVoxel1nx0py1nz(void) const;
+			inline VoxelType peekVoxel1nx0py0pz(void) const;
+			inline VoxelType peekVoxel1nx0py1pz(void) const;
+			inline VoxelType peekVoxel1nx1py1nz(void) const;
+			inline VoxelType peekVoxel1nx1py0pz(void) const;
+			inline VoxelType peekVoxel1nx1py1pz(void) const;
+
+			inline VoxelType peekVoxel0px1ny1nz(void) const;
+			inline VoxelType peekVoxel0px1ny0pz(void) const;
+			inline VoxelType peekVoxel0px1ny1pz(void) const;
+			inline VoxelType peekVoxel0px0py1nz(void) const;
+			inline VoxelType peekVoxel0px0py0pz(void) const;
+			inline VoxelType peekVoxel0px0py1pz(void) const;
+			inline VoxelType peekVoxel0px1py1nz(void) const;
+			inline VoxelType peekVoxel0px1py0pz(void) const;
+			inline VoxelType peekVoxel0px1py1pz(void) const;
+
+			inline VoxelType peekVoxel1px1ny1nz(void) const;
+			inline VoxelType peekVoxel1px1ny0pz(void) const;
+			inline VoxelType peekVoxel1px1ny1pz(void) const;
+			inline VoxelType peekVoxel1px0py1nz(void) const;
+			inline VoxelType peekVoxel1px0py0pz(void) const;
+			inline VoxelType peekVoxel1px0py1pz(void) const;
+			inline VoxelType peekVoxel1px1py1nz(void) const;
+			inline VoxelType peekVoxel1px1py0pz(void) const;
+			inline VoxelType peekVoxel1px1py1pz(void) const;
+
+			/// Reads the 3x3x3 neighbourhood of the current position, indexed by <tt>(x+1) + (y+1)*3 + (z+1)*9</tt>.
+			inline void peekNeighbourhood(VoxelType pStencil[27]) const;
+			/// Reads the 2x2x2 cell whose lower corner is the current position, indexed by <tt>x + y*2 + z*4</tt>.
+			inline void peekCell(VoxelType pCell[8]) const;
+
+		private:
+			//Finds the leaf containing the current position, reusing as much of the cached path as possible.
+			void updatePath(void);
+			//Reads a voxel relative to the current position, starting the search from the cached path.
+			VoxelType peekRelative(int32_t xOffset, int32_t yOffset, int32_t zOffset) const;
+
+			//The nodes from the root down to the leaf containing mPathX, mPathY and mPathZ (relative to the lower corner of the volume).
+			uint32_t mPath[32];
+			uint8_t mLeafDepth;
+			int32_t mPathX;
+			int32_t mPathY;
+			int32_t mPathZ;
+
+			VoxelType mCurrentVoxel;
+		};
+		#endif
+
+	public:
+		/// Constructor for creating a fixed size volume.
+		OctreeVolume(const Region& regValid);
+		/// Destructor
+		~OctreeVolume();
+
+		/// Gets the value used for voxels which are outside the volume
+		VoxelType getBorderValue(void) const;
+		/// Gets a voxel at the position given by <tt>x,y,z</tt> coordinates
+		VoxelType getVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos) const;
+		/// Gets a voxel at the position given by a 3D vector
+		VoxelType getVoxelAt(const Vector3DInt32& v3dPos) const;
+		/// Gets the number of nodes which are currently part of the tree
+		uint32_t getNoOfNodes(void) const;
+
+		/// Sets the value used for voxels which are outside the volume
+		void setBorderValue(const VoxelType& tBorder);
+		/// Sets the voxel at the position given by <tt>x,y,z</tt> coordinates
+		bool setVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue);
+		/// Sets the voxel at the position given by a 3D vector
+		bool setVoxelAt(const Vector3DInt32& v3dPos, VoxelType tValue);
+
+		/// Calculates approximatly how many bytes of memory the volume is currently using.
+		uint32_t calculateSizeInBytes(void);
+
+	private:
+		struct Node
+		{
+			//Index of the first of the eight children, or zero for a leaf. The root is
+			//node zero so it can never be a child.
+			uint32_t uFirstChild;
+			//For a leaf this is the value of every voxel in the node. For an internal node
+			//it is the cached minimum of the voxels beneath it (see getSubSampledVoxel()).
+			VoxelType tValue;
+			bool bMinimumIsValid;
+		};
+
+		uint32_t getChildIndex(int32_t iXPos, int32_t iYPos, int32_t iZPos, uint8_t uDepth) const;
+		uint32_t allocateChildren(VoxelType tValue);
+		VoxelType getMinimumOfNode(uint32_t uNode);
+
+		//The pool of nodes. The root is always at index zero.
+		std::vector<Node> m_vecNodes;
+		//Indices of groups of eight nodes which are no longer part of the tree.
+		std::vector<uint32_t> m_vecFreeChildren;
+
+		//The root covers a cube with sides of length 2^m_uDepth.
+		uint8_t m_uDepth;
+
+		VoxelType m_tBorderValue;
+	};
+}
+
+#include "PolyVoxCore/OctreeVolume.inl"
+#include "PolyVoxCore/OctreeVolumeSampler.inl"
+
+#endif //__PolyVox_OctreeVolume_H__
@@ -0,0 +1,291 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+namespace PolyVox
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/// This constructor creates a volume with a fixed size which is specified as a parameter.
+	/// Initially the whole volume is a single leaf holding the default voxel value.
+	/// \param regValid Specifies the minimum and maximum valid voxel positions.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	OctreeVolume<VoxelType>::OctreeVolume(const Region& regValid)
+	:BaseVolume<VoxelType>(regValid)
+	{
+		setBorderValue(VoxelType());
+
+		//Other properties we might find useful later
+		this->m_uLongestSideLength = (std::max)((std::max)(this->getWidth(),this->getHeight()),this->getDepth());
+		this->m_uShortestSideLength = (std::min)((std::min)(this->getWidth(),this->getHeight()),this->getDepth());
+		this->m_fDiagonalLength = sqrtf(static_cast<float>(this->getWidth() * this->getWidth() + this->getHeight() * this->getHeight() + this->getDepth() * this->getDepth()));
+
+		//The root must cover a power-of-two sized cube which encloses the whole volume.
+		m_uDepth = 0;
+		while((static_cast<uint32_t>(1) << m_uDepth) < static_cast<uint32_t>(this->m_uLongestSideLength))
+		{
+			++m_uDepth;
+		}
+
+		Node root;
+		root.uFirstChild = 0;
+		root.tValue = VoxelType();
+		root.bMinimumIsValid = false;
+		m_vecNodes.push_back(root);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Destroys the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	OctreeVolume<VoxelType>::~OctreeVolume()
+	{
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The border value is returned whenever an attempt is made to read a voxel which
+	/// is outside the extents of the volume.
+	/// \return The value used for voxels outside of the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::getBorderValue(void) const
+	{
+		return m_tBorderValue;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param uXPos The \c x position of the voxel
+	/// \param uYPos The \c y position of the voxel
+	/// \param uZPos The \c z position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::getVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos) const
+	{
+		if(this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)))
+		{
+			const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
+			const int32_t iXPos = uXPos - v3dLowerCorner.getX();
+			const int32_t iYPos = uYPos - v3dLowerCorner.getY();
+			const int32_t iZPos = uZPos - v3dLowerCorner.getZ();
+
+			uint32_t uNode = 0;
+			uint8_t uDepth = 0;
+			while(m_vecNodes[uNode].uFirstChild != 0)
+			{
+				uNode = m_vecNodes[uNode].uFirstChild + getChildIndex(iXPos, iYPos, iZPos, uDepth);
+				++uDepth;
+			}
+			return m_vecNodes[uNode].tValue;
+		}
+		else
+		{
+			return getBorderValue();
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos The 3D position of the voxel
+	/// \return The voxel value
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::getVoxelAt(const Vector3DInt32& v3dPos) const
+	{
+		return getVoxelAt(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// A volume which has never been written to consists of just the root node. Each
+	/// write can add at most eight nodes per level of the tree, and collapsing
+	/// homogeneous areas removes them again.
+	/// \return The number of nodes currently in the tree
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t OctreeVolume<VoxelType>::getNoOfNodes(void) const
+	{
+		return static_cast<uint32_t>(m_vecNodes.size() - m_vecFreeChildren.size() * 8);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param tBorder The value to use for voxels outside the volume.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void OctreeVolume<VoxelType>::setBorderValue(const VoxelType& tBorder) 
+	{
+		m_tBorderValue = tBorder;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Leaves on the way down to the voxel are split as required. Afterwards, any
+	/// node whose children have all become leaves with the same value is collapsed.
+	/// \param uXPos the \c x position of the voxel
+	/// \param uYPos the \c y position of the voxel
+	/// \param uZPos the \c z position of the voxel
+	/// \param tValue the value to which the voxel will be set
+	/// \return whether the requested position is inside the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool OctreeVolume<VoxelType>::setVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue)
+	{
+		if(this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)) == false)
+		{
+			return false;
+		}
+
+		const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
+		const int32_t iXPos = uXPos - v3dLowerCorner.getX();
+		const int32_t iYPos = uYPos - v3dLowerCorner.getY();
+		const int32_t iZPos = uZPos - v3dLowerCorner.getZ();
+
+		//Walk down to the voxel, remembering the path so we can collapse nodes afterwards.
+		uint32_t path[32];
+		uint32_t uNode = 0;
+		path[0] = 0;
+		for(uint8_t uDepth = 0; uDepth < m_uDepth; ++uDepth)
+		{
+			if(m_vecNodes[uNode].uFirstChild == 0)
+			{
+				//If the leaf already has the right value then there is nothing to do.
+				if(m_vecNodes[uNode].tValue == tValue)
+				{
+					return true;
+				}
+
+				//Otherwise it is split into eight children which start off with its value. Note
+				//that this can reallocate the pool, so we always work with indices here.
+				const uint32_t uFirstChild = allocateChildren(m_vecNodes[uNode].tValue);
+				m_vecNodes[uNode].uFirstChild = uFirstChild;
+			}
+
+			m_vecNodes[uNode].bMinimumIsValid = false;
+			uNode = m_vecNodes[uNode].uFirstChild + getChildIndex(iXPos, iYPos, iZPos, uDepth);
+			path[uDepth + 1] = uNode;
+		}
+
+		m_vecNodes[uNode].tValue = tValue;
+
+		//Collapse any nodes which have become homogeneous, working back up towards the root.
+		for(int32_t iDepth = m_uDepth - 1; iDepth >= 0; --iDepth)
+		{
+			Node& parent = m_vecNodes[path[iDepth]];
+			const uint32_t uFirstChild = parent.uFirstChild;
+			for(uint32_t ct = 0; ct < 8; ++ct)
+			{
+				const Node& child = m_vecNodes[uFirstChild + ct];
+				if((child.uFirstChild != 0) || (child.tValue != tValue))
+				{
+					return true;
+				}
+			}
+
+			parent.uFirstChild = 0;
+			parent.tValue = tValue;
+			m_vecFreeChildren.push_back(uFirstChild);
+		}
+
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// \param v3dPos the 3D position of the voxel
+	/// \param tValue the value to which the voxel will be set
+	/// \return whether the requested position is inside the volume
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool OctreeVolume<VoxelType>::setVoxelAt(const Vector3DInt32& v3dPos, VoxelType tValue)
+	{
+		return setVoxelAt(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ(), tValue);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Note: This function needs reviewing for accuracy...
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	uint32_t OctreeVolume<VoxelType>::calculateSizeInBytes(void)
+	{
+		uint32_t uSizeInBytes = sizeof(OctreeVolume);
+
+		uSizeInBytes += m_vecNodes.capacity() * sizeof(Node);
+		uSizeInBytes += m_vecFreeChildren.capacity() * sizeof(uint32_t);
+
+		return uSizeInBytes;
+	}
+
+	template <typename VoxelType>
+	uint32_t OctreeVolume<VoxelType>::getChildIndex(int32_t iXPos, int32_t iYPos, int32_t iZPos, uint8_t uDepth) const
+	{
+		//The positions are relative to the lower corner of the volume, so the bit at this depth
+		//says which half of the node the position is in along each axis.
+		const uint8_t uShift = m_uDepth - uDepth - 1;
+		return ((iXPos >> uShift) & 1) | (((iYPos >> uShift) & 1) << 1) | (((iZPos >> uShift) & 1) << 2);
+	}
+
+	template <typename VoxelType>
+	uint32_t OctreeVolume<VoxelType>::allocateChildren(VoxelType tValue)
+	{
+		//Note that tValue is passed by value as it may refer to a node in the pool, which we are about to resize.
+		uint32_t uFirstChild;
+		if(m_vecFreeChildren.empty())
+		{
+			uFirstChild = static_cast<uint32_t>(m_vecNodes.size());
+			m_vecNodes.resize(m_vecNodes.size() + 8);
+		}
+		else
+		{
+			uFirstChild = m_vecFreeChildren.back();
+			m_vecFreeChildren.pop_back();
+		}
+
+		for(uint32_t ct = 0; ct < 8; ++ct)
+		{
+			Node& child = m_vecNodes[uFirstChild + ct];
+			child.uFirstChild = 0;
+			child.tValue = tValue;
+			child.bMinimumIsValid = false;
+		}
+
+		return uFirstChild;
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::getMinimumOfNode(uint32_t uNode)
+	{
+		//Leaves, and nodes which have not been written to since the minimum was last
+		//computed, can return their value straight away.
+		const Node& node = m_vecNodes[uNode];
+		if((node.uFirstChild == 0) || (node.bMinimumIsValid))
+		{
+			return node.tValue;
+		}
+
+		const uint32_t uFirstChild = node.uFirstChild;
+		VoxelType tValue = getMinimumOfNode(uFirstChild);
+		for(uint32_t ct = 1; ct < 8; ++ct)
+		{
+			tValue = (std::min)(tValue, getMinimumOfNode(uFirstChild + ct));
+		}
+
+		m_vecNodes[uNode].tValue = tValue;
+		m_vecNodes[uNode].bMinimumIsValid = true;
+		return tValue;
+	}
+}
@@ -0,0 +1,455 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+namespace PolyVox
+{
+	template <typename VoxelType>
+	OctreeVolume<VoxelType>::Sampler::Sampler(OctreeVolume<VoxelType>* volume)
+		:BaseVolume<VoxelType>::template Sampler< OctreeVolume<VoxelType> >(volume)
+	{
+		setPosition(0,0,0);
+	}
+
+	template <typename VoxelType>
+	OctreeVolume<VoxelType>::Sampler::~Sampler()
+	{
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::getSubSampledVoxel(uint8_t uLevel) const
+	{
+		if(uLevel == 0)
+		{
+			return getVoxel();
+		}
+
+		const int32_t iSize = 1 << uLevel;
+		const Vector3DInt32& v3dLowerCorner = this->mVolume->m_regValidRegion.getLowerCorner();
+		const Vector3DInt32& v3dUpperCorner = this->mVolume->m_regValidRegion.getUpperCorner();
+		const int32_t iXPos = this->mXPosInVolume - v3dLowerCorner.getX();
+		const int32_t iYPos = this->mYPosInVolume - v3dLowerCorner.getY();
+		const int32_t iZPos = this->mZPosInVolume - v3dLowerCorner.getZ();
+
+		//If the requested cube is exactly covered by a node (or lies within a leaf) then the answer is
+		//the cached minimum of that node. This only holds if the whole cube is inside the volume, as
+		//otherwise some of it should read as the border value.
+		if((uLevel <= this->mVolume->m_uDepth) &&
+			(((iXPos | iYPos | iZPos) & (iSize - 1)) == 0) &&
+			(iXPos >= 0) && (iYPos >= 0) && (iZPos >= 0) &&
+			(this->mXPosInVolume + iSize - 1 <= v3dUpperCorner.getX()) &&
+			(this->mYPosInVolume + iSize - 1 <= v3dUpperCorner.getY()) &&
+			(this->mZPosInVolume + iSize - 1 <= v3dUpperCorner.getZ()))
+		{
+			const std::vector<Node>& vecNodes = this->mVolume->m_vecNodes;
+			const uint8_t uTargetDepth = this->mVolume->m_uDepth - uLevel;
+
+			//Climb the cached path until we reach a node containing the cube...
+			const uint32_t uDiff = static_cast<uint32_t>((iXPos ^ mPathX) | (iYPos ^ mPathY) | (iZPos ^ mPathZ));
+			uint8_t uDepth = (std::min)(mLeafDepth, uTargetDepth);
+			while((uDiff >> (this->mVolume->m_uDepth - uDepth)) != 0)
+			{
+				--uDepth;
+			}
+
+			//...then descend to the node which covers it exactly, or to the leaf which contains it.
+			uint32_t uNode = mPath[uDepth];
+			while((uDepth < uTargetDepth) && (vecNodes[uNode].uFirstChild != 0))
+			{
+				uNode = vecNodes[uNode].uFirstChild + this->mVolume->getChildIndex(iXPos, iYPos, iZPos, uDepth);
+				++uDepth;
+			}
+
+			return this->mVolume->getMinimumOfNode(uNode);
+		}
+		else
+		{
+			VoxelType tValue = (std::numeric_limits<VoxelType>::max)();
+			for(int32_t z = 0; z < iSize; ++z)
+			{
+				for(int32_t y = 0; y < iSize; ++y)
+				{
+					for(int32_t x = 0; x < iSize; ++x)
+					{
+						tValue = (std::min)(tValue, this->mVolume->getVoxelAt(this->mXPosInVolume + x, this->mYPosInVolume + y, this->mZPosInVolume + z));
+					}
+				}
+			}
+			return tValue;
+		}
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::getVoxel(void) const
+	{
+		return mCurrentVoxel;
+	}
+
+	template <typename VoxelType>
+	void OctreeVolume<VoxelType>::Sampler::setPosition(const Vector3DInt32& v3dNewPos)
+	{
+		setPosition(v3dNewPos.getX(), v3dNewPos.getY(), v3dNewPos.getZ());
+	}
+
+	template <typename VoxelType>
+	void OctreeVolume<VoxelType>::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos)
+	{
+		this->mXPosInVolume = xPos;
+		this->mYPosInVolume = yPos;
+		this->mZPosInVolume = zPos;
+
+		//The volume may have been modified since the path was cached, so start again from the root.
+		mPath[0] = 0;
+		mLeafDepth = 0;
+		mPathX = 0;
+		mPathY = 0;
+		mPathZ = 0;
+		updatePath();
+	}
+
+	template <typename VoxelType>
+	bool OctreeVolume<VoxelType>::Sampler::setVoxel(VoxelType tValue)
+	{
+		bool bResult = this->mVolume->setVoxelAt(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume, tValue);
+
+		//Writing can split or collapse nodes so the cached path may no longer be valid.
+		setPosition(this->mXPosInVolume, this->mYPosInVolume, this->mZPosInVolume);
+
+		return bResult;
+	}
+
+	template <typename VoxelType>
+	void OctreeVolume<VoxelType>::Sampler::movePositiveX(void)
+	{
+		++this->mXPosInVolume;
+		updatePath();
+	}
+
+	template <typename VoxelType>
+	void OctreeVolume<VoxelType>::Sampler::movePositiveY(void)
+	{
+		++this->mYPosInVolume;
+		updatePath();
+	}
+
+	template <typename VoxelType>
+	void OctreeVolume<VoxelType>::Sampler::movePositiveZ(void)
+	{
+		++this->mZPosInVolume;
+		updatePath();
+	}
+
+	template <typename VoxelType>
+	void OctreeVolume<VoxelType>::Sampler::moveNegativeX(void)
+	{
+		--this->mXPosInVolume;
+		updatePath();
+	}
+
+	template <typename VoxelType>
+	void OctreeVolume<VoxelType>::Sampler::moveNegativeY(void)
+	{
+		--this->mYPosInVolume;
+		updatePath();
+	}
+
+	template <typename VoxelType>
+	void OctreeVolume<VoxelType>::Sampler::moveNegativeZ(void)
+	{
+		--this->mZPosInVolume;
+		updatePath();
+	}
+
+	template <typename VoxelType>
+	void OctreeVolume<VoxelType>::Sampler::updatePath(void)
+	{
+		const Vector3DInt32& v3dLowerCorner = this->mVolume->m_regValidRegion.getLowerCorner();
+		const Vector3DInt32& v3dUpperCorner = this->mVolume->m_regValidRegion.getUpperCorner();
+		if((this->mXPosInVolume < v3dLowerCorner.getX()) || (this->mXPosInVolume > v3dUpperCorner.getX()) ||
+			(this->mYPosInVolume < v3dLowerCorner.getY()) || (this->mYPosInVolume > v3dUpperCorner.getY()) ||
+			(this->mZPosInVolume < v3dLowerCorner.getZ()) || (this->mZPosInVolume > v3dUpperCorner.getZ()))
+		{
+			//The cached path is left alone. It still leads to a valid leaf so we can continue from it later.
+			mCurrentVoxel = this->mVolume->getBorderValue();
+			return;
+		}
+
+		const int32_t iXPos = this->mXPosInVolume - v3dLowerCorner.getX();
+		const int32_t iYPos = this->mYPosInVolume - v3dLowerCorner.getY();
+		const int32_t iZPos = this->mZPosInVolume - v3dLowerCorner.getZ();
+
+		//Climb the cached path until we reach a node which also contains the new position. The
+		//nodes are aligned to their size, so this is where the positions agree in all higher bits.
+		const uint32_t uDiff = static_cast<uint32_t>((iXPos ^ mPathX) | (iYPos ^ mPathY) | (iZPos ^ mPathZ));
+		while((uDiff >> (this->mVolume->m_uDepth - mLeafDepth)) != 0)
+		{
+			--mLeafDepth;
+		}
+
+		//Then descend to the leaf which contains it.
+		const std::vector<Node>& vecNodes = this->mVolume->m_vecNodes;
+		uint32_t uNode = mPath[mLeafDepth];
+		while(vecNodes[uNode].uFirstChild != 0)
+		{
+			uNode = vecNodes[uNode].uFirstChild + this->mVolume->getChildIndex(iXPos, iYPos, iZPos, mLeafDepth);
+			mPath[++mLeafDepth] = uNode;
+		}
+
+		mPathX = iXPos;
+		mPathY = iYPos;
+		mPathZ = iZPos;
+		mCurrentVoxel = vecNodes[uNode].tValue;
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekRelative(int32_t xOffset, int32_t yOffset, int32_t zOffset) const
+	{
+		const int32_t xPos = this->mXPosInVolume + xOffset;
+		const int32_t yPos = this->mYPosInVolume + yOffset;
+		const int32_t zPos = this->mZPosInVolume + zOffset;
+
+		const Vector3DInt32& v3dLowerCorner = this->mVolume->m_regValidRegion.getLowerCorner();
+		const Vector3DInt32& v3dUpperCorner = this->mVolume->m_regValidRegion.getUpperCorner();
+		if((xPos < v3dLowerCorner.getX()) || (xPos > v3dUpperCorner.getX()) ||
+			(yPos < v3dLowerCorner.getY()) || (yPos > v3dUpperCorner.getY()) ||
+			(zPos < v3dLowerCorner.getZ()) || (zPos > v3dUpperCorner.getZ()))
+		{
+			return this->mVolume->getBorderValue();
+		}
+
+		const int32_t iXPos = xPos - v3dLowerCorner.getX();
+		const int32_t iYPos = yPos - v3dLowerCorner.getY();
+		const int32_t iZPos = zPos - v3dLowerCorner.getZ();
+
+		//As in updatePath(), but without modifying the cached path. Most of the time the
+		//neighbour is in the same leaf and neither loop does any work.
+		const uint32_t uDiff = static_cast<uint32_t>((iXPos ^ mPathX) | (iYPos ^ mPathY) | (iZPos ^ mPathZ));
+		uint8_t uDepth = mLeafDepth;
+		while((uDiff >> (this->mVolume->m_uDepth - uDepth)) != 0)
+		{
+			--uDepth;
+		}
+
+		const std::vector<Node>& vecNodes = this->mVolume->m_vecNodes;
+		uint32_t uNode = mPath[uDepth];
+		while(vecNodes[uNode].uFirstChild != 0)
+		{
+			uNode = vecNodes[uNode].uFirstChild + this->mVolume->getChildIndex(iXPos, iYPos, iZPos, uDepth);
+			++uDepth;
+		}
+
+		return vecNodes[uNode].tValue;
+	}
+
+	template <typename VoxelType>
+	void OctreeVolume<VoxelType>::Sampler::peekNeighbourhood(VoxelType pStencil[27]) const
+	{
+		for(int32_t z = 0; z < 3; z++)
+		{
+			for(int32_t y = 0; y < 3; y++)
+			{
+				for(int32_t x = 0; x < 3; x++)
+				{
+					pStencil[x + y * 3 + z * 9] = peekRelative(x - 1, y - 1, z - 1);
+				}
+			}
+		}
+	}
+
+	template <typename VoxelType>
+	void OctreeVolume<VoxelType>::Sampler::peekCell(VoxelType pCell[8]) const
+	{
+		pCell[0] = mCurrentVoxel;
+		for(int32_t ct = 1; ct < 8; ct++)
+		{
+			pCell[ct] = peekRelative(ct & 1, (ct >> 1) & 1, (ct >> 2) & 1);
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1nx1ny1nz(void) const
+	{
+		return peekRelative(-1,-1,-1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1nx1ny0pz(void) const
+	{
+		return peekRelative(-1,-1,0);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1nx1ny1pz(void) const
+	{
+		return peekRelative(-1,-1,1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1nx0py1nz(void) const
+	{
+		return peekRelative(-1,0,-1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1nx0py0pz(void) const
+	{
+		return peekRelative(-1,0,0);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1nx0py1pz(void) const
+	{
+		return peekRelative(-1,0,1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1nx1py1nz(void) const
+	{
+		return peekRelative(-1,1,-1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1nx1py0pz(void) const
+	{
+		return peekRelative(-1,1,0);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1nx1py1pz(void) const
+	{
+		return peekRelative(-1,1,1);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel0px1ny1nz(void) const
+	{
+		return peekRelative(0,-1,-1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel0px1ny0pz(void) const
+	{
+		return peekRelative(0,-1,0);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel0px1ny1pz(void) const
+	{
+		return peekRelative(0,-1,1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel0px0py1nz(void) const
+	{
+		return peekRelative(0,0,-1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel0px0py0pz(void) const
+	{
+		return mCurrentVoxel;
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel0px0py1pz(void) const
+	{
+		return peekRelative(0,0,1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel0px1py1nz(void) const
+	{
+		return peekRelative(0,1,-1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel0px1py0pz(void) const
+	{
+		return peekRelative(0,1,0);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel0px1py1pz(void) const
+	{
+		return peekRelative(0,1,1);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1px1ny1nz(void) const
+	{
+		return peekRelative(1,-1,-1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1px1ny0pz(void) const
+	{
+		return peekRelative(1,-1,0);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1px1ny1pz(void) const
+	{
+		return peekRelative(1,-1,1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1px0py1nz(void) const
+	{
+		return peekRelative(1,0,-1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1px0py0pz(void) const
+	{
+		return peekRelative(1,0,0);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1px0py1pz(void) const
+	{
+		return peekRelative(1,0,1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1px1py1nz(void) const
+	{
+		return peekRelative(1,1,-1);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1px1py0pz(void) const
+	{
+		return peekRelative(1,1,0);
+	}
+
+	template <typename VoxelType>
+	VoxelType OctreeVolume<VoxelType>::Sampler::peekVoxel1px1py1pz(void) const
+	{
+		return peekRelative(1,1,1);
+	}
+}
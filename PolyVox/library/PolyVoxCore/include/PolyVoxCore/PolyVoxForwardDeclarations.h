@@ -64,6 +64,18 @@ namespace PolyVox
 	template <typename VoxelType> class LargeVolume;
 	//---------------------------------
 
+	//---------- ColumnVolume ----------
+	template <typename VoxelType> class ColumnVolume;
+	//----------------------------------
+
+	//---------- FixedBlockVolume ----------
+	template <typename VoxelType, uint8_t BlockSideLengthPower> class FixedBlockVolume;
+	//--------------------------------------
+
+	//---------- OctreeVolume ----------
+	template <typename VoxelType> class OctreeVolume;
+	//----------------------------------
+
 
 	template <typename Type> class Density;
 	typedef Density<uint8_t> Density8;
@@ -106,6 +106,11 @@ namespace PolyVox
 			inline VoxelType peekVoxel1px1py0pz(void) const;
 			inline VoxelType peekVoxel1px1py1pz(void) const;
 
+			/// Reads the 3x3x3 neighbourhood of the current position, indexed by <tt>(x+1) + (y+1)*3 + (z+1)*9</tt>.
+			inline void peekNeighbourhood(VoxelType pStencil[27]) const;
+			/// Reads the 2x2x2 cell whose lower corner is the current position, indexed by <tt>x + y*2 + z*4</tt>.
+			inline void peekCell(VoxelType pCell[8]) const;
+
 		private:
 			//Other current position information
 			VoxelType* mCurrentVoxel;
@@ -140,6 +145,10 @@ namespace PolyVox
 		bool setVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue);
 		/// Sets the voxel at the position given by a 3D vector
 		bool setVoxelAt(const Vector3DInt32& v3dPos, VoxelType tValue);
+		/// Gets a pointer to a run of voxels along the \c x axis starting at <tt>x,y,z</tt>
+		const VoxelType* getSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength) const;
+		/// Gets a writable pointer to a run of voxels along the \c x axis starting at <tt>x,y,z</tt>
+		VoxelType* getWritableSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength);
 
 		/// Calculates approximatly how many bytes of memory the volume is currently using.
 		uint32_t calculateSizeInBytes(void);
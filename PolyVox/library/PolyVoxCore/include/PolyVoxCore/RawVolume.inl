@@ -153,6 +153,79 @@ namespace PolyVox
 		return setVoxelAt(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ(), tValue);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// The returned run holds \a iLength consecutive voxels along the \c x axis, where \a iLength is never
+	/// more than \a iMaxLength. A null pointer means the voxels are outside the volume or are not stored
+	/// contiguously, and should be read through getVoxelAt() instead. \a iLength is set in either case.
+	///
+	/// The pointer is only valid until the volume is next accessed.
+	/// \param uXPos The \c x position of the first voxel in the run
+	/// \param uYPos The \c y position of the run
+	/// \param uZPos The \c z position of the run
+	/// \param iMaxLength The largest number of voxels the run may contain
+	/// \param iLength Set to the number of voxels in the run
+	/// \return A pointer to the first voxel in the run, or null
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	const VoxelType* RawVolume<VoxelType>::getSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength) const
+	{
+		if(this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)))
+		{
+			const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
+			int32_t iLocalXPos = uXPos - v3dLowerCorner.getX();
+			int32_t iLocalYPos = uYPos - v3dLowerCorner.getY();
+			int32_t iLocalZPos = uZPos - v3dLowerCorner.getZ();
+
+			//Rows are contiguous, so the run only stops at the edge of the volume or when it is long enough.
+			iLength = (std::min)(iMaxLength, this->m_regValidRegion.getUpperCorner().getX() - uXPos + 1);
+
+			return m_pData +
+				iLocalXPos + 
+				iLocalYPos * this->getWidth() + 
+				iLocalZPos * this->getWidth() * this->getHeight();
+		}
+		else
+		{
+			iLength = this->getBorderSpanLength(uXPos, uYPos, uZPos, iMaxLength);
+			return 0;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// As getSpanAt(), except that the voxels may be modified through the returned pointer. A null pointer
+	/// means the voxels should be written through setVoxelAt() instead.
+	/// \param uXPos The \c x position of the first voxel in the run
+	/// \param uYPos The \c y position of the run
+	/// \param uZPos The \c z position of the run
+	/// \param iMaxLength The largest number of voxels the run may contain
+	/// \param iLength Set to the number of voxels in the run
+	/// \return A pointer to the first voxel in the run, or null
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType* RawVolume<VoxelType>::getWritableSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength)
+	{
+		if(this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)))
+		{
+			const Vector3DInt32& v3dLowerCorner = this->m_regValidRegion.getLowerCorner();
+			int32_t iLocalXPos = uXPos - v3dLowerCorner.getX();
+			int32_t iLocalYPos = uYPos - v3dLowerCorner.getY();
+			int32_t iLocalZPos = uZPos - v3dLowerCorner.getZ();
+
+			//Rows are contiguous, so the run only stops at the edge of the volume or when it is long enough.
+			iLength = (std::min)(iMaxLength, this->m_regValidRegion.getUpperCorner().getX() - uXPos + 1);
+
+			return m_pData +
+				iLocalXPos + 
+				iLocalYPos * this->getWidth() + 
+				iLocalZPos * this->getWidth() * this->getHeight();
+		}
+		else
+		{
+			iLength = this->getBorderSpanLength(uXPos, uYPos, uZPos, iMaxLength);
+			return 0;
+		}
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/// This function should probably be made internal...
 	////////////////////////////////////////////////////////////////////////////////
@@ -161,6 +161,77 @@ namespace PolyVox
 		m_bIsCurrentPositionValidInZ = this->mVolume->getEnclosingRegion().containsPointInZ(this->mZPosInVolume);
 	}
 
+	template <typename VoxelType>
+	void RawVolume<VoxelType>::Sampler::peekNeighbourhood(VoxelType pStencil[27]) const
+	{
+		if(m_bIsCurrentPositionValidInX && m_bIsCurrentPositionValidInY && m_bIsCurrentPositionValidInZ &&
+			BORDER_LOWX(this->mXPosInVolume) && BORDER_HIGHX(this->mXPosInVolume) && BORDER_LOWY(this->mYPosInVolume) && BORDER_HIGHY(this->mYPosInVolume) && BORDER_LOWZ(this->mZPosInVolume) && BORDER_HIGHZ(this->mZPosInVolume))
+		{
+			//The whole neighbourhood is inside the volume, so every voxel is at a fixed offset from the current one.
+			const int32_t iRow = this->mVolume->getWidth();
+			const int32_t iSlice = iRow * this->mVolume->getHeight();
+			const VoxelType* pCorner = mCurrentVoxel - 1 - iRow - iSlice;
+			for(int32_t z = 0; z < 3; z++)
+			{
+				for(int32_t y = 0; y < 3; y++)
+				{
+					for(int32_t x = 0; x < 3; x++)
+					{
+						pStencil[x + y * 3 + z * 9] = pCorner[x + y * iRow + z * iSlice];
+					}
+				}
+			}
+		}
+		else
+		{
+			//Note that the individual peeks can't be used here as they only check the axes along which they move.
+			for(int32_t z = 0; z < 3; z++)
+			{
+				for(int32_t y = 0; y < 3; y++)
+				{
+					for(int32_t x = 0; x < 3; x++)
+					{
+						pStencil[x + y * 3 + z * 9] = this->mVolume->getVoxelAt(this->mXPosInVolume + x - 1, this->mYPosInVolume + y - 1, this->mZPosInVolume + z - 1);
+					}
+				}
+			}
+		}
+	}
+
+	template <typename VoxelType>
+	void RawVolume<VoxelType>::Sampler::peekCell(VoxelType pCell[8]) const
+	{
+		if(m_bIsCurrentPositionValidInX && m_bIsCurrentPositionValidInY && m_bIsCurrentPositionValidInZ &&
+			BORDER_HIGHX(this->mXPosInVolume) && BORDER_HIGHY(this->mYPosInVolume) && BORDER_HIGHZ(this->mZPosInVolume))
+		{
+			const int32_t iRow = this->mVolume->getWidth();
+			const int32_t iSlice = iRow * this->mVolume->getHeight();
+			pCell[0] = mCurrentVoxel[0];
+			pCell[1] = mCurrentVoxel[1];
+			pCell[2] = mCurrentVoxel[iRow];
+			pCell[3] = mCurrentVoxel[iRow + 1];
+			pCell[4] = mCurrentVoxel[iSlice];
+			pCell[5] = mCurrentVoxel[iSlice + 1];
+			pCell[6] = mCurrentVoxel[iSlice + iRow];
+			pCell[7] = mCurrentVoxel[iSlice + iRow + 1];
+		}
+		else
+		{
+			for(int32_t z = 0; z < 2; z++)
+			{
+				for(int32_t y = 0; y < 2; y++)
+				{
+					for(int32_t x = 0; x < 2; x++)
+					{
+						pCell[x + y * 2 + z * 4] = this->mVolume->getVoxelAt(this->mXPosInVolume + x, this->mYPosInVolume + y, this->mZPosInVolume + z);
+					}
+				}
+			}
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
 	template <typename VoxelType>
 	VoxelType RawVolume<VoxelType>::Sampler::peekVoxel1nx1ny1nz(void) const
 	{
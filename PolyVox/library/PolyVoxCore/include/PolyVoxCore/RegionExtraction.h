@@ -0,0 +1,110 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#ifndef __PolyVox_RegionExtraction_H__
+#define __PolyVox_RegionExtraction_H__
+
+#include "PolyVoxImpl/RegionExtractionImpl.h"
+#include "PolyVoxImpl/TypeDef.h"
+
+#include "PolyVoxCore/Region.h"
+#include "PolyVoxCore/SurfaceMesh.h"
+
+#include <vector>
+
+namespace PolyVox
+{
+	/// Controls how extractRegions() spreads its work.
+	////////////////////////////////////////////////////////////////////////////////
+	/// All the options have sensible default values, so a default constructed
+	/// ExtractionPolicy uses every available core and reports no progress.
+	///
+	/// \sa extractRegions
+	////////////////////////////////////////////////////////////////////////////////
+	struct ExtractionPolicy
+	{
+	public:
+		ExtractionPolicy
+		(
+			uint32_t uNoOfThreads = 0,
+			polyvox_function<void (uint32_t, uint32_t)> funcProgressCallback = 0
+		)
+			:noOfThreads(uNoOfThreads)
+			,progressCallback(funcProgressCallback)
+		{
+		}
+
+		/// The number of threads which perform the extraction, including the calling
+		/// thread. Zero means one thread for each core reported by the system. Setting
+		/// this to one performs all the extraction on the calling thread, which is
+		/// required for volumes (such as the LargeVolume) which cannot be read from
+		/// several threads at once.
+		uint32_t noOfThreads;
+
+		/// This function is called each time a region has been extracted. It is given the
+		/// index of that region and the number of regions which have been completed so far,
+		/// so it can be used both to update a progress bar and to start using meshes
+		/// before the rest are finished. The calls can come from any of the threads but
+		/// never overlap, so the function does not need to do any locking of its own.
+		polyvox_function<void (uint32_t, uint32_t)> progressCallback;
+	};
+
+	/// Runs a surface extractor over each of a list of regions, using several threads.
+	////////////////////////////////////////////////////////////////////////////////
+	/// The extractor is given as the first template parameter, and may be any of
+	/// the extractors which are constructed from a volume, a region and a mesh
+	/// (SurfaceExtractor, CubicSurfaceExtractor or CubicSurfaceExtractorWithNormals).
+	/// The remaining template parameters are deduced from the arguments:
+	///
+	/// \code
+	/// std::vector< SurfaceMesh<PositionMaterialNormal> > vecMeshes;
+	/// extractRegions<SurfaceExtractor>(&volData, vecRegions, vecMeshes);
+	/// \endcode
+	///
+	/// Each worker takes the next unprocessed region from the list, so regions which
+	/// take different amounts of time are still shared out evenly. Each worker also
+	/// keeps a single extractor Context for all the regions it processes, so the
+	/// working buffers are allocated once per worker rather than once per region.
+	/// Whichever thread performs the extraction, the mesh for vecRegions[i] is always
+	/// stored in vecResults[i] and is identical to the mesh which the extractor
+	/// produces when run on its own. The volume is only read, and must not be modified
+	/// until the function returns.
+	///
+	/// If an extractor (or the progress callback) throws, no further regions are started
+	/// and the exception is rethrown on the calling thread once the workers have stopped.
+	///
+	/// \param volData The volume to extract the surfaces from.
+	/// \param vecRegions The regions to extract. They may overlap.
+	/// \param vecResults Receives one mesh per region. Any existing contents are replaced,
+	/// but the meshes already in the vector keep their memory. Passing the same vector
+	/// each time a set of regions is extracted therefore avoids most of the allocation,
+	/// as each mesh is already about the right size for its region.
+	/// \param policy Controls the number of threads and the progress reporting.
+	////////////////////////////////////////////////////////////////////////////////
+	template< template<template<typename> class, typename> class ExtractorType, template<typename> class VolumeType, typename VoxelType, typename VertexType>
+	void extractRegions(VolumeType<VoxelType>* volData, const std::vector<Region>& vecRegions, std::vector< SurfaceMesh<VertexType> >& vecResults, const ExtractionPolicy& policy = ExtractionPolicy());
+}
+
+#include "PolyVoxCore/RegionExtraction.inl"
+
+#endif //__PolyVox_RegionExtraction_H__
@@ -0,0 +1,94 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#include <algorithm>
+
+namespace PolyVox
+{
+	//The loop run by each of the workers (including the calling thread).
+	template< template<template<typename> class, typename> class ExtractorType, template<typename> class VolumeType, typename VoxelType, typename VertexType>
+	void extractRegionsWorker(VolumeType<VoxelType>* volData, const std::vector<Region>* pVecRegions, std::vector< SurfaceMesh<VertexType> >* pVecResults, const ExtractionPolicy* pPolicy, RegionExtractionQueue* pQueue)
+	{
+		//Each worker reuses the same buffers for all the regions which it extracts.
+		typename ExtractorType<VolumeType, VoxelType>::Context context;
+
+		uint32_t uRegionIndex;
+		while(pQueue->getNextRegion(uRegionIndex))
+		{
+			try
+			{
+				ExtractorType<VolumeType, VoxelType> extractor(volData, (*pVecRegions)[uRegionIndex], &((*pVecResults)[uRegionIndex]));
+				extractor.setContext(&context);
+				extractor.execute();
+
+				pQueue->regionCompleted(uRegionIndex, pPolicy->progressCallback);
+			}
+			catch(...)
+			{
+				pQueue->setFailed(polyvox_current_exception());
+				return;
+			}
+		}
+	}
+
+	template< template<template<typename> class, typename> class ExtractorType, template<typename> class VolumeType, typename VoxelType, typename VertexType>
+	void extractRegions(VolumeType<VoxelType>* volData, const std::vector<Region>& vecRegions, std::vector< SurfaceMesh<VertexType> >& vecResults, const ExtractionPolicy& policy)
+	{
+		//Meshes which are already present are reused rather than replaced. The extractors clear them
+		//but keep their memory, so extracting the same regions again does not need to reallocate.
+		vecResults.resize(vecRegions.size());
+
+		const uint32_t uNoOfRegions = static_cast<uint32_t>(vecRegions.size());
+		if(uNoOfRegions == 0)
+		{
+			return;
+		}
+
+		uint32_t uNoOfThreads = policy.noOfThreads;
+		if(uNoOfThreads == 0)
+		{
+			//Note that hardware_concurrency() is allowed to return zero if it doesn't know.
+			uNoOfThreads = (std::max)(polyvox_thread::hardware_concurrency(), 1u);
+		}
+		//There's no point in having workers with nothing to do.
+		uNoOfThreads = (std::min)(uNoOfThreads, uNoOfRegions);
+
+		RegionExtractionQueue queue(uNoOfRegions);
+
+		//The calling thread is one of the workers, so we only start the others.
+		std::vector< polyvox_shared_ptr<polyvox_thread> > vecThreads;
+		for(uint32_t ct = 1; ct < uNoOfThreads; ct++)
+		{
+			vecThreads.push_back(polyvox_shared_ptr<polyvox_thread>(new polyvox_thread(&extractRegionsWorker<ExtractorType, VolumeType, VoxelType, VertexType>, volData, &vecRegions, &vecResults, &policy, &queue)));
+		}
+
+		extractRegionsWorker<ExtractorType, VolumeType, VoxelType, VertexType>(volData, &vecRegions, &vecResults, &policy, &queue);
+
+		for(uint32_t ct = 0; ct < vecThreads.size(); ct++)
+		{
+			vecThreads[ct]->join();
+		}
+
+		queue.rethrowIfFailed();
+	}
+}
@@ -26,6 +26,7 @@ freely, subject to the following restrictions:
 
 #include "PolyVoxCore/CubicSurfaceExtractorWithNormals.h"
 #include "PolyVoxCore/MaterialDensityPair.h"
+#include "PolyVoxCore/RegionExtraction.h"
 #include "PolyVoxCore/SimpleVolume.h"
 #include "PolyVoxCore/SurfaceExtractor.h"
 
@@ -39,6 +40,10 @@ namespace PolyVox
 	void extractCubicMesh(Volume& volume, const Region& region, Mesh& resultMesh);
 	void extractSmoothMesh(Volume& volume, const Region& region, Mesh& resultMesh);
 
+	//These extract a mesh for each of the regions, in parallel. See extractRegions() for details.
+	void extractCubicMeshes(Volume& volume, const std::vector<Region>& regions, std::vector<Mesh>& resultMeshes, const ExtractionPolicy& policy = ExtractionPolicy());
+	void extractSmoothMeshes(Volume& volume, const std::vector<Region>& regions, std::vector<Mesh>& resultMeshes, const ExtractionPolicy& policy = ExtractionPolicy());
+
 }
 
 #endif //__PolyVox_SimpleInterface_H__
@@ -66,6 +66,7 @@ namespace PolyVox
 			VoxelType* m_tUncompressedData;
 			uint16_t m_uSideLength;
 			uint8_t m_uSideLengthPower;	
+			DensityRange<VoxelType> m_densityRange;
 		};
 
 		//There seems to be some descrepency between Visual Studio and GCC about how the following class should be declared.
@@ -135,6 +136,11 @@ namespace PolyVox
 			inline VoxelType peekVoxel1px1py0pz(void) const;
 			inline VoxelType peekVoxel1px1py1pz(void) const;
 
+			/// Reads the 3x3x3 neighbourhood of the current position, indexed by <tt>(x+1) + (y+1)*3 + (z+1)*9</tt>.
+			inline void peekNeighbourhood(VoxelType pStencil[27]) const;
+			/// Reads the 2x2x2 cell whose lower corner is the current position, indexed by <tt>x + y*2 + z*4</tt>.
+			inline void peekCell(VoxelType pCell[8]) const;
+
 		private:			
 			//Other current position information
 			VoxelType* mCurrentVoxel;
@@ -169,6 +175,15 @@ namespace PolyVox
 		bool setVoxelAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, VoxelType tValue);
 		/// Sets the voxel at the position given by a 3D vector
 		bool setVoxelAt(const Vector3DInt32& v3dPos, VoxelType tValue);
+		/// Gets a pointer to a run of voxels along the \c x axis starting at <tt>x,y,z</tt>
+		const VoxelType* getSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength) const;
+		/// Gets a writable pointer to a run of voxels along the \c x axis starting at <tt>x,y,z</tt>
+		VoxelType* getWritableSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength);
+
+		/// Gets the smallest and largest densities which the voxels in a region might have
+		bool getDensityRange(const Region& region, typename BaseVolume<VoxelType>::DensityType& tMin, typename BaseVolume<VoxelType>::DensityType& tMax) const;
+		/// Recalculates the density ranges invalidated by writing through getWritableSpanAt()
+		void recalculateDensityRanges(void);
 
 		/// Calculates approximatly how many bytes of memory the volume is currently using.
 		uint32_t calculateSizeInBytes(void);
@@ -178,6 +193,7 @@ namespace PolyVox
 
 private:	
 		Block* getUncompressedBlock(int32_t uBlockX, int32_t uBlockY, int32_t uBlockZ) const;
+		VoxelType* getBlockDataForReading(int32_t uBlockX, int32_t uBlockY, int32_t uBlockZ) const;
 
 		//The block data
 		Block* m_pBlocks;
@@ -188,6 +204,10 @@ private:
 		//the VolumeIterator can do it's usual pointer arithmetic without needing to know it's gone outside the volume.
 		VoxelType* m_pUncompressedBorderData;
 
+		//Blocks are only allocated the first time they are written to. Until then reads are served from this
+		//shared block of default valued voxels, which again allows the Sampler to use its pointer arithmetic.
+		VoxelType* m_pUncompressedDefaultData;
+
 		//The size of the volume in vlocks
 		Region m_regValidRegionInBlocks;
 
@@ -55,6 +55,9 @@ namespace PolyVox
 		uint16_t uBlockSideLength
 	)
 	:BaseVolume<VoxelType>(regValid)
+	,m_pBlocks(0)
+	,m_pUncompressedBorderData(0)
+	,m_pUncompressedDefaultData(0)
 	{
 		//Create a volume of the right size.
 		resize(regValid,uBlockSideLength);
@@ -68,6 +71,7 @@ namespace PolyVox
 	{
 		delete[] m_pBlocks;
 		delete[] m_pUncompressedBorderData;
+		delete[] m_pUncompressedDefaultData;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -100,9 +104,14 @@ namespace PolyVox
 			const uint16_t yOffset = uYPos - (blockY << m_uBlockSideLengthPower);
 			const uint16_t zOffset = uZPos - (blockZ << m_uBlockSideLengthPower);
 
-			typename SimpleVolume<VoxelType>::Block* pUncompressedBlock = getUncompressedBlock(blockX, blockY, blockZ);
+			const VoxelType* pBlockData = getBlockDataForReading(blockX, blockY, blockZ);
 
-			return pUncompressedBlock->getVoxelAt(xOffset,yOffset,zOffset);
+			return pBlockData
+				[
+					xOffset + 
+					yOffset * m_uBlockSideLength + 
+					zOffset * m_uBlockSideLength * m_uBlockSideLength
+				];
 		}
 		else
 		{
@@ -170,6 +179,185 @@ namespace PolyVox
 		return setVoxelAt(v3dPos.getX(), v3dPos.getY(), v3dPos.getZ(), tValue);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// The returned run holds \a iLength consecutive voxels along the \c x axis, where \a iLength is never
+	/// more than \a iMaxLength. A null pointer means the voxels are outside the volume or are not stored
+	/// contiguously, and should be read through getVoxelAt() instead. \a iLength is set in either case.
+	///
+	/// The pointer is only valid until the volume is next accessed.
+	/// \param uXPos The \c x position of the first voxel in the run
+	/// \param uYPos The \c y position of the run
+	/// \param uZPos The \c z position of the run
+	/// \param iMaxLength The largest number of voxels the run may contain
+	/// \param iLength Set to the number of voxels in the run
+	/// \return A pointer to the first voxel in the run, or null
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	const VoxelType* SimpleVolume<VoxelType>::getSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength) const
+	{
+		if(this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)))
+		{
+			const int32_t blockX = uXPos >> m_uBlockSideLengthPower;
+			const int32_t blockY = uYPos >> m_uBlockSideLengthPower;
+			const int32_t blockZ = uZPos >> m_uBlockSideLengthPower;
+
+			const uint16_t xOffset = uXPos - (blockX << m_uBlockSideLengthPower);
+			const uint16_t yOffset = uYPos - (blockY << m_uBlockSideLengthPower);
+			const uint16_t zOffset = uZPos - (blockZ << m_uBlockSideLengthPower);
+
+			//The run stops at the end of the block, at the edge of the volume, or when it is long enough.
+			iLength = (std::min)((std::min)(iMaxLength, static_cast<int32_t>(m_uBlockSideLength - xOffset)), this->m_regValidRegion.getUpperCorner().getX() - uXPos + 1);
+
+			const VoxelType* pBlockData = getBlockDataForReading(blockX, blockY, blockZ);
+
+			return pBlockData + xOffset + yOffset * m_uBlockSideLength + zOffset * m_uBlockSideLength * m_uBlockSideLength;
+		}
+		else
+		{
+			iLength = this->getBorderSpanLength(uXPos, uYPos, uZPos, iMaxLength);
+			return 0;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// As getSpanAt(), except that the voxels may be modified through the returned pointer. A null pointer
+	/// means the voxels should be written through setVoxelAt() instead.
+	/// \param uXPos The \c x position of the first voxel in the run
+	/// \param uYPos The \c y position of the run
+	/// \param uZPos The \c z position of the run
+	/// \param iMaxLength The largest number of voxels the run may contain
+	/// \param iLength Set to the number of voxels in the run
+	/// \return A pointer to the first voxel in the run, or null
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	VoxelType* SimpleVolume<VoxelType>::getWritableSpanAt(int32_t uXPos, int32_t uYPos, int32_t uZPos, int32_t iMaxLength, int32_t& iLength)
+	{
+		if(this->m_regValidRegion.containsPoint(Vector3DInt32(uXPos, uYPos, uZPos)))
+		{
+			const int32_t blockX = uXPos >> m_uBlockSideLengthPower;
+			const int32_t blockY = uYPos >> m_uBlockSideLengthPower;
+			const int32_t blockZ = uZPos >> m_uBlockSideLengthPower;
+
+			const uint16_t xOffset = uXPos - (blockX << m_uBlockSideLengthPower);
+			const uint16_t yOffset = uYPos - (blockY << m_uBlockSideLengthPower);
+			const uint16_t zOffset = uZPos - (blockZ << m_uBlockSideLengthPower);
+
+			//The run stops at the end of the block, at the edge of the volume, or when it is long enough.
+			iLength = (std::min)((std::min)(iMaxLength, static_cast<int32_t>(m_uBlockSideLength - xOffset)), this->m_regValidRegion.getUpperCorner().getX() - uXPos + 1);
+
+			//This allocates the block if it has not been written to before. We can't
+			//see what is written through the pointer, so the range has to be recalculated.
+			Block* pBlock = getUncompressedBlock(blockX, blockY, blockZ);
+			pBlock->m_densityRange.invalidate();
+			VoxelType* pBlockData = pBlock->m_tUncompressedData;
+
+			return pBlockData + xOffset + yOffset * m_uBlockSideLength + zOffset * m_uBlockSideLength * m_uBlockSideLength;
+		}
+		else
+		{
+			iLength = this->getBorderSpanLength(uXPos, uYPos, uZPos, iMaxLength);
+			return 0;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// The range is built from the ranges of the blocks which the region touches, which are kept up to date as
+	/// voxels are written. See BaseVolume::getDensityRange() for more details.
+	/// \param region The region to find the range for
+	/// \param tMin Set to the smallest density in the region
+	/// \param tMax Set to the largest density in the region
+	/// \return Whether the range is known
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	bool SimpleVolume<VoxelType>::getDensityRange(const Region& region, typename BaseVolume<VoxelType>::DensityType& tMin, typename BaseVolume<VoxelType>::DensityType& tMax) const
+	{
+		typedef typename BaseVolume<VoxelType>::DensityType DensityType;
+
+		Region regInside(region);
+		regInside.cropTo(this->m_regValidRegion);
+
+		//Any part of the region which is outside the volume contains the border value.
+		bool bFoundRange = false;
+		if(regInside != region)
+		{
+			tMin = VoxelDensity<VoxelType>::get(getBorderValue());
+			tMax = tMin;
+			bFoundRange = true;
+		}
+
+		const Vector3DInt32& v3dLowerCorner = regInside.getLowerCorner();
+		const Vector3DInt32& v3dUpperCorner = regInside.getUpperCorner();
+		if((v3dLowerCorner.getX() > v3dUpperCorner.getX()) || (v3dLowerCorner.getY() > v3dUpperCorner.getY()) || (v3dLowerCorner.getZ() > v3dUpperCorner.getZ()))
+		{
+			//The region is entirely outside the volume.
+			return bFoundRange;
+		}
+
+		for(int32_t iBlockZ = v3dLowerCorner.getZ() >> m_uBlockSideLengthPower; iBlockZ <= (v3dUpperCorner.getZ() >> m_uBlockSideLengthPower); iBlockZ++)
+		{
+			for(int32_t iBlockY = v3dLowerCorner.getY() >> m_uBlockSideLengthPower; iBlockY <= (v3dUpperCorner.getY() >> m_uBlockSideLengthPower); iBlockY++)
+			{
+				for(int32_t iBlockX = v3dLowerCorner.getX() >> m_uBlockSideLengthPower; iBlockX <= (v3dUpperCorner.getX() >> m_uBlockSideLengthPower); iBlockX++)
+				{
+					const uint32_t uBlockIndex =
+						(iBlockX - m_regValidRegionInBlocks.getLowerCorner().getX()) + 
+						(iBlockY - m_regValidRegionInBlocks.getLowerCorner().getY()) * m_uWidthInBlocks + 
+						(iBlockZ - m_regValidRegionInBlocks.getLowerCorner().getZ()) * m_uWidthInBlocks * m_uHeightInBlocks;
+					const Block& block = m_pBlocks[uBlockIndex];
+
+					DensityType tBlockMin;
+					DensityType tBlockMax;
+					if(block.m_tUncompressedData == 0)
+					{
+						//Blocks which have never been written to all hold the default value.
+						tBlockMin = VoxelDensity<VoxelType>::get(*m_pUncompressedDefaultData);
+						tBlockMax = tBlockMin;
+					}
+					else if(block.m_densityRange.isValid())
+					{
+						tBlockMin = block.m_densityRange.getMin();
+						tBlockMax = block.m_densityRange.getMax();
+					}
+					else
+					{
+						return false;
+					}
+
+					if(bFoundRange)
+					{
+						tMin = (std::min)(tMin, tBlockMin);
+						tMax = (std::max)(tMax, tBlockMax);
+					}
+					else
+					{
+						tMin = tBlockMin;
+						tMax = tBlockMax;
+						bFoundRange = true;
+					}
+				}
+			}
+		}
+
+		return bFoundRange;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Code which writes voxels through getWritableSpanAt() should call this once it has finished, so that
+	/// getDensityRange() can be used on the modified region again.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VoxelType>
+	void SimpleVolume<VoxelType>::recalculateDensityRanges(void)
+	{
+		for(uint32_t i = 0; i < m_uNoOfBlocksInVolume; ++i)
+		{
+			Block& block = m_pBlocks[i];
+			if((block.m_tUncompressedData != 0) && (!block.m_densityRange.isValid()))
+			{
+				block.m_densityRange.calculate(block.m_tUncompressedData, m_uNoOfVoxelsPerBlock);
+			}
+		}
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/// This function should probably be made internal...
 	////////////////////////////////////////////////////////////////////////////////
@@ -189,9 +377,16 @@ namespace PolyVox
 			throw std::invalid_argument("Block side length must be a power of two.");
 		}
 
+		//Free the data from any previous size. Existing volumes are resized when they are loaded, for example.
+		delete[] m_pBlocks;
+		delete[] m_pUncompressedBorderData;
+		delete[] m_pUncompressedDefaultData;
+
 		m_uBlockSideLength = uBlockSideLength;
 		m_uNoOfVoxelsPerBlock = m_uBlockSideLength * m_uBlockSideLength * m_uBlockSideLength;
+		m_pBlocks = 0;
 		m_pUncompressedBorderData = 0;
+		m_pUncompressedDefaultData = 0;
 
 		this->m_regValidRegion = regValidRegion;
 
@@ -208,12 +403,12 @@ namespace PolyVox
 		m_uDepthInBlocks = m_regValidRegionInBlocks.getUpperCorner().getZ() - m_regValidRegionInBlocks.getLowerCorner().getZ() + 1;
 		m_uNoOfBlocksInVolume = m_uWidthInBlocks * m_uHeightInBlocks * m_uDepthInBlocks;
 
-		//Allocate the data
+		//Create the blocks. They don't allocate any voxel data until they are first written to.
 		m_pBlocks = new Block[m_uNoOfBlocksInVolume];
-		for(uint32_t i = 0; i < m_uNoOfBlocksInVolume; ++i)
-		{
-			m_pBlocks[i].initialise(m_uBlockSideLength);
-		}
+
+		//Create the block which is shared by all unallocated blocks
+		m_pUncompressedDefaultData = new VoxelType[m_uNoOfVoxelsPerBlock];
+		std::fill(m_pUncompressedDefaultData, m_pUncompressedDefaultData + m_uNoOfVoxelsPerBlock, VoxelType());
 
 		//Create the border block
 		m_pUncompressedBorderData = new VoxelType[m_uNoOfVoxelsPerBlock];
@@ -240,8 +435,35 @@ namespace PolyVox
 				uBlockY * m_uWidthInBlocks + 
 				uBlockZ * m_uWidthInBlocks * m_uHeightInBlocks;
 
+		//Allocate the block the first time it is requested for writing
+		Block* pBlock = &(m_pBlocks[uBlockIndex]);
+		if(pBlock->m_tUncompressedData == 0)
+		{
+			pBlock->initialise(m_uBlockSideLength);
+		}
+
 		//Return the block
-		return &(m_pBlocks[uBlockIndex]);
+		return pBlock;
+	}
+
+	template <typename VoxelType>
+	VoxelType* SimpleVolume<VoxelType>::getBlockDataForReading(int32_t uBlockX, int32_t uBlockY, int32_t uBlockZ) const
+	{
+		//The lower left corner of the volume could be
+		//anywhere, but array indices need to start at zero.
+		uBlockX -= m_regValidRegionInBlocks.getLowerCorner().getX();
+		uBlockY -= m_regValidRegionInBlocks.getLowerCorner().getY();
+		uBlockZ -= m_regValidRegionInBlocks.getLowerCorner().getZ();
+
+		//Compute the block index
+		uint32_t uBlockIndex =
+				uBlockX + 
+				uBlockY * m_uWidthInBlocks + 
+				uBlockZ * m_uWidthInBlocks * m_uHeightInBlocks;
+
+		//Blocks which have never been written to all share the default data.
+		VoxelType* pBlockData = m_pBlocks[uBlockIndex].m_tUncompressedData;
+		return (pBlockData != 0) ? pBlockData : m_pUncompressedDefaultData;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -252,10 +474,15 @@ namespace PolyVox
 	{
 		uint32_t uSizeInBytes = sizeof(SimpleVolume);
 		
-		uint32_t uSizeOfBlockInBytes = m_uNoOfVoxelsPerBlock * sizeof(VoxelType);
+		//Memory used by the blocks. Unallocated blocks only cost the Block object itself.
+		for(uint32_t i = 0; i < m_uNoOfBlocksInVolume; ++i)
+		{
+			uSizeInBytes += m_pBlocks[i].calculateSizeInBytes();
+		}
 
-		//Memory used by the blocks ( + 1 is for border)
-		uSizeInBytes += uSizeOfBlockInBytes * (m_uNoOfBlocksInVolume + 1);
+		//Memory used by the border and default data
+		uint32_t uSizeOfBlockInBytes = m_uNoOfVoxelsPerBlock * sizeof(VoxelType);
+		uSizeInBytes += uSizeOfBlockInBytes * 2;
 
 		return uSizeInBytes;
 	}
@@ -79,12 +79,17 @@ namespace PolyVox
 
 		assert(m_tUncompressedData);
 
-		m_tUncompressedData
+		VoxelType& tVoxel = m_tUncompressedData
 		[
 			uXPos + 
 			uYPos * m_uSideLength + 
 			uZPos * m_uSideLength * m_uSideLength
-		] = tValue;
+		];
+
+		const VoxelType tOldValue = tVoxel;
+		tVoxel = tValue;
+
+		m_densityRange.voxelChanged(tOldValue, tValue, m_tUncompressedData, m_uSideLength * m_uSideLength * m_uSideLength);
 	}
 
 	template <typename VoxelType>
@@ -98,6 +103,7 @@ namespace PolyVox
 	{
 		const uint32_t uNoOfVoxels = m_uSideLength * m_uSideLength * m_uSideLength;
 		std::fill(m_tUncompressedData, m_tUncompressedData + uNoOfVoxels, tValue);
+		m_densityRange.fill(tValue, uNoOfVoxels);
 	}
 
 	template <typename VoxelType>
@@ -125,7 +131,10 @@ namespace PolyVox
 	uint32_t SimpleVolume<VoxelType>::Block::calculateSizeInBytes(void)
 	{
 		uint32_t uSizeInBytes = sizeof(Block);
-		uSizeInBytes += sizeof(VoxelType) * m_uSideLength * m_uSideLength * m_uSideLength;
+		if(m_tUncompressedData)
+		{
+			uSizeInBytes += sizeof(VoxelType) * m_uSideLength * m_uSideLength * m_uSideLength;
+		}
 		return  uSizeInBytes;
 	}
 }
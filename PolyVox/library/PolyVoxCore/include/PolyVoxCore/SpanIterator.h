@@ -0,0 +1,151 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#ifndef __PolyVox_SpanIterator_H__
+#define __PolyVox_SpanIterator_H__
+
+#include "PolyVoxCore/Region.h"
+
+#include <vector>
+
+namespace PolyVox
+{
+	///The ConstSpanIterator walks over a region of a volume one run of voxels at a time.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// Most algorithms which process a whole region visit every voxel through a Sampler (or through getVoxelAt()), paying for
+	/// the position and block checks on every voxel. The ConstSpanIterator instead splits each row of the region into runs
+	/// which are contiguous in memory, normally the part of the row which falls within a single block, and hands out a pointer
+	/// to each run in turn. The loop over the voxels in a run is then a plain loop over an array, which the compiler is free
+	/// to unroll or vectorise.
+	///
+	/// Runs are visited in the same order as a loop over \c z, then \c y, then \c x would visit the voxels. Volumes which do
+	/// not store their voxels contiguously (and parts of the region which lie outside the volume) are still supported, but
+	/// the voxels are first copied into a buffer owned by the iterator.
+	///
+	/// \code
+	/// for(ConstSpanIterator<SimpleVolume, Material8> iter(&volume, region); iter.isValid(); iter.moveForward())
+	/// {
+	///     const Material8* pVoxels = iter.getSpan();
+	///     for(int32_t i = 0; i < iter.getLength(); i++)
+	///     {
+	///         //Process pVoxels[i], which is at position (iter.getPosX() + i, iter.getPosY(), iter.getPosZ())
+	///     }
+	/// }
+	/// \endcode
+	///
+	/// The pointer returned by getSpan() is only valid until the iterator is moved or the volume is accessed in some other way.
+	///
+	/// \sa SpanIterator
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	class ConstSpanIterator
+	{
+	public:
+		ConstSpanIterator(const VolumeType<VoxelType>* pVolume, const Region& regSpans);
+
+		/// Gets the voxels in the current run
+		const VoxelType* getSpan(void) const;
+		/// Gets the number of voxels in the current run
+		int32_t getLength(void) const;
+		/// Gets the \c x position of the first voxel in the current run
+		int32_t getPosX(void) const;
+		/// Gets the \c y position of the current run
+		int32_t getPosY(void) const;
+		/// Gets the \c z position of the current run
+		int32_t getPosZ(void) const;
+
+		/// Returns false once every run in the region has been visited
+		bool isValid(void) const;
+		/// Moves on to the next run, returning false if there are none left
+		bool moveForward(void);
+
+	private:
+		void fetchSpan(void);
+
+		const VolumeType<VoxelType>* m_pVolume;
+		Region m_regSpans;
+
+		int32_t m_iXPos;
+		int32_t m_iYPos;
+		int32_t m_iZPos;
+		int32_t m_iLength;
+		const VoxelType* m_pSpan;
+		bool m_bIsValid;
+
+		//Holds copies of voxels which the volume can't provide a pointer to.
+		std::vector<VoxelType> m_vecBuffer;
+	};
+
+	///The SpanIterator is a ConstSpanIterator which allows the voxels to be modified.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// Writing through the pointer returned by getSpan() modifies the volume. When the volume can not provide a pointer to the
+	/// voxels they are copied into a buffer as for the ConstSpanIterator, and the buffer is written back to the volume when
+	/// moveForward() is called. The region must therefore lie inside the volume, and moveForward() must be called once the last
+	/// run has been processed (which the usual loop shown for the ConstSpanIterator does).
+	///
+	/// \sa ConstSpanIterator
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template< template<typename> class VolumeType, typename VoxelType>
+	class SpanIterator
+	{
+	public:
+		SpanIterator(VolumeType<VoxelType>* pVolume, const Region& regSpans);
+
+		/// Gets the voxels in the current run
+		VoxelType* getSpan(void) const;
+		/// Gets the number of voxels in the current run
+		int32_t getLength(void) const;
+		/// Gets the \c x position of the first voxel in the current run
+		int32_t getPosX(void) const;
+		/// Gets the \c y position of the current run
+		int32_t getPosY(void) const;
+		/// Gets the \c z position of the current run
+		int32_t getPosZ(void) const;
+
+		/// Returns false once every run in the region has been visited
+		bool isValid(void) const;
+		/// Writes back the current run if necessary and moves on to the next one, returning false if there are none left
+		bool moveForward(void);
+
+	private:
+		void fetchSpan(void);
+
+		VolumeType<VoxelType>* m_pVolume;
+		Region m_regSpans;
+
+		int32_t m_iXPos;
+		int32_t m_iYPos;
+		int32_t m_iZPos;
+		int32_t m_iLength;
+		VoxelType* m_pSpan;
+		bool m_bIsValid;
+
+		//Holds copies of voxels which the volume can't provide a pointer to.
+		std::vector<VoxelType> m_vecBuffer;
+		bool m_bSpanIsBuffered;
+	};
+}
+
+#include "PolyVoxCore/SpanIterator.inl"
+
+#endif //__PolyVox_SpanIterator_H__
@@ -0,0 +1,244 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#include <cassert>
+
+namespace PolyVox
+{
+	template< template<typename> class VolumeType, typename VoxelType>
+	ConstSpanIterator<VolumeType, VoxelType>::ConstSpanIterator(const VolumeType<VoxelType>* pVolume, const Region& regSpans)
+		:m_pVolume(pVolume)
+		,m_regSpans(regSpans)
+		,m_iXPos(regSpans.getLowerCorner().getX())
+		,m_iYPos(regSpans.getLowerCorner().getY())
+		,m_iZPos(regSpans.getLowerCorner().getZ())
+		,m_iLength(0)
+		,m_pSpan(0)
+		,m_bIsValid(true)
+		,m_vecBuffer(regSpans.getUpperCorner().getX() - regSpans.getLowerCorner().getX() + 1)
+	{
+		assert(regSpans.getUpperCorner().getX() >= regSpans.getLowerCorner().getX());
+
+		fetchSpan();
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	const VoxelType* ConstSpanIterator<VolumeType, VoxelType>::getSpan(void) const
+	{
+		return m_pSpan;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	int32_t ConstSpanIterator<VolumeType, VoxelType>::getLength(void) const
+	{
+		return m_iLength;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	int32_t ConstSpanIterator<VolumeType, VoxelType>::getPosX(void) const
+	{
+		return m_iXPos;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	int32_t ConstSpanIterator<VolumeType, VoxelType>::getPosY(void) const
+	{
+		return m_iYPos;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	int32_t ConstSpanIterator<VolumeType, VoxelType>::getPosZ(void) const
+	{
+		return m_iZPos;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	bool ConstSpanIterator<VolumeType, VoxelType>::isValid(void) const
+	{
+		return m_bIsValid;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	bool ConstSpanIterator<VolumeType, VoxelType>::moveForward(void)
+	{
+		if(!m_bIsValid)
+		{
+			return false;
+		}
+
+		m_iXPos += m_iLength;
+		if(m_iXPos > m_regSpans.getUpperCorner().getX())
+		{
+			m_iXPos = m_regSpans.getLowerCorner().getX();
+			m_iYPos++;
+			if(m_iYPos > m_regSpans.getUpperCorner().getY())
+			{
+				m_iYPos = m_regSpans.getLowerCorner().getY();
+				m_iZPos++;
+				if(m_iZPos > m_regSpans.getUpperCorner().getZ())
+				{
+					m_bIsValid = false;
+					m_pSpan = 0;
+					m_iLength = 0;
+					return false;
+				}
+			}
+		}
+
+		fetchSpan();
+		return true;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void ConstSpanIterator<VolumeType, VoxelType>::fetchSpan(void)
+	{
+		const int32_t iMaxLength = m_regSpans.getUpperCorner().getX() - m_iXPos + 1;
+		m_pSpan = m_pVolume->getSpanAt(m_iXPos, m_iYPos, m_iZPos, iMaxLength, m_iLength);
+
+		if(m_pSpan == 0)
+		{
+			//The volume can't give us a pointer, so copy the voxels instead.
+			for(int32_t i = 0; i < m_iLength; i++)
+			{
+				m_vecBuffer[i] = m_pVolume->getVoxelAt(m_iXPos + i, m_iYPos, m_iZPos);
+			}
+			m_pSpan = &(m_vecBuffer[0]);
+		}
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	SpanIterator<VolumeType, VoxelType>::SpanIterator(VolumeType<VoxelType>* pVolume, const Region& regSpans)
+		:m_pVolume(pVolume)
+		,m_regSpans(regSpans)
+		,m_iXPos(regSpans.getLowerCorner().getX())
+		,m_iYPos(regSpans.getLowerCorner().getY())
+		,m_iZPos(regSpans.getLowerCorner().getZ())
+		,m_iLength(0)
+		,m_pSpan(0)
+		,m_bIsValid(true)
+		,m_vecBuffer(regSpans.getUpperCorner().getX() - regSpans.getLowerCorner().getX() + 1)
+		,m_bSpanIsBuffered(false)
+	{
+		assert(regSpans.getUpperCorner().getX() >= regSpans.getLowerCorner().getX());
+
+		//Buffered runs are written back with setVoxelAt(), which requires them to be inside the volume.
+		assert(pVolume->getEnclosingRegion().containsPoint(regSpans.getLowerCorner()));
+		assert(pVolume->getEnclosingRegion().containsPoint(regSpans.getUpperCorner()));
+
+		fetchSpan();
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	VoxelType* SpanIterator<VolumeType, VoxelType>::getSpan(void) const
+	{
+		return m_pSpan;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	int32_t SpanIterator<VolumeType, VoxelType>::getLength(void) const
+	{
+		return m_iLength;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	int32_t SpanIterator<VolumeType, VoxelType>::getPosX(void) const
+	{
+		return m_iXPos;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	int32_t SpanIterator<VolumeType, VoxelType>::getPosY(void) const
+	{
+		return m_iYPos;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	int32_t SpanIterator<VolumeType, VoxelType>::getPosZ(void) const
+	{
+		return m_iZPos;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	bool SpanIterator<VolumeType, VoxelType>::isValid(void) const
+	{
+		return m_bIsValid;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	bool SpanIterator<VolumeType, VoxelType>::moveForward(void)
+	{
+		if(!m_bIsValid)
+		{
+			return false;
+		}
+
+		if(m_bSpanIsBuffered)
+		{
+			for(int32_t i = 0; i < m_iLength; i++)
+			{
+				m_pVolume->setVoxelAt(m_iXPos + i, m_iYPos, m_iZPos, m_vecBuffer[i]);
+			}
+		}
+
+		m_iXPos += m_iLength;
+		if(m_iXPos > m_regSpans.getUpperCorner().getX())
+		{
+			m_iXPos = m_regSpans.getLowerCorner().getX();
+			m_iYPos++;
+			if(m_iYPos > m_regSpans.getUpperCorner().getY())
+			{
+				m_iYPos = m_regSpans.getLowerCorner().getY();
+				m_iZPos++;
+				if(m_iZPos > m_regSpans.getUpperCorner().getZ())
+				{
+					m_bIsValid = false;
+					m_bSpanIsBuffered = false;
+					m_pSpan = 0;
+					m_iLength = 0;
+					return false;
+				}
+			}
+		}
+
+		fetchSpan();
+		return true;
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void SpanIterator<VolumeType, VoxelType>::fetchSpan(void)
+	{
+		const int32_t iMaxLength = m_regSpans.getUpperCorner().getX() - m_iXPos + 1;
+		m_pSpan = m_pVolume->getWritableSpanAt(m_iXPos, m_iYPos, m_iZPos, iMaxLength, m_iLength);
+
+		m_bSpanIsBuffered = (m_pSpan == 0);
+		if(m_bSpanIsBuffered)
+		{
+			//The volume can't give us a pointer, so work on a copy and write it back in moveForward().
+			for(int32_t i = 0; i < m_iLength; i++)
+			{
+				m_vecBuffer[i] = m_pVolume->getVoxelAt(m_iXPos + i, m_iYPos, m_iZPos);
+			}
+			m_pSpan = &(m_vecBuffer[0]);
+		}
+	}
+}
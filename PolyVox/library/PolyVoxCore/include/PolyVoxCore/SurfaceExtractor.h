@@ -24,30 +24,113 @@ freely, subject to the following restrictions:
 #ifndef __PolyVox_SurfaceExtractor_H__
 #define __PolyVox_SurfaceExtractor_H__
 
+#include "PolyVoxImpl/CubeIndices.h"
 #include "PolyVoxImpl/MarchingCubesTables.h"
+#include "PolyVoxImpl/RegionExtractionImpl.h"
 #include "PolyVoxImpl/TypeDef.h"
 
 #include "PolyVoxCore/Array.h"
+#include "PolyVoxCore/SpanIterator.h"
 #include "PolyVoxCore/SurfaceMesh.h"
 
+#include <cstring>
+#include <vector>
+
 namespace PolyVox
 {
 	template< template<typename> class VolumeType, typename VoxelType>
 	class SurfaceExtractor
 	{
 	public:
+		/// Holds the working buffers which are used during extraction.
+		////////////////////////////////////////////////////////////////////////////////
+		/// By default each extractor allocates its own buffers the first time it is
+		/// executed. When many regions are extracted one after another (for example by
+		/// a worker thread) the same Context can instead be given to each extractor
+		/// through setContext(). The buffers then grow to fit the largest region seen
+		/// so far and are reused from then on, so extracting further regions of that
+		/// size does not touch the heap. A Context must only be used by one extractor
+		/// at a time.
+		////////////////////////////////////////////////////////////////////////////////
+		class Context
+		{
+		public:
+			Context();
+
+		private:
+			friend class SurfaceExtractor;
+
+			//Makes sure the slice arrays can hold a slice of the given size. They are never made smaller.
+			void reserveSlices(uint32_t uWidth, uint32_t uHeight);
+
+			//The size which the slice arrays currently have.
+			uint32_t m_uSliceWidth;
+			uint32_t m_uSliceHeight;
+
+			//The cell bitmasks and vertex indices for the slice being processed and the one before it.
+			Array2DUint8 m_pPreviousBitmask;
+			Array2DUint8 m_pCurrentBitmask;
+			Array2DInt32 m_pPreviousVertexIndicesX;
+			Array2DInt32 m_pPreviousVertexIndicesY;
+			Array2DInt32 m_pPreviousVertexIndicesZ;
+			Array2DInt32 m_pCurrentVertexIndicesX;
+			Array2DInt32 m_pCurrentVertexIndicesY;
+			Array2DInt32 m_pCurrentVertexIndicesZ;
+
+			//When extracting in slabs, these are kept so that the slab can be joined to the one before it.
+			Array2DInt32 m_pFirstVertexIndicesX;
+			Array2DInt32 m_pFirstVertexIndicesY;
+
+			//The results of the threshold test for the voxels on either side of the current slice of cells,
+			//and the cube indices for the row of cells currently being processed.
+			std::vector<uint8_t> m_vecThresholdFlagsLower;
+			std::vector<uint8_t> m_vecThresholdFlagsUpper;
+			std::vector<uint8_t> m_vecCubeIndices;
+		};
+
 		SurfaceExtractor(VolumeType<VoxelType>* volData, Region region, SurfaceMesh<PositionMaterialNormal>* result);
 
+		/// Makes the extractor use the buffers held by the given Context, rather than
+		/// its own. The Context must outlive any calls to execute(). Passing null makes
+		/// the extractor go back to using its own buffers.
+		void setContext(Context* pContext);
+
 		void execute();
 
+		/// Extracts the same mesh as execute(), but splits the region into slabs along
+		/// the z axis and extracts these on several threads. Each slab numbers its
+		/// vertices from zero, and once they are all finished the slabs are joined up
+		/// by offsetting their indices and generating the triangles which span the
+		/// boundary between neighbouring slabs. The result is identical to that of
+		/// execute(), so this is intended for large regions which would otherwise be
+		/// extracted on a single core. Many small regions are better handled by
+		/// extractRegions().
+		///
+		/// The volume is read from several threads at once, so this must not be used
+		/// with volumes (such as the LargeVolume) which do not allow that.
+		///
+		/// \param uNoOfThreads The maximum number of threads to use, including the
+		/// calling thread. Zero means one for each core reported by the system.
+		void executeParallel(uint32_t uNoOfThreads = 0);
+
 	private:
+		//Whether the volume reports that all the voxels read by the extraction are on the same side of
+		//the threshold. Such regions (entirely air or entirely rock) can't contain any of the surface.
+		bool isRegionUniform(void) const;
+
+		//Extract the vertices for the slices from iFirstZ to iLastZ, and the triangles joining
+		//them up. Triangles joining iLastZ to the next slice are left for the caller.
+		void extractSlices(int32_t iFirstZ, int32_t iLastZ, bool bKeepFirstSlice);
+
+		//Runs extractSlices() for each of the slabs handed out by the queue.
+		static void extractSlabsWorker(std::vector< polyvox_shared_ptr< SurfaceExtractor<VolumeType, VoxelType> > >* pVecSlabExtractors, const std::vector<int32_t>* pVecSlabFirstZ, RegionExtractionQueue* pQueue);
+
 		//Compute the cell bitmask for a particular slice in z.
 		template<bool isPrevZAvail>
-		uint32_t computeBitmaskForSlice(const Array2DUint8& pPreviousBitmask, Array2DUint8& pCurrentBitmask);
+		uint32_t computeBitmaskForSlice(Array2DUint8& pCurrentBitmask);
 
-		//Compute the cell bitmask for a given cell.
-		template<bool isPrevXAvail, bool isPrevYAvail, bool isPrevZAvail>
-		void computeBitmaskForCell(const Array2DUint8& pPreviousBitmask, Array2DUint8& pCurrentBitmask);
+		//Test every voxel in a slice against the threshold, storing one byte per voxel.
+		void computeThresholdFlagsForSlice(int32_t iZPos, std::vector<uint8_t>& vecFlags);
 
 		//Use the cell bitmasks to generate all the vertices needed for that slice
 		void generateVerticesForSlice(const Array2DUint8& pCurrentBitmask,
@@ -86,38 +169,42 @@ namespace PolyVox
 			static const int weights[3][3][3] = {  {  {2,3,2}, {3,6,3}, {2,3,2}  },  {
 				{3,6,3},  {6,0,6},  {3,6,3} },  { {2,3,2},  {3,6,3},  {2,3,2} } };
 
+				//Fetch the whole neighbourhood at once, rather than peeking at each voxel in turn.
+				VoxelType pStencil[27];
+				volIter.peekNeighbourhood(pStencil);
+
 				//FIXME - Should actually use DensityType here, both in principle and because the maths may be
 				//faster (and to reduce casts). So it would be good to add a way to get DensityType from a voxel.
 				//But watch out for when the DensityType is unsigned and the difference could be negative.
-				const float pVoxel1nx1ny1nz = static_cast<float>(volIter.peekVoxel1nx1ny1nz().getDensity());
-				const float pVoxel1nx1ny0pz = static_cast<float>(volIter.peekVoxel1nx1ny0pz().getDensity());
-				const float pVoxel1nx1ny1pz = static_cast<float>(volIter.peekVoxel1nx1ny1pz().getDensity());
-				const float pVoxel1nx0py1nz = static_cast<float>(volIter.peekVoxel1nx0py1nz().getDensity());
-				const float pVoxel1nx0py0pz = static_cast<float>(volIter.peekVoxel1nx0py0pz().getDensity());
-				const float pVoxel1nx0py1pz = static_cast<float>(volIter.peekVoxel1nx0py1pz().getDensity());
-				const float pVoxel1nx1py1nz = static_cast<float>(volIter.peekVoxel1nx1py1nz().getDensity());
-				const float pVoxel1nx1py0pz = static_cast<float>(volIter.peekVoxel1nx1py0pz().getDensity());
-				const float pVoxel1nx1py1pz = static_cast<float>(volIter.peekVoxel1nx1py1pz().getDensity());
-
-				const float pVoxel0px1ny1nz = static_cast<float>(volIter.peekVoxel0px1ny1nz().getDensity());
-				const float pVoxel0px1ny0pz = static_cast<float>(volIter.peekVoxel0px1ny0pz().getDensity());
-				const float pVoxel0px1ny1pz = static_cast<float>(volIter.peekVoxel0px1ny1pz().getDensity());
-				const float pVoxel0px0py1nz = static_cast<float>(volIter.peekVoxel0px0py1nz().getDensity());
-				//const float pVoxel0px0py0pz = static_cast<float>(volIter.peekVoxel0px0py0pz().getDensity());
-				const float pVoxel0px0py1pz = static_cast<float>(volIter.peekVoxel0px0py1pz().getDensity());
-				const float pVoxel0px1py1nz = static_cast<float>(volIter.peekVoxel0px1py1nz().getDensity());
-				const float pVoxel0px1py0pz = static_cast<float>(volIter.peekVoxel0px1py0pz().getDensity());
-				const float pVoxel0px1py1pz = static_cast<float>(volIter.peekVoxel0px1py1pz().getDensity());
-
-				const float pVoxel1px1ny1nz = static_cast<float>(volIter.peekVoxel1px1ny1nz().getDensity());
-				const float pVoxel1px1ny0pz = static_cast<float>(volIter.peekVoxel1px1ny0pz().getDensity());
-				const float pVoxel1px1ny1pz = static_cast<float>(volIter.peekVoxel1px1ny1pz().getDensity());
-				const float pVoxel1px0py1nz = static_cast<float>(volIter.peekVoxel1px0py1nz().getDensity());
-				const float pVoxel1px0py0pz = static_cast<float>(volIter.peekVoxel1px0py0pz().getDensity());
-				const float pVoxel1px0py1pz = static_cast<float>(volIter.peekVoxel1px0py1pz().getDensity());
-				const float pVoxel1px1py1nz = static_cast<float>(volIter.peekVoxel1px1py1nz().getDensity());
-				const float pVoxel1px1py0pz = static_cast<float>(volIter.peekVoxel1px1py0pz().getDensity());
-				const float pVoxel1px1py1pz = static_cast<float>(volIter.peekVoxel1px1py1pz().getDensity());
+				const float pVoxel1nx1ny1nz = static_cast<float>(pStencil[0].getDensity());
+				const float pVoxel1nx1ny0pz = static_cast<float>(pStencil[9].getDensity());
+				const float pVoxel1nx1ny1pz = static_cast<float>(pStencil[18].getDensity());
+				const float pVoxel1nx0py1nz = static_cast<float>(pStencil[3].getDensity());
+				const float pVoxel1nx0py0pz = static_cast<float>(pStencil[12].getDensity());
+				const float pVoxel1nx0py1pz = static_cast<float>(pStencil[21].getDensity());
+				const float pVoxel1nx1py1nz = static_cast<float>(pStencil[6].getDensity());
+				const float pVoxel1nx1py0pz = static_cast<float>(pStencil[15].getDensity());
+				const float pVoxel1nx1py1pz = static_cast<float>(pStencil[24].getDensity());
+
+				const float pVoxel0px1ny1nz = static_cast<float>(pStencil[1].getDensity());
+				const float pVoxel0px1ny0pz = static_cast<float>(pStencil[10].getDensity());
+				const float pVoxel0px1ny1pz = static_cast<float>(pStencil[19].getDensity());
+				const float pVoxel0px0py1nz = static_cast<float>(pStencil[4].getDensity());
+				//const float pVoxel0px0py0pz = static_cast<float>(pStencil[13].getDensity());
+				const float pVoxel0px0py1pz = static_cast<float>(pStencil[22].getDensity());
+				const float pVoxel0px1py1nz = static_cast<float>(pStencil[7].getDensity());
+				const float pVoxel0px1py0pz = static_cast<float>(pStencil[16].getDensity());
+				const float pVoxel0px1py1pz = static_cast<float>(pStencil[25].getDensity());
+
+				const float pVoxel1px1ny1nz = static_cast<float>(pStencil[2].getDensity());
+				const float pVoxel1px1ny0pz = static_cast<float>(pStencil[11].getDensity());
+				const float pVoxel1px1ny1pz = static_cast<float>(pStencil[20].getDensity());
+				const float pVoxel1px0py1nz = static_cast<float>(pStencil[5].getDensity());
+				const float pVoxel1px0py0pz = static_cast<float>(pStencil[14].getDensity());
+				const float pVoxel1px0py1pz = static_cast<float>(pStencil[23].getDensity());
+				const float pVoxel1px1py1nz = static_cast<float>(pStencil[8].getDensity());
+				const float pVoxel1px1py0pz = static_cast<float>(pStencil[17].getDensity());
+				const float pVoxel1px1py1pz = static_cast<float>(pStencil[26].getDensity());
 
 				const float xGrad(- weights[0][0][0] * pVoxel1nx1ny1nz -
 					weights[1][0][0] * pVoxel1nx1ny0pz - weights[2][0][0] *
@@ -194,6 +281,17 @@ namespace PolyVox
 		//Used to return the number of cells in a slice which contain triangles.
 		uint32_t m_uNoOfOccupiedCells;
 
+		//The buffers used when no other context has been provided, and the ones actually in use.
+		Context m_defaultContext;
+		Context* m_pContext;
+
+		//When extracting in slabs, these are kept so that the slab can be joined to the one before it.
+		uint32_t m_uNoOfOccupiedCellsInFirstSlice;
+		uint32_t m_uNoOfOccupiedCellsInLastSlice;
+
+		//Slabs thinner than this are not worth the cost of joining them up.
+		static const uint32_t MinSlicesPerSlab;
+
 		//The surface patch we are currently filling.
 		SurfaceMesh<PositionMaterialNormal>* m_meshCurrent;
 
@@ -23,10 +23,39 @@ freely, subject to the following restrictions:
 
 namespace PolyVox
 {
+	template< template<typename> class VolumeType, typename VoxelType>
+	SurfaceExtractor<VolumeType, VoxelType>::Context::Context()
+		:m_uSliceWidth(0)
+		,m_uSliceHeight(0)
+	{
+	}
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void SurfaceExtractor<VolumeType, VoxelType>::Context::reserveSlices(uint32_t uWidth, uint32_t uHeight)
+	{
+		//Regions of different sizes share the largest arrays, as the indexing only depends on the
+		//array dimensions. Resizing an array to the size it already has leaves its memory alone.
+		m_uSliceWidth = (std::max)(m_uSliceWidth, uWidth);
+		m_uSliceHeight = (std::max)(m_uSliceHeight, uHeight);
+		uint32_t arraySizes[2]= {m_uSliceWidth, m_uSliceHeight}; // Array dimensions
+
+		m_pPreviousBitmask.resize(arraySizes);
+		m_pCurrentBitmask.resize(arraySizes);
+		m_pPreviousVertexIndicesX.resize(arraySizes);
+		m_pPreviousVertexIndicesY.resize(arraySizes);
+		m_pPreviousVertexIndicesZ.resize(arraySizes);
+		m_pCurrentVertexIndicesX.resize(arraySizes);
+		m_pCurrentVertexIndicesY.resize(arraySizes);
+		m_pCurrentVertexIndicesZ.resize(arraySizes);
+	}
+
 	template< template<typename> class VolumeType, typename VoxelType>
 	SurfaceExtractor<VolumeType, VoxelType>::SurfaceExtractor(VolumeType<VoxelType>* volData, Region region, SurfaceMesh<PositionMaterialNormal>* result)
 		:m_volData(volData)
 		,m_sampVolume(volData)
+		,m_pContext(&m_defaultContext)
+		,m_uNoOfOccupiedCellsInFirstSlice(0)
+		,m_uNoOfOccupiedCellsInLastSlice(0)
 		,m_meshCurrent(result)
 		,m_regSizeInVoxels(region)
 	{
@@ -35,84 +64,137 @@ namespace PolyVox
 		m_regSizeInCells.setUpperCorner(m_regSizeInCells.getUpperCorner() - Vector3DInt32(1,1,1));
 	}
 
+	template< template<typename> class VolumeType, typename VoxelType>
+	const uint32_t SurfaceExtractor<VolumeType, VoxelType>::MinSlicesPerSlab = 8;
+
+	template< template<typename> class VolumeType, typename VoxelType>
+	void SurfaceExtractor<VolumeType, VoxelType>::setContext(Context* pContext)
+	{
+		m_pContext = (pContext != 0) ? pContext : &m_defaultContext;
+	}
+
 	template< template<typename> class VolumeType, typename VoxelType>
 	void SurfaceExtractor<VolumeType, VoxelType>::execute()
 	{		
 		m_meshCurrent->clear();
 
-		uint32_t uArrayWidth = m_regSizeInVoxels.getUpperCorner().getX() - m_regSizeInVoxels.getLowerCorner().getX() + 1;
-		uint32_t uArrayHeight = m_regSizeInVoxels.getUpperCorner().getY() - m_regSizeInVoxels.getLowerCorner().getY() + 1;
-		uint32_t arraySizes[2]= {uArrayWidth, uArrayHeight}; // Array dimensions
+		if(!isRegionUniform())
+		{
+			extractSlices(m_regSizeInVoxels.getLowerCorner().getZ(), m_regSizeInVoxels.getUpperCorner().getZ(), false);
+		}
 
-		//For edge indices
-		Array2DInt32 m_pPreviousVertexIndicesX(arraySizes);
-		Array2DInt32 m_pPreviousVertexIndicesY(arraySizes);
-		Array2DInt32 m_pPreviousVertexIndicesZ(arraySizes);
-		Array2DInt32 m_pCurrentVertexIndicesX(arraySizes);
-		Array2DInt32 m_pCurrentVertexIndicesY(arraySizes);
-		Array2DInt32 m_pCurrentVertexIndicesZ(arraySizes);
+		m_meshCurrent->m_Region = m_regSizeInVoxels;
 
-		Array2DUint8 pPreviousBitmask(arraySizes);
-		Array2DUint8 pCurrentBitmask(arraySizes);
+		m_meshCurrent->m_vecLodRecords.clear();
+		LodRecord lodRecord;
+		lodRecord.beginIndex = 0;
+		lodRecord.endIndex = m_meshCurrent->getNoOfIndices();
+		m_meshCurrent->m_vecLodRecords.push_back(lodRecord);
+	}
 
-		//Create a region corresponding to the first slice
-		m_regSlicePrevious = m_regSizeInVoxels;
-		Vector3DInt32 v3dUpperCorner = m_regSlicePrevious.getUpperCorner();
-		v3dUpperCorner.setZ(m_regSlicePrevious.getLowerCorner().getZ()); //Set the upper z to the lower z to make it one slice thick.
-		m_regSlicePrevious.setUpperCorner(v3dUpperCorner);
-		m_regSliceCurrent = m_regSlicePrevious;	
+	template< template<typename> class VolumeType, typename VoxelType>
+	void SurfaceExtractor<VolumeType, VoxelType>::executeParallel(uint32_t uNoOfThreads)
+	{
+		const int32_t iLowerZ = m_regSizeInVoxels.getLowerCorner().getZ();
+		const int32_t iUpperZ = m_regSizeInVoxels.getUpperCorner().getZ();
+		const uint32_t uNoOfSlices = iUpperZ - iLowerZ + 1;
 
-		uint32_t uNoOfNonEmptyCellsForSlice0 = 0;
-		uint32_t uNoOfNonEmptyCellsForSlice1 = 0;
+		if(uNoOfThreads == 0)
+		{
+			//Note that hardware_concurrency() is allowed to return zero if it doesn't know.
+			uNoOfThreads = (std::max)(polyvox_thread::hardware_concurrency(), 1u);
+		}
+		const uint32_t uNoOfSlabs = (std::min)(uNoOfThreads, uNoOfSlices / MinSlicesPerSlab);
+		if((uNoOfSlabs <= 1) || isRegionUniform())
+		{
+			execute();
+			return;
+		}
 
-		//Process the first slice (previous slice not available)
-		computeBitmaskForSlice<false>(pPreviousBitmask, pCurrentBitmask);
-		uNoOfNonEmptyCellsForSlice1 = m_uNoOfOccupiedCells;
+		m_meshCurrent->clear();
 
-		if(uNoOfNonEmptyCellsForSlice1 != 0)
+		//Each slab gets its own extractor and mesh, so the threads share nothing but the volume.
+		std::vector< SurfaceMesh<PositionMaterialNormal> > vecSlabMeshes(uNoOfSlabs);
+		std::vector< polyvox_shared_ptr< SurfaceExtractor<VolumeType, VoxelType> > > vecSlabExtractors;
+		std::vector<int32_t> vecSlabFirstZ(uNoOfSlabs + 1);
+		for(uint32_t ct = 0; ct < uNoOfSlabs; ct++)
 		{
-			memset(m_pCurrentVertexIndicesX.getRawData(), 0xff, m_pCurrentVertexIndicesX.getNoOfElements() * 4);
-			memset(m_pCurrentVertexIndicesY.getRawData(), 0xff, m_pCurrentVertexIndicesY.getNoOfElements() * 4);
-			memset(m_pCurrentVertexIndicesZ.getRawData(), 0xff, m_pCurrentVertexIndicesZ.getNoOfElements() * 4);
-			generateVerticesForSlice(pCurrentBitmask, m_pCurrentVertexIndicesX, m_pCurrentVertexIndicesY, m_pCurrentVertexIndicesZ);				
+			vecSlabExtractors.push_back(polyvox_shared_ptr< SurfaceExtractor<VolumeType, VoxelType> >(new SurfaceExtractor<VolumeType, VoxelType>(m_volData, m_regSizeInVoxels, &vecSlabMeshes[ct])));
+			vecSlabFirstZ[ct] = iLowerZ + static_cast<int32_t>((ct * uNoOfSlices) / uNoOfSlabs);
 		}
+		vecSlabFirstZ[uNoOfSlabs] = iUpperZ + 1;
 
-		std::swap(uNoOfNonEmptyCellsForSlice0, uNoOfNonEmptyCellsForSlice1);
-		pPreviousBitmask.swap(pCurrentBitmask);
-		m_pPreviousVertexIndicesX.swap(m_pCurrentVertexIndicesX);
-		m_pPreviousVertexIndicesY.swap(m_pCurrentVertexIndicesY);
-		m_pPreviousVertexIndicesZ.swap(m_pCurrentVertexIndicesZ);
-
-		m_regSlicePrevious = m_regSliceCurrent;
-		m_regSliceCurrent.shift(Vector3DInt32(0,0,1));
+		//The calling thread takes a share of the slabs too.
+		RegionExtractionQueue queue(uNoOfSlabs);
+		std::vector< polyvox_shared_ptr<polyvox_thread> > vecThreads;
+		for(uint32_t ct = 1; ct < uNoOfSlabs; ct++)
+		{
+			vecThreads.push_back(polyvox_shared_ptr<polyvox_thread>(new polyvox_thread(&SurfaceExtractor<VolumeType, VoxelType>::extractSlabsWorker, &vecSlabExtractors, &vecSlabFirstZ, &queue)));
+		}
+		extractSlabsWorker(&vecSlabExtractors, &vecSlabFirstZ, &queue);
+		for(uint32_t ct = 0; ct < vecThreads.size(); ct++)
+		{
+			vecThreads[ct]->join();
+		}
+		queue.rethrowIfFailed();
 
-		//Process the other slices (previous slice is available)
-		for(int32_t uSlice = 1; uSlice <= m_regSizeInVoxels.getUpperCorner().getZ() - m_regSizeInVoxels.getLowerCorner().getZ(); uSlice++)
-		{	
-			computeBitmaskForSlice<true>(pPreviousBitmask, pCurrentBitmask);
-			uNoOfNonEmptyCellsForSlice1 = m_uNoOfOccupiedCells;
+		//The vertices are generated slice by slice, so simply appending the slabs gives the same order as execute().
+		std::vector<uint32_t> vecVertexOffsets(uNoOfSlabs);
+		uint32_t uNoOfVertices = 0;
+		uint32_t uNoOfIndices = 0;
+		for(uint32_t ct = 0; ct < uNoOfSlabs; ct++)
+		{
+			vecVertexOffsets[ct] = uNoOfVertices;
+			uNoOfVertices += vecSlabMeshes[ct].getNoOfVertices();
+			uNoOfIndices += vecSlabMeshes[ct].getNoOfIndices();
+		}
+		m_meshCurrent->m_vecVertices.reserve(uNoOfVertices);
+		m_meshCurrent->m_vecTriangleIndices.reserve(uNoOfIndices);
+		for(uint32_t ct = 0; ct < uNoOfSlabs; ct++)
+		{
+			m_meshCurrent->m_vecVertices.insert(m_meshCurrent->m_vecVertices.end(), vecSlabMeshes[ct].m_vecVertices.begin(), vecSlabMeshes[ct].m_vecVertices.end());
+		}
 
-			if(uNoOfNonEmptyCellsForSlice1 != 0)
+		//Move the vertex indices at the slab boundaries into the numbering of the whole mesh. Unused entries are -1 and stay that way.
+		for(uint32_t ct = 0; ct < uNoOfSlabs; ct++)
+		{
+			SurfaceExtractor<VolumeType, VoxelType>& slab = *(vecSlabExtractors[ct]);
+			Array2DInt32* pBoundaryIndices[5] = {&slab.m_pContext->m_pPreviousVertexIndicesX, &slab.m_pContext->m_pPreviousVertexIndicesY, &slab.m_pContext->m_pPreviousVertexIndicesZ, &slab.m_pContext->m_pFirstVertexIndicesX, &slab.m_pContext->m_pFirstVertexIndicesY};
+			for(uint32_t uArray = (ct + 1 < uNoOfSlabs) ? 0 : 3; uArray < ((ct > 0) ? 5u : 3u); uArray++)
 			{
-				memset(m_pCurrentVertexIndicesX.getRawData(), 0xff, m_pCurrentVertexIndicesX.getNoOfElements() * 4);
-				memset(m_pCurrentVertexIndicesY.getRawData(), 0xff, m_pCurrentVertexIndicesY.getNoOfElements() * 4);
-				memset(m_pCurrentVertexIndicesZ.getRawData(), 0xff, m_pCurrentVertexIndicesZ.getNoOfElements() * 4);
-				generateVerticesForSlice(pCurrentBitmask, m_pCurrentVertexIndicesX, m_pCurrentVertexIndicesY, m_pCurrentVertexIndicesZ);				
+				int32_t* pIndices = pBoundaryIndices[uArray]->getRawData();
+				for(uint32_t uElement = 0; uElement < pBoundaryIndices[uArray]->getNoOfElements(); uElement++)
+				{
+					if(pIndices[uElement] != -1)
+					{
+						pIndices[uElement] += vecVertexOffsets[ct];
+					}
+				}
 			}
+		}
 
-			if((uNoOfNonEmptyCellsForSlice0 != 0) || (uNoOfNonEmptyCellsForSlice1 != 0))
+		//The triangles are also generated slice by slice, with those for each boundary falling between the two slabs.
+		for(uint32_t ct = 0; ct < uNoOfSlabs; ct++)
+		{
+			const std::vector<uint32_t>& vecSlabIndices = vecSlabMeshes[ct].m_vecTriangleIndices;
+			for(uint32_t uIndex = 0; uIndex < vecSlabIndices.size(); uIndex++)
 			{
-				generateIndicesForSlice(pPreviousBitmask, m_pPreviousVertexIndicesX, m_pPreviousVertexIndicesY, m_pPreviousVertexIndicesZ, m_pCurrentVertexIndicesX, m_pCurrentVertexIndicesY);
+				m_meshCurrent->m_vecTriangleIndices.push_back(vecSlabIndices[uIndex] + vecVertexOffsets[ct]);
 			}
 
-			std::swap(uNoOfNonEmptyCellsForSlice0, uNoOfNonEmptyCellsForSlice1);
-			pPreviousBitmask.swap(pCurrentBitmask);
-			m_pPreviousVertexIndicesX.swap(m_pCurrentVertexIndicesX);
-			m_pPreviousVertexIndicesY.swap(m_pCurrentVertexIndicesY);
-			m_pPreviousVertexIndicesZ.swap(m_pCurrentVertexIndicesZ);
+			if(ct + 1 < uNoOfSlabs)
+			{
+				const SurfaceExtractor<VolumeType, VoxelType>& slab = *(vecSlabExtractors[ct]);
+				const SurfaceExtractor<VolumeType, VoxelType>& nextSlab = *(vecSlabExtractors[ct + 1]);
+				if((slab.m_uNoOfOccupiedCellsInLastSlice != 0) || (nextSlab.m_uNoOfOccupiedCellsInFirstSlice != 0))
+				{
+					m_regSlicePrevious = m_regSizeInVoxels;
+					m_regSlicePrevious.setLowerCorner(Vector3DInt32(m_regSizeInVoxels.getLowerCorner().getX(), m_regSizeInVoxels.getLowerCorner().getY(), vecSlabFirstZ[ct + 1] - 1));
+					m_regSlicePrevious.setUpperCorner(Vector3DInt32(m_regSizeInVoxels.getUpperCorner().getX(), m_regSizeInVoxels.getUpperCorner().getY(), vecSlabFirstZ[ct + 1] - 1));
 
-			m_regSlicePrevious = m_regSliceCurrent;
-			m_regSliceCurrent.shift(Vector3DInt32(0,0,1));
+					generateIndicesForSlice(slab.m_pContext->m_pPreviousBitmask, slab.m_pContext->m_pPreviousVertexIndicesX, slab.m_pContext->m_pPreviousVertexIndicesY, slab.m_pContext->m_pPreviousVertexIndicesZ, nextSlab.m_pContext->m_pFirstVertexIndicesX, nextSlab.m_pContext->m_pFirstVertexIndicesY);
+				}
+			}
 		}
 
 		m_meshCurrent->m_Region = m_regSizeInVoxels;
@@ -125,268 +207,203 @@ namespace PolyVox
 	}
 
 	template< template<typename> class VolumeType, typename VoxelType>
-	template<bool isPrevZAvail>
-	uint32_t SurfaceExtractor<VolumeType, VoxelType>::computeBitmaskForSlice(const Array2DUint8& pPreviousBitmask, Array2DUint8& pCurrentBitmask)
+	bool SurfaceExtractor<VolumeType, VoxelType>::isRegionUniform(void) const
 	{
-		m_uNoOfOccupiedCells = 0;
-
-		const int32_t iMaxXVolSpace = m_regSliceCurrent.getUpperCorner().getX();
-		const int32_t iMaxYVolSpace = m_regSliceCurrent.getUpperCorner().getY();
-
-		iZVolSpace = m_regSliceCurrent.getLowerCorner().getZ();
-		uZRegSpace = iZVolSpace - m_regSizeInVoxels.getLowerCorner().getZ();
+		//The threshold flags are computed for one voxel beyond the upper corner of the region.
+		const Region regVoxels(m_regSizeInVoxels.getLowerCorner(), m_regSizeInVoxels.getUpperCorner() + Vector3DInt32(1,1,1));
 
-		//Process the lower left corner
-		iYVolSpace = m_regSliceCurrent.getLowerCorner().getY();
-		iXVolSpace = m_regSliceCurrent.getLowerCorner().getX();
-
-		uXRegSpace = iXVolSpace - m_regSizeInVoxels.getLowerCorner().getX();
-		uYRegSpace = iYVolSpace - m_regSizeInVoxels.getLowerCorner().getY();
-
-		m_sampVolume.setPosition(iXVolSpace,iYVolSpace,iZVolSpace);
-		computeBitmaskForCell<false, false, isPrevZAvail>(pPreviousBitmask, pCurrentBitmask);
-
-		//Process the edge where x is minimal.
-		iXVolSpace = m_regSliceCurrent.getLowerCorner().getX();
-		m_sampVolume.setPosition(iXVolSpace, m_regSliceCurrent.getLowerCorner().getY(), iZVolSpace);
-		for(iYVolSpace = m_regSliceCurrent.getLowerCorner().getY() + 1; iYVolSpace <= iMaxYVolSpace; iYVolSpace++)
+		typename VolumeType<VoxelType>::DensityType tMin;
+		typename VolumeType<VoxelType>::DensityType tMax;
+		if(m_volData->getDensityRange(regVoxels, tMin, tMax))
 		{
-			uXRegSpace = iXVolSpace - m_regSizeInVoxels.getLowerCorner().getX();
-			uYRegSpace = iYVolSpace - m_regSizeInVoxels.getLowerCorner().getY();
-
-			m_sampVolume.movePositiveY();
-
-			computeBitmaskForCell<false, true, isPrevZAvail>(pPreviousBitmask, pCurrentBitmask);
+			return (tMin >= VoxelType::getThreshold()) || (tMax < VoxelType::getThreshold());
 		}
 
-		//Process the edge where y is minimal.
-		iYVolSpace = m_regSliceCurrent.getLowerCorner().getY();
-		m_sampVolume.setPosition(m_regSliceCurrent.getLowerCorner().getX(), iYVolSpace, iZVolSpace);
-		for(iXVolSpace = m_regSliceCurrent.getLowerCorner().getX() + 1; iXVolSpace <= iMaxXVolSpace; iXVolSpace++)
-		{	
-			uXRegSpace = iXVolSpace - m_regSizeInVoxels.getLowerCorner().getX();
-			uYRegSpace = iYVolSpace - m_regSizeInVoxels.getLowerCorner().getY();
-
-			m_sampVolume.movePositiveX();
-
-			computeBitmaskForCell<true, false, isPrevZAvail>(pPreviousBitmask, pCurrentBitmask);
-		}
+		return false;
+	}
 
-		//Process all remaining elemnents of the slice. In this case, previous x and y values are always available
-		for(iYVolSpace = m_regSliceCurrent.getLowerCorner().getY() + 1; iYVolSpace <= iMaxYVolSpace; iYVolSpace++)
+	template< template<typename> class VolumeType, typename VoxelType>
+	void SurfaceExtractor<VolumeType, VoxelType>::extractSlabsWorker(std::vector< polyvox_shared_ptr< SurfaceExtractor<VolumeType, VoxelType> > >* pVecSlabExtractors, const std::vector<int32_t>* pVecSlabFirstZ, RegionExtractionQueue* pQueue)
+	{
+		uint32_t uSlab;
+		while(pQueue->getNextRegion(uSlab))
 		{
-			m_sampVolume.setPosition(m_regSliceCurrent.getLowerCorner().getX(), iYVolSpace, iZVolSpace);
-			for(iXVolSpace = m_regSliceCurrent.getLowerCorner().getX() + 1; iXVolSpace <= iMaxXVolSpace; iXVolSpace++)
-			{	
-				uXRegSpace = iXVolSpace - m_regSizeInVoxels.getLowerCorner().getX();
-				uYRegSpace = iYVolSpace - m_regSizeInVoxels.getLowerCorner().getY();
-
-				m_sampVolume.movePositiveX();
-
-				computeBitmaskForCell<true, true, isPrevZAvail>(pPreviousBitmask, pCurrentBitmask);
+			try
+			{
+				(*pVecSlabExtractors)[uSlab]->extractSlices((*pVecSlabFirstZ)[uSlab], (*pVecSlabFirstZ)[uSlab + 1] - 1, uSlab != 0);
+				pQueue->regionCompleted(uSlab, 0);
+			}
+			catch(...)
+			{
+				pQueue->setFailed(polyvox_current_exception());
+				return;
 			}
 		}
-
-		return m_uNoOfOccupiedCells;
 	}
 
 	template< template<typename> class VolumeType, typename VoxelType>
-	template<bool isPrevXAvail, bool isPrevYAvail, bool isPrevZAvail>
-	void SurfaceExtractor<VolumeType, VoxelType>::computeBitmaskForCell(const Array2DUint8& pPreviousBitmask, Array2DUint8& pCurrentBitmask)
+	void SurfaceExtractor<VolumeType, VoxelType>::extractSlices(int32_t iFirstZ, int32_t iLastZ, bool bKeepFirstSlice)
 	{
-		uint8_t iCubeIndex = 0;
+		uint32_t uArrayWidth = m_regSizeInVoxels.getUpperCorner().getX() - m_regSizeInVoxels.getLowerCorner().getX() + 1;
+		uint32_t uArrayHeight = m_regSizeInVoxels.getUpperCorner().getY() - m_regSizeInVoxels.getLowerCorner().getY() + 1;
 
-		VoxelType v000;
-		VoxelType v100;
-		VoxelType v010;
-		VoxelType v110;
-		VoxelType v001;
-		VoxelType v101;
-		VoxelType v011;
-		VoxelType v111;
+		Context& context = *m_pContext;
+		context.reserveSlices(uArrayWidth, uArrayHeight);
 
-		if(isPrevZAvail)
-		{
-			if(isPrevYAvail)
-			{
-				if(isPrevXAvail)
-				{
-					v111 = m_sampVolume.peekVoxel1px1py1pz();
+		//For edge indices
+		memset(context.m_pPreviousVertexIndicesX.getRawData(), 0xff, context.m_pPreviousVertexIndicesX.getNoOfElements() * 4);
+		memset(context.m_pPreviousVertexIndicesY.getRawData(), 0xff, context.m_pPreviousVertexIndicesY.getNoOfElements() * 4);
+		memset(context.m_pPreviousVertexIndicesZ.getRawData(), 0xff, context.m_pPreviousVertexIndicesZ.getNoOfElements() * 4);
+		memset(context.m_pCurrentVertexIndicesX.getRawData(), 0xff, context.m_pCurrentVertexIndicesX.getNoOfElements() * 4);
+		memset(context.m_pCurrentVertexIndicesY.getRawData(), 0xff, context.m_pCurrentVertexIndicesY.getNoOfElements() * 4);
+		memset(context.m_pCurrentVertexIndicesZ.getRawData(), 0xff, context.m_pCurrentVertexIndicesZ.getNoOfElements() * 4);
 
-					//z
-					uint8_t iPreviousCubeIndexZ = pPreviousBitmask[uXRegSpace][uYRegSpace];
-					iPreviousCubeIndexZ >>= 4;
+		//Create a region corresponding to the first slice
+		m_regSlicePrevious = m_regSizeInVoxels;
+		m_regSlicePrevious.setLowerCorner(Vector3DInt32(m_regSizeInVoxels.getLowerCorner().getX(), m_regSizeInVoxels.getLowerCorner().getY(), iFirstZ));
+		m_regSlicePrevious.setUpperCorner(Vector3DInt32(m_regSizeInVoxels.getUpperCorner().getX(), m_regSizeInVoxels.getUpperCorner().getY(), iFirstZ)); //Set the upper z to the lower z to make it one slice thick.
+		m_regSliceCurrent = m_regSlicePrevious;	
 
-					//y
-					uint8_t iPreviousCubeIndexY = pCurrentBitmask[uXRegSpace][uYRegSpace-1];
-					iPreviousCubeIndexY &= 192; //192 = 128 + 64
-					iPreviousCubeIndexY >>= 2;
+		uint32_t uNoOfNonEmptyCellsForSlice0 = 0;
+		uint32_t uNoOfNonEmptyCellsForSlice1 = 0;
 
-					//x
-					uint8_t iPreviousCubeIndexX = pCurrentBitmask[uXRegSpace-1][uYRegSpace];
-					iPreviousCubeIndexX &= 128;
-					iPreviousCubeIndexX >>= 1;
+		//Process the first slice (previous slice not available)
+		computeBitmaskForSlice<false>(context.m_pCurrentBitmask);
+		uNoOfNonEmptyCellsForSlice1 = m_uNoOfOccupiedCells;
 
-					iCubeIndex = iPreviousCubeIndexX | iPreviousCubeIndexY | iPreviousCubeIndexZ;
+		if(uNoOfNonEmptyCellsForSlice1 != 0)
+		{
+			memset(context.m_pCurrentVertexIndicesX.getRawData(), 0xff, context.m_pCurrentVertexIndicesX.getNoOfElements() * 4);
+			memset(context.m_pCurrentVertexIndicesY.getRawData(), 0xff, context.m_pCurrentVertexIndicesY.getNoOfElements() * 4);
+			memset(context.m_pCurrentVertexIndicesZ.getRawData(), 0xff, context.m_pCurrentVertexIndicesZ.getNoOfElements() * 4);
+			generateVerticesForSlice(context.m_pCurrentBitmask, context.m_pCurrentVertexIndicesX, context.m_pCurrentVertexIndicesY, context.m_pCurrentVertexIndicesZ);				
+		}
 
-					if (v111.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 128;
-				}
-				else //previous X not available
-				{
-					v011 = m_sampVolume.peekVoxel0px1py1pz();
-					v111 = m_sampVolume.peekVoxel1px1py1pz();
+		//The slab before this one will need these to generate the triangles which join the two slabs.
+		if(bKeepFirstSlice)
+		{
+			uint32_t arraySizes[2]= {context.m_uSliceWidth, context.m_uSliceHeight}; // Array dimensions
+			context.m_pFirstVertexIndicesX.resize(arraySizes);
+			context.m_pFirstVertexIndicesY.resize(arraySizes);
+			memcpy(context.m_pFirstVertexIndicesX.getRawData(), context.m_pCurrentVertexIndicesX.getRawData(), context.m_pCurrentVertexIndicesX.getNoOfElements() * 4);
+			memcpy(context.m_pFirstVertexIndicesY.getRawData(), context.m_pCurrentVertexIndicesY.getRawData(), context.m_pCurrentVertexIndicesY.getNoOfElements() * 4);
+			m_uNoOfOccupiedCellsInFirstSlice = uNoOfNonEmptyCellsForSlice1;
+		}
 
-					//z
-					uint8_t iPreviousCubeIndexZ = pPreviousBitmask[uXRegSpace][uYRegSpace];
-					iPreviousCubeIndexZ >>= 4;
+		std::swap(uNoOfNonEmptyCellsForSlice0, uNoOfNonEmptyCellsForSlice1);
+		context.m_pPreviousBitmask.swap(context.m_pCurrentBitmask);
+		context.m_pPreviousVertexIndicesX.swap(context.m_pCurrentVertexIndicesX);
+		context.m_pPreviousVertexIndicesY.swap(context.m_pCurrentVertexIndicesY);
+		context.m_pPreviousVertexIndicesZ.swap(context.m_pCurrentVertexIndicesZ);
 
-					//y
-					uint8_t iPreviousCubeIndexY = pCurrentBitmask[uXRegSpace][uYRegSpace-1];
-					iPreviousCubeIndexY &= 192; //192 = 128 + 64
-					iPreviousCubeIndexY >>= 2;
+		m_regSlicePrevious = m_regSliceCurrent;
+		m_regSliceCurrent.shift(Vector3DInt32(0,0,1));
 
-					iCubeIndex = iPreviousCubeIndexY | iPreviousCubeIndexZ;
+		//Process the other slices (previous slice is available)
+		for(int32_t iSliceZ = iFirstZ + 1; iSliceZ <= iLastZ; iSliceZ++)
+		{	
+			computeBitmaskForSlice<true>(context.m_pCurrentBitmask);
+			uNoOfNonEmptyCellsForSlice1 = m_uNoOfOccupiedCells;
 
-					if (v011.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 64;
-					if (v111.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 128;
-				}
-			}
-			else //previous Y not available
+			if(uNoOfNonEmptyCellsForSlice1 != 0)
 			{
-				if(isPrevXAvail)
-				{
-					v101 = m_sampVolume.peekVoxel1px0py1pz();
-					v111 = m_sampVolume.peekVoxel1px1py1pz();
-
-					//z
-					uint8_t iPreviousCubeIndexZ = pPreviousBitmask[uXRegSpace][uYRegSpace];
-					iPreviousCubeIndexZ >>= 4;
+				memset(context.m_pCurrentVertexIndicesX.getRawData(), 0xff, context.m_pCurrentVertexIndicesX.getNoOfElements() * 4);
+				memset(context.m_pCurrentVertexIndicesY.getRawData(), 0xff, context.m_pCurrentVertexIndicesY.getNoOfElements() * 4);
+				memset(context.m_pCurrentVertexIndicesZ.getRawData(), 0xff, context.m_pCurrentVertexIndicesZ.getNoOfElements() * 4);
+				generateVerticesForSlice(context.m_pCurrentBitmask, context.m_pCurrentVertexIndicesX, context.m_pCurrentVertexIndicesY, context.m_pCurrentVertexIndicesZ);				
+			}
 
-					//x
-					uint8_t iPreviousCubeIndexX = pCurrentBitmask[uXRegSpace-1][uYRegSpace];
-					iPreviousCubeIndexX &= 160; //160 = 128+32
-					iPreviousCubeIndexX >>= 1;
+			if((uNoOfNonEmptyCellsForSlice0 != 0) || (uNoOfNonEmptyCellsForSlice1 != 0))
+			{
+				generateIndicesForSlice(context.m_pPreviousBitmask, context.m_pPreviousVertexIndicesX, context.m_pPreviousVertexIndicesY, context.m_pPreviousVertexIndicesZ, context.m_pCurrentVertexIndicesX, context.m_pCurrentVertexIndicesY);
+			}
 
-					iCubeIndex = iPreviousCubeIndexX | iPreviousCubeIndexZ;
+			std::swap(uNoOfNonEmptyCellsForSlice0, uNoOfNonEmptyCellsForSlice1);
+			context.m_pPreviousBitmask.swap(context.m_pCurrentBitmask);
+			context.m_pPreviousVertexIndicesX.swap(context.m_pCurrentVertexIndicesX);
+			context.m_pPreviousVertexIndicesY.swap(context.m_pCurrentVertexIndicesY);
+			context.m_pPreviousVertexIndicesZ.swap(context.m_pCurrentVertexIndicesZ);
 
-					if (v101.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 32;
-					if (v111.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 128;
-				}
-				else //previous X not available
-				{
-					v001 = m_sampVolume.peekVoxel0px0py1pz();
-					v101 = m_sampVolume.peekVoxel1px0py1pz();
-					v011 = m_sampVolume.peekVoxel0px1py1pz();
-					v111 = m_sampVolume.peekVoxel1px1py1pz();
-
-					//z
-					uint8_t iPreviousCubeIndexZ = pPreviousBitmask[uXRegSpace][uYRegSpace];
-					iCubeIndex = iPreviousCubeIndexZ >> 4;
-
-					if (v001.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 16;
-					if (v101.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 32;
-					if (v011.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 64;
-					if (v111.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 128;
-				}
-			}
+			m_regSlicePrevious = m_regSliceCurrent;
+			m_regSliceCurrent.shift(Vector3DInt32(0,0,1));
 		}
-		else //previous Z not available
-		{
-			if(isPrevYAvail)
-			{
-				if(isPrevXAvail)
-				{
-					v110 = m_sampVolume.peekVoxel1px1py0pz();
-					v111 = m_sampVolume.peekVoxel1px1py1pz();
 
-					//y
-					uint8_t iPreviousCubeIndexY = pCurrentBitmask[uXRegSpace][uYRegSpace-1];
-					iPreviousCubeIndexY &= 204; //204 = 128+64+8+4
-					iPreviousCubeIndexY >>= 2;
+		//The next slab will need the last slice to generate the triangles which join the two slabs.
+		m_uNoOfOccupiedCellsInLastSlice = uNoOfNonEmptyCellsForSlice0;
+	}
 
-					//x
-					uint8_t iPreviousCubeIndexX = pCurrentBitmask[uXRegSpace-1][uYRegSpace];
-					iPreviousCubeIndexX &= 170; //170 = 128+32+8+2
-					iPreviousCubeIndexX >>= 1;
+	template< template<typename> class VolumeType, typename VoxelType>
+	template<bool isPrevZAvail>
+	uint32_t SurfaceExtractor<VolumeType, VoxelType>::computeBitmaskForSlice(Array2DUint8& pCurrentBitmask)
+	{
+		Context& context = *m_pContext;
 
-					iCubeIndex = iPreviousCubeIndexX | iPreviousCubeIndexY;
+		m_uNoOfOccupiedCells = 0;
 
-					if (v110.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 8;
-					if (v111.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 128;
-				}
-				else //previous X not available
-				{
-					v010 = m_sampVolume.peekVoxel0px1py0pz();
-					v110 = m_sampVolume.peekVoxel1px1py0pz();
+		const int32_t iMinXVolSpace = m_regSliceCurrent.getLowerCorner().getX();
+		const int32_t iMaxXVolSpace = m_regSliceCurrent.getUpperCorner().getX();
+		const int32_t iMinYVolSpace = m_regSliceCurrent.getLowerCorner().getY();
+		const int32_t iMaxYVolSpace = m_regSliceCurrent.getUpperCorner().getY();
 
-					v011 = m_sampVolume.peekVoxel0px1py1pz();
-					v111 = m_sampVolume.peekVoxel1px1py1pz();
+		//Each cell also uses the voxels on its positive side, so the flags cover one more voxel in each direction.
+		const uint32_t uNoOfCellsInRow = iMaxXVolSpace - iMinXVolSpace + 1;
+		const uint32_t uFlagsRowLength = uNoOfCellsInRow + 1;
 
-					//y
-					uint8_t iPreviousCubeIndexY = pCurrentBitmask[uXRegSpace][uYRegSpace-1];
-					iPreviousCubeIndexY &= 204; //204 = 128+64+8+4
-					iPreviousCubeIndexY >>= 2;
+		iZVolSpace = m_regSliceCurrent.getLowerCorner().getZ();
+		uZRegSpace = iZVolSpace - m_regSizeInVoxels.getLowerCorner().getZ();
 
-					iCubeIndex = iPreviousCubeIndexY;
+		//The lower side of this slice is the upper side of the previous one, so in that case its flags are reused.
+		if(isPrevZAvail)
+		{
+			context.m_vecThresholdFlagsLower.swap(context.m_vecThresholdFlagsUpper);
+		}
+		else
+		{
+			computeThresholdFlagsForSlice(iZVolSpace, context.m_vecThresholdFlagsLower);
+		}
+		computeThresholdFlagsForSlice(iZVolSpace + 1, context.m_vecThresholdFlagsUpper);
 
-					if (v010.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 4;
-					if (v110.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 8;
-					if (v011.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 64;
-					if (v111.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 128;
-				}
-			}
-			else //previous Y not available
-			{
-				if(isPrevXAvail)
-				{
-					v100 = m_sampVolume.peekVoxel1px0py0pz();
-					v110 = m_sampVolume.peekVoxel1px1py0pz();
+		context.m_vecCubeIndices.resize(uNoOfCellsInRow);
 
-					v101 = m_sampVolume.peekVoxel1px0py1pz();
-					v111 = m_sampVolume.peekVoxel1px1py1pz();
+		for(iYVolSpace = iMinYVolSpace; iYVolSpace <= iMaxYVolSpace; iYVolSpace++)
+		{
+			uYRegSpace = iYVolSpace - m_regSizeInVoxels.getLowerCorner().getY();
 
-					//x
-					uint8_t iPreviousCubeIndexX = pCurrentBitmask[uXRegSpace-1][uYRegSpace];
-					iPreviousCubeIndexX &= 170; //170 = 128+32+8+2
-					iPreviousCubeIndexX >>= 1;
+			const uint8_t* pRow00 = &context.m_vecThresholdFlagsLower[uYRegSpace * uFlagsRowLength];
+			const uint8_t* pRow01 = &context.m_vecThresholdFlagsUpper[uYRegSpace * uFlagsRowLength];
 
-					iCubeIndex = iPreviousCubeIndexX;
+			m_uNoOfOccupiedCells += computeCubeIndicesForRow(pRow00, pRow00 + uFlagsRowLength, pRow01, pRow01 + uFlagsRowLength, &context.m_vecCubeIndices[0], uNoOfCellsInRow);
 
-					if (v100.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 2;	
-					if (v110.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 8;
-					if (v101.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 32;
-					if (v111.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 128;
-				}
-				else //previous X not available
-				{
-					v000 = m_sampVolume.getVoxel();
-					v100 = m_sampVolume.peekVoxel1px0py0pz();
-					v010 = m_sampVolume.peekVoxel0px1py0pz();
-					v110 = m_sampVolume.peekVoxel1px1py0pz();
-
-					v001 = m_sampVolume.peekVoxel0px0py1pz();
-					v101 = m_sampVolume.peekVoxel1px0py1pz();
-					v011 = m_sampVolume.peekVoxel0px1py1pz();
-					v111 = m_sampVolume.peekVoxel1px1py1pz();
-
-					if (v000.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 1;
-					if (v100.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 2;
-					if (v010.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 4;
-					if (v110.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 8;
-					if (v001.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 16;
-					if (v101.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 32;
-					if (v011.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 64;
-					if (v111.getDensity() < VoxelType::getThreshold()) iCubeIndex |= 128;
-				}
+			//Save the bitmask
+			for(uXRegSpace = 0; uXRegSpace < uNoOfCellsInRow; uXRegSpace++)
+			{
+				pCurrentBitmask[uXRegSpace][uYRegSpace] = context.m_vecCubeIndices[uXRegSpace];
 			}
 		}
 
-		//Save the bitmask
-		pCurrentBitmask[uXRegSpace][iYVolSpace- m_regSizeInVoxels.getLowerCorner().getY()] = iCubeIndex;
+		return m_uNoOfOccupiedCells;
+	}
 
-		if(edgeTable[iCubeIndex] != 0)
+	template< template<typename> class VolumeType, typename VoxelType>
+	void SurfaceExtractor<VolumeType, VoxelType>::computeThresholdFlagsForSlice(int32_t iZPos, std::vector<uint8_t>& vecFlags)
+	{
+		const Vector3DInt32& v3dLowerCorner = m_regSliceCurrent.getLowerCorner();
+		const Vector3DInt32& v3dUpperCorner = m_regSliceCurrent.getUpperCorner();
+		const Region regFlags(Vector3DInt32(v3dLowerCorner.getX(), v3dLowerCorner.getY(), iZPos), Vector3DInt32(v3dUpperCorner.getX() + 1, v3dUpperCorner.getY() + 1, iZPos));
+
+		const uint32_t uFlagsRowLength = regFlags.getUpperCorner().getX() - regFlags.getLowerCorner().getX() + 1;
+		const uint32_t uFlagsNoOfRows = regFlags.getUpperCorner().getY() - regFlags.getLowerCorner().getY() + 1;
+		vecFlags.resize(uFlagsRowLength * uFlagsNoOfRows);
+
+		for(ConstSpanIterator<VolumeType, VoxelType> iter(m_volData, regFlags); iter.isValid(); iter.moveForward())
 		{
-			++m_uNoOfOccupiedCells;
+			const VoxelType* pVoxels = iter.getSpan();
+			uint8_t* pFlags = &vecFlags[(iter.getPosY() - regFlags.getLowerCorner().getY()) * uFlagsRowLength + (iter.getPosX() - regFlags.getLowerCorner().getX())];
+			const int32_t iLength = iter.getLength();
+			for(int32_t i = 0; i < iLength; i++)
+			{
+				pFlags[i] = (pVoxels[i].getDensity() < VoxelType::getThreshold()) ? 1 : 0;
+			}
 		}
 	}
 
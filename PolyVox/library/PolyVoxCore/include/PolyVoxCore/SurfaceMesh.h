@@ -45,6 +45,19 @@ namespace PolyVox
 		int endIndex; //Let's put it just past the end STL style
 	};
 
+	/// The directions in which the faces of a cubic mesh can point, in the order in
+	/// which the CubicSurfaceExtractor writes them to the mesh.
+	enum FacingDirection
+	{
+		FacingPositiveX,
+		FacingPositiveY,
+		FacingPositiveZ,
+		FacingNegativeX,
+		FacingNegativeY,
+		FacingNegativeZ,
+		NoOfFacingDirections
+	};
+
 	template <typename VertexType>
 	class SurfaceMesh
 	{
@@ -65,6 +78,8 @@ namespace PolyVox
 	   uint32_t addVertex(const VertexType& vertex);
 	   void clear(void);
 	   bool isEmpty(void) const;
+	   void reserve(uint32_t uNoOfVertices, uint32_t uNoOfIndices);
+	   void swap(SurfaceMesh<VertexType>& rhs);
 
 	   void scaleVertices(float amount);
 	   void translateVertices(const Vector3DFloat& amount);
@@ -93,10 +108,94 @@ namespace PolyVox
 		std::vector<VertexType> m_vecVertices;
 
 		std::vector<LodRecord> m_vecLodRecords;
+
+		//Meshes from the CubicSurfaceExtractor have one of these for each FacingDirection, giving the range of
+		//indices for the faces which point in that direction. Together they cover the first LOD record. Other
+		//meshes (and meshes whose triangles have been changed since extraction) have none.
+		std::vector<LodRecord> m_vecFacingRecords;
 	};	
 
 	template <typename VertexType>
 	polyvox_shared_ptr< SurfaceMesh<VertexType> > extractSubset(SurfaceMesh<VertexType>& inputMesh, std::set<uint8_t> setMaterials);
+
+	/// Finds which faces of a cubic mesh could be seen from a given position.
+	////////////////////////////////////////////////////////////////////////////////
+	/// A face can only be seen from in front of it, so (for example) the faces which
+	/// point along positive x can be skipped when the position is on the negative x
+	/// side of all of them. Each of the faces in a mesh lies on the boundary of one
+	/// of its voxels, so this only needs the region which the mesh was extracted from.
+	/// When the position is outside the region along all three axes, three of the six
+	/// directions are skipped.
+	///
+	/// \param region The region which the mesh covers (its m_Region).
+	/// \param v3dViewPosition The position to view the mesh from, in the same space as the region.
+	/// \return The directions which could be seen, with FacingPositiveX as bit 0 and so on.
+	////////////////////////////////////////////////////////////////////////////////
+	POLYVOX_API uint32_t getVisibleFacingDirections(const Region& region, const Vector3DFloat& v3dViewPosition);
+
+	/// Gives the ranges of indices which hold the faces pointing in the given directions.
+	////////////////////////////////////////////////////////////////////////////////
+	/// Ranges which follow on from each other are joined, so that they can be drawn
+	/// together. If there are no facing records (because the mesh is not from the
+	/// CubicSurfaceExtractor) then the whole of the first LOD record is given.
+	///
+	/// \param vecFacingRecords The facing records of the mesh.
+	/// \param vecLodRecords The LOD records of the mesh.
+	/// \param uDirections The directions to include, as given by getVisibleFacingDirections().
+	/// \param vecRanges Receives the ranges, with any existing contents replaced.
+	////////////////////////////////////////////////////////////////////////////////
+	POLYVOX_API void getFacingIndexRanges(const std::vector<LodRecord>& vecFacingRecords, const std::vector<LodRecord>& vecLodRecords, uint32_t uDirections, std::vector<LodRecord>& vecRanges);
+
+	/// Chooses which level of detail to draw a mesh at, based on how far away it is.
+	////////////////////////////////////////////////////////////////////////////////
+	/// The first level is used while the position is closer to the region than the
+	/// given distance, and each doubling of the distance beyond that moves one level
+	/// coarser, up to the last level which the mesh has.
+	///
+	/// \param region The region which the mesh covers (its m_Region).
+	/// \param v3dViewPosition The position to view the mesh from, in the same space as the region.
+	/// \param uNoOfLodLevels The number of LOD records which the mesh has.
+	/// \param fLodDistance The distance at which the second level starts being used. If this is zero or less the first level is always used.
+	/// \return The level to draw, counting from zero.
+	////////////////////////////////////////////////////////////////////////////////
+	POLYVOX_API uint32_t selectLodLevel(const Region& region, const Vector3DFloat& v3dViewPosition, uint32_t uNoOfLodLevels, float fLodDistance);
+
+	/// Gives the ranges of indices to draw for a level of detail.
+	////////////////////////////////////////////////////////////////////////////////
+	/// The facing records only describe the first level, so for that level this is
+	/// the same as getFacingIndexRanges(). For the coarser levels the whole of the
+	/// level's LOD record is given. Each level has its own range of the index buffer
+	/// (see MeshSimplifier), so only one level is ever drawn at a time.
+	///
+	/// \param vecFacingRecords The facing records of the mesh.
+	/// \param vecLodRecords The LOD records of the mesh.
+	/// \param uLodLevel The level to draw, as given by selectLodLevel().
+	/// \param uDirections The directions to include, as given by getVisibleFacingDirections().
+	/// \param vecRanges Receives the ranges, with any existing contents replaced.
+	////////////////////////////////////////////////////////////////////////////////
+	POLYVOX_API void getLodIndexRanges(const std::vector<LodRecord>& vecFacingRecords, const std::vector<LodRecord>& vecLodRecords, uint32_t uLodLevel, uint32_t uDirections, std::vector<LodRecord>& vecRanges);
+
+	/// Checks whether the indices of a mesh can be stored in 16 bits.
+	////////////////////////////////////////////////////////////////////////////////
+	/// This is the case when the mesh has at most 65535 vertices, which includes almost
+	/// every mesh extracted from a 32x32x32 region. The largest 16 bit value is left unused
+	/// as some graphics APIs treat it as a marker for restarting primitives.
+	///
+	/// \param uNoOfVertices The number of vertices in the mesh.
+	/// \return Whether every index into the vertices fits in 16 bits.
+	////////////////////////////////////////////////////////////////////////////////
+	POLYVOX_API bool canUse16BitIndices(uint32_t uNoOfVertices);
+
+	/// Narrows indices to 16 bits, halving the memory they need.
+	////////////////////////////////////////////////////////////////////////////////
+	/// This is intended for filling a 16 bit index buffer, such as one which is mapped
+	/// into memory by the graphics API, without keeping a second copy of the indices.
+	/// It should only be used when canUse16BitIndices() is true for the mesh.
+	///
+	/// \param vecIndices The indices of the mesh.
+	/// \param pPackedIndices Receives the narrowed indices. There must be room for all of them.
+	////////////////////////////////////////////////////////////////////////////////
+	POLYVOX_API void packIndicesTo16Bit(const std::vector<uint32_t>& vecIndices, uint16_t* pPackedIndices);
 }
 
 #include "PolyVoxCore/SurfaceMesh.inl"
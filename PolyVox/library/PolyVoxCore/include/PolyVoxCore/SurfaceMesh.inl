@@ -27,6 +27,7 @@ namespace PolyVox
 	SurfaceMesh<VertexType>::SurfaceMesh()
 	{
 		m_iTimeStamp = -1;
+		m_iNoOfLod0Tris = 0;
 	}
 
 	template <typename VertexType>
@@ -130,12 +131,18 @@ namespace PolyVox
 		return m_vecVertices.size() - 1;
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// Removes all the vertices, indices and records. The memory which held them
+	/// is kept, so a mesh which is cleared and refilled (as the extractors do) only
+	/// needs to allocate when it grows beyond its previous size.
+	////////////////////////////////////////////////////////////////////////////////
 	template <typename VertexType>
 	void SurfaceMesh<VertexType>::clear(void)
 	{
 		m_vecVertices.clear();
 		m_vecTriangleIndices.clear();
 		m_vecLodRecords.clear();
+		m_vecFacingRecords.clear();
 	}
 
 	template <typename VertexType>
@@ -144,6 +151,35 @@ namespace PolyVox
 		return (getNoOfVertices() == 0) || (getNoOfIndices() == 0);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// Makes room for the given number of vertices and indices, so that they can be
+	/// added without any further allocation. The counts from a previous extraction of
+	/// the same region make a good estimate. The mesh is not changed.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VertexType>
+	void SurfaceMesh<VertexType>::reserve(uint32_t uNoOfVertices, uint32_t uNoOfIndices)
+	{
+		m_vecVertices.reserve(uNoOfVertices);
+		m_vecTriangleIndices.reserve(uNoOfIndices);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// Exchanges the contents of two meshes without copying the vertex or index data.
+	/// This allows a finished mesh to be handed on while its memory is recycled.
+	/// \param rhs The mesh to swap this one with.
+	////////////////////////////////////////////////////////////////////////////////
+	template <typename VertexType>
+	void SurfaceMesh<VertexType>::swap(SurfaceMesh<VertexType>& rhs)
+	{
+		std::swap(m_Region, rhs.m_Region);
+		std::swap(m_iTimeStamp, rhs.m_iTimeStamp);
+		std::swap(m_iNoOfLod0Tris, rhs.m_iNoOfLod0Tris);
+		m_vecTriangleIndices.swap(rhs.m_vecTriangleIndices);
+		m_vecVertices.swap(rhs.m_vecVertices);
+		m_vecLodRecords.swap(rhs.m_vecLodRecords);
+		m_vecFacingRecords.swap(rhs.m_vecFacingRecords);
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/// This function can help improve the visual appearance of a surface patch by
 	/// smoothing normals with other nearby normals. It iterates over each triangle
@@ -359,6 +395,9 @@ namespace PolyVox
 		}
 
 		m_vecTriangleIndices.resize(noOfNonDegenerate * 3);
+
+		//The faces for each direction may have moved.
+		m_vecFacingRecords.clear();
 	}
 
 	template <typename VertexType>
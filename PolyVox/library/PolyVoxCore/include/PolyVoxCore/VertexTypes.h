@@ -54,6 +54,37 @@ namespace PolyVox
 		float material;
 	};	
 
+	/// A vertex of a cubic mesh which also records how much ambient light reaches it.
+	////////////////////////////////////////////////////////////////////////////////
+	/// The ambient occlusion is found from the three voxels which touch the vertex
+	/// in the layer in front of its face. It goes from 0 (the vertex is in a corner
+	/// which is closed in on both sides) to 3 (none of the voxels are solid).
+	////////////////////////////////////////////////////////////////////////////////
+#ifdef SWIG
+	class PositionMaterialAO
+#else
+	class POLYVOX_API PositionMaterialAO
+#endif
+	{
+	public:	
+		PositionMaterialAO();
+		PositionMaterialAO(Vector3DFloat positionToSet, float materialToSet);
+		PositionMaterialAO(Vector3DFloat positionToSet, float materialToSet, uint8_t ambientOcclusionToSet);
+
+		uint8_t getAmbientOcclusion(void) const;
+		float getMaterial(void) const;
+		const Vector3DFloat& getPosition(void) const;
+
+		void setAmbientOcclusion(uint8_t ambientOcclusionToSet);
+		void setMaterial(float materialToSet);
+		void setPosition(const Vector3DFloat& positionToSet);
+	public:
+		//The same four floats as the PositionMaterial, followed by the occlusion.
+		Vector3DFloat position;
+		float material;
+		uint8_t ambientOcclusion;
+	};
+
 #ifdef SWIG
 	class PositionMaterialNormal
 #else
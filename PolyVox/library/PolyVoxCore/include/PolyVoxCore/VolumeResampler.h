@@ -24,7 +24,12 @@ freely, subject to the following restrictions:
 #ifndef __PolyVox_VolumeResampler_H__
 #define __PolyVox_VolumeResampler_H__
 
+#include "PolyVoxCore/Region.h"
+#include "PolyVoxCore/SpanIterator.h"
+
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace PolyVox
 {
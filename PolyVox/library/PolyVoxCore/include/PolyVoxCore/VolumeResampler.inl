@@ -56,17 +56,31 @@ namespace PolyVox
 	template< template<typename> class SrcVolumeType, template<typename> class DestVolumeType, typename VoxelType>
 	void VolumeResampler<SrcVolumeType, DestVolumeType, VoxelType>::resampleSameSize()
 	{
+		//Each row is read into a buffer before being written, in case the source and destination are the same volume.
+		std::vector<VoxelType> vecRow(m_regDst.getUpperCorner().getX() - m_regDst.getLowerCorner().getX() + 1);
+
 		for(int32_t sz = m_regSrc.getLowerCorner().getZ(), dz = m_regDst.getLowerCorner().getZ(); dz <= m_regDst.getUpperCorner().getZ(); sz++, dz++)
 		{
 			for(int32_t sy = m_regSrc.getLowerCorner().getY(), dy = m_regDst.getLowerCorner().getY(); dy <= m_regDst.getUpperCorner().getY(); sy++, dy++)
 			{
-				for(int32_t sx = m_regSrc.getLowerCorner().getX(), dx = m_regDst.getLowerCorner().getX(); dx <= m_regDst.getUpperCorner().getX(); sx++,dx++)
+				const int32_t sx = m_regSrc.getLowerCorner().getX();
+				Region regSrcRow(Vector3DInt32(sx, sy, sz), Vector3DInt32(sx + static_cast<int32_t>(vecRow.size()) - 1, sy, sz));
+				for(ConstSpanIterator<SrcVolumeType, VoxelType> srcIter(m_pVolSrc, regSrcRow); srcIter.isValid(); srcIter.moveForward())
 				{
-					VoxelType voxel = m_pVolSrc->getVoxelAt(sx,sy,sz);
-					m_pVolDst->setVoxelAt(dx,dy,dz,voxel);
+					std::copy(srcIter.getSpan(), srcIter.getSpan() + srcIter.getLength(), vecRow.begin() + (srcIter.getPosX() - sx));
+				}
+
+				const int32_t dx = m_regDst.getLowerCorner().getX();
+				Region regDstRow(Vector3DInt32(dx, dy, dz), Vector3DInt32(m_regDst.getUpperCorner().getX(), dy, dz));
+				for(SpanIterator<DestVolumeType, VoxelType> dstIter(m_pVolDst, regDstRow); dstIter.isValid(); dstIter.moveForward())
+				{
+					std::copy(vecRow.begin() + (dstIter.getPosX() - dx), vecRow.begin() + (dstIter.getPosX() - dx + dstIter.getLength()), dstIter.getSpan());
 				}
 			}
 		}
+
+		//The rows were written through spans, which the destination can't keep track of.
+		m_pVolDst->recalculateDensityRanges();
 	}
 
 	template< template<typename> class SrcVolumeType, template<typename> class DestVolumeType, typename VoxelType>
@@ -63,6 +63,7 @@ namespace PolyVox
 	public:
 		void compress(void);
 		void uncompress(void);
+		void tidy(void);
 
 		std::vector< RunlengthEntry<uint16_t> > m_vecCompressedData;
 		VoxelType* m_tUncompressedData;
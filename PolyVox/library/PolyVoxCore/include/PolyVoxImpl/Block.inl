@@ -211,4 +211,21 @@ namespace PolyVox
 		m_bIsCompressed = false;
 		m_bIsUncompressedDataModified = false;
 	}
+
+	template <typename VoxelType>
+	void Block<VoxelType>::tidy(void)
+	{
+		//Only the compressed representation can accumulate slack.
+		if(!m_bIsCompressed)
+		{
+			return;
+		}
+
+		//compress() already joins equal neighbours into runs, so there is nothing to merge. But fill() replaces the
+		//runs with a single one and keeps the old capacity, so release any spare capacity (as compress() does).
+		if(m_vecCompressedData.capacity() > m_vecCompressedData.size())
+		{
+			std::vector< RunlengthEntry<uint16_t> >(m_vecCompressedData).swap(m_vecCompressedData);
+		}
+	}
 }
@@ -0,0 +1,38 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#ifndef __PolyVox_CubeIndices_H__
+#define __PolyVox_CubeIndices_H__
+
+#include "PolyVoxImpl/TypeDef.h"
+
+namespace PolyVox
+{
+	//Computes the marching cubes index of every cell in a row. The four inputs hold one byte per voxel (one if the voxel
+	//is below the threshold, zero otherwise) for the rows at (y,z), (y+1,z), (y,z+1) and (y+1,z+1). Each must hold
+	//uNoOfCells + 1 values, because the last cell in the row also needs the voxels at its far side. The return value is
+	//the number of cells which are neither completely empty nor completely full, and hence contain part of the surface.
+	POLYVOX_API uint32_t computeCubeIndicesForRow(const uint8_t* pRow00, const uint8_t* pRow10, const uint8_t* pRow01, const uint8_t* pRow11, uint8_t* pCubeIndices, uint32_t uNoOfCells);
+}
+
+#endif
@@ -0,0 +1,84 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#ifndef __PolyVox_DensityRange_H__
+#define __PolyVox_DensityRange_H__
+
+#include "PolyVoxImpl/TypeDef.h"
+
+#include <cassert>
+
+namespace PolyVox
+{
+	//Gives the density of a voxel. The volumes also accept primitive types as voxels,
+	//and these have no getDensity() function so the value itself is used instead.
+	template <typename VoxelType, bool IsPrimitive = polyvox_is_arithmetic<VoxelType>::value>
+	class VoxelDensity
+	{
+	public:
+		typedef typename VoxelType::DensityType DensityType;
+
+		static DensityType get(const VoxelType& tVoxel) { return tVoxel.getDensity(); }
+	};
+
+	template <typename VoxelType>
+	class VoxelDensity<VoxelType, true>
+	{
+	public:
+		typedef VoxelType DensityType;
+
+		static DensityType get(const VoxelType& tVoxel) { return tVoxel; }
+	};
+
+	//Keeps track of the smallest and largest density in a block of voxels as the block is written to. The number
+	//of voxels at each extreme is counted too, so that overwriting one of them only requires the block to be scanned
+	//again if it was the last one. A range which has been invalidated is recalculated by the next write.
+	template <typename VoxelType>
+	class DensityRange
+	{
+	public:
+		typedef typename VoxelDensity<VoxelType>::DensityType DensityType;
+
+		DensityRange();
+
+		DensityType getMin(void) const;
+		DensityType getMax(void) const;
+		bool isValid(void) const;
+
+		void calculate(const VoxelType* pData, uint32_t uNoOfVoxels);
+		void fill(const VoxelType& tValue, uint32_t uNoOfVoxels);
+		void invalidate(void);
+		void voxelChanged(const VoxelType& tOldValue, const VoxelType& tNewValue, const VoxelType* pData, uint32_t uNoOfVoxels);
+
+	private:
+		DensityType m_tMin;
+		DensityType m_tMax;
+		uint32_t m_uNoOfVoxelsAtMin;
+		uint32_t m_uNoOfVoxelsAtMax;
+		bool m_bValid;
+	};
+}
+
+#include "PolyVoxImpl/DensityRange.inl"
+
+#endif
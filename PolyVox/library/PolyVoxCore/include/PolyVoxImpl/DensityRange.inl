@@ -0,0 +1,160 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+namespace PolyVox
+{
+	template <typename VoxelType>
+	DensityRange<VoxelType>::DensityRange()
+		:m_tMin()
+		,m_tMax()
+		,m_uNoOfVoxelsAtMin(0)
+		,m_uNoOfVoxelsAtMax(0)
+		,m_bValid(false)
+	{
+	}
+
+	template <typename VoxelType>
+	typename DensityRange<VoxelType>::DensityType DensityRange<VoxelType>::getMin(void) const
+	{
+		assert(m_bValid);
+		return m_tMin;
+	}
+
+	template <typename VoxelType>
+	typename DensityRange<VoxelType>::DensityType DensityRange<VoxelType>::getMax(void) const
+	{
+		assert(m_bValid);
+		return m_tMax;
+	}
+
+	template <typename VoxelType>
+	bool DensityRange<VoxelType>::isValid(void) const
+	{
+		return m_bValid;
+	}
+
+	template <typename VoxelType>
+	void DensityRange<VoxelType>::calculate(const VoxelType* pData, uint32_t uNoOfVoxels)
+	{
+		assert(uNoOfVoxels > 0);
+
+		m_tMin = VoxelDensity<VoxelType>::get(pData[0]);
+		m_tMax = m_tMin;
+		m_uNoOfVoxelsAtMin = 0;
+		m_uNoOfVoxelsAtMax = 0;
+
+		for(uint32_t ct = 0; ct < uNoOfVoxels; ct++)
+		{
+			const DensityType tDensity = VoxelDensity<VoxelType>::get(pData[ct]);
+			if(tDensity < m_tMin)
+			{
+				m_tMin = tDensity;
+				m_uNoOfVoxelsAtMin = 0;
+			}
+			if(tDensity > m_tMax)
+			{
+				m_tMax = tDensity;
+				m_uNoOfVoxelsAtMax = 0;
+			}
+			if(tDensity == m_tMin)
+			{
+				++m_uNoOfVoxelsAtMin;
+			}
+			if(tDensity == m_tMax)
+			{
+				++m_uNoOfVoxelsAtMax;
+			}
+		}
+
+		m_bValid = true;
+	}
+
+	template <typename VoxelType>
+	void DensityRange<VoxelType>::fill(const VoxelType& tValue, uint32_t uNoOfVoxels)
+	{
+		m_tMin = VoxelDensity<VoxelType>::get(tValue);
+		m_tMax = m_tMin;
+		m_uNoOfVoxelsAtMin = uNoOfVoxels;
+		m_uNoOfVoxelsAtMax = uNoOfVoxels;
+		m_bValid = true;
+	}
+
+	template <typename VoxelType>
+	void DensityRange<VoxelType>::invalidate(void)
+	{
+		m_bValid = false;
+	}
+
+	template <typename VoxelType>
+	void DensityRange<VoxelType>::voxelChanged(const VoxelType& tOldValue, const VoxelType& tNewValue, const VoxelType* pData, uint32_t uNoOfVoxels)
+	{
+		//The block data has already been modified, so can be scanned directly.
+		if(!m_bValid)
+		{
+			calculate(pData, uNoOfVoxels);
+			return;
+		}
+
+		const DensityType tOldDensity = VoxelDensity<VoxelType>::get(tOldValue);
+		const DensityType tNewDensity = VoxelDensity<VoxelType>::get(tNewValue);
+		if(tOldDensity == tNewDensity)
+		{
+			return;
+		}
+
+		if(tOldDensity == m_tMin)
+		{
+			--m_uNoOfVoxelsAtMin;
+		}
+		if(tOldDensity == m_tMax)
+		{
+			--m_uNoOfVoxelsAtMax;
+		}
+
+		if(tNewDensity < m_tMin)
+		{
+			m_tMin = tNewDensity;
+			m_uNoOfVoxelsAtMin = 1;
+		}
+		else if(tNewDensity == m_tMin)
+		{
+			++m_uNoOfVoxelsAtMin;
+		}
+		if(tNewDensity > m_tMax)
+		{
+			m_tMax = tNewDensity;
+			m_uNoOfVoxelsAtMax = 1;
+		}
+		else if(tNewDensity == m_tMax)
+		{
+			++m_uNoOfVoxelsAtMax;
+		}
+
+		//If the last voxel at either end of the range was overwritten then we can't
+		//tell where the range now ends without looking at the rest of the block.
+		if((m_uNoOfVoxelsAtMin == 0) || (m_uNoOfVoxelsAtMax == 0))
+		{
+			calculate(pData, uNoOfVoxels);
+		}
+	}
+}
@@ -0,0 +1,99 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#ifndef __PolyVox_RegionExtractionImpl_H__
+#define __PolyVox_RegionExtractionImpl_H__
+
+#include "PolyVoxImpl/TypeDef.h"
+
+namespace PolyVox
+{
+	//Shared between the workers used by extractRegions(). It hands out the regions one at a time (so that a worker
+	//which gets quick regions simply takes more of them), serialises the calls to the progress callback, and records
+	//the first exception thrown by a worker so that it can be rethrown on the calling thread.
+	class RegionExtractionQueue
+	{
+	public:
+		RegionExtractionQueue(uint32_t uNoOfRegions)
+			:m_uNoOfRegions(uNoOfRegions)
+			,m_uNextRegion(0)
+			,m_uNoOfRegionsCompleted(0)
+			,m_bFailed(false)
+		{
+		}
+
+		//Gets the index of the next region to extract, or returns false if there are none left.
+		bool getNextRegion(uint32_t& uRegionIndex)
+		{
+			polyvox_lock_guard<polyvox_mutex> lock(m_mutex);
+			if(m_bFailed || (m_uNextRegion == m_uNoOfRegions))
+			{
+				return false;
+			}
+			uRegionIndex = m_uNextRegion;
+			m_uNextRegion++;
+			return true;
+		}
+
+		//Records that a region is finished and reports it through the callback (if there is one).
+		void regionCompleted(uint32_t uRegionIndex, const polyvox_function<void (uint32_t, uint32_t)>& funcProgressCallback)
+		{
+			polyvox_lock_guard<polyvox_mutex> lock(m_mutex);
+			m_uNoOfRegionsCompleted++;
+			if(funcProgressCallback)
+			{
+				funcProgressCallback(uRegionIndex, m_uNoOfRegionsCompleted);
+			}
+		}
+
+		//Stops any more regions from being handed out. Only the first exception is kept.
+		void setFailed(polyvox_exception_ptr exception)
+		{
+			polyvox_lock_guard<polyvox_mutex> lock(m_mutex);
+			if(!m_bFailed)
+			{
+				m_bFailed = true;
+				m_exception = exception;
+			}
+		}
+
+		//Rethrows the exception which stopped the extraction, if any. Only call this once all the workers have finished.
+		void rethrowIfFailed(void)
+		{
+			if(m_bFailed)
+			{
+				polyvox_rethrow_exception(m_exception);
+			}
+		}
+
+	private:
+		uint32_t m_uNoOfRegions;
+		uint32_t m_uNextRegion;
+		uint32_t m_uNoOfRegionsCompleted;
+		bool m_bFailed;
+		polyvox_exception_ptr m_exception;
+		polyvox_mutex m_mutex;
+	};
+}
+
+#endif //__PolyVox_RegionExtractionImpl_H__
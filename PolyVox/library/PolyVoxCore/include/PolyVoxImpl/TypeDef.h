@@ -77,6 +77,18 @@ freely, subject to the following restrictions:
 	#define polyvox_placeholder_1 _1
 	#define polyvox_placeholder_2 _2
 
+	#include <boost/thread.hpp>
+	#define polyvox_thread boost::thread
+	#define polyvox_mutex boost::mutex
+	#define polyvox_lock_guard boost::lock_guard
+
+	#include <boost/exception_ptr.hpp>
+	#define polyvox_exception_ptr boost::exception_ptr
+	#define polyvox_current_exception boost::current_exception
+	#define polyvox_rethrow_exception boost::rethrow_exception
+
+	#include <boost/type_traits/is_arithmetic.hpp>
+	#define polyvox_is_arithmetic boost::is_arithmetic
 
 	//As long as we're requiring boost, we'll use it to compensate
 	//for the missing cstdint header too.
@@ -87,17 +99,30 @@ freely, subject to the following restrictions:
 	using boost::uint8_t;
 	using boost::uint16_t;
 	using boost::uint32_t;
+	using boost::int64_t;
+	using boost::uint64_t;
 #else
 	//We have a decent compiler - use real C++0x features
 	#include <cstdint>
+	#include <exception>
 	#include <functional>
 	#include <memory>
+	#include <mutex>
+	#include <thread>
+	#include <type_traits>
 	#define polyvox_shared_ptr std::shared_ptr
 	#define polyvox_function std::function
 	#define polyvox_bind std::bind
 	#define polyvox_placeholder_1 std::placeholders::_1
 	#define polyvox_placeholder_2 std::placeholders::_2
 	#define polyvox_hash std::hash
+	#define polyvox_thread std::thread
+	#define polyvox_mutex std::mutex
+	#define polyvox_lock_guard std::lock_guard
+	#define polyvox_exception_ptr std::exception_ptr
+	#define polyvox_current_exception std::current_exception
+	#define polyvox_rethrow_exception std::rethrow_exception
+	#define polyvox_is_arithmetic std::is_arithmetic
 #endif
 
 #endif
@@ -28,11 +28,38 @@ freely, subject to the following restrictions:
 
 #include <cassert>
 
+#if defined(_MSC_VER) && defined(_WIN64)
+	#include <intrin.h>
+#endif
+
 namespace PolyVox
 {
 	POLYVOX_API uint8_t logBase2(uint32_t uInput);
 	POLYVOX_API bool isPowerOf2(uint32_t uInput);
 
+	//Note: this function only works for inputs which are not zero.
+	//It is inline as it is used in the inner loops of the cubic surface extractor.
+	inline uint32_t countTrailingZeros(uint64_t uInput)
+	{
+		assert(uInput != 0);
+
+#if defined(__GNUC__)
+		return static_cast<uint32_t>(__builtin_ctzll(uInput));
+#elif defined(_MSC_VER) && defined(_WIN64)
+		unsigned long uResult;
+		_BitScanForward64(&uResult, uInput);
+		return static_cast<uint32_t>(uResult);
+#else
+		uint32_t uResult = 0;
+		while((uInput & 1) == 0)
+		{
+			uInput >>= 1;
+			++uResult;
+		}
+		return uResult;
+#endif
+	}
+
 	template <typename Type>
         Type trilinearlyInterpolate(
         const Type& v000,const Type& v100,const Type& v010,const Type& v110,
@@ -0,0 +1,58 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#include "PolyVoxCore/MeshOptimiser.h"
+
+namespace PolyVox
+{
+	float computeAverageCacheMissRatio(const std::vector<uint32_t>& vecIndices, uint32_t uBeginIndex, uint32_t uEndIndex, uint32_t uCacheSize)
+	{
+		const uint32_t uNoOfTriangles = (uEndIndex - uBeginIndex) / 3;
+		if(uNoOfTriangles == 0)
+		{
+			return 0.0f;
+		}
+
+		uint32_t uNoOfVertices = 0;
+		for(uint32_t ct = uBeginIndex; ct < uEndIndex; ct++)
+		{
+			uNoOfVertices = (std::max)(uNoOfVertices, vecIndices[ct] + 1);
+		}
+
+		//Rather than keeping the queue itself, each vertex records how many misses there had been when it
+		//went in. It is still in the cache as long as there have been fewer than uCacheSize misses since.
+		std::vector<uint32_t> vecInsertionTimes(uNoOfVertices, 0);
+		uint32_t uNoOfMisses = 0;
+		for(uint32_t ct = uBeginIndex; ct < uBeginIndex + uNoOfTriangles * 3; ct++)
+		{
+			uint32_t& uInsertionTime = vecInsertionTimes[vecIndices[ct]];
+			if((uInsertionTime == 0) || (uNoOfMisses - uInsertionTime >= uCacheSize))
+			{
+				uNoOfMisses++;
+				uInsertionTime = uNoOfMisses;
+			}
+		}
+
+		return static_cast<float>(uNoOfMisses) / static_cast<float>(uNoOfTriangles);
+	}
+}
@@ -0,0 +1,104 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#include "PolyVoxImpl/CubeIndices.h"
+
+//SSE2 is always available on x64, and on x86 when the compiler has been told to use it.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define POLYVOX_CUBE_INDICES_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace PolyVox
+{
+	//Bit layout of the cube index is v000 = 1, v100 = 2, v010 = 4, v110 = 8, v001 = 16, v101 = 32, v011 = 64, v111 = 128.
+	//The voxels at a given x contribute the even bits and those at x+1 contribute the odd bits, so we first pack the four
+	//rows into one 'column' byte per x and then combine each column with the next one shifted up by a single bit.
+	uint32_t computeCubeIndicesForRow(const uint8_t* pRow00, const uint8_t* pRow10, const uint8_t* pRow01, const uint8_t* pRow11, uint8_t* pCubeIndices, uint32_t uNoOfCells)
+	{
+		uint32_t uNoOfOccupiedCells = 0;
+		uint32_t uX = 0;
+
+#ifdef POLYVOX_CUBE_INDICES_SSE2
+		//Process sixteen cells at a time. SSE2 has no byte shifts, but as the inputs are all zero or one
+		//(and the partial results never overflow a byte) we can shift left by adding a value to itself.
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i full = _mm_set1_epi8(static_cast<char>(0xff));
+		for(; uX + 16 <= uNoOfCells; uX += 16)
+		{
+			__m128i v00 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow00 + uX));
+			__m128i v10 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow10 + uX));
+			__m128i v01 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow01 + uX));
+			__m128i v11 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow11 + uX));
+
+			//column = v00 | v10 << 2 | v01 << 4 | v11 << 6
+			__m128i column = _mm_add_epi8(v11, v11);
+			column = _mm_or_si128(v01, _mm_add_epi8(column, column));
+			column = _mm_add_epi8(column, column);
+			column = _mm_or_si128(v10, _mm_add_epi8(column, column));
+			column = _mm_add_epi8(column, column);
+			column = _mm_or_si128(v00, _mm_add_epi8(column, column));
+
+			v00 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow00 + uX + 1));
+			v10 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow10 + uX + 1));
+			v01 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow01 + uX + 1));
+			v11 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow11 + uX + 1));
+
+			__m128i nextColumn = _mm_add_epi8(v11, v11);
+			nextColumn = _mm_or_si128(v01, _mm_add_epi8(nextColumn, nextColumn));
+			nextColumn = _mm_add_epi8(nextColumn, nextColumn);
+			nextColumn = _mm_or_si128(v10, _mm_add_epi8(nextColumn, nextColumn));
+			nextColumn = _mm_add_epi8(nextColumn, nextColumn);
+			nextColumn = _mm_or_si128(v00, _mm_add_epi8(nextColumn, nextColumn));
+
+			const __m128i cubeIndices = _mm_or_si128(column, _mm_add_epi8(nextColumn, nextColumn));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pCubeIndices + uX), cubeIndices);
+
+			//Only the empty (0) and full (255) cells have no entry in the edge table.
+			const __m128i unoccupied = _mm_or_si128(_mm_cmpeq_epi8(cubeIndices, zero), _mm_cmpeq_epi8(cubeIndices, full));
+			uint32_t uOccupiedMask = (~static_cast<uint32_t>(_mm_movemask_epi8(unoccupied))) & 0xffff;
+			while(uOccupiedMask != 0)
+			{
+				uOccupiedMask &= uOccupiedMask - 1;
+				++uNoOfOccupiedCells;
+			}
+		}
+#endif
+
+		//Scalar fallback, and the cells left over by the SIMD path.
+		for(; uX < uNoOfCells; uX++)
+		{
+			const uint8_t uColumn = static_cast<uint8_t>(pRow00[uX] | (pRow10[uX] << 2) | (pRow01[uX] << 4) | (pRow11[uX] << 6));
+			const uint8_t uNextColumn = static_cast<uint8_t>(pRow00[uX+1] | (pRow10[uX+1] << 2) | (pRow01[uX+1] << 4) | (pRow11[uX+1] << 6));
+			const uint8_t uCubeIndex = static_cast<uint8_t>(uColumn | (uNextColumn << 1));
+			pCubeIndices[uX] = uCubeIndex;
+
+			if((uCubeIndex != 0) && (uCubeIndex != 255))
+			{
+				++uNoOfOccupiedCells;
+			}
+		}
+
+		return uNoOfOccupiedCells;
+	}
+}
@@ -36,4 +36,14 @@ namespace PolyVox
 		SurfaceExtractor<SimpleVolume, MaterialDensityPair88 > surfaceExtractor(&volume, region, &resultMesh);
 		surfaceExtractor.execute();
 	}
+
+	void extractCubicMeshes(Volume& volume, const std::vector<Region>& regions, std::vector<Mesh>& resultMeshes, const ExtractionPolicy& policy)
+	{
+		extractRegions<CubicSurfaceExtractorWithNormals>(&volume, regions, resultMeshes, policy);
+	}
+
+	void extractSmoothMeshes(Volume& volume, const std::vector<Region>& regions, std::vector<Mesh>& resultMeshes, const ExtractionPolicy& policy)
+	{
+		extractRegions<SurfaceExtractor>(&volume, regions, resultMeshes, policy);
+	}
 }
@@ -0,0 +1,165 @@
+/*******************************************************************************
+Copyright (c) 2005-2009 David Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution. 	
+*******************************************************************************/
+
+#include "PolyVoxCore/SurfaceMesh.h"
+
+namespace PolyVox
+{
+	uint32_t getVisibleFacingDirections(const Region& region, const Vector3DFloat& v3dViewPosition)
+	{
+		//The faces lie half a voxel either side of the centres of the voxels in the region.
+		const float fLower[3] =
+		{
+			region.getLowerCorner().getX() - 0.5f,
+			region.getLowerCorner().getY() - 0.5f,
+			region.getLowerCorner().getZ() - 0.5f
+		};
+		const float fUpper[3] =
+		{
+			region.getUpperCorner().getX() + 0.5f,
+			region.getUpperCorner().getY() + 0.5f,
+			region.getUpperCorner().getZ() + 0.5f
+		};
+		const float fPosition[3] = {v3dViewPosition.getX(), v3dViewPosition.getY(), v3dViewPosition.getZ()};
+
+		//Faces which are edge on to the position can't be seen either.
+		uint32_t uDirections = 0;
+		for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
+		{
+			if(fPosition[uAxis] > fLower[uAxis])
+			{
+				uDirections |= 1 << (FacingPositiveX + uAxis);
+			}
+			if(fPosition[uAxis] < fUpper[uAxis])
+			{
+				uDirections |= 1 << (FacingNegativeX + uAxis);
+			}
+		}
+		return uDirections;
+	}
+
+	void getFacingIndexRanges(const std::vector<LodRecord>& vecFacingRecords, const std::vector<LodRecord>& vecLodRecords, uint32_t uDirections, std::vector<LodRecord>& vecRanges)
+	{
+		vecRanges.clear();
+
+		if(vecFacingRecords.size() != NoOfFacingDirections)
+		{
+			if((vecLodRecords.empty() == false) && (vecLodRecords[0].endIndex > vecLodRecords[0].beginIndex))
+			{
+				vecRanges.push_back(vecLodRecords[0]);
+			}
+			return;
+		}
+
+		for(uint32_t uDirection = 0; uDirection < NoOfFacingDirections; uDirection++)
+		{
+			const LodRecord& record = vecFacingRecords[uDirection];
+			if(((uDirections & (1 << uDirection)) == 0) || (record.endIndex == record.beginIndex))
+			{
+				continue;
+			}
+
+			if((vecRanges.empty() == false) && (vecRanges.back().endIndex == record.beginIndex))
+			{
+				vecRanges.back().endIndex = record.endIndex;
+			}
+			else
+			{
+				vecRanges.push_back(record);
+			}
+		}
+	}
+
+	uint32_t selectLodLevel(const Region& region, const Vector3DFloat& v3dViewPosition, uint32_t uNoOfLodLevels, float fLodDistance)
+	{
+		if((uNoOfLodLevels <= 1) || (fLodDistance <= 0.0f))
+		{
+			return 0;
+		}
+
+		//The distance from the position to the nearest point of the region (zero when inside it).
+		const float fLower[3] =
+		{
+			region.getLowerCorner().getX() - 0.5f,
+			region.getLowerCorner().getY() - 0.5f,
+			region.getLowerCorner().getZ() - 0.5f
+		};
+		const float fUpper[3] =
+		{
+			region.getUpperCorner().getX() + 0.5f,
+			region.getUpperCorner().getY() + 0.5f,
+			region.getUpperCorner().getZ() + 0.5f
+		};
+		const float fPosition[3] = {v3dViewPosition.getX(), v3dViewPosition.getY(), v3dViewPosition.getZ()};
+
+		float fDistanceSquared = 0.0f;
+		for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
+		{
+			float fOutside = (std::max)(fLower[uAxis] - fPosition[uAxis], fPosition[uAxis] - fUpper[uAxis]);
+			if(fOutside > 0.0f)
+			{
+				fDistanceSquared += fOutside * fOutside;
+			}
+		}
+
+		uint32_t uLodLevel = 0;
+		float fThreshold = fLodDistance;
+		while((uLodLevel + 1 < uNoOfLodLevels) && (fDistanceSquared >= fThreshold * fThreshold))
+		{
+			uLodLevel++;
+			fThreshold *= 2.0f;
+		}
+		return uLodLevel;
+	}
+
+	void getLodIndexRanges(const std::vector<LodRecord>& vecFacingRecords, const std::vector<LodRecord>& vecLodRecords, uint32_t uLodLevel, uint32_t uDirections, std::vector<LodRecord>& vecRanges)
+	{
+		if((uLodLevel == 0) || (vecLodRecords.size() <= 1))
+		{
+			getFacingIndexRanges(vecFacingRecords, vecLodRecords, uDirections, vecRanges);
+			return;
+		}
+
+		vecRanges.clear();
+
+		const LodRecord& record = vecLodRecords[(std::min)(uLodLevel, static_cast<uint32_t>(vecLodRecords.size() - 1))];
+		if(record.endIndex > record.beginIndex)
+		{
+			vecRanges.push_back(record);
+		}
+	}
+
+	bool canUse16BitIndices(uint32_t uNoOfVertices)
+	{
+		return uNoOfVertices <= 0xFFFF;
+	}
+
+	void packIndicesTo16Bit(const std::vector<uint32_t>& vecIndices, uint16_t* pPackedIndices)
+	{
+		const uint32_t uNoOfIndices = vecIndices.size();
+		for(uint32_t ct = 0; ct < uNoOfIndices; ct++)
+		{
+			pPackedIndices[ct] = static_cast<uint16_t>(vecIndices[ct]);
+		}
+	}
+}
@@ -107,4 +107,56 @@ namespace PolyVox
 	{
 		position = positionToSet;
 	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// PositionMaterialAO
+	////////////////////////////////////////////////////////////////////////////////
+
+	PositionMaterialAO::PositionMaterialAO()
+	{
+	}
+
+	PositionMaterialAO::PositionMaterialAO(Vector3DFloat positionToSet, float materialToSet)
+		:position(positionToSet)
+		,material(materialToSet)
+		,ambientOcclusion(3)
+	{
+	}
+
+	PositionMaterialAO::PositionMaterialAO(Vector3DFloat positionToSet, float materialToSet, uint8_t ambientOcclusionToSet)
+		:position(positionToSet)
+		,material(materialToSet)
+		,ambientOcclusion(ambientOcclusionToSet)
+	{
+	}
+
+	uint8_t PositionMaterialAO::getAmbientOcclusion(void) const
+	{
+		return ambientOcclusion;
+	}
+
+	float PositionMaterialAO::getMaterial(void) const
+	{
+		return material;
+	}
+
+	const Vector3DFloat& PositionMaterialAO::getPosition(void) const
+	{
+		return position;
+	}
+
+	void PositionMaterialAO::setAmbientOcclusion(uint8_t ambientOcclusionToSet)
+	{
+		ambientOcclusion = ambientOcclusionToSet;
+	}
+
+	void PositionMaterialAO::setMaterial(float materialToSet)
+	{
+		material = materialToSet;
+	}
+
+	void PositionMaterialAO::setPosition(const Vector3DFloat& positionToSet)
+	{
+		position = positionToSet;
+	}
 }
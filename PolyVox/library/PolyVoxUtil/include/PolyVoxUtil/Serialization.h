@@ -28,7 +28,9 @@ freely, subject to the following restrictions:
 
 #include "PolyVoxCore/Region.h"
 #include "PolyVoxCore/LargeVolume.h"
+#include "PolyVoxCore/SpanIterator.h"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 
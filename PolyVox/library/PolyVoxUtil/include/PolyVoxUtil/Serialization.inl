@@ -303,6 +303,7 @@ namespace PolyVox
 	}
 
 	//Note: we don't do much error handling in here - exceptions will simply be propergated up to the caller.
+	//A stream which ends early or holds an empty run is rejected by returning false, leaving the volume partly loaded.
 	//FIXME - think about pointer ownership issues. Or could return volume by value if the copy constructor is shallow
 	template< template<typename> class VolumeType, typename VoxelType>
 	bool loadVersion0(std::istream& stream, VolumeType<VoxelType>& volume, VolumeSerializationProgressListener* progressListener)
@@ -314,17 +315,18 @@ namespace PolyVox
 		stream.read(reinterpret_cast<char*>(&volumeWidth), sizeof(volumeWidth));
 		stream.read(reinterpret_cast<char*>(&volumeHeight), sizeof(volumeHeight));
 		stream.read(reinterpret_cast<char*>(&volumeDepth), sizeof(volumeDepth));
+		if(stream.fail())
+		{
+			return false;
+		}
 
 		//Resize the volume
 		//HACK - Forces block size to 32. This functions needs reworking anyway due to large volume support.
 		volume.resize(Region(Vector3DInt32(0,0,0), Vector3DInt32(volumeWidth, volumeHeight, volumeDepth)), 32);
 
-		//Read data
-		bool firstTime = true;
+		//Read data. Runs are read as they are needed, so that one can cover several spans.
 		uint32_t runLength = 0;
 		VoxelType value;
-		stream.read(reinterpret_cast<char*>(&value), sizeof(value));
-		stream.read(reinterpret_cast<char*>(&runLength), sizeof(runLength));
 		for(uint16_t z = 0; z < volumeDepth; ++z)
 		{
 			//Update progress once per slice.
@@ -334,27 +336,38 @@ namespace PolyVox
 				progressListener->onProgressUpdated(fProgress);
 			}
 
-			for(uint16_t y = 0; y < volumeHeight; ++y)
+			Region regSlice(Vector3DInt32(0, 0, z), Vector3DInt32(volumeWidth - 1, volumeHeight - 1, z));
+			for(SpanIterator<VolumeType, VoxelType> volIter(&volume, regSlice); volIter.isValid(); volIter.moveForward())
 			{
-				for(uint16_t x = 0; x < volumeWidth; ++x)
-				{	
-					if(runLength != 0)
-					{
-						volume.setVoxelAt(x,y,z,value);
-						runLength--;
-					}
-					else
+				VoxelType* pVoxels = volIter.getSpan();
+				const int32_t iLength = volIter.getLength();
+				int32_t i = 0;
+				while(i < iLength)
+				{
+					if(runLength == 0)
 					{
 						stream.read(reinterpret_cast<char*>(&value), sizeof(value));
 						stream.read(reinterpret_cast<char*>(&runLength), sizeof(runLength));
 
-						volume.setVoxelAt(x,y,z,value);
-						runLength--;
+						//Without this check a truncated stream or a stored zero length would never fill the span.
+						if(stream.fail() || (runLength == 0))
+						{
+							return false;
+						}
 					}
+
+					//Fill as much of the span as the current run covers.
+					const uint32_t uCount = (std::min)(static_cast<uint32_t>(iLength - i), runLength);
+					std::fill(pVoxels + i, pVoxels + i + uCount, value);
+					i += uCount;
+					runLength -= uCount;
 				}
-			}			
+			}
 		}
 
+		//The voxels were written through spans, which the volume can't keep track of.
+		volume.recalculateDensityRanges();
+
 		//Finished
 		if(progressListener)
 		{
@@ -377,7 +390,6 @@ namespace PolyVox
 		stream.write(reinterpret_cast<char*>(&volumeDepth), sizeof(volumeDepth));
 
 		//Write data
-		typename VolumeType<VoxelType>::Sampler volIter(&volume);
 		VoxelType current;
 		uint32_t runLength = 0;
 		bool firstTime = true;
@@ -390,12 +402,14 @@ namespace PolyVox
 				progressListener->onProgressUpdated(fProgress);
 			}
 
-			for(uint16_t y = 0; y < volumeHeight; ++y)
+			Region regSlice(Vector3DInt32(0, 0, z), Vector3DInt32(volumeWidth - 1, volumeHeight - 1, z));
+			for(ConstSpanIterator<VolumeType, VoxelType> volIter(&volume, regSlice); volIter.isValid(); volIter.moveForward())
 			{
-				for(uint16_t x = 0; x < volumeWidth; ++x)
-				{		
-					volIter.setPosition(x,y,z);
-					VoxelType value = volIter.getVoxel();
+				const VoxelType* pVoxels = volIter.getSpan();
+				const int32_t iLength = volIter.getLength();
+				for(int32_t i = 0; i < iLength; i++)
+				{
+					VoxelType value = pVoxels[i];
 					if(firstTime)
 					{
 						current = value;
@@ -415,7 +429,7 @@ namespace PolyVox
 							current = value;
 							runLength = 1;
 						}
-					}					
+					}
 				}
 			}
 		}
@@ -0,0 +1,66 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#ifndef __PolyVox_TerrainGenerator_H__
+#define __PolyVox_TerrainGenerator_H__
+
+#include "PolyVoxCore/Material.h"
+#include "PolyVoxCore/SimpleVolume.h"
+
+#include <cmath>
+
+//Rolling hills with grass on top, dirt below that and rock underneath, plus some scattered voxels of other materials.
+//The terrain fills the whole volume, which should have its lower corner at the origin. The scattered voxels are placed
+//by a fixed pseudo-random sequence, so the terrain is the same on every run.
+inline void createHeightmapTerrainInVolume(PolyVox::SimpleVolume<PolyVox::Material16>& volData, uint32_t uNoOfScatteredVoxels)
+{
+	const int32_t iWidth = volData.getWidth();
+	const int32_t iHeight = volData.getHeight();
+	const int32_t iDepth = volData.getDepth();
+
+	for(int32_t z = 0; z < iDepth; z++)
+	{
+		for(int32_t x = 0; x < iWidth; x++)
+		{
+			int32_t iGroundHeight = 24 + static_cast<int32_t>(10.0f * std::sin(x * 0.07f) + 8.0f * std::cos(z * 0.05f) + 3.0f * std::sin((x + z) * 0.3f));
+			for(int32_t y = 0; y <= iGroundHeight; y++)
+			{
+				volData.setVoxelAt(x, y, z, PolyVox::Material16((y == iGroundHeight) ? 3 : ((y > iGroundHeight - 4) ? 2 : 1)));
+			}
+		}
+	}
+
+	uint32_t uSeed = 12345;
+	for(uint32_t ct = 0; ct < uNoOfScatteredVoxels; ct++)
+	{
+		uSeed = uSeed * 1103515245 + 12345;
+		int32_t x = (uSeed >> 8) % iWidth;
+		uSeed = uSeed * 1103515245 + 12345;
+		int32_t y = (uSeed >> 8) % iHeight;
+		uSeed = uSeed * 1103515245 + 12345;
+		int32_t z = (uSeed >> 8) % iDepth;
+		volData.setVoxelAt(x, y, z, PolyVox::Material16((uSeed >> 4) % 5));
+	}
+}
+
+#endif
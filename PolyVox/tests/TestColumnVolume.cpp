@@ -0,0 +1,172 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#include "TestColumnVolume.h"
+
+#include "PolyVoxCore/ColumnVolume.h"
+#include "PolyVoxCore/CubicSurfaceExtractor.h"
+#include "PolyVoxCore/MaterialDensityPair.h"
+#include "PolyVoxCore/RawVolume.h"
+#include "PolyVoxCore/SimpleVolume.h"
+#include "PolyVoxCore/SurfaceExtractor.h"
+
+#include <QtTest>
+
+using namespace PolyVox;
+
+const int32_t g_uTerrainSideLength = 128;
+//Heightmap2Volume creates volumes of this height.
+const int32_t g_uTerrainHeight = 256;
+
+//A simple rolling terrain, with a thin layer of a different material at the surface.
+template <typename VolumeType>
+void createTerrainInVolume(VolumeType& volData)
+{
+	for (int32_t z = 1; z < g_uTerrainSideLength - 1; z++)
+	{
+		for (int32_t x = 1; x < g_uTerrainSideLength - 1; x++)
+		{
+			int32_t iHeight = static_cast<int32_t>(g_uTerrainHeight / 4 + 20.0f * sin(x * 0.1f) * cos(z * 0.07f));
+			for (int32_t y = 1; y <= iHeight; y++)
+			{
+				uint8_t uMaterial = (y > iHeight - 3) ? 2 : 1;
+				volData.setVoxelAt(x, y, z, MaterialDensityPair44(uMaterial, 15));
+			}
+		}
+	}
+}
+
+void TestColumnVolume::testReadWrite()
+{
+	Region reg(Vector3DInt32(3,2,5), Vector3DInt32(26,40,30));
+	ColumnVolume<uint8_t> columnVolume(reg);
+	RawVolume<uint8_t> rawVolume(reg);
+
+	//The RawVolume doesn't initialise its voxels, whereas unwritten voxels of the ColumnVolume read as zero.
+	for(int32_t z = reg.getLowerCorner().getZ(); z <= reg.getUpperCorner().getZ(); z++)
+	{
+		for(int32_t y = reg.getLowerCorner().getY(); y <= reg.getUpperCorner().getY(); y++)
+		{
+			for(int32_t x = reg.getLowerCorner().getX(); x <= reg.getUpperCorner().getX(); x++)
+			{
+				rawVolume.setVoxelAt(x, y, z, uint8_t());
+			}
+		}
+	}
+
+	//Mix single voxel writes with spans, some of which extend outside the volume.
+	uint32_t uSeed = 12345;
+	for(int ct = 0; ct < 20000; ct++)
+	{
+		uSeed = uSeed * 1103515245 + 12345;
+		int32_t x = reg.getLowerCorner().getX() + (uSeed >> 8) % (reg.getUpperCorner().getX() - reg.getLowerCorner().getX() + 1);
+		uSeed = uSeed * 1103515245 + 12345;
+		int32_t z = reg.getLowerCorner().getZ() + (uSeed >> 8) % (reg.getUpperCorner().getZ() - reg.getLowerCorner().getZ() + 1);
+		uSeed = uSeed * 1103515245 + 12345;
+		int32_t y0 = static_cast<int32_t>((uSeed >> 8) % 50) - 3;
+		uSeed = uSeed * 1103515245 + 12345;
+		int32_t y1 = y0 + static_cast<int32_t>((uSeed >> 8) % 12);
+		uint8_t uValue = static_cast<uint8_t>((uSeed >> 20) % 4);
+
+		if(ct % 3 == 0)
+		{
+			columnVolume.setVoxelAt(x, y0, z, uValue);
+			rawVolume.setVoxelAt(x, y0, z, uValue);
+		}
+		else
+		{
+			columnVolume.setColumnSpan(x, z, y0, y1, uValue);
+			for(int32_t y = (std::max)(y0, reg.getLowerCorner().getY()); y <= (std::min)(y1, reg.getUpperCorner().getY()); y++)
+			{
+				rawVolume.setVoxelAt(x, y, z, uValue);
+			}
+		}
+
+		if(ct == 10000)
+		{
+			columnVolume.tidy();
+		}
+	}
+
+	bool bAllMatch = true;
+	ColumnVolume<uint8_t>::Sampler sampler(&columnVolume);
+	for(int32_t z = reg.getLowerCorner().getZ(); z <= reg.getUpperCorner().getZ(); z++)
+	{
+		for(int32_t x = reg.getLowerCorner().getX(); x <= reg.getUpperCorner().getX(); x++)
+		{
+			sampler.setPosition(x, reg.getLowerCorner().getY(), z);
+			for(int32_t y = reg.getLowerCorner().getY(); y <= reg.getUpperCorner().getY(); y++)
+			{
+				bAllMatch &= (columnVolume.getVoxelAt(x, y, z) == rawVolume.getVoxelAt(x, y, z));
+				bAllMatch &= (sampler.getVoxel() == rawVolume.getVoxelAt(x, y, z));
+				sampler.movePositiveY();
+			}
+		}
+	}
+	QVERIFY(bAllMatch);
+}
+
+void TestColumnVolume::testExtractSurface()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(g_uTerrainSideLength-1, g_uTerrainHeight-1, g_uTerrainSideLength-1));
+
+	SimpleVolume<MaterialDensityPair44> simpleVolume(reg, 32);
+	createTerrainInVolume(simpleVolume);
+	ColumnVolume<MaterialDensityPair44> columnVolume(reg);
+	createTerrainInVolume(columnVolume);
+
+	SurfaceMesh<PositionMaterialNormal> simpleSmoothMesh, columnSmoothMesh;
+	SurfaceExtractor<SimpleVolume, MaterialDensityPair44> simpleSurfaceExtractor(&simpleVolume, reg, &simpleSmoothMesh);
+	simpleSurfaceExtractor.execute();
+	SurfaceExtractor<ColumnVolume, MaterialDensityPair44> columnSurfaceExtractor(&columnVolume, reg, &columnSmoothMesh);
+	columnSurfaceExtractor.execute();
+
+	SurfaceMesh<PositionMaterial> simpleCubicMesh, columnCubicMesh;
+	CubicSurfaceExtractor<SimpleVolume, MaterialDensityPair44> simpleCubicSurfaceExtractor(&simpleVolume, reg, &simpleCubicMesh);
+	simpleCubicSurfaceExtractor.execute();
+	CubicSurfaceExtractor<ColumnVolume, MaterialDensityPair44> columnCubicSurfaceExtractor(&columnVolume, reg, &columnCubicMesh);
+	columnCubicSurfaceExtractor.execute();
+
+	//Both volumes must give exactly the same results.
+	QVERIFY(simpleSmoothMesh.getNoOfVertices() > 0);
+	QCOMPARE(columnSmoothMesh.getNoOfVertices(), simpleSmoothMesh.getNoOfVertices());
+	QVERIFY(columnSmoothMesh.getIndices() == simpleSmoothMesh.getIndices());
+	QVERIFY(simpleCubicMesh.getNoOfVertices() > 0);
+	QCOMPARE(columnCubicMesh.getNoOfVertices(), simpleCubicMesh.getNoOfVertices());
+	QVERIFY(columnCubicMesh.getIndices() == simpleCubicMesh.getIndices());
+}
+
+void TestColumnVolume::testMemoryUsage()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(g_uTerrainSideLength-1, g_uTerrainHeight-1, g_uTerrainSideLength-1));
+
+	RawVolume<MaterialDensityPair44> rawVolume(reg);
+	ColumnVolume<MaterialDensityPair44> columnVolume(reg);
+	createTerrainInVolume(columnVolume);
+	columnVolume.tidy();
+
+	//Terrain columns hold only a handful of runs, so we expect at least an order of magnitude saving.
+	QVERIFY(columnVolume.calculateSizeInBytes() * 10 < rawVolume.calculateSizeInBytes());
+}
+
+QTEST_MAIN(TestColumnVolume)
@@ -0,0 +1,443 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#include "TestCubicSurfaceExtractor.h"
+#include "TerrainGenerator.h"
+
+#include "PolyVoxCore/CubicSurfaceExtractor.h"
+#include "PolyVoxCore/Material.h"
+#include "PolyVoxCore/SimpleVolume.h"
+
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace PolyVox;
+
+const int32_t g_iTerrainSideLength = 128;
+const int32_t g_iTerrainHeight = 64;
+
+//The occlusion of a vertex, where vertices without one count as unoccluded.
+uint32_t getVertexOcclusion(const PositionMaterial& /*vertex*/)
+{
+	return 3;
+}
+
+uint32_t getVertexOcclusion(const PositionMaterialAO& vertex)
+{
+	return vertex.getAmbientOcclusion();
+}
+
+//Packs everything which identifies a unit face into one value. The occlusions of the corners are packed
+//two bits each, with the corner at the upper u and lower v in bits 2 and 3, and so on.
+uint64_t getFaceKey(uint64_t uMaterial, uint32_t uAxis, bool bPositive, int32_t iPlane, int32_t u, int32_t v, uint32_t uOcclusions)
+{
+	return (uMaterial << 40) | (static_cast<uint64_t>(uOcclusions) << 32) | (static_cast<uint64_t>(uAxis) << 30) | (static_cast<uint64_t>(bPositive) << 29) | (iPlane << 16) | (u << 8) | v;
+}
+
+//Splits the quads of a mesh back into the unit faces which they cover. Each face is identified by its
+//axis, position, the direction it points in, its material and the occlusions at its corners, so that
+//differently merged meshes which cover the same surface give the same (sorted) list of faces.
+template <typename VertexType>
+void getUnitFaces(const SurfaceMesh<VertexType>& mesh, std::vector<uint64_t>& vecFaces)
+{
+	const std::vector<uint32_t>& vecIndices = mesh.getIndices();
+	const std::vector<VertexType>& vecVertices = mesh.getVertices();
+
+	for(uint32_t ct = 0; ct + 5 < vecIndices.size(); ct += 6)
+	{
+		//Each quad is written as the triangles (v0, v1, v2) and (v0, v2, v3).
+		QCOMPARE(vecIndices[ct + 3], vecIndices[ct]);
+		QCOMPARE(vecIndices[ct + 4], vecIndices[ct + 2]);
+
+		const uint32_t uQuadIndices[4] = {vecIndices[ct], vecIndices[ct + 1], vecIndices[ct + 2], vecIndices[ct + 5]};
+		int32_t iMin[3] = {1000, 1000, 1000};
+		int32_t iMax[3] = {-1000, -1000, -1000};
+		for(uint32_t uCorner = 0; uCorner < 4; uCorner++)
+		{
+			const VertexType& vertex = vecVertices[uQuadIndices[uCorner]];
+			QCOMPARE(vertex.getMaterial(), vecVertices[uQuadIndices[0]].getMaterial());
+
+			const int32_t iCorner[3] =
+			{
+				static_cast<int32_t>(std::floor(vertex.getPosition().getX() + 1.0f)),
+				static_cast<int32_t>(std::floor(vertex.getPosition().getY() + 1.0f)),
+				static_cast<int32_t>(std::floor(vertex.getPosition().getZ() + 1.0f))
+			};
+			for(uint32_t uAxis = 0; uAxis < 3; uAxis++)
+			{
+				iMin[uAxis] = (std::min)(iMin[uAxis], iCorner[uAxis]);
+				iMax[uAxis] = (std::max)(iMax[uAxis], iCorner[uAxis]);
+			}
+		}
+
+		const uint32_t uAxis = (iMin[0] == iMax[0]) ? 0 : ((iMin[1] == iMax[1]) ? 1 : 2);
+		const uint32_t uAxisU = (uAxis == 0) ? 1 : 0;
+		const uint32_t uAxisV = (uAxis == 2) ? 1 : 2;
+
+		const Vector3DFloat v3dNormal = (vecVertices[uQuadIndices[1]].getPosition() - vecVertices[uQuadIndices[0]].getPosition()).cross(vecVertices[uQuadIndices[2]].getPosition() - vecVertices[uQuadIndices[0]].getPosition());
+		const float fNormal = (uAxis == 0) ? v3dNormal.getX() : ((uAxis == 1) ? v3dNormal.getY() : v3dNormal.getZ());
+		const uint64_t uMaterial = static_cast<uint64_t>(vecVertices[uQuadIndices[0]].getMaterial());
+
+		//A quad which is more than one face across has the same occlusion all the way across, so
+		//each of the faces it covers has the occlusions of the corners of the quad.
+		uint32_t uOcclusions = 0;
+		for(uint32_t uCorner = 0; uCorner < 4; uCorner++)
+		{
+			const VertexType& vertex = vecVertices[uQuadIndices[uCorner]];
+			const float fPosition[3] = {vertex.getPosition().getX(), vertex.getPosition().getY(), vertex.getPosition().getZ()};
+			const uint32_t uCornerU = (fPosition[uAxisU] + 1.0f > iMin[uAxisU] + 0.5f) ? 1 : 0;
+			const uint32_t uCornerV = (fPosition[uAxisV] + 1.0f > iMin[uAxisV] + 0.5f) ? 1 : 0;
+			uOcclusions |= getVertexOcclusion(vertex) << ((uCornerV * 2 + uCornerU) * 2);
+		}
+
+		for(int32_t v = iMin[uAxisV]; v < iMax[uAxisV]; v++)
+		{
+			for(int32_t u = iMin[uAxisU]; u < iMax[uAxisU]; u++)
+			{
+				vecFaces.push_back(getFaceKey(uMaterial, uAxis, fNormal > 0.0f, iMin[uAxis], u, v, uOcclusions));
+			}
+		}
+	}
+
+	std::sort(vecFaces.begin(), vecFaces.end());
+}
+
+void TestCubicSurfaceExtractor::testMergeQuads()
+{
+	SimpleVolume<Material16> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iTerrainSideLength-1, g_iTerrainHeight-1, g_iTerrainSideLength-1)), 32);
+	createHeightmapTerrainInVolume(volData, 3000);
+
+	//The whole volume, a region which lies inside it, one which sticks out of it, and one whose
+	//sides (with the layer of voxels around them) are either side of the 64 bits in a word.
+	const Region regions[4] =
+	{
+		volData.getEnclosingRegion(),
+		Region(Vector3DInt32(32,16,32), Vector3DInt32(63,47,71)),
+		Region(Vector3DInt32(100,40,-8), Vector3DInt32(139,79,23)),
+		Region(Vector3DInt32(1,0,1), Vector3DInt32(62,63,63))
+	};
+
+	for(uint32_t ct = 0; ct < 4; ct++)
+	{
+		SurfaceMesh<PositionMaterial> mergedMesh;
+		CubicSurfaceExtractor<SimpleVolume, Material16> mergedExtractor(&volData, regions[ct], &mergedMesh, true);
+		mergedExtractor.execute();
+
+		SurfaceMesh<PositionMaterial> unmergedMesh;
+		CubicSurfaceExtractor<SimpleVolume, Material16> unmergedExtractor(&volData, regions[ct], &unmergedMesh, false);
+		unmergedExtractor.execute();
+
+		//Merging must cover exactly the same faces, with the same materials and facing the same way...
+		std::vector<uint64_t> vecMergedFaces;
+		std::vector<uint64_t> vecUnmergedFaces;
+		getUnitFaces(mergedMesh, vecMergedFaces);
+		getUnitFaces(unmergedMesh, vecUnmergedFaces);
+		QVERIFY(vecUnmergedFaces.size() > 0);
+		QVERIFY(vecMergedFaces == vecUnmergedFaces);
+
+		//...but with fewer triangles, and without any unused vertices.
+		QVERIFY(mergedMesh.getNoOfIndices() < unmergedMesh.getNoOfIndices());
+		std::vector<bool> vecVertexUsed(mergedMesh.getNoOfVertices(), false);
+		for(uint32_t uIndex = 0; uIndex < mergedMesh.getNoOfIndices(); uIndex++)
+		{
+			vecVertexUsed[mergedMesh.getIndices()[uIndex]] = true;
+		}
+		QVERIFY(std::find(vecVertexUsed.begin(), vecVertexUsed.end(), false) == vecVertexUsed.end());
+	}
+}
+
+void TestCubicSurfaceExtractor::testAmbientOcclusion()
+{
+	//A floor with a single voxel on top of it.
+	SimpleVolume<Material16> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(7,7,7)), 8);
+	for(int32_t z = 0; z < 8; z++)
+	{
+		for(int32_t x = 0; x < 8; x++)
+		{
+			volData.setVoxelAt(x, 0, z, Material16(1));
+		}
+	}
+	volData.setVoxelAt(3, 1, 3, Material16(2));
+
+	std::vector<uint64_t> vecFaces;
+	SurfaceMesh<PositionMaterialAO> mesh;
+	CubicSurfaceExtractor<SimpleVolume, Material16> extractor(&volData, volData.getEnclosingRegion(), &mesh);
+	extractor.execute();
+	getUnitFaces(mesh, vecFaces);
+
+	//The floor next to the voxel is darkened at the two corners which touch it, while the
+	//floor diagonally next to it is only darkened at the one corner they have in common.
+	QVERIFY(std::binary_search(vecFaces.begin(), vecFaces.end(), getFaceKey(1, 1, true, 1, 2, 3, 0xBB)));
+	QVERIFY(std::binary_search(vecFaces.begin(), vecFaces.end(), getFaceKey(1, 1, true, 1, 2, 2, 0xBF)));
+	QVERIFY(std::binary_search(vecFaces.begin(), vecFaces.end(), getFaceKey(1, 1, true, 1, 0, 0, 0xFF)));
+
+	//The sides of the voxel are darkened along the bottom, where they meet the floor.
+	QVERIFY(std::binary_search(vecFaces.begin(), vecFaces.end(), getFaceKey(2, 0, true, 4, 1, 3, 0xDD)));
+
+	//Faces which are occluded differently are not merged, so there are more triangles than without occlusion.
+	SurfaceMesh<PositionMaterial> plainMesh;
+	CubicSurfaceExtractor<SimpleVolume, Material16> plainExtractor(&volData, volData.getEnclosingRegion(), &plainMesh);
+	plainExtractor.execute();
+	QVERIFY(mesh.getNoOfIndices() > plainMesh.getNoOfIndices());
+
+	//On the terrain, finding the occlusions while merging must give the same occlusions as finding them for
+	//each face separately. Without the occlusions the same faces must be covered as when they are not found.
+	SimpleVolume<Material16> terrainData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iTerrainSideLength-1, g_iTerrainHeight-1, g_iTerrainSideLength-1)), 32);
+	createHeightmapTerrainInVolume(terrainData, 3000);
+
+	const Region regions[3] =
+	{
+		terrainData.getEnclosingRegion(),
+		Region(Vector3DInt32(32,16,32), Vector3DInt32(63,47,71)),
+		Region(Vector3DInt32(100,40,-8), Vector3DInt32(139,79,23))
+	};
+
+	for(uint32_t ct = 0; ct < 3; ct++)
+	{
+		SurfaceMesh<PositionMaterialAO> mergedMesh;
+		CubicSurfaceExtractor<SimpleVolume, Material16> mergedExtractor(&terrainData, regions[ct], &mergedMesh, true);
+		mergedExtractor.execute();
+
+		SurfaceMesh<PositionMaterialAO> unmergedMesh;
+		CubicSurfaceExtractor<SimpleVolume, Material16> unmergedExtractor(&terrainData, regions[ct], &unmergedMesh, false);
+		unmergedExtractor.execute();
+
+		std::vector<uint64_t> vecMergedFaces;
+		std::vector<uint64_t> vecUnmergedFaces;
+		getUnitFaces(mergedMesh, vecMergedFaces);
+		getUnitFaces(unmergedMesh, vecUnmergedFaces);
+		QVERIFY(vecUnmergedFaces.size() > 0);
+		QVERIFY(vecMergedFaces == vecUnmergedFaces);
+
+		SurfaceMesh<PositionMaterial> plainMergedMesh;
+		CubicSurfaceExtractor<SimpleVolume, Material16> plainMergedExtractor(&terrainData, regions[ct], &plainMergedMesh, true);
+		plainMergedExtractor.execute();
+
+		std::vector<uint64_t> vecPlainFaces;
+		getUnitFaces(plainMergedMesh, vecPlainFaces);
+		for(uint32_t uFace = 0; uFace < vecMergedFaces.size(); uFace++)
+		{
+			vecMergedFaces[uFace] |= static_cast<uint64_t>(0xFF) << 32;
+		}
+		std::sort(vecMergedFaces.begin(), vecMergedFaces.end());
+		QVERIFY(vecMergedFaces == vecPlainFaces);
+	}
+}
+
+//Checks that the facing records of a cubic mesh cover its indices, that each triangle is in the range for the direction it
+//points in, and that the ranges picked for a view position leave out only triangles which face away from that position.
+template <typename VertexType>
+void checkFacingRecords(const SurfaceMesh<VertexType>& mesh, const Vector3DFloat& v3dViewPosition)
+{
+	QCOMPARE(mesh.m_vecFacingRecords.size(), static_cast<size_t>(NoOfFacingDirections));
+	QCOMPARE(mesh.m_vecFacingRecords[0].beginIndex, mesh.m_vecLodRecords[0].beginIndex);
+	QCOMPARE(mesh.m_vecFacingRecords[NoOfFacingDirections - 1].endIndex, mesh.m_vecLodRecords[0].endIndex);
+
+	const std::vector<uint32_t>& vecIndices = mesh.getIndices();
+	const std::vector<VertexType>& vecVertices = mesh.getVertices();
+	std::vector<uint32_t> vecTriangleDirections(vecIndices.size() / 3);
+	for(uint32_t uDirection = 0; uDirection < NoOfFacingDirections; uDirection++)
+	{
+		const LodRecord& record = mesh.m_vecFacingRecords[uDirection];
+		if(uDirection > 0)
+		{
+			QCOMPARE(record.beginIndex, mesh.m_vecFacingRecords[uDirection - 1].endIndex);
+		}
+
+		for(int32_t iIndex = record.beginIndex; iIndex < record.endIndex; iIndex += 3)
+		{
+			const Vector3DFloat& v0 = vecVertices[vecIndices[iIndex]].getPosition();
+			const Vector3DFloat v3dNormal = (vecVertices[vecIndices[iIndex + 1]].getPosition() - v0).cross(vecVertices[vecIndices[iIndex + 2]].getPosition() - v0);
+			const float fNormal[3] = {v3dNormal.getX(), v3dNormal.getY(), v3dNormal.getZ()};
+			const uint32_t uAxis = uDirection % 3;
+			QVERIFY((uDirection < FacingNegativeX) ? (fNormal[uAxis] > 0.0f) : (fNormal[uAxis] < 0.0f));
+			vecTriangleDirections[iIndex / 3] = uDirection;
+		}
+	}
+
+	//The view position is relative to the volume, while the vertices are relative to the region.
+	const Vector3DFloat v3dRegionPosition(static_cast<float>(mesh.m_Region.getLowerCorner().getX()), static_cast<float>(mesh.m_Region.getLowerCorner().getY()), static_cast<float>(mesh.m_Region.getLowerCorner().getZ()));
+	const uint32_t uDirections = getVisibleFacingDirections(mesh.m_Region, v3dViewPosition);
+	std::vector<LodRecord> vecRanges;
+	getFacingIndexRanges(mesh.m_vecFacingRecords, mesh.m_vecLodRecords, uDirections, vecRanges);
+
+	std::vector<bool> vecTriangleDrawn(vecIndices.size() / 3, false);
+	for(uint32_t uRange = 0; uRange < vecRanges.size(); uRange++)
+	{
+		if(uRange > 0)
+		{
+			QVERIFY(vecRanges[uRange].beginIndex > vecRanges[uRange - 1].endIndex);
+		}
+		std::fill(vecTriangleDrawn.begin() + vecRanges[uRange].beginIndex / 3, vecTriangleDrawn.begin() + vecRanges[uRange].endIndex / 3, true);
+	}
+
+	for(uint32_t uTriangle = 0; uTriangle < vecTriangleDrawn.size(); uTriangle++)
+	{
+		QCOMPARE(static_cast<bool>(vecTriangleDrawn[uTriangle]), (uDirections & (1 << vecTriangleDirections[uTriangle])) != 0);
+		if(!vecTriangleDrawn[uTriangle])
+		{
+			const Vector3DFloat& v0 = vecVertices[vecIndices[uTriangle * 3]].getPosition();
+			const Vector3DFloat v3dNormal = (vecVertices[vecIndices[uTriangle * 3 + 1]].getPosition() - v0).cross(vecVertices[vecIndices[uTriangle * 3 + 2]].getPosition() - v0);
+			QVERIFY(v3dNormal.dot(v3dViewPosition - v3dRegionPosition - v0) <= 0.0f);
+		}
+	}
+}
+
+void TestCubicSurfaceExtractor::testFacingRecords()
+{
+	SimpleVolume<Material16> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iTerrainSideLength-1, g_iTerrainHeight-1, g_iTerrainSideLength-1)), 32);
+	createHeightmapTerrainInVolume(volData, 3000);
+
+	const Region region(Vector3DInt32(32,0,32), Vector3DInt32(63,31,63));
+
+	//Outside the region along every axis, beside it, and inside it.
+	const Vector3DFloat v3dViewPositions[3] =
+	{
+		Vector3DFloat(10.0f, 50.0f, 90.0f),
+		Vector3DFloat(70.0f, 20.0f, 40.0f),
+		Vector3DFloat(40.0f, 20.0f, 50.0f)
+	};
+	const uint32_t uExpectedDirections[3] =
+	{
+		(1 << FacingNegativeX) | (1 << FacingPositiveY) | (1 << FacingPositiveZ),
+		(1 << FacingPositiveX) | (1 << FacingPositiveY) | (1 << FacingNegativeY) | (1 << FacingPositiveZ) | (1 << FacingNegativeZ),
+		(1 << NoOfFacingDirections) - 1
+	};
+
+	for(uint32_t ct = 0; ct < 3; ct++)
+	{
+		QCOMPARE(getVisibleFacingDirections(region, v3dViewPositions[ct]), uExpectedDirections[ct]);
+
+		SurfaceMesh<PositionMaterial> mergedMesh;
+		CubicSurfaceExtractor<SimpleVolume, Material16> mergedExtractor(&volData, region, &mergedMesh, true);
+		mergedExtractor.execute();
+		checkFacingRecords(mergedMesh, v3dViewPositions[ct]);
+
+		SurfaceMesh<PositionMaterial> unmergedMesh;
+		CubicSurfaceExtractor<SimpleVolume, Material16> unmergedExtractor(&volData, region, &unmergedMesh, false);
+		unmergedExtractor.execute();
+		checkFacingRecords(unmergedMesh, v3dViewPositions[ct]);
+	}
+
+	//Viewed from inside the region everything is drawn as one range, and from beside it the y and z faces are joined.
+	SurfaceMesh<PositionMaterial> mesh;
+	CubicSurfaceExtractor<SimpleVolume, Material16> extractor(&volData, region, &mesh);
+	extractor.execute();
+	std::vector<LodRecord> vecRanges;
+	getFacingIndexRanges(mesh.m_vecFacingRecords, mesh.m_vecLodRecords, uExpectedDirections[2], vecRanges);
+	QCOMPARE(vecRanges.size(), static_cast<size_t>(1));
+	QCOMPARE(vecRanges[0].endIndex, static_cast<int>(mesh.getNoOfIndices()));
+	getFacingIndexRanges(mesh.m_vecFacingRecords, mesh.m_vecLodRecords, uExpectedDirections[1], vecRanges);
+	QCOMPARE(vecRanges.size(), static_cast<size_t>(2));
+
+	//A mesh without facing records is drawn whole.
+	mesh.m_vecFacingRecords.clear();
+	getFacingIndexRanges(mesh.m_vecFacingRecords, mesh.m_vecLodRecords, 0, vecRanges);
+	QCOMPARE(vecRanges.size(), static_cast<size_t>(1));
+	QCOMPARE(vecRanges[0].endIndex, static_cast<int>(mesh.getNoOfIndices()));
+}
+
+void TestCubicSurfaceExtractor::testPackedIndices()
+{
+	SimpleVolume<Material16> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iTerrainSideLength-1, g_iTerrainHeight-1, g_iTerrainSideLength-1)), 32);
+	createHeightmapTerrainInVolume(volData, 3000);
+
+	//The largest 16 bit value is never used as an index.
+	QVERIFY(canUse16BitIndices(0));
+	QVERIFY(canUse16BitIndices(65535));
+	QVERIFY(!canUse16BitIndices(65536));
+
+	//Every region the size Thermite uses can have its indices narrowed, and they come out the same.
+	for(int32_t z = 0; z < g_iTerrainSideLength; z += 32)
+	{
+		for(int32_t x = 0; x < g_iTerrainSideLength; x += 32)
+		{
+			SurfaceMesh<PositionMaterial> mesh;
+			CubicSurfaceExtractor<SimpleVolume, Material16> extractor(&volData, Region(Vector3DInt32(x,0,z), Vector3DInt32(x+31,31,z+31)), &mesh, false);
+			extractor.execute();
+			QVERIFY(mesh.getNoOfIndices() > 0);
+			QVERIFY(canUse16BitIndices(mesh.getNoOfVertices()));
+
+			//One extra element checks that nothing is written past the end.
+			std::vector<uint16_t> vecPackedIndices(mesh.getNoOfIndices() + 1, 0xFFFF);
+			packIndicesTo16Bit(mesh.getIndices(), &vecPackedIndices[0]);
+			QVERIFY(std::equal(mesh.getIndices().begin(), mesh.getIndices().end(), vecPackedIndices.begin()));
+			QCOMPARE(vecPackedIndices.back(), static_cast<uint16_t>(0xFFFF));
+		}
+	}
+
+	//The largest index which is allowed survives narrowing.
+	std::vector<uint32_t> vecIndices;
+	vecIndices.push_back(0);
+	vecIndices.push_back(255);
+	vecIndices.push_back(65534);
+	uint16_t uPackedIndices[3];
+	packIndicesTo16Bit(vecIndices, uPackedIndices);
+	QCOMPARE(uPackedIndices[0], static_cast<uint16_t>(0));
+	QCOMPARE(uPackedIndices[1], static_cast<uint16_t>(255));
+	QCOMPARE(uPackedIndices[2], static_cast<uint16_t>(65534));
+}
+
+void TestCubicSurfaceExtractor::benchmarkMergedQuads()
+{
+	SimpleVolume<Material16> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iTerrainSideLength-1, g_iTerrainHeight-1, g_iTerrainSideLength-1)), 32);
+	createHeightmapTerrainInVolume(volData, 3000);
+
+	SurfaceMesh<PositionMaterial> mesh;
+	QBENCHMARK
+	{
+		CubicSurfaceExtractor<SimpleVolume, Material16> extractor(&volData, volData.getEnclosingRegion(), &mesh, true);
+		extractor.execute();
+	}
+}
+
+void TestCubicSurfaceExtractor::benchmarkUnmergedQuads()
+{
+	SimpleVolume<Material16> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iTerrainSideLength-1, g_iTerrainHeight-1, g_iTerrainSideLength-1)), 32);
+	createHeightmapTerrainInVolume(volData, 3000);
+
+	SurfaceMesh<PositionMaterial> mesh;
+	QBENCHMARK
+	{
+		CubicSurfaceExtractor<SimpleVolume, Material16> extractor(&volData, volData.getEnclosingRegion(), &mesh, false);
+		extractor.execute();
+	}
+}
+
+void TestCubicSurfaceExtractor::benchmarkAmbientOcclusion()
+{
+	SimpleVolume<Material16> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iTerrainSideLength-1, g_iTerrainHeight-1, g_iTerrainSideLength-1)), 32);
+	createHeightmapTerrainInVolume(volData, 3000);
+
+	SurfaceMesh<PositionMaterialAO> mesh;
+	QBENCHMARK
+	{
+		CubicSurfaceExtractor<SimpleVolume, Material16> extractor(&volData, volData.getEnclosingRegion(), &mesh, true);
+		extractor.execute();
+	}
+}
+
+QTEST_MAIN(TestCubicSurfaceExtractor)
@@ -0,0 +1,179 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#include "TestFixedBlockVolume.h"
+
+#include "PolyVoxCore/CubicSurfaceExtractor.h"
+#include "PolyVoxCore/MaterialDensityPair.h"
+#include "PolyVoxCore/FixedBlockVolume.h"
+#include "PolyVoxCore/SimpleVolume.h"
+#include "PolyVoxCore/SurfaceExtractor.h"
+
+#include <QtTest>
+
+using namespace PolyVox;
+
+const int32_t g_uVolumeSideLength = 128;
+
+template <typename VolumeType>
+void createSphereInVolume(VolumeType& volData)
+{
+	Vector3DFloat v3dVolCenter(g_uVolumeSideLength / 2, g_uVolumeSideLength / 2, g_uVolumeSideLength / 2);
+	const float fRadius = g_uVolumeSideLength / 3.0f;
+
+	for (int32_t z = 0; z < g_uVolumeSideLength; z++)
+	{
+		for (int32_t y = 0; y < g_uVolumeSideLength; y++)
+		{
+			for (int32_t x = 0; x < g_uVolumeSideLength; x++)
+			{
+				float fDistToCenter = (Vector3DFloat(x,y,z) - v3dVolCenter).length();
+				if(fDistToCenter <= fRadius)
+				{
+					volData.setVoxelAt(x, y, z, MaterialDensityPair44(1, 15));
+				}
+			}
+		}
+	}
+}
+
+template< template<typename> class VolumeType >
+void extractSurfaces(VolumeType<MaterialDensityPair44>& volData, SurfaceMesh<PositionMaterialNormal>& smoothMesh, SurfaceMesh<PositionMaterial>& cubicMesh)
+{
+	SurfaceExtractor<VolumeType, MaterialDensityPair44> surfaceExtractor(&volData, volData.getEnclosingRegion(), &smoothMesh);
+	surfaceExtractor.execute();
+
+	CubicSurfaceExtractor<VolumeType, MaterialDensityPair44> cubicSurfaceExtractor(&volData, volData.getEnclosingRegion(), &cubicMesh);
+	cubicSurfaceExtractor.execute();
+}
+
+void TestFixedBlockVolume::testExtractSurface()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1));
+
+	SimpleVolume<MaterialDensityPair44> simpleVolume(reg, 32);
+	createSphereInVolume(simpleVolume);
+	FixedBlockVolume32<MaterialDensityPair44> fixedBlockVolume(reg);
+	createSphereInVolume(fixedBlockVolume);
+
+	SurfaceMesh<PositionMaterialNormal> simpleSmoothMesh, fixedBlockSmoothMesh;
+	SurfaceMesh<PositionMaterial> simpleCubicMesh, fixedBlockCubicMesh;
+	extractSurfaces<SimpleVolume>(simpleVolume, simpleSmoothMesh, simpleCubicMesh);
+	extractSurfaces<FixedBlockVolume32>(fixedBlockVolume, fixedBlockSmoothMesh, fixedBlockCubicMesh);
+
+	//Both volumes must give exactly the same results.
+	QVERIFY(simpleSmoothMesh.getNoOfVertices() > 0);
+	QCOMPARE(fixedBlockSmoothMesh.getNoOfVertices(), simpleSmoothMesh.getNoOfVertices());
+	QVERIFY(fixedBlockSmoothMesh.getIndices() == simpleSmoothMesh.getIndices());
+	QVERIFY(simpleCubicMesh.getNoOfVertices() > 0);
+	QCOMPARE(fixedBlockCubicMesh.getNoOfVertices(), simpleCubicMesh.getNoOfVertices());
+	QVERIFY(fixedBlockCubicMesh.getIndices() == simpleCubicMesh.getIndices());
+}
+
+template< template<typename> class VolumeType >
+void checkDensityRanges(VolumeType<MaterialDensityPair44>& volData)
+{
+	uint8_t uMin = 0;
+	uint8_t uMax = 0;
+
+	//The sphere is centred in the volume, so the corner block is all air and the centre is all rock.
+	Region regCorner(Vector3DInt32(0,0,0), Vector3DInt32(31,31,31));
+	Region regCentre(Vector3DInt32(56,56,56), Vector3DInt32(71,71,71));
+	QVERIFY(volData.getDensityRange(regCorner, uMin, uMax));
+	QCOMPARE(uMax, static_cast<uint8_t>(0));
+	QVERIFY(volData.getDensityRange(regCentre, uMin, uMax));
+	QCOMPARE(uMin, static_cast<uint8_t>(15));
+
+	//Regions which are partly outside the volume include the border value.
+	QVERIFY(volData.getDensityRange(Region(Vector3DInt32(-8,56,56), Vector3DInt32(71,71,71)), uMin, uMax));
+	QCOMPARE(uMin, static_cast<uint8_t>(0));
+	QCOMPARE(uMax, static_cast<uint8_t>(15));
+
+	//Digging out a voxel widens the range, and filling it in again narrows it back.
+	volData.setVoxelAt(64, 64, 64, MaterialDensityPair44(0, 0));
+	QVERIFY(volData.getDensityRange(regCentre, uMin, uMax));
+	QCOMPARE(uMin, static_cast<uint8_t>(0));
+	volData.setVoxelAt(64, 64, 64, MaterialDensityPair44(1, 15));
+	QVERIFY(volData.getDensityRange(regCentre, uMin, uMax));
+	QCOMPARE(uMin, static_cast<uint8_t>(15));
+
+	//Writing through a span leaves the range unknown until it is recalculated.
+	int32_t iLength = 0;
+	MaterialDensityPair44* pVoxels = volData.getWritableSpanAt(0, 0, 0, 4, iLength);
+	QVERIFY(pVoxels != 0);
+	pVoxels[0] = MaterialDensityPair44(1, 15);
+	QVERIFY(!volData.getDensityRange(regCorner, uMin, uMax));
+	volData.recalculateDensityRanges();
+	QVERIFY(volData.getDensityRange(regCorner, uMin, uMax));
+	QCOMPARE(uMax, static_cast<uint8_t>(15));
+
+	//Extracting a region of air gives an empty mesh.
+	SurfaceMesh<PositionMaterialNormal> smoothMesh;
+	SurfaceExtractor<VolumeType, MaterialDensityPair44> surfaceExtractor(&volData, Region(Vector3DInt32(96,96,96), Vector3DInt32(127,127,127)), &smoothMesh);
+	surfaceExtractor.execute();
+	QCOMPARE(smoothMesh.getNoOfIndices(), static_cast<uint32_t>(0));
+	QCOMPARE(smoothMesh.m_vecLodRecords.size(), static_cast<size_t>(1));
+}
+
+void TestFixedBlockVolume::testDensityRange()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1));
+
+	SimpleVolume<MaterialDensityPair44> simpleVolume(reg, 16);
+	createSphereInVolume(simpleVolume);
+	checkDensityRanges<SimpleVolume>(simpleVolume);
+
+	FixedBlockVolume16<MaterialDensityPair44> fixedBlockVolume(reg);
+	createSphereInVolume(fixedBlockVolume);
+	checkDensityRanges<FixedBlockVolume16>(fixedBlockVolume);
+}
+
+void TestFixedBlockVolume::benchmarkSimpleVolume()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1));
+	SimpleVolume<MaterialDensityPair44> volData(reg, 32);
+	createSphereInVolume(volData);
+
+	QBENCHMARK
+	{
+		SurfaceMesh<PositionMaterialNormal> smoothMesh;
+		SurfaceMesh<PositionMaterial> cubicMesh;
+		extractSurfaces<SimpleVolume>(volData, smoothMesh, cubicMesh);
+	}
+}
+
+void TestFixedBlockVolume::benchmarkFixedBlockVolume()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1));
+	FixedBlockVolume32<MaterialDensityPair44> volData(reg);
+	createSphereInVolume(volData);
+
+	QBENCHMARK
+	{
+		SurfaceMesh<PositionMaterialNormal> smoothMesh;
+		SurfaceMesh<PositionMaterial> cubicMesh;
+		extractSurfaces<FixedBlockVolume32>(volData, smoothMesh, cubicMesh);
+	}
+}
+
+QTEST_MAIN(TestFixedBlockVolume)
@@ -0,0 +1,208 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#include "TestHierarchicalRaycast.h"
+
+#include "PolyVoxCore/DensityPyramid.h"
+#include "PolyVoxCore/HierarchicalRaycast.h"
+#include "PolyVoxCore/MaterialDensityPair.h"
+#include "PolyVoxCore/Raycast.h"
+#include "PolyVoxCore/SimpleVolume.h"
+
+#include <QtTest>
+
+using namespace PolyVox;
+
+const int32_t g_iVolumeSideLength = 128;
+
+void createSphereInVolume(SimpleVolume<MaterialDensityPair44>& volData)
+{
+	Vector3DFloat v3dVolCenter(g_iVolumeSideLength / 2, g_iVolumeSideLength / 2, g_iVolumeSideLength / 2);
+	const float fRadius = g_iVolumeSideLength / 4.0f;
+
+	for (int32_t z = 0; z < g_iVolumeSideLength; z++)
+	{
+		for (int32_t y = 0; y < g_iVolumeSideLength; y++)
+		{
+			for (int32_t x = 0; x < g_iVolumeSideLength; x++)
+			{
+				float fDistToCenter = (Vector3DFloat(x,y,z) - v3dVolCenter).length();
+				if(fDistToCenter <= fRadius)
+				{
+					volData.setVoxelAt(x, y, z, MaterialDensityPair44(1, 15));
+				}
+			}
+		}
+	}
+}
+
+void TestHierarchicalRaycast::testExecute()
+{
+	SimpleVolume<MaterialDensityPair44> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iVolumeSideLength-1, g_iVolumeSideLength-1, g_iVolumeSideLength-1)));
+	createSphereInVolume(volData);
+	DensityPyramid<SimpleVolume, MaterialDensityPair44> pyramid(&volData);
+
+	//The corner of the volume is far from the sphere, so should be skipped over in large steps.
+	Region regNode;
+	QVERIFY(pyramid.getLargestNodeAt(0, 0, 0, MaterialDensityPair44::getThreshold(), regNode));
+	QVERIFY(regNode.getUpperCorner().getX() - regNode.getLowerCorner().getX() + 1 > pyramid.getBrickSideLength());
+	QVERIFY(!pyramid.getLargestNodeAt(64, 64, 64, MaterialDensityPair44::getThreshold(), regNode));
+
+	RaycastResult raycastResult;
+	Raycast<SimpleVolume, MaterialDensityPair44> raycast(&volData, Vector3DFloat(0,0,0), Vector3DFloat(1,1,1), raycastResult);
+	RaycastResult hierarchicalResult;
+	HierarchicalRaycast<SimpleVolume, MaterialDensityPair44> hierarchicalRaycast(&volData, &pyramid, Vector3DFloat(0,0,0), Vector3DFloat(1,1,1), hierarchicalResult);
+
+	//Rays along the axes, from outside the volume and from inside it, towards and away from the sphere.
+	int iNoOfHits = 0;
+	for(int32_t iAxis = 0; iAxis < 3; iAxis++)
+	{
+		for(int32_t iPos = -16; iPos < g_iVolumeSideLength + 16; iPos += 5)
+		{
+			for(int32_t iDirection = -1; iDirection <= 1; iDirection += 2)
+			{
+				Vector3DFloat v3dStart(64, 64, 64);
+				Vector3DFloat v3dDirection(0, 0, 0);
+				v3dStart.setElement(iAxis, static_cast<float>(iPos));
+				v3dStart.setElement((iAxis + 1) % 3, static_cast<float>(48 + iPos % 32));
+				v3dDirection.setElement(iAxis, iDirection * 1000.0f);
+
+				raycast.setStart(v3dStart);
+				raycast.setDirection(v3dDirection);
+				raycast.execute();
+				hierarchicalRaycast.setStart(v3dStart);
+				hierarchicalRaycast.setDirection(v3dDirection);
+				hierarchicalRaycast.execute();
+
+				QCOMPARE(hierarchicalResult.foundIntersection, raycastResult.foundIntersection);
+				if(raycastResult.foundIntersection)
+				{
+					QCOMPARE(hierarchicalResult.intersectionVoxel, raycastResult.intersectionVoxel);
+					QCOMPARE(hierarchicalResult.previousVoxel, raycastResult.previousVoxel);
+					iNoOfHits++;
+				}
+			}
+		}
+	}
+	QVERIFY(iNoOfHits > 0);
+
+	//Diagonal rays from the corners of the volume towards the centre all hit the sphere.
+	for(int32_t iCorner = 0; iCorner < 8; iCorner++)
+	{
+		Vector3DFloat v3dStart((iCorner & 1) ? g_iVolumeSideLength - 1 : 0, (iCorner & 2) ? g_iVolumeSideLength - 1 : 0, (iCorner & 4) ? g_iVolumeSideLength - 1 : 0);
+		Vector3DFloat v3dDirection = Vector3DFloat(g_iVolumeSideLength / 2, g_iVolumeSideLength / 2, g_iVolumeSideLength / 2) - v3dStart;
+
+		hierarchicalRaycast.setStart(v3dStart);
+		hierarchicalRaycast.setDirection(v3dDirection);
+		hierarchicalRaycast.execute();
+
+		QVERIFY(hierarchicalResult.foundIntersection);
+		QVERIFY(volData.getVoxelAt(hierarchicalResult.intersectionVoxel).getDensity() > MaterialDensityPair44::getThreshold());
+		QVERIFY(volData.getVoxelAt(hierarchicalResult.previousVoxel).getDensity() <= MaterialDensityPair44::getThreshold());
+	}
+}
+
+void TestHierarchicalRaycast::testRegionChanged()
+{
+	SimpleVolume<MaterialDensityPair44> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iVolumeSideLength-1, g_iVolumeSideLength-1, g_iVolumeSideLength-1)));
+	createSphereInVolume(volData);
+	DensityPyramid<SimpleVolume, MaterialDensityPair44> pyramid(&volData);
+
+	RaycastResult result;
+	HierarchicalRaycast<SimpleVolume, MaterialDensityPair44> raycast(&volData, &pyramid, Vector3DFloat(0, 10, 10), Vector3DFloat(g_iVolumeSideLength, 0, 0), result);
+	raycast.execute();
+	QVERIFY(!result.foundIntersection);
+
+	//Place a voxel in the empty space along the ray.
+	volData.setVoxelAt(100, 10, 10, MaterialDensityPair44(1, 15));
+	pyramid.regionChanged(Region(Vector3DInt32(100, 10, 10), Vector3DInt32(100, 10, 10)));
+	raycast.execute();
+	QVERIFY(result.foundIntersection);
+	QCOMPARE(result.intersectionVoxel, Vector3DInt32(100, 10, 10));
+	QCOMPARE(result.previousVoxel, Vector3DInt32(99, 10, 10));
+
+	//And remove it again.
+	volData.setVoxelAt(100, 10, 10, MaterialDensityPair44(0, 0));
+	pyramid.regionChanged(Region(Vector3DInt32(100, 10, 10), Vector3DInt32(100, 10, 10)));
+	raycast.execute();
+	QVERIFY(!result.foundIntersection);
+}
+
+template <typename RaycastType>
+int32_t castRays(RaycastType& raycast, RaycastResult& result)
+{
+	//Long rays from random points above the middle of the volume, as used for picking.
+	srand(12345);
+	int32_t iNoOfHits = 0;
+	for(int32_t ct = 0; ct < 1000; ct++)
+	{
+		Vector3DFloat v3dStart(rand() % g_iVolumeSideLength, rand() % g_iVolumeSideLength, g_iVolumeSideLength - 1 - rand() % 16);
+		Vector3DFloat v3dDirection((rand() % 201) - 100, (rand() % 201) - 100, -100);
+		v3dDirection.normalise();
+		v3dDirection *= 1000.0f;
+
+		raycast.setStart(v3dStart);
+		raycast.setDirection(v3dDirection);
+		raycast.execute();
+		if(result.foundIntersection)
+		{
+			iNoOfHits++;
+		}
+	}
+	return iNoOfHits;
+}
+
+void TestHierarchicalRaycast::benchmarkRaycast()
+{
+	SimpleVolume<MaterialDensityPair44> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iVolumeSideLength-1, g_iVolumeSideLength-1, g_iVolumeSideLength-1)));
+	createSphereInVolume(volData);
+
+	RaycastResult result;
+	Raycast<SimpleVolume, MaterialDensityPair44> raycast(&volData, Vector3DFloat(0,0,0), Vector3DFloat(1,1,1), result);
+
+	int32_t iNoOfHits = 0;
+	QBENCHMARK
+	{
+		iNoOfHits = castRays(raycast, result);
+	}
+	QVERIFY(iNoOfHits > 0);
+}
+
+void TestHierarchicalRaycast::benchmarkHierarchicalRaycast()
+{
+	SimpleVolume<MaterialDensityPair44> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iVolumeSideLength-1, g_iVolumeSideLength-1, g_iVolumeSideLength-1)));
+	createSphereInVolume(volData);
+	DensityPyramid<SimpleVolume, MaterialDensityPair44> pyramid(&volData);
+
+	RaycastResult result;
+	HierarchicalRaycast<SimpleVolume, MaterialDensityPair44> raycast(&volData, &pyramid, Vector3DFloat(0,0,0), Vector3DFloat(1,1,1), result);
+
+	int32_t iNoOfHits = 0;
+	QBENCHMARK
+	{
+		iNoOfHits = castRays(raycast, result);
+	}
+	QVERIFY(iNoOfHits > 0);
+}
+
+QTEST_MAIN(TestHierarchicalRaycast)
@@ -0,0 +1,221 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#include "TestLodSurfaceExtractor.h"
+
+#include "PolyVoxCore/Density.h"
+#include "PolyVoxCore/LodSurfaceExtractor.h"
+#include "PolyVoxCore/SimpleVolume.h"
+#include "PolyVoxCore/SurfaceExtractor.h"
+
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace PolyVox;
+
+const int32_t g_iVolumeSideLength = 64;
+const float g_fRadius = 20.0f;
+
+//A sphere with a bumpy surface, so that the contours at different levels differ in interesting ways.
+void createBumpySphereInVolume(SimpleVolume<Density8>& volData)
+{
+	for (int32_t z = 0; z <= g_iVolumeSideLength; z++)
+	{
+		for (int32_t y = 0; y <= g_iVolumeSideLength; y++)
+		{
+			for (int32_t x = 0; x <= g_iVolumeSideLength; x++)
+			{
+				float fDistToCenter = (Vector3DFloat(x,y,z) - Vector3DFloat(32,32,32)).length();
+				float fBumps = std::sin(x * 0.7f) * std::cos(y * 0.9f + z * 0.4f) * std::sin(z * 1.3f + x * 0.2f);
+				float fDensity = 127.5f + (g_fRadius - fDistToCenter) * 30.0f + fBumps * 60.0f;
+				volData.setVoxelAt(x, y, z, Density8(static_cast<uint8_t>((std::min)((std::max)(fDensity, 0.0f), 255.0f))));
+			}
+		}
+	}
+}
+
+uint32_t extractAtLevel(SimpleVolume<Density8>& volData, const Region& region, uint8_t uLodLevel, uint8_t uTransitionFaces, std::vector<Vector3DFloat>& vecTriangles)
+{
+	SurfaceMesh<PositionMaterialNormal> mesh;
+	if(uLodLevel == 0)
+	{
+		SurfaceExtractor<SimpleVolume, Density8> extractor(&volData, region, &mesh);
+		extractor.execute();
+	}
+	else
+	{
+		LodSurfaceExtractor<SimpleVolume, Density8> extractor(&volData, region, &mesh, uLodLevel, uTransitionFaces);
+		extractor.execute();
+	}
+
+	const Vector3DFloat v3dOffset(region.getLowerCorner().getX(), region.getLowerCorner().getY(), region.getLowerCorner().getZ());
+	for(uint32_t ct = 0; ct < mesh.getNoOfIndices(); ct++)
+	{
+		vecTriangles.push_back(mesh.getVertices()[mesh.getIndices()[ct]].getPosition() + v3dOffset);
+	}
+	return mesh.getNoOfIndices() / 3;
+}
+
+//Casts rays from outside the sphere at points around the seam, and counts those which
+//slip through a crack and so see the back of a triangle before they see the front of one.
+uint32_t countRaysThroughCracks(const std::vector<Vector3DFloat>& vecTriangles)
+{
+	uint32_t uNoOfCracks = 0;
+	for(int iTarget = 0; iTarget < 1000; iTarget++)
+	{
+		float fAngle = iTarget * 0.37f;
+		float fOffset = std::fmod(iTarget * 0.61f, 3.0f) - 1.5f;
+		float fRadius = std::sqrt(g_fRadius * g_fRadius - fOffset * fOffset);
+		Vector3DFloat v3dTarget(32.0f + fOffset, 32.0f + fRadius * std::cos(fAngle), 32.0f + fRadius * std::sin(fAngle));
+		Vector3DFloat v3dDir = v3dTarget - Vector3DFloat(32,32,32);
+		v3dDir.normalise();
+		v3dDir += Vector3DFloat(std::sin(iTarget * 1.1f), std::sin(iTarget * 2.3f), std::sin(iTarget * 3.7f)) * 0.5f;
+		v3dDir.normalise();
+		const Vector3DFloat v3dStart = v3dTarget + v3dDir * 60.0f;
+		v3dDir = v3dDir * -1.0f;
+
+		float fNearest = 1000.0f;
+		bool bFrontFacing = true;
+		for(uint32_t ct = 0; ct < vecTriangles.size(); ct += 3)
+		{
+			Vector3DFloat v3dEdge1 = vecTriangles[ct+1] - vecTriangles[ct];
+			Vector3DFloat v3dEdge2 = vecTriangles[ct+2] - vecTriangles[ct];
+			Vector3DFloat v3dP = v3dDir.cross(v3dEdge2);
+			float fDet = v3dEdge1.dot(v3dP);
+			if(std::fabs(fDet) < 1e-9f)
+			{
+				continue;
+			}
+			Vector3DFloat v3dT = v3dStart - vecTriangles[ct];
+			float fU = v3dT.dot(v3dP) / fDet;
+			Vector3DFloat v3dQ = v3dT.cross(v3dEdge1);
+			float fV = v3dDir.dot(v3dQ) / fDet;
+			float fDist = v3dEdge2.dot(v3dQ) / fDet;
+			if((fU >= -1e-5f) && (fV >= -1e-5f) && (fU + fV <= 1.0f + 1e-5f) && (fDist > 0.0f) && (fDist < fNearest))
+			{
+				fNearest = fDist;
+				bFrontFacing = fDet > 0.0f;
+			}
+		}
+		if(!bFrontFacing)
+		{
+			uNoOfCracks++;
+		}
+	}
+	return uNoOfCracks;
+}
+
+std::vector< std::vector<float> > sortTriangles(const std::vector<Vector3DFloat>& vecTriangles)
+{
+	std::vector< std::vector<float> > vecSorted(vecTriangles.size() / 3);
+	for(uint32_t ct = 0; ct < vecTriangles.size(); ct++)
+	{
+		vecSorted[ct / 3].push_back(vecTriangles[ct].getX());
+		vecSorted[ct / 3].push_back(vecTriangles[ct].getY());
+		vecSorted[ct / 3].push_back(vecTriangles[ct].getZ());
+	}
+	std::sort(vecSorted.begin(), vecSorted.end());
+	return vecSorted;
+}
+
+void TestLodSurfaceExtractor::testExecute()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(g_iVolumeSideLength, g_iVolumeSideLength, g_iVolumeSideLength));
+	SimpleVolume<Density8> volData(reg, 16);
+	createBumpySphereInVolume(volData);
+
+	//Level zero gives exactly the same triangles as the SurfaceExtractor, though in a different order.
+	std::vector<Vector3DFloat> vecTriangles;
+	std::vector<Vector3DFloat> vecLodTriangles;
+	extractAtLevel(volData, reg, 0, 0, vecTriangles);
+	SurfaceMesh<PositionMaterialNormal> mesh;
+	LodSurfaceExtractor<SimpleVolume, Density8> extractor(&volData, reg, &mesh, 0);
+	extractor.execute();
+	for(uint32_t ct = 0; ct < mesh.getNoOfIndices(); ct++)
+	{
+		vecLodTriangles.push_back(mesh.getVertices()[mesh.getIndices()[ct]].getPosition());
+	}
+	QVERIFY(vecTriangles.size() > 0);
+	QVERIFY(sortTriangles(vecLodTriangles) == sortTriangles(vecTriangles));
+
+	//Each level has about a quarter of the triangles of the one before.
+	uint32_t uPreviousNoOfTriangles = vecTriangles.size() / 3;
+	for(uint8_t uLevel = 1; uLevel <= 3; uLevel++)
+	{
+		std::vector<Vector3DFloat> vecLevelTriangles;
+		uint32_t uNoOfTriangles = extractAtLevel(volData, reg, uLevel, 0, vecLevelTriangles);
+		QVERIFY(uNoOfTriangles * 3 < uPreviousNoOfTriangles);
+		QVERIFY(uNoOfTriangles * 5 > uPreviousNoOfTriangles);
+		uPreviousNoOfTriangles = uNoOfTriangles;
+	}
+}
+
+void TestLodSurfaceExtractor::testTransitionCells()
+{
+	SimpleVolume<Density8> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iVolumeSideLength, g_iVolumeSideLength, g_iVolumeSideLength)), 16);
+	createBumpySphereInVolume(volData);
+
+	//The sphere is split down the middle, with the coarser half on either side.
+	Region regLower(Vector3DInt32(0,0,0), Vector3DInt32(32, g_iVolumeSideLength, g_iVolumeSideLength));
+	Region regUpper(Vector3DInt32(32,0,0), Vector3DInt32(g_iVolumeSideLength, g_iVolumeSideLength, g_iVolumeSideLength));
+	for(uint8_t uLevel = 1; uLevel <= 2; uLevel++)
+	{
+		for(int iCoarseUpper = 0; iCoarseUpper < 2; iCoarseUpper++)
+		{
+			const Region& regCoarse = iCoarseUpper ? regUpper : regLower;
+			const Region& regFine = iCoarseUpper ? regLower : regUpper;
+			const uint8_t uTransitionFace = iCoarseUpper ? TransitionNegativeX : TransitionPositiveX;
+
+			//Without the transition cells the seam has cracks...
+			std::vector<Vector3DFloat> vecTriangles;
+			extractAtLevel(volData, regFine, uLevel - 1, 0, vecTriangles);
+			extractAtLevel(volData, regCoarse, uLevel, 0, vecTriangles);
+			QVERIFY(countRaysThroughCracks(vecTriangles) > 0);
+
+			//...and with them it has none.
+			vecTriangles.clear();
+			extractAtLevel(volData, regFine, uLevel - 1, 0, vecTriangles);
+			extractAtLevel(volData, regCoarse, uLevel, uTransitionFace, vecTriangles);
+			QCOMPARE(countRaysThroughCracks(vecTriangles), static_cast<uint32_t>(0));
+		}
+	}
+}
+
+void TestLodSurfaceExtractor::benchmarkExecute()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(g_iVolumeSideLength, g_iVolumeSideLength, g_iVolumeSideLength));
+	SimpleVolume<Density8> volData(reg, 16);
+	createBumpySphereInVolume(volData);
+
+	QBENCHMARK
+	{
+		SurfaceMesh<PositionMaterialNormal> mesh;
+		LodSurfaceExtractor<SimpleVolume, Density8> extractor(&volData, reg, &mesh, 2, TransitionNegativeX | TransitionPositiveX);
+		extractor.execute();
+	}
+}
+
+QTEST_MAIN(TestLodSurfaceExtractor)
@@ -0,0 +1,212 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+
+#include "TestMeshOptimiser.h"
+
+#include "PolyVoxCore/CubicSurfaceExtractor.h"
+#include "PolyVoxCore/MaterialDensityPair.h"
+#include "PolyVoxCore/MeshOptimiser.h"
+#include "PolyVoxCore/SimpleVolume.h"
+#include "PolyVoxCore/SurfaceExtractor.h"
+
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace PolyVox;
+
+const int32_t g_iVolumeSideLength = 64;
+
+//A sphere with a bumpy surface, so that the cubic mesh has plenty of separate pieces in each facing direction.
+void createBumpySphereInVolume(SimpleVolume<MaterialDensityPair44>& volData)
+{
+	Vector3DFloat v3dVolCenter(g_iVolumeSideLength / 2, g_iVolumeSideLength / 2, g_iVolumeSideLength / 2);
+
+	for(int32_t z = 0; z < g_iVolumeSideLength; z++)
+	{
+		for(int32_t y = 0; y < g_iVolumeSideLength; y++)
+		{
+			for(int32_t x = 0; x < g_iVolumeSideLength; x++)
+			{
+				float fRadius = g_iVolumeSideLength / 3.0f + 2.0f * std::sin(x * 0.5f) * std::cos(z * 0.4f);
+				if((Vector3DFloat(x,y,z) - v3dVolCenter).length() <= fRadius)
+				{
+					volData.setVoxelAt(x, y, z, MaterialDensityPair44((x + y) % 3 + 1, 15));
+				}
+			}
+		}
+	}
+}
+
+//Lists the triangles in a range of a mesh by the positions and materials of their vertices, in a fixed order, so
+//that meshes can be compared regardless of the order of their triangles and vertices. The corners aren't rotated.
+template <typename VertexType>
+void getSortedTriangles(const SurfaceMesh<VertexType>& mesh, uint32_t uBeginIndex, uint32_t uEndIndex, std::vector< std::vector<float> >& vecTriangles)
+{
+	vecTriangles.clear();
+	for(uint32_t ct = uBeginIndex; ct < uEndIndex; ct += 3)
+	{
+		std::vector<float> vecTriangle;
+		for(uint32_t uCorner = 0; uCorner < 3; uCorner++)
+		{
+			const VertexType& vertex = mesh.getVertices()[mesh.getIndices()[ct + uCorner]];
+			vecTriangle.push_back(vertex.getPosition().getX());
+			vecTriangle.push_back(vertex.getPosition().getY());
+			vecTriangle.push_back(vertex.getPosition().getZ());
+			vecTriangle.push_back(vertex.getMaterial());
+		}
+		vecTriangles.push_back(vecTriangle);
+	}
+	std::sort(vecTriangles.begin(), vecTriangles.end());
+}
+
+//The vertices should be numbered in the order in which the triangles first use them.
+template <typename VertexType>
+bool verticesAreInFirstUseOrder(const SurfaceMesh<VertexType>& mesh)
+{
+	uint32_t uNoOfVerticesUsed = 0;
+	for(uint32_t ct = 0; ct < mesh.getNoOfIndices(); ct++)
+	{
+		if(mesh.getIndices()[ct] > uNoOfVerticesUsed)
+		{
+			return false;
+		}
+		if(mesh.getIndices()[ct] == uNoOfVerticesUsed)
+		{
+			uNoOfVerticesUsed++;
+		}
+	}
+	return uNoOfVerticesUsed == mesh.getNoOfVertices();
+}
+
+void TestMeshOptimiser::testCacheMissRatio()
+{
+	//Two triangles sharing an edge need four vertices between them.
+	uint32_t uQuad[] = {0, 1, 2, 0, 2, 3};
+	std::vector<uint32_t> vecQuad(uQuad, uQuad + 6);
+	QCOMPARE(computeAverageCacheMissRatio(vecQuad, 0, 6, 16), 2.0f);
+	QCOMPARE(computeAverageCacheMissRatio(vecQuad, 3, 6, 16), 3.0f);
+	QCOMPARE(computeAverageCacheMissRatio(vecQuad, 0, 0, 16), 0.0f);
+
+	//With room for only three vertices, vertex 0 has been pushed out by the time the third triangle uses it again.
+	uint32_t uFan[] = {0, 1, 2, 0, 2, 3, 0, 3, 4};
+	std::vector<uint32_t> vecFan(uFan, uFan + 9);
+	QCOMPARE(computeAverageCacheMissRatio(vecFan, 0, 9, 16), 5.0f / 3.0f);
+	QCOMPARE(computeAverageCacheMissRatio(vecFan, 0, 9, 3), 6.0f / 3.0f);
+}
+
+void TestMeshOptimiser::testOptimiseSmoothMesh()
+{
+	SimpleVolume<MaterialDensityPair44> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iVolumeSideLength-1, g_iVolumeSideLength-1, g_iVolumeSideLength-1)), 32);
+	createBumpySphereInVolume(volData);
+
+	SurfaceMesh<PositionMaterialNormal> mesh;
+	SurfaceExtractor<SimpleVolume, MaterialDensityPair44> extractor(&volData, volData.getEnclosingRegion(), &mesh);
+	extractor.execute();
+
+	SurfaceMesh<PositionMaterialNormal> optimisedMesh;
+	MeshOptimiser<PositionMaterialNormal> optimiser(&mesh, &optimisedMesh);
+	optimiser.execute();
+
+	//The mesh has the same triangles as before...
+	std::vector< std::vector<float> > vecTriangles;
+	std::vector< std::vector<float> > vecOptimisedTriangles;
+	getSortedTriangles(mesh, 0, mesh.getNoOfIndices(), vecTriangles);
+	getSortedTriangles(optimisedMesh, 0, optimisedMesh.getNoOfIndices(), vecOptimisedTriangles);
+	QVERIFY(vecTriangles.size() > 0);
+	QVERIFY(vecOptimisedTriangles == vecTriangles);
+	QCOMPARE(optimisedMesh.getNoOfVertices(), mesh.getNoOfVertices());
+	QVERIFY(verticesAreInFirstUseOrder(optimisedMesh));
+
+	//...but uses the cache much better.
+	QCOMPARE(optimiser.getCacheMissRatioBefore(), computeAverageCacheMissRatio(mesh.getIndices(), 0, mesh.getNoOfIndices(), 16));
+	QCOMPARE(optimiser.getCacheMissRatioAfter(), computeAverageCacheMissRatio(optimisedMesh.getIndices(), 0, optimisedMesh.getNoOfIndices(), 16));
+	QVERIFY(optimiser.getCacheMissRatioAfter() < optimiser.getCacheMissRatioBefore() * 0.8f);
+	QVERIFY(optimiser.getCacheMissRatioAfter() < 0.8f);
+
+	//Optimising a mesh in place gives the same result.
+	MeshOptimiser<PositionMaterialNormal> inPlaceOptimiser(&mesh, &mesh);
+	inPlaceOptimiser.execute();
+	QVERIFY(mesh.getIndices() == optimisedMesh.getIndices());
+}
+
+void TestMeshOptimiser::testOptimiseCubicMesh()
+{
+	SimpleVolume<MaterialDensityPair44> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iVolumeSideLength-1, g_iVolumeSideLength-1, g_iVolumeSideLength-1)), 32);
+	createBumpySphereInVolume(volData);
+
+	SurfaceMesh<PositionMaterial> mesh;
+	CubicSurfaceExtractor<SimpleVolume, MaterialDensityPair44> extractor(&volData, volData.getEnclosingRegion(), &mesh, false);
+	extractor.execute();
+	QCOMPARE(mesh.m_vecFacingRecords.size(), static_cast<size_t>(NoOfFacingDirections));
+
+	SurfaceMesh<PositionMaterial> optimisedMesh;
+	MeshOptimiser<PositionMaterial> optimiser(&mesh, &optimisedMesh);
+	optimiser.execute();
+
+	//The triangles have only moved within the ranges of the facing records, so these are unchanged.
+	QCOMPARE(optimisedMesh.m_vecFacingRecords.size(), mesh.m_vecFacingRecords.size());
+	for(uint32_t uDirection = 0; uDirection < NoOfFacingDirections; uDirection++)
+	{
+		const LodRecord& record = mesh.m_vecFacingRecords[uDirection];
+		QCOMPARE(optimisedMesh.m_vecFacingRecords[uDirection].beginIndex, record.beginIndex);
+		QCOMPARE(optimisedMesh.m_vecFacingRecords[uDirection].endIndex, record.endIndex);
+
+		std::vector< std::vector<float> > vecTriangles;
+		std::vector< std::vector<float> > vecOptimisedTriangles;
+		getSortedTriangles(mesh, record.beginIndex, record.endIndex, vecTriangles);
+		getSortedTriangles(optimisedMesh, record.beginIndex, record.endIndex, vecOptimisedTriangles);
+		QVERIFY(vecOptimisedTriangles == vecTriangles);
+	}
+	QVERIFY(verticesAreInFirstUseOrder(optimisedMesh));
+
+	QVERIFY(optimiser.getCacheMissRatioAfter() < optimiser.getCacheMissRatioBefore());
+
+	//Each facing direction can be drawn on its own, so each should use the cache well on its own.
+	for(uint32_t uDirection = 0; uDirection < NoOfFacingDirections; uDirection++)
+	{
+		const LodRecord& record = optimisedMesh.m_vecFacingRecords[uDirection];
+		QVERIFY(computeAverageCacheMissRatio(optimisedMesh.getIndices(), record.beginIndex, record.endIndex, 16) <= computeAverageCacheMissRatio(mesh.getIndices(), record.beginIndex, record.endIndex, 16));
+	}
+}
+
+void TestMeshOptimiser::benchmarkMeshOptimiser()
+{
+	SimpleVolume<MaterialDensityPair44> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iVolumeSideLength-1, g_iVolumeSideLength-1, g_iVolumeSideLength-1)), 32);
+	createBumpySphereInVolume(volData);
+
+	SurfaceMesh<PositionMaterialNormal> mesh;
+	SurfaceExtractor<SimpleVolume, MaterialDensityPair44> extractor(&volData, volData.getEnclosingRegion(), &mesh);
+	extractor.execute();
+
+	QBENCHMARK
+	{
+		SurfaceMesh<PositionMaterialNormal> optimisedMesh;
+		MeshOptimiser<PositionMaterialNormal> optimiser(&mesh, &optimisedMesh);
+		optimiser.execute();
+	}
+}
+
+QTEST_MAIN(TestMeshOptimiser)
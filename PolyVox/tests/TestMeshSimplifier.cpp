@@ -0,0 +1,282 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+
+#include "TestMeshSimplifier.h"
+#include "TerrainGenerator.h"
+
+#include "PolyVoxCore/CubicSurfaceExtractor.h"
+#include "PolyVoxCore/Material.h"
+#include "PolyVoxCore/MeshDecimator.h"
+#include "PolyVoxCore/MeshSimplifier.h"
+#include "PolyVoxCore/SimpleVolume.h"
+
+#include <QtTest>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <map>
+#include <utility>
+
+using namespace PolyVox;
+
+const int32_t g_iTerrainSideLength = 64;
+const int32_t g_iTerrainHeight = 64;
+
+//Extracts the region which Thermite would use for the middle of the terrain, without merging quads so that there is plenty to simplify.
+void extractRegionMesh(SimpleVolume<Material16>& volData, SurfaceMesh<PositionMaterial>& mesh)
+{
+	CubicSurfaceExtractor<SimpleVolume, Material16> extractor(&volData, Region(Vector3DInt32(16,16,16), Vector3DInt32(47,47,47)), &mesh, false);
+	extractor.execute();
+}
+
+//Sums the area of the triangles lying in each plane, separately for each material and for each way the triangles can face.
+void getPlaneAreas(const SurfaceMesh<PositionMaterial>& mesh, std::map<uint64_t, double>& mapAreas)
+{
+	const std::vector<uint32_t>& vecIndices = mesh.getIndices();
+	const std::vector<PositionMaterial>& vecVertices = mesh.getVertices();
+
+	mapAreas.clear();
+	for(uint32_t ct = 0; ct < vecIndices.size(); ct += 3)
+	{
+		const Vector3DFloat& v3dPos0 = vecVertices[vecIndices[ct]].getPosition();
+		const Vector3DFloat v3dNormal = (vecVertices[vecIndices[ct + 1]].getPosition() - v3dPos0).cross(vecVertices[vecIndices[ct + 2]].getPosition() - v3dPos0);
+
+		uint32_t uAxis = 0;
+		for(uint32_t uElement = 1; uElement < 3; uElement++)
+		{
+			if(std::fabs(v3dNormal.getElement(uElement)) > std::fabs(v3dNormal.getElement(uAxis)))
+			{
+				uAxis = uElement;
+			}
+		}
+
+		const uint64_t uMaterial = static_cast<uint64_t>(vecVertices[vecIndices[ct]].getMaterial());
+		const uint64_t uPlane = static_cast<uint64_t>(std::floor(v3dPos0.getElement(uAxis) + 0.5f) + 1000.0f);
+		const uint64_t uPositive = (v3dNormal.getElement(uAxis) > 0.0f) ? 1 : 0;
+		mapAreas[(uMaterial << 32) | (uAxis << 24) | (uPositive << 16) | uPlane] += v3dNormal.length() * 0.5;
+	}
+}
+
+//The total length of the edges which are used by only one triangle. In a cubic mesh these are the
+//boundaries between materials and the places where the surface is cut off by the faces of the region.
+double getOpenEdgeLength(const SurfaceMesh<PositionMaterial>& mesh)
+{
+	const std::vector<uint32_t>& vecIndices = mesh.getIndices();
+	const std::vector<PositionMaterial>& vecVertices = mesh.getVertices();
+
+	//Each edge is counted in the direction it is used, so an edge shared by two triangles is seen once each way.
+	std::map< std::pair<uint32_t, uint32_t>, uint32_t > mapEdges;
+	for(uint32_t ct = 0; ct < vecIndices.size(); ct += 3)
+	{
+		for(uint32_t uCorner = 0; uCorner < 3; uCorner++)
+		{
+			mapEdges[std::make_pair(vecIndices[ct + uCorner], vecIndices[ct + (uCorner + 1) % 3])]++;
+		}
+	}
+
+	double dLength = 0.0;
+	for(std::map< std::pair<uint32_t, uint32_t>, uint32_t >::const_iterator iter = mapEdges.begin(); iter != mapEdges.end(); iter++)
+	{
+		if(mapEdges.find(std::make_pair(iter->first.second, iter->first.first)) == mapEdges.end())
+		{
+			dLength += (vecVertices[iter->first.first].getPosition() - vecVertices[iter->first.second].getPosition()).length();
+		}
+	}
+	return dLength;
+}
+
+void TestMeshSimplifier::testExactSimplification()
+{
+	SimpleVolume<Material16> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iTerrainSideLength-1, g_iTerrainHeight-1, g_iTerrainSideLength-1)), 32);
+	createHeightmapTerrainInVolume(volData, 1000);
+
+	SurfaceMesh<PositionMaterial> mesh;
+	extractRegionMesh(volData, mesh);
+
+	SurfaceMesh<PositionMaterial> simplifiedMesh;
+	MeshSimplifier<PositionMaterial> simplifier(&mesh, &simplifiedMesh);
+	simplifier.execute();
+
+	//The flat areas should have been merged into fewer triangles, at least as few as the MeshDecimator manages...
+	SurfaceMesh<PositionMaterial> decimatedMesh;
+	MeshDecimator<PositionMaterial> decimator(&mesh, &decimatedMesh);
+	decimator.execute();
+	QVERIFY(simplifiedMesh.getNoOfIndices() > 0);
+	QVERIFY(simplifiedMesh.getNoOfIndices() < mesh.getNoOfIndices());
+	QVERIFY(simplifiedMesh.getNoOfIndices() <= decimatedMesh.getNoOfIndices());
+	QVERIFY(simplifiedMesh.getNoOfVertices() < mesh.getNoOfVertices());
+
+	//...covering exactly the same area with each material on each plane...
+	std::map<uint64_t, double> mapAreas;
+	std::map<uint64_t, double> mapSimplifiedAreas;
+	getPlaneAreas(mesh, mapAreas);
+	getPlaneAreas(simplifiedMesh, mapSimplifiedAreas);
+	QCOMPARE(mapSimplifiedAreas.size(), mapAreas.size());
+	for(std::map<uint64_t, double>::const_iterator iter = mapAreas.begin(); iter != mapAreas.end(); iter++)
+	{
+		QVERIFY(std::fabs(mapSimplifiedAreas[iter->first] - iter->second) < 0.001);
+	}
+
+	//...and with the material boundaries and the edges on the faces of the region left where they were.
+	QVERIFY(std::fabs(getOpenEdgeLength(simplifiedMesh) - getOpenEdgeLength(mesh)) < 0.001);
+
+	//Every collapse left the surface where it was, so the facing records still apply.
+	QCOMPARE(simplifiedMesh.m_vecFacingRecords.size(), mesh.m_vecFacingRecords.size());
+	QCOMPARE(simplifiedMesh.m_vecLodRecords.size(), static_cast<size_t>(1));
+	QCOMPARE(simplifiedMesh.m_vecLodRecords[0].endIndex, static_cast<int>(simplifiedMesh.getNoOfIndices()));
+}
+
+void TestMeshSimplifier::testTargetTriangleCount()
+{
+	SimpleVolume<Material16> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iTerrainSideLength-1, g_iTerrainHeight-1, g_iTerrainSideLength-1)), 32);
+	createHeightmapTerrainInVolume(volData, 1000);
+
+	SurfaceMesh<PositionMaterial> mesh;
+	extractRegionMesh(volData, mesh);
+
+	SurfaceMesh<PositionMaterial> exactMesh;
+	MeshSimplifier<PositionMaterial> exactSimplifier(&mesh, &exactMesh);
+	exactSimplifier.execute();
+
+	//With no limit on the error the simplifier carries on past the exact result until it reaches the target.
+	const uint32_t uTargetTriangleCount = exactMesh.getNoOfIndices() / 6;
+	SurfaceMesh<PositionMaterial> simplifiedMesh;
+	MeshSimplifier<PositionMaterial> simplifier(&mesh, &simplifiedMesh, uTargetTriangleCount, FLT_MAX);
+	simplifier.execute();
+	QVERIFY(simplifiedMesh.getNoOfIndices() > 0);
+	QVERIFY(simplifiedMesh.getNoOfIndices() / 3 <= uTargetTriangleCount);
+
+	//The surface has moved, so facing records would no longer be correct.
+	QVERIFY(simplifiedMesh.m_vecFacingRecords.empty());
+
+	//The material boundaries are still kept exactly, as is the edge of the mesh on the faces of the region.
+	QVERIFY(std::fabs(getOpenEdgeLength(simplifiedMesh) - getOpenEdgeLength(mesh)) < 0.001);
+
+	//A tight error bound stops the simplifier well short of the target.
+	SurfaceMesh<PositionMaterial> boundedMesh;
+	MeshSimplifier<PositionMaterial> boundedSimplifier(&mesh, &boundedMesh, uTargetTriangleCount, 0.01f);
+	boundedSimplifier.execute();
+	QVERIFY(boundedMesh.getNoOfIndices() / 3 > uTargetTriangleCount);
+	QVERIFY(boundedMesh.getNoOfIndices() <= exactMesh.getNoOfIndices());
+}
+
+void TestMeshSimplifier::testLodLevels()
+{
+	SimpleVolume<Material16> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iTerrainSideLength-1, g_iTerrainHeight-1, g_iTerrainSideLength-1)), 32);
+	createHeightmapTerrainInVolume(volData, 1000);
+
+	SurfaceMesh<PositionMaterial> mesh;
+	extractRegionMesh(volData, mesh);
+
+	SurfaceMesh<PositionMaterial> exactMesh;
+	MeshSimplifier<PositionMaterial> exactSimplifier(&mesh, &exactMesh);
+	exactSimplifier.execute();
+
+	SurfaceMesh<PositionMaterial> lodMesh;
+	MeshSimplifier<PositionMaterial> simplifier(&mesh, &lodMesh);
+	simplifier.setNoOfLodLevels(4);
+	simplifier.execute();
+
+	//The first level is the same as simplifying without any extra levels, and keeps its facing records.
+	QVERIFY(lodMesh.m_vecLodRecords.size() > 1);
+	QVERIFY(lodMesh.m_vecLodRecords.size() <= 4);
+	QCOMPARE(lodMesh.m_vecLodRecords[0].beginIndex, 0);
+	QCOMPARE(lodMesh.m_vecLodRecords[0].endIndex, static_cast<int>(exactMesh.getNoOfIndices()));
+	QVERIFY(std::equal(exactMesh.getIndices().begin(), exactMesh.getIndices().end(), lodMesh.getIndices().begin()));
+	QCOMPARE(lodMesh.m_vecFacingRecords.size(), exactMesh.m_vecFacingRecords.size());
+
+	const double dOpenEdgeLength = getOpenEdgeLength(mesh);
+	for(uint32_t uLevel = 1; uLevel < lodMesh.m_vecLodRecords.size(); uLevel++)
+	{
+		//The levels follow on from each other in the index buffer, each with at most three quarters of the triangles of the one before.
+		const LodRecord& previous = lodMesh.m_vecLodRecords[uLevel - 1];
+		const LodRecord& record = lodMesh.m_vecLodRecords[uLevel];
+		QCOMPARE(record.beginIndex, previous.endIndex);
+		QVERIFY(record.endIndex > record.beginIndex);
+		QVERIFY((record.endIndex - record.beginIndex) * 4 <= (previous.endIndex - previous.beginIndex) * 3);
+
+		//Each level still meets its neighbours and keeps its material boundaries.
+		SurfaceMesh<PositionMaterial> levelMesh(lodMesh);
+		levelMesh.m_vecTriangleIndices.assign(lodMesh.getIndices().begin() + record.beginIndex, lodMesh.getIndices().begin() + record.endIndex);
+		QVERIFY(std::fabs(getOpenEdgeLength(levelMesh) - dOpenEdgeLength) < 0.001);
+	}
+	QCOMPARE(lodMesh.m_vecLodRecords.back().endIndex, static_cast<int>(lodMesh.getNoOfIndices()));
+	for(uint32_t ct = 0; ct < lodMesh.getNoOfIndices(); ct++)
+	{
+		QVERIFY(lodMesh.getIndices()[ct] < lodMesh.getNoOfVertices());
+	}
+
+	//The first level is used close to the region, and each doubling of the distance moves one level coarser.
+	const Region& region = lodMesh.m_Region;
+	const uint32_t uNoOfLevels = lodMesh.m_vecLodRecords.size();
+	const Vector3DFloat v3dCentre = static_cast<Vector3DFloat>(region.getLowerCorner() + region.getUpperCorner()) * 0.5f;
+	const float fEdge = region.getUpperCorner().getX() + 0.5f;
+	QCOMPARE(selectLodLevel(region, v3dCentre, uNoOfLevels, 16.0f), static_cast<uint32_t>(0));
+	QCOMPARE(selectLodLevel(region, Vector3DFloat(fEdge + 15.0f, v3dCentre.getY(), v3dCentre.getZ()), uNoOfLevels, 16.0f), static_cast<uint32_t>(0));
+	QCOMPARE(selectLodLevel(region, Vector3DFloat(fEdge + 17.0f, v3dCentre.getY(), v3dCentre.getZ()), uNoOfLevels, 16.0f), static_cast<uint32_t>(1));
+	QCOMPARE(selectLodLevel(region, Vector3DFloat(fEdge + 10000.0f, v3dCentre.getY(), v3dCentre.getZ()), uNoOfLevels, 16.0f), uNoOfLevels - 1);
+	QCOMPARE(selectLodLevel(region, Vector3DFloat(fEdge + 10000.0f, v3dCentre.getY(), v3dCentre.getZ()), uNoOfLevels, 0.0f), static_cast<uint32_t>(0));
+
+	//The coarser levels are drawn whole, whichever way the camera is facing.
+	std::vector<LodRecord> vecRanges;
+	getLodIndexRanges(lodMesh.m_vecFacingRecords, lodMesh.m_vecLodRecords, 1, 1 << FacingPositiveX, vecRanges);
+	QCOMPARE(vecRanges.size(), static_cast<size_t>(1));
+	QCOMPARE(vecRanges[0].beginIndex, lodMesh.m_vecLodRecords[1].beginIndex);
+	QCOMPARE(vecRanges[0].endIndex, lodMesh.m_vecLodRecords[1].endIndex);
+}
+
+void TestMeshSimplifier::benchmarkMeshSimplifier()
+{
+	SimpleVolume<Material16> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iTerrainSideLength-1, g_iTerrainHeight-1, g_iTerrainSideLength-1)), 32);
+	createHeightmapTerrainInVolume(volData, 1000);
+
+	SurfaceMesh<PositionMaterial> mesh;
+	extractRegionMesh(volData, mesh);
+
+	QBENCHMARK
+	{
+		SurfaceMesh<PositionMaterial> simplifiedMesh;
+		MeshSimplifier<PositionMaterial> simplifier(&mesh, &simplifiedMesh);
+		simplifier.execute();
+	}
+}
+
+void TestMeshSimplifier::benchmarkMeshDecimator()
+{
+	SimpleVolume<Material16> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_iTerrainSideLength-1, g_iTerrainHeight-1, g_iTerrainSideLength-1)), 32);
+	createHeightmapTerrainInVolume(volData, 1000);
+
+	SurfaceMesh<PositionMaterial> mesh;
+	extractRegionMesh(volData, mesh);
+
+	QBENCHMARK
+	{
+		SurfaceMesh<PositionMaterial> decimatedMesh;
+		MeshDecimator<PositionMaterial> decimator(&mesh, &decimatedMesh);
+		decimator.execute();
+	}
+}
+
+QTEST_MAIN(TestMeshSimplifier)
@@ -0,0 +1,210 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#include "TestOctreeVolume.h"
+
+#include "PolyVoxCore/AStarPathfinder.h"
+#include "PolyVoxCore/CubicSurfaceExtractor.h"
+#include "PolyVoxCore/MaterialDensityPair.h"
+#include "PolyVoxCore/OctreeVolume.h"
+#include "PolyVoxCore/Raycast.h"
+#include "PolyVoxCore/SimpleVolume.h"
+#include "PolyVoxCore/SurfaceExtractor.h"
+
+#include <QtTest>
+
+using namespace PolyVox;
+
+const int32_t g_uVolumeSideLength = 64;
+
+template <typename VolumeType>
+void createSphereInVolume(VolumeType& volData, const Vector3DFloat& v3dVolCenter, float fRadius)
+{
+	for (int32_t z = 0; z < g_uVolumeSideLength; z++)
+	{
+		for (int32_t y = 0; y < g_uVolumeSideLength; y++)
+		{
+			for (int32_t x = 0; x < g_uVolumeSideLength; x++)
+			{
+				float fDistToCenter = (Vector3DFloat(x,y,z) - v3dVolCenter).length();
+				if(fDistToCenter <= fRadius)
+				{
+					volData.setVoxelAt(x, y, z, MaterialDensityPair44(1, 15));
+				}
+			}
+		}
+	}
+}
+
+//Fills both volumes with the same pseudo-random data. Only a few values are used so that some nodes get collapsed.
+void createRandomData(OctreeVolume<uint8_t>& octreeVolume, SimpleVolume<uint8_t>& simpleVolume)
+{
+	const Region& reg = simpleVolume.getEnclosingRegion();
+	uint32_t uSeed = 12345;
+	for(int ct = 0; ct < 50000; ct++)
+	{
+		uSeed = uSeed * 1103515245 + 12345;
+		int32_t x = reg.getLowerCorner().getX() + (uSeed >> 8) % simpleVolume.getWidth();
+		uSeed = uSeed * 1103515245 + 12345;
+		int32_t y = reg.getLowerCorner().getY() + (uSeed >> 8) % simpleVolume.getHeight();
+		uSeed = uSeed * 1103515245 + 12345;
+		int32_t z = reg.getLowerCorner().getZ() + (uSeed >> 8) % simpleVolume.getDepth();
+		uint8_t uValue = static_cast<uint8_t>((uSeed >> 20) % 3);
+
+		octreeVolume.setVoxelAt(x, y, z, uValue);
+		simpleVolume.setVoxelAt(x, y, z, uValue);
+	}
+}
+
+void TestOctreeVolume::testReadWrite()
+{
+	Region reg(Vector3DInt32(3,2,5), Vector3DInt32(26,40,30));
+	OctreeVolume<uint8_t> octreeVolume(reg);
+	SimpleVolume<uint8_t> simpleVolume(reg, 8);
+	createRandomData(octreeVolume, simpleVolume);
+
+	bool bAllMatch = true;
+	for(int32_t z = reg.getLowerCorner().getZ() - 1; z <= reg.getUpperCorner().getZ() + 1; z++)
+	{
+		for(int32_t y = reg.getLowerCorner().getY() - 1; y <= reg.getUpperCorner().getY() + 1; y++)
+		{
+			for(int32_t x = reg.getLowerCorner().getX() - 1; x <= reg.getUpperCorner().getX() + 1; x++)
+			{
+				bAllMatch &= (octreeVolume.getVoxelAt(x, y, z) == simpleVolume.getVoxelAt(x, y, z));
+			}
+		}
+	}
+	QVERIFY(bAllMatch);
+
+	//Writes outside the volume must be rejected.
+	QCOMPARE(octreeVolume.setVoxelAt(0, 0, 0, 1), false);
+
+	//Setting everything to the same value again should collapse the tree down to the root.
+	QVERIFY(octreeVolume.getNoOfNodes() > 1);
+	for(int32_t z = reg.getLowerCorner().getZ(); z <= reg.getUpperCorner().getZ(); z++)
+	{
+		for(int32_t y = reg.getLowerCorner().getY(); y <= reg.getUpperCorner().getY(); y++)
+		{
+			for(int32_t x = reg.getLowerCorner().getX(); x <= reg.getUpperCorner().getX(); x++)
+			{
+				octreeVolume.setVoxelAt(x, y, z, 0);
+			}
+		}
+	}
+	QCOMPARE(octreeVolume.getNoOfNodes(), static_cast<uint32_t>(1));
+}
+
+void TestOctreeVolume::testSampler()
+{
+	Region reg(Vector3DInt32(3,2,5), Vector3DInt32(26,40,30));
+	OctreeVolume<uint8_t> octreeVolume(reg);
+	SimpleVolume<uint8_t> simpleVolume(reg, 8);
+	createRandomData(octreeVolume, simpleVolume);
+
+	//Walk the sampler through the volume (and a little way outside it) checking the peeks and subsampled values.
+	bool bAllMatch = true;
+	OctreeVolume<uint8_t>::Sampler sampler(&octreeVolume);
+	for(int32_t z = reg.getLowerCorner().getZ() - 1; z <= reg.getUpperCorner().getZ(); z++)
+	{
+		for(int32_t y = reg.getLowerCorner().getY() - 1; y <= reg.getUpperCorner().getY(); y++)
+		{
+			sampler.setPosition(reg.getLowerCorner().getX() - 1, y, z);
+			for(int32_t x = reg.getLowerCorner().getX() - 1; x <= reg.getUpperCorner().getX(); x++)
+			{
+				bAllMatch &= (sampler.getVoxel() == simpleVolume.getVoxelAt(x, y, z));
+				bAllMatch &= (sampler.peekVoxel1nx1ny1nz() == simpleVolume.getVoxelAt(x-1, y-1, z-1));
+				bAllMatch &= (sampler.peekVoxel1px0py1nz() == simpleVolume.getVoxelAt(x+1, y, z-1));
+				bAllMatch &= (sampler.peekVoxel1px1py1pz() == simpleVolume.getVoxelAt(x+1, y+1, z+1));
+
+				uint8_t uMinimum = simpleVolume.getVoxelAt(x, y, z);
+				for(int32_t iOffset = 1; iOffset < 8; iOffset++)
+				{
+					uMinimum = (std::min)(uMinimum, simpleVolume.getVoxelAt(x + (iOffset & 1), y + ((iOffset >> 1) & 1), z + ((iOffset >> 2) & 1)));
+				}
+				bAllMatch &= (sampler.getSubSampledVoxel(1) == uMinimum);
+
+				sampler.movePositiveX();
+			}
+		}
+	}
+	QVERIFY(bAllMatch);
+}
+
+void TestOctreeVolume::testExtractSurface()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1));
+	Vector3DFloat v3dVolCenter(g_uVolumeSideLength / 2, g_uVolumeSideLength / 2, g_uVolumeSideLength / 2);
+
+	SimpleVolume<MaterialDensityPair44> simpleVolume(reg, 16);
+	createSphereInVolume(simpleVolume, v3dVolCenter, g_uVolumeSideLength / 3.0f);
+	OctreeVolume<MaterialDensityPair44> octreeVolume(reg);
+	createSphereInVolume(octreeVolume, v3dVolCenter, g_uVolumeSideLength / 3.0f);
+
+	SurfaceMesh<PositionMaterialNormal> simpleSmoothMesh, octreeSmoothMesh;
+	SurfaceExtractor<SimpleVolume, MaterialDensityPair44> simpleSurfaceExtractor(&simpleVolume, reg, &simpleSmoothMesh);
+	simpleSurfaceExtractor.execute();
+	SurfaceExtractor<OctreeVolume, MaterialDensityPair44> octreeSurfaceExtractor(&octreeVolume, reg, &octreeSmoothMesh);
+	octreeSurfaceExtractor.execute();
+
+	SurfaceMesh<PositionMaterial> simpleCubicMesh, octreeCubicMesh;
+	CubicSurfaceExtractor<SimpleVolume, MaterialDensityPair44> simpleCubicSurfaceExtractor(&simpleVolume, reg, &simpleCubicMesh);
+	simpleCubicSurfaceExtractor.execute();
+	CubicSurfaceExtractor<OctreeVolume, MaterialDensityPair44> octreeCubicSurfaceExtractor(&octreeVolume, reg, &octreeCubicMesh);
+	octreeCubicSurfaceExtractor.execute();
+
+	//Both volumes must give exactly the same results.
+	QVERIFY(simpleSmoothMesh.getNoOfVertices() > 0);
+	QCOMPARE(octreeSmoothMesh.getNoOfVertices(), simpleSmoothMesh.getNoOfVertices());
+	QVERIFY(octreeSmoothMesh.getIndices() == simpleSmoothMesh.getIndices());
+	QVERIFY(simpleCubicMesh.getNoOfVertices() > 0);
+	QCOMPARE(octreeCubicMesh.getNoOfVertices(), simpleCubicMesh.getNoOfVertices());
+	QVERIFY(octreeCubicMesh.getIndices() == simpleCubicMesh.getIndices());
+
+	//A ray along the x axis should hit the sphere.
+	RaycastResult raycastResult;
+	Raycast<OctreeVolume, MaterialDensityPair44> raycast(&octreeVolume, Vector3DFloat(0, v3dVolCenter.getY(), v3dVolCenter.getZ()), Vector3DFloat(g_uVolumeSideLength, 0, 0), raycastResult);
+	raycast.execute();
+	QVERIFY(raycastResult.foundIntersection);
+	QCOMPARE(raycastResult.intersectionVoxel.getX(), static_cast<int32_t>(v3dVolCenter.getX() - g_uVolumeSideLength / 3.0f + 1.0f));
+
+	//And the pathfinder should be able to walk around it.
+	std::list<Vector3DInt32> listResult;
+	AStarPathfinderParams<OctreeVolume, MaterialDensityPair44> pathfinderParams(&octreeVolume, Vector3DInt32(1, 1, 1), Vector3DInt32(12, 6, 9), &listResult);
+	AStarPathfinder<OctreeVolume, MaterialDensityPair44> pathfinder(pathfinderParams);
+	pathfinder.execute();
+	QVERIFY(listResult.size() > 0);
+	QCOMPARE(listResult.back(), Vector3DInt32(12, 6, 9));
+}
+
+void TestOctreeVolume::testSparseMemoryUsage()
+{
+	//A large volume containing a single small object.
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(1023, 1023, 1023));
+	OctreeVolume<MaterialDensityPair44> octreeVolume(reg);
+	createSphereInVolume(octreeVolume, Vector3DFloat(g_uVolumeSideLength / 2, g_uVolumeSideLength / 2, g_uVolumeSideLength / 2), g_uVolumeSideLength / 3.0f);
+
+	//The empty space should cost next to nothing, so the whole volume should need less than one byte per voxel of the sphere's bounding box.
+	QVERIFY(octreeVolume.calculateSizeInBytes() < static_cast<uint32_t>(g_uVolumeSideLength * g_uVolumeSideLength * g_uVolumeSideLength));
+}
+
+QTEST_MAIN(TestOctreeVolume)
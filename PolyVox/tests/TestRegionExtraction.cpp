@@ -0,0 +1,328 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#include "TestRegionExtraction.h"
+
+#include "PolyVoxCore/CubicSurfaceExtractor.h"
+#include "PolyVoxCore/MaterialDensityPair.h"
+#include "PolyVoxCore/RegionExtraction.h"
+#include "PolyVoxCore/SimpleVolume.h"
+#include "PolyVoxCore/SurfaceExtractor.h"
+
+#include <QtTest>
+
+using namespace PolyVox;
+
+const int32_t g_uVolumeSideLength = 128;
+const int32_t g_uRegionSideLength = 32;
+
+void createNoisySphereInVolume(SimpleVolume<MaterialDensityPair88>& volData)
+{
+	Vector3DFloat v3dVolCenter(g_uVolumeSideLength / 2, g_uVolumeSideLength / 2, g_uVolumeSideLength / 2);
+	const float fRadius = g_uVolumeSideLength / 3.0f;
+
+	for (int32_t z = 0; z < g_uVolumeSideLength; z++)
+	{
+		for (int32_t y = 0; y < g_uVolumeSideLength; y++)
+		{
+			for (int32_t x = 0; x < g_uVolumeSideLength; x++)
+			{
+				float fDistToSurface = fRadius + 4.0f * sin(x * 0.3f) * cos(y * 0.2f) - (Vector3DFloat(x,y,z) - v3dVolCenter).length();
+				int32_t iDensity = (std::max)(0, (std::min)(255, static_cast<int32_t>(128.0f + fDistToSurface * 30.0f)));
+				volData.setVoxelAt(x, y, z, MaterialDensityPair88(1, iDensity));
+			}
+		}
+	}
+}
+
+//Tiles the volume in the same way as Thermite does.
+std::vector<Region> createRegions(void)
+{
+	std::vector<Region> vecRegions;
+	for (int32_t z = 0; z < g_uVolumeSideLength; z += g_uRegionSideLength)
+	{
+		for (int32_t y = 0; y < g_uVolumeSideLength; y += g_uRegionSideLength)
+		{
+			for (int32_t x = 0; x < g_uVolumeSideLength; x += g_uRegionSideLength)
+			{
+				vecRegions.push_back(Region(Vector3DInt32(x, y, z), Vector3DInt32(x + g_uRegionSideLength - 1, y + g_uRegionSideLength - 1, z + g_uRegionSideLength - 1)));
+			}
+		}
+	}
+	return vecRegions;
+}
+
+void TestRegionExtraction::testStableOrder()
+{
+	SimpleVolume<MaterialDensityPair88> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1)));
+	createNoisySphereInVolume(volData);
+	std::vector<Region> vecRegions = createRegions();
+
+	std::vector< SurfaceMesh<PositionMaterialNormal> > vecSmoothMeshes;
+	extractRegions<SurfaceExtractor>(&volData, vecRegions, vecSmoothMeshes, ExtractionPolicy(4));
+	std::vector< SurfaceMesh<PositionMaterial> > vecCubicMeshes;
+	extractRegions<CubicSurfaceExtractor>(&volData, vecRegions, vecCubicMeshes, ExtractionPolicy(4));
+
+	QCOMPARE(vecSmoothMeshes.size(), vecRegions.size());
+	QCOMPARE(vecCubicMeshes.size(), vecRegions.size());
+
+	//Each mesh must be the one which would be extracted for its region on a single thread.
+	uint32_t uNoOfNonEmptyMeshes = 0;
+	for(uint32_t ct = 0; ct < vecRegions.size(); ct++)
+	{
+		SurfaceMesh<PositionMaterialNormal> smoothMesh;
+		SurfaceExtractor<SimpleVolume, MaterialDensityPair88> surfaceExtractor(&volData, vecRegions[ct], &smoothMesh);
+		surfaceExtractor.execute();
+
+		QVERIFY(vecSmoothMeshes[ct].m_Region == vecRegions[ct]);
+		QCOMPARE(vecSmoothMeshes[ct].getNoOfVertices(), smoothMesh.getNoOfVertices());
+		QVERIFY(vecSmoothMeshes[ct].getIndices() == smoothMesh.getIndices());
+
+		SurfaceMesh<PositionMaterial> cubicMesh;
+		CubicSurfaceExtractor<SimpleVolume, MaterialDensityPair88> cubicSurfaceExtractor(&volData, vecRegions[ct], &cubicMesh);
+		cubicSurfaceExtractor.execute();
+
+		QCOMPARE(vecCubicMeshes[ct].getNoOfVertices(), cubicMesh.getNoOfVertices());
+		QVERIFY(vecCubicMeshes[ct].getIndices() == cubicMesh.getIndices());
+
+		if(smoothMesh.getNoOfIndices() > 0)
+		{
+			uNoOfNonEmptyMeshes++;
+		}
+	}
+	QVERIFY(uNoOfNonEmptyMeshes > 0);
+}
+
+//Checks that each region is reported exactly once, and that the count goes up by one each time.
+class ProgressRecorder
+{
+public:
+	ProgressRecorder(uint32_t uNoOfRegions)
+		:m_vecTimesReported(uNoOfRegions, 0)
+		,m_uLastNoOfRegionsCompleted(0)
+		,m_bCountsInOrder(true)
+	{
+	}
+
+	void operator()(uint32_t uRegionIndex, uint32_t uNoOfRegionsCompleted)
+	{
+		m_vecTimesReported[uRegionIndex]++;
+		if(uNoOfRegionsCompleted != m_uLastNoOfRegionsCompleted + 1)
+		{
+			m_bCountsInOrder = false;
+		}
+		m_uLastNoOfRegionsCompleted = uNoOfRegionsCompleted;
+	}
+
+	std::vector<uint32_t> m_vecTimesReported;
+	uint32_t m_uLastNoOfRegionsCompleted;
+	bool m_bCountsInOrder;
+};
+
+void TestRegionExtraction::testProgressCallback()
+{
+	SimpleVolume<MaterialDensityPair88> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1)));
+	createNoisySphereInVolume(volData);
+	std::vector<Region> vecRegions = createRegions();
+
+	ProgressRecorder recorder(vecRegions.size());
+	std::vector< SurfaceMesh<PositionMaterialNormal> > vecMeshes;
+	extractRegions<SurfaceExtractor>(&volData, vecRegions, vecMeshes, ExtractionPolicy(4, std::ref(recorder)));
+
+	QVERIFY(recorder.m_bCountsInOrder);
+	QCOMPARE(recorder.m_uLastNoOfRegionsCompleted, static_cast<uint32_t>(vecRegions.size()));
+	for(uint32_t ct = 0; ct < vecRegions.size(); ct++)
+	{
+		QCOMPARE(recorder.m_vecTimesReported[ct], static_cast<uint32_t>(1));
+	}
+}
+
+void TestRegionExtraction::testExecuteParallel()
+{
+	SimpleVolume<MaterialDensityPair88> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1)));
+	createNoisySphereInVolume(volData);
+
+	//Clear a band so that some of the slab boundaries fall where there is no surface.
+	for (int32_t z = 60; z < 70; z++)
+	{
+		for (int32_t y = 0; y < g_uVolumeSideLength; y++)
+		{
+			for (int32_t x = 0; x < g_uVolumeSideLength; x++)
+			{
+				volData.setVoxelAt(x, y, z, MaterialDensityPair88(0, 0));
+			}
+		}
+	}
+
+	SurfaceMesh<PositionMaterialNormal> sequentialMesh;
+	SurfaceExtractor<SimpleVolume, MaterialDensityPair88> sequentialExtractor(&volData, volData.getEnclosingRegion(), &sequentialMesh);
+	sequentialExtractor.execute();
+	QVERIFY(sequentialMesh.getNoOfIndices() > 0);
+
+	//The slabs are joined up differently depending on how many there are.
+	for(uint32_t uNoOfThreads = 2; uNoOfThreads <= 16; uNoOfThreads += 3)
+	{
+		SurfaceMesh<PositionMaterialNormal> parallelMesh;
+		SurfaceExtractor<SimpleVolume, MaterialDensityPair88> parallelExtractor(&volData, volData.getEnclosingRegion(), &parallelMesh);
+		parallelExtractor.executeParallel(uNoOfThreads);
+
+		QCOMPARE(parallelMesh.getNoOfVertices(), sequentialMesh.getNoOfVertices());
+		QVERIFY(parallelMesh.getIndices() == sequentialMesh.getIndices());
+		for(uint32_t ct = 0; ct < sequentialMesh.getNoOfVertices(); ct++)
+		{
+			QVERIFY(parallelMesh.getVertices()[ct].getPosition() == sequentialMesh.getVertices()[ct].getPosition());
+			QVERIFY(parallelMesh.getVertices()[ct].getNormal() == sequentialMesh.getVertices()[ct].getNormal());
+		}
+	}
+}
+
+void TestRegionExtraction::testSharedContext()
+{
+	SimpleVolume<MaterialDensityPair88> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1)));
+	createNoisySphereInVolume(volData);
+
+	//Regions of assorted sizes, so the buffers sometimes have to grow and are sometimes larger than needed.
+	std::vector<Region> vecRegions = createRegions();
+	vecRegions.push_back(Region(Vector3DInt32(20,30,40), Vector3DInt32(27,90,45)));
+	vecRegions.push_back(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1)));
+	vecRegions.push_back(Region(Vector3DInt32(40,40,40), Vector3DInt32(43,44,100)));
+	vecRegions.push_back(Region(Vector3DInt32(30,60,50), Vector3DInt32(100,70,60)));
+
+	SurfaceExtractor<SimpleVolume, MaterialDensityPair88>::Context smoothContext;
+	CubicSurfaceExtractor<SimpleVolume, MaterialDensityPair88>::Context cubicContext;
+
+	//An extractor using the shared context must give the same mesh as one using its own buffers.
+	uint32_t uNoOfNonEmptyMeshes = 0;
+	for(uint32_t ct = 0; ct < vecRegions.size(); ct++)
+	{
+		SurfaceMesh<PositionMaterialNormal> smoothMesh;
+		SurfaceExtractor<SimpleVolume, MaterialDensityPair88> surfaceExtractor(&volData, vecRegions[ct], &smoothMesh);
+		surfaceExtractor.execute();
+
+		SurfaceMesh<PositionMaterialNormal> sharedSmoothMesh;
+		SurfaceExtractor<SimpleVolume, MaterialDensityPair88> sharedSurfaceExtractor(&volData, vecRegions[ct], &sharedSmoothMesh);
+		sharedSurfaceExtractor.setContext(&smoothContext);
+		sharedSurfaceExtractor.execute();
+
+		QCOMPARE(sharedSmoothMesh.getNoOfVertices(), smoothMesh.getNoOfVertices());
+		QVERIFY(sharedSmoothMesh.getIndices() == smoothMesh.getIndices());
+
+		//Alternate the quad merging, as it decides what is left in the quad lists and how the vertex table is laid out.
+		SurfaceMesh<PositionMaterial> cubicMesh;
+		CubicSurfaceExtractor<SimpleVolume, MaterialDensityPair88> cubicSurfaceExtractor(&volData, vecRegions[ct], &cubicMesh, (ct % 2) == 0);
+		cubicSurfaceExtractor.execute();
+
+		SurfaceMesh<PositionMaterial> sharedCubicMesh;
+		CubicSurfaceExtractor<SimpleVolume, MaterialDensityPair88> sharedCubicSurfaceExtractor(&volData, vecRegions[ct], &sharedCubicMesh, (ct % 2) == 0);
+		sharedCubicSurfaceExtractor.setContext(&cubicContext);
+		sharedCubicSurfaceExtractor.execute();
+
+		QCOMPARE(sharedCubicMesh.getNoOfVertices(), cubicMesh.getNoOfVertices());
+		QVERIFY(sharedCubicMesh.getIndices() == cubicMesh.getIndices());
+
+		if(smoothMesh.getNoOfIndices() > 0)
+		{
+			uNoOfNonEmptyMeshes++;
+		}
+	}
+	QVERIFY(uNoOfNonEmptyMeshes > 0);
+}
+
+void TestRegionExtraction::testReuseResults()
+{
+	SimpleVolume<MaterialDensityPair88> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1)));
+	createNoisySphereInVolume(volData);
+	std::vector<Region> vecRegions = createRegions();
+
+	std::vector< SurfaceMesh<PositionMaterialNormal> > vecMeshes;
+	extractRegions<SurfaceExtractor>(&volData, vecRegions, vecMeshes, ExtractionPolicy(4));
+	std::vector< SurfaceMesh<PositionMaterialNormal> > vecFirstMeshes = vecMeshes;
+
+	std::vector<const PositionMaterialNormal*> vecVertexData;
+	std::vector<const uint32_t*> vecIndexData;
+	for(uint32_t ct = 0; ct < vecMeshes.size(); ct++)
+	{
+		vecVertexData.push_back(vecMeshes[ct].getNoOfVertices() > 0 ? &vecMeshes[ct].getVertices()[0] : 0);
+		vecIndexData.push_back(vecMeshes[ct].getNoOfIndices() > 0 ? &vecMeshes[ct].getIndices()[0] : 0);
+	}
+
+	//Extracting the same regions again into the same meshes gives the same results in the same memory.
+	extractRegions<SurfaceExtractor>(&volData, vecRegions, vecMeshes, ExtractionPolicy(4));
+	uint32_t uNoOfNonEmptyMeshes = 0;
+	for(uint32_t ct = 0; ct < vecMeshes.size(); ct++)
+	{
+		QCOMPARE(vecMeshes[ct].getNoOfVertices(), vecFirstMeshes[ct].getNoOfVertices());
+		QVERIFY(vecMeshes[ct].getIndices() == vecFirstMeshes[ct].getIndices());
+		QCOMPARE(vecMeshes[ct].m_vecLodRecords.size(), static_cast<size_t>(1));
+		if(vecMeshes[ct].getNoOfIndices() > 0)
+		{
+			QVERIFY(&vecMeshes[ct].getVertices()[0] == vecVertexData[ct]);
+			QVERIFY(&vecMeshes[ct].getIndices()[0] == vecIndexData[ct]);
+			uNoOfNonEmptyMeshes++;
+		}
+	}
+	QVERIFY(uNoOfNonEmptyMeshes > 0);
+
+	//Swapping hands over the data without copying it.
+	SurfaceMesh<PositionMaterialNormal> swappedMesh;
+	for(uint32_t ct = 0; ct < vecMeshes.size(); ct++)
+	{
+		if(vecMeshes[ct].getNoOfIndices() > 0)
+		{
+			swappedMesh.swap(vecMeshes[ct]);
+			QVERIFY(vecMeshes[ct].isEmpty());
+			QVERIFY(swappedMesh.m_Region == vecRegions[ct]);
+			QVERIFY(swappedMesh.getIndices() == vecFirstMeshes[ct].getIndices());
+			QVERIFY(&swappedMesh.getVertices()[0] == vecVertexData[ct]);
+			break;
+		}
+	}
+}
+
+void TestRegionExtraction::benchmarkSingleThread()
+{
+	SimpleVolume<MaterialDensityPair88> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1)));
+	createNoisySphereInVolume(volData);
+	std::vector<Region> vecRegions = createRegions();
+
+	QBENCHMARK
+	{
+		std::vector< SurfaceMesh<PositionMaterialNormal> > vecMeshes;
+		extractRegions<SurfaceExtractor>(&volData, vecRegions, vecMeshes, ExtractionPolicy(1));
+	}
+}
+
+void TestRegionExtraction::benchmarkAllThreads()
+{
+	SimpleVolume<MaterialDensityPair88> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1)));
+	createNoisySphereInVolume(volData);
+	std::vector<Region> vecRegions = createRegions();
+
+	QBENCHMARK
+	{
+		std::vector< SurfaceMesh<PositionMaterialNormal> > vecMeshes;
+		extractRegions<SurfaceExtractor>(&volData, vecRegions, vecMeshes);
+	}
+}
+
+QTEST_MAIN(TestRegionExtraction)
@@ -0,0 +1,98 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#include "TestSerialization.h"
+
+#include "PolyVoxCore/Material.h"
+#include "PolyVoxCore/SimpleVolume.h"
+#include "PolyVoxUtil/Serialization.h"
+
+#include <sstream>
+
+#include <QtTest>
+
+using namespace PolyVox;
+
+void TestSerialization::testLoadTruncated()
+{
+	const int32_t iSideLength = 32;
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(iSideLength-1, iSideLength-1, iSideLength-1));
+	SimpleVolume<Material8> volData(reg, 16);
+	for (int32_t z = 0; z < iSideLength; z++)
+	{
+		for (int32_t y = 0; y < iSideLength; y++)
+		{
+			for (int32_t x = 0; x < iSideLength; x++)
+			{
+				volData.setVoxelAt(x, y, z, Material8((x / 3 + y + z * 5) % 7));
+			}
+		}
+	}
+
+	std::stringstream stream;
+	QVERIFY(saveVolume(stream, volData));
+	const std::string strSaved = stream.str();
+
+	//The complete stream should load back the same voxels.
+	SimpleVolume<Material8> loadedVolume(reg, 16);
+	std::istringstream completeStream(strSaved);
+	QVERIFY(loadVolume(completeStream, loadedVolume));
+	for (int32_t z = 0; z < iSideLength; z++)
+	{
+		for (int32_t y = 0; y < iSideLength; y++)
+		{
+			for (int32_t x = 0; x < iSideLength; x++)
+			{
+				QCOMPARE(loadedVolume.getVoxelAt(x, y, z).getMaterial(), volData.getVoxelAt(x, y, z).getMaterial());
+			}
+		}
+	}
+
+	//Streams which stop partway through the dimensions, partway through a run, and just before the last run.
+	//Each of these must fail rather than loop forever waiting for the rest of the data.
+	const std::string::size_type uHeaderSize = 7 + sizeof(uint16_t);
+	const std::string::size_type uTruncatedSizes[] = {uHeaderSize + 3, strSaved.size() / 2, strSaved.size() - sizeof(uint32_t) - sizeof(Material8)};
+	for(int i = 0; i < 3; i++)
+	{
+		std::istringstream truncatedStream(strSaved.substr(0, uTruncatedSizes[i]));
+		QVERIFY(!loadVolume(truncatedStream, loadedVolume));
+	}
+
+	//A run with a length of zero can't fill any voxels, so it is also rejected. This holds for the first run as well as
+	//later ones, even when the runs which follow it would be enough to fill the volume.
+	const std::string::size_type uRunsBegin = uHeaderSize + 3 * sizeof(uint16_t);
+	const Material8 value(1);
+	const uint32_t uZeroLength = 0;
+	std::string strZeroRun;
+	strZeroRun.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	strZeroRun.append(reinterpret_cast<const char*>(&uZeroLength), sizeof(uZeroLength));
+
+	std::istringstream zeroFirstRunStream(strSaved.substr(0, uRunsBegin) + strZeroRun + strSaved.substr(uRunsBegin));
+	QVERIFY(!loadVolume(zeroFirstRunStream, loadedVolume));
+
+	const std::string::size_type uSecondRunBegin = uRunsBegin + sizeof(Material8) + sizeof(uint32_t);
+	std::istringstream zeroSecondRunStream(strSaved.substr(0, uSecondRunBegin) + strZeroRun + strSaved.substr(uSecondRunBegin));
+	QVERIFY(!loadVolume(zeroSecondRunStream, loadedVolume));
+}
+
+QTEST_MAIN(TestSerialization)
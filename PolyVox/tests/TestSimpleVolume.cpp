@@ -0,0 +1,112 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#include "TestSimpleVolume.h"
+
+#include "PolyVoxCore/SimpleVolume.h"
+
+#include <QtTest>
+
+using namespace PolyVox;
+
+void TestSimpleVolume::testLazyAllocation()
+{
+	const uint16_t uBlockSideLength = 16;
+	const uint32_t uBlockSizeInBytes = uBlockSideLength * uBlockSideLength * uBlockSideLength * sizeof(uint16_t);
+	Region reg(Vector3DInt32(3,0,5), Vector3DInt32(66,63,68));
+	SimpleVolume<uint16_t> volData(reg, uBlockSideLength);
+
+	//A new volume only holds the Block objects, the border data and the shared default data.
+	const uint32_t uEmptySize = volData.calculateSizeInBytes();
+	QVERIFY(uEmptySize < uBlockSizeInBytes * 3);
+
+	//Reading, either directly or through a sampler, shouldn't allocate anything.
+	bool bAllDefault = true;
+	SimpleVolume<uint16_t>::Sampler sampler(&volData);
+	for(int32_t z = reg.getLowerCorner().getZ(); z <= reg.getUpperCorner().getZ(); z++)
+	{
+		for(int32_t y = reg.getLowerCorner().getY(); y <= reg.getUpperCorner().getY(); y++)
+		{
+			sampler.setPosition(reg.getLowerCorner().getX(), y, z);
+			for(int32_t x = reg.getLowerCorner().getX(); x <= reg.getUpperCorner().getX(); x++)
+			{
+				bAllDefault &= (volData.getVoxelAt(x, y, z) == 0);
+				bAllDefault &= (sampler.getVoxel() == 0);
+				sampler.movePositiveX();
+			}
+		}
+	}
+	QVERIFY(bAllDefault);
+	QCOMPARE(volData.calculateSizeInBytes(), uEmptySize);
+
+	//The first write to a block allocates just that block, and further writes to it allocate nothing.
+	QVERIFY(volData.setVoxelAt(20, 30, 40, 7));
+	QCOMPARE(volData.calculateSizeInBytes(), uEmptySize + uBlockSizeInBytes);
+	QVERIFY(volData.setVoxelAt(21, 31, 41, 8));
+	QCOMPARE(volData.calculateSizeInBytes(), uEmptySize + uBlockSizeInBytes);
+	QCOMPARE(volData.getVoxelAt(20, 30, 40), static_cast<uint16_t>(7));
+	QCOMPARE(volData.getVoxelAt(21, 31, 41), static_cast<uint16_t>(8));
+	QCOMPARE(volData.getVoxelAt(22, 30, 40), static_cast<uint16_t>(0));
+
+	//Writing through a sampler which points at the shared default data allocates one block in the same way.
+	//The sampler should then point into the new block, so that later reads and writes through it go there.
+	sampler.setPosition(3, 0, 5);
+	QCOMPARE(sampler.getVoxel(), static_cast<uint16_t>(0));
+	QVERIFY(sampler.setVoxel(3));
+	QCOMPARE(volData.calculateSizeInBytes(), uEmptySize + uBlockSizeInBytes * 2);
+	QCOMPARE(sampler.getVoxel(), static_cast<uint16_t>(3));
+	sampler.movePositiveX();
+	QVERIFY(sampler.setVoxel(4));
+	QCOMPARE(volData.calculateSizeInBytes(), uEmptySize + uBlockSizeInBytes * 2);
+	QCOMPARE(volData.getVoxelAt(3, 0, 5), static_cast<uint16_t>(3));
+	QCOMPARE(volData.getVoxelAt(4, 0, 5), static_cast<uint16_t>(4));
+
+	//The shared default data must not have been changed by any of this.
+	QCOMPARE(volData.getVoxelAt(0, 0, 60), static_cast<uint16_t>(0));
+}
+
+void TestSimpleVolume::testResize()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(63,63,63));
+	SimpleVolume<uint16_t> volData(reg, 16);
+	const uint32_t uEmptySize = volData.calculateSizeInBytes();
+	for(int32_t z = 0; z < 64; z += 16)
+	{
+		volData.setVoxelAt(z, z, z, 9);
+	}
+	QVERIFY(volData.calculateSizeInBytes() > uEmptySize);
+
+	//Resizing discards the old blocks, so the volume should be back to its empty size and hold default voxels.
+	volData.resize(reg, 16);
+	QCOMPARE(volData.calculateSizeInBytes(), uEmptySize);
+	QCOMPARE(volData.getVoxelAt(16, 16, 16), static_cast<uint16_t>(0));
+
+	//And it should work with a different size and block size.
+	Region regSmaller(Vector3DInt32(0,0,0), Vector3DInt32(31,31,31));
+	volData.resize(regSmaller, 8);
+	QVERIFY(volData.setVoxelAt(31, 31, 31, 5));
+	QCOMPARE(volData.getVoxelAt(31, 31, 31), static_cast<uint16_t>(5));
+	QCOMPARE(volData.getVoxelAt(30, 31, 31), static_cast<uint16_t>(0));
+}
+
+QTEST_MAIN(TestSimpleVolume)
@@ -0,0 +1,199 @@
+/*******************************************************************************
+Copyright (c) 2010 Matt Williams
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source
+    distribution.
+*******************************************************************************/
+
+#include "TestSpanIterator.h"
+
+#include "PolyVoxCore/LargeVolume.h"
+#include "PolyVoxCore/LowPassFilter.h"
+#include "PolyVoxCore/Material.h"
+#include "PolyVoxCore/MaterialDensityPair.h"
+#include "PolyVoxCore/OctreeVolume.h"
+#include "PolyVoxCore/SimpleVolume.h"
+#include "PolyVoxCore/SpanIterator.h"
+
+#include <QtTest>
+
+using namespace PolyVox;
+
+const int32_t g_uVolumeSideLength = 64;
+
+uint8_t expectedMaterial(int32_t x, int32_t y, int32_t z)
+{
+	return ((x * 7 + y * 3 + z * 11) % 5 == 0) ? ((x + y + z) % 200) + 1 : 0;
+}
+
+template< template<typename> class VolumeType >
+void fillVolume(VolumeType<Material8>& volData)
+{
+	for (int32_t z = 0; z < g_uVolumeSideLength; z++)
+	{
+		for (int32_t y = 0; y < g_uVolumeSideLength; y++)
+		{
+			for (int32_t x = 0; x < g_uVolumeSideLength; x++)
+			{
+				volData.setVoxelAt(x, y, z, Material8(expectedMaterial(x, y, z)));
+			}
+		}
+	}
+}
+
+//Checks that the spans cover the region in order, and that they hold the same voxels as getVoxelAt().
+template< template<typename> class VolumeType >
+bool checkSpans(VolumeType<Material8>& volData, const Region& reg)
+{
+	int32_t iExpectedX = reg.getLowerCorner().getX();
+	int32_t iExpectedY = reg.getLowerCorner().getY();
+	int32_t iExpectedZ = reg.getLowerCorner().getZ();
+	int32_t iVoxelCount = 0;
+
+	for(ConstSpanIterator<VolumeType, Material8> iter(&volData, reg); iter.isValid(); iter.moveForward())
+	{
+		if((iter.getPosX() != iExpectedX) || (iter.getPosY() != iExpectedY) || (iter.getPosZ() != iExpectedZ) || (iter.getLength() <= 0))
+		{
+			return false;
+		}
+
+		for(int32_t i = 0; i < iter.getLength(); i++)
+		{
+			if(iter.getSpan()[i] != volData.getVoxelAt(iExpectedX + i, iExpectedY, iExpectedZ))
+			{
+				return false;
+			}
+		}
+		iVoxelCount += iter.getLength();
+
+		iExpectedX += iter.getLength();
+		if(iExpectedX > reg.getUpperCorner().getX())
+		{
+			iExpectedX = reg.getLowerCorner().getX();
+			iExpectedY++;
+			if(iExpectedY > reg.getUpperCorner().getY())
+			{
+				iExpectedY = reg.getLowerCorner().getY();
+				iExpectedZ++;
+			}
+		}
+	}
+
+	Vector3DInt32 v3dSize = reg.getUpperCorner() - reg.getLowerCorner() + Vector3DInt32(1, 1, 1);
+	return iVoxelCount == v3dSize.getX() * v3dSize.getY() * v3dSize.getZ();
+}
+
+//Overwrites the region through a SpanIterator and checks that only the region changed.
+template< template<typename> class VolumeType >
+bool checkWrite(VolumeType<Material8>& volData, const Region& reg)
+{
+	for(SpanIterator<VolumeType, Material8> iter(&volData, reg); iter.isValid(); iter.moveForward())
+	{
+		Material8* pVoxels = iter.getSpan();
+		for(int32_t i = 0; i < iter.getLength(); i++)
+		{
+			pVoxels[i] = Material8((iter.getPosX() + i + iter.getPosY() * 2 + iter.getPosZ()) % 250);
+		}
+	}
+
+	for (int32_t z = 0; z < g_uVolumeSideLength; z++)
+	{
+		for (int32_t y = 0; y < g_uVolumeSideLength; y++)
+		{
+			for (int32_t x = 0; x < g_uVolumeSideLength; x++)
+			{
+				uint8_t uExpected = reg.containsPoint(Vector3DInt32(x, y, z)) ? (x + y * 2 + z) % 250 : expectedMaterial(x, y, z);
+				if(volData.getVoxelAt(x, y, z).getMaterial() != uExpected)
+				{
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+void TestSpanIterator::testRead()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1));
+
+	//A region which starts and ends partway through blocks, and which extends outside the volume.
+	Region regSpans(Vector3DInt32(-5, 3, -2), Vector3DInt32(g_uVolumeSideLength + 4, g_uVolumeSideLength - 3, g_uVolumeSideLength + 1));
+
+	SimpleVolume<Material8> simpleVolume(reg, 16);
+	fillVolume(simpleVolume);
+	QVERIFY(checkSpans(simpleVolume, regSpans));
+
+	LargeVolume<Material8> largeVolume(reg, 0, 0, false, 16);
+	largeVolume.setMaxNumberOfUncompressedBlocks(4);
+	fillVolume(largeVolume);
+	QVERIFY(checkSpans(largeVolume, regSpans));
+
+	//The OctreeVolume doesn't store voxels contiguously, so this exercises the buffered path.
+	OctreeVolume<Material8> octreeVolume(reg);
+	fillVolume(octreeVolume);
+	QVERIFY(checkSpans(octreeVolume, regSpans));
+}
+
+void TestSpanIterator::testWrite()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1));
+	Region regSpans(Vector3DInt32(3, 5, 7), Vector3DInt32(g_uVolumeSideLength - 2, g_uVolumeSideLength / 2, g_uVolumeSideLength - 6));
+
+	SimpleVolume<Material8> simpleVolume(reg, 16);
+	fillVolume(simpleVolume);
+	QVERIFY(checkWrite(simpleVolume, regSpans));
+
+	//With compression enabled and only a few uncompressed blocks, modified blocks get compressed while we write.
+	LargeVolume<Material8> largeVolume(reg, 0, 0, false, 16);
+	largeVolume.setCompressionEnabled(true);
+	largeVolume.setMaxNumberOfUncompressedBlocks(4);
+	fillVolume(largeVolume);
+	QVERIFY(checkWrite(largeVolume, regSpans));
+
+	OctreeVolume<Material8> octreeVolume(reg);
+	fillVolume(octreeVolume);
+	QVERIFY(checkWrite(octreeVolume, regSpans));
+}
+
+void TestSpanIterator::benchmarkLowPassFilter()
+{
+	Region reg(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1));
+	SimpleVolume<MaterialDensityPair88> volData(reg, 32);
+	for (int32_t z = 0; z < g_uVolumeSideLength; z++)
+	{
+		for (int32_t y = 0; y < g_uVolumeSideLength; y++)
+		{
+			for (int32_t x = 0; x < g_uVolumeSideLength; x++)
+			{
+				volData.setVoxelAt(x, y, z, MaterialDensityPair88(1, (x * 13 + y * 7 + z) % 256));
+			}
+		}
+	}
+
+	SimpleVolume<MaterialDensityPair88> resultVolume(reg, 32);
+
+	QBENCHMARK
+	{
+		LowPassFilter<SimpleVolume, SimpleVolume, MaterialDensityPair88> lowPassFilter(&volData, reg, &resultVolume, reg, 3);
+		lowPassFilter.execute();
+	}
+}
+
+QTEST_MAIN(TestSpanIterator)
@@ -50,4 +50,43 @@ void TestVolume::testSize()
 	QCOMPARE(volData.getDepth(), g_uVolumeSideLength);
 }
 
+void TestVolume::testTidy()
+{
+	const int32_t g_uVolumeSideLength = 64;
+	LargeVolume<uint8_t> volData(Region(Vector3DInt32(0,0,0), Vector3DInt32(g_uVolumeSideLength-1, g_uVolumeSideLength-1, g_uVolumeSideLength-1)));
+
+	//Write some noise and then overwrite it with a single value, leaving uniform blocks behind.
+	for (int32_t z = 0; z < g_uVolumeSideLength; z++)
+	{
+		for (int32_t y = 0; y < g_uVolumeSideLength; y++)
+		{
+			for (int32_t x = 0; x < g_uVolumeSideLength; x++)
+			{
+				volData.setVoxelAt(x,y,z,(x+y+z) % 7);
+			}
+		}
+	}
+	for (int32_t z = 0; z < g_uVolumeSideLength; z++)
+	{
+		for (int32_t y = 0; y < g_uVolumeSideLength; y++)
+		{
+			for (int32_t x = 0; x < g_uVolumeSideLength; x++)
+			{
+				volData.setVoxelAt(x,y,z,3);
+			}
+		}
+	}
+
+	uint32_t uSizeBefore = volData.calculateSizeInBytes();
+	uint32_t uReclaimed = volData.tidy(1000, 0);
+	uint32_t uSizeAfter = volData.calculateSizeInBytes();
+
+	QVERIFY(uReclaimed > 0);
+	QVERIFY(uSizeAfter < uSizeBefore);
+
+	//A second pass has nothing left to do, and the data must be unchanged.
+	QCOMPARE(volData.tidy(1000, 0), static_cast<uint32_t>(0));
+	QCOMPARE(volData.getVoxelAt(17,42,63), static_cast<uint8_t>(3));
+}
+
 QTEST_MAIN(TestVolume)
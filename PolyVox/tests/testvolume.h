@@ -32,6 +32,7 @@ class TestVolume: public QObject
 	
 	private slots:
 		void testSize();
+		void testTidy();
 };
 
 #endif
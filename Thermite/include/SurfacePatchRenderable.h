@@ -31,6 +31,29 @@ freely, subject to the following restrictions:
 
 namespace Thermite
 {
+	class SurfacePatchRenderable;
+
+	//Draws one range of the indices of a SurfacePatchRenderable. The renderable draws the first of the
+	//ranges which can be seen itself, and uses these for the others. They share its vertices and indices.
+	class SurfacePatchIndexRange : public Ogre::Renderable
+	{
+	public:
+		SurfacePatchIndexRange(SurfacePatchRenderable* pParent);
+		~SurfacePatchIndexRange(void);
+
+		const Ogre::LightList& getLights(void) const;
+		const Ogre::MaterialPtr& getMaterial(void) const;
+		void getRenderOperation(Ogre::RenderOperation& op);
+		Ogre::Real getSquaredViewDepth(const Ogre::Camera *cam) const;
+		void getWorldTransforms( Ogre::Matrix4* xform ) const;
+
+		void setRange(const PolyVox::LodRecord& range);
+
+	private:
+		SurfacePatchRenderable* m_pParent;
+		Ogre::IndexData* m_pIndexData;
+	};
+
 	//IDEA - If profiling identifies this class as a bottleneck, we could implement a memory pooling system.
 	//All buffers could be powers of two, and we get the smallest one which is big enough for our needs.
 	//See http://www.ogre3d.org/wiki/index.php/DynamicGrowingBuffers
@@ -57,14 +80,17 @@ namespace Thermite
 		void setMaterial( const Ogre::String& matName );
 		void setWorldTransform( const Ogre::Matrix4& xform );
 		
+		virtual void _notifyCurrentCamera(Ogre::Camera* cam);
 		virtual void _updateRenderQueue(Ogre::RenderQueue* queue);
 		void visitRenderables(Ogre::Renderable::Visitor* visitor, bool debugRenderables = false);
 
 		static Ogre::Real* addVertex(const PolyVox::PositionMaterialNormal& vertex, float alpha, Ogre::Real* prPos);
-		void buildRenderOperationFrom(PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal>& mesh, bool bSingleMaterial);
-		void buildRenderOperationFrom(PolyVox::SurfaceMesh<PolyVox::PositionMaterial>& mesh);
+		void buildRenderOperationFrom(const PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal>& mesh, bool bSingleMaterial);
+		void buildRenderOperationFrom(const PolyVox::SurfaceMesh<PolyVox::PositionMaterial>& mesh);
 
 	protected:
+		friend class SurfacePatchIndexRange;
+
 		Ogre::RenderOperation* m_RenderOp;
 		Ogre::Matrix4 m_matWorldTransform;
 		Ogre::AxisAlignedBox mBox;
@@ -79,6 +105,16 @@ namespace Thermite
 
 		std::vector<PolyVox::LodRecord> m_vecLodRecords;
 
+		//Simplified meshes can have several levels of detail. Coarser ones are drawn once the camera is this far from the region.
+		float m_fLodDistance;
+
+		//Cubic meshes keep the faces pointing in each direction together, so only the directions which
+		//can face the current camera are drawn. These are the ranges of indices for those directions.
+		PolyVox::Region m_regMesh;
+		std::vector<PolyVox::LodRecord> m_vecFacingRecords;
+		std::vector<PolyVox::LodRecord> m_vecVisibleRanges;
+		std::vector<SurfacePatchIndexRange*> m_vecIndexRanges;
+
 		mutable Ogre::LightList list;
 	};
 
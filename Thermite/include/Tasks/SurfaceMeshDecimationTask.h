@@ -30,11 +30,14 @@ freely, subject to the following restrictions:
 namespace Thermite
 {
 
+	//Simplifies a mesh which has already been extracted. The task works on its own copy of the input mesh, so the original
+	//can be replaced while the task is queued. The simplified mesh is written to m_meshResult, and it is up to the receiver
+	//of finished() to use it.
 	class SurfaceMeshDecimationTask : public Task
 	{
 		Q_OBJECT
 	public:
-		SurfaceMeshDecimationTask(PolyVox::SurfaceMesh<PolyVox::PositionMaterial>* mesh, uint32_t uTimeStamp);
+		SurfaceMeshDecimationTask(const PolyVox::SurfaceMesh<PolyVox::PositionMaterial>& mesh, uint32_t uTimeStamp, float fMaxError, uint32_t uNoOfLodLevels, bool bOptimiseMesh);
 
 		void run(void);
 
@@ -42,8 +45,16 @@ namespace Thermite
 		void finished(SurfaceMeshDecimationTask* mesh);
 
 	public:
-		PolyVox::SurfaceMesh<PolyVox::PositionMaterial>* mMesh;
+		PolyVox::SurfaceMesh<PolyVox::PositionMaterial> m_meshInput;
+		PolyVox::SurfaceMesh<PolyVox::PositionMaterial> m_meshResult;
 		uint32_t m_uTimeStamp;
+		float m_fMaxError;
+		uint32_t m_uNoOfLodLevels;
+
+		//As for the SurfaceMeshExtractionTask.
+		bool m_bOptimiseMesh;
+		float m_fCacheMissRatioBefore;
+		float m_fCacheMissRatioAfter;
 	};
 }
 
@@ -38,7 +38,7 @@ namespace Thermite
 	{
 		Q_OBJECT
 	public:
-		SurfaceMeshExtractionTask(PolyVox::SimpleVolume<PolyVox::Material16>* volume, PolyVox::Region regToProcess, uint32_t uTimeStamp);
+		SurfaceMeshExtractionTask(PolyVox::SimpleVolume<PolyVox::Material16>* volume, PolyVox::Region regToProcess, uint32_t uTimeStamp, bool bOptimiseMesh);
 
 		void run(void);
 
@@ -50,6 +50,12 @@ namespace Thermite
 		PolyVox::SurfaceMesh<PolyVox::PositionMaterial> m_meshResult;
 		PolyVox::SimpleVolume<PolyVox::Material16>* mVolume;
 		uint32_t m_uTimeStamp;
+
+		//If set, the mesh is reordered for the vertex cache once it has been extracted. The
+		//average cache miss ratios from before and after are kept so they can be reported.
+		bool m_bOptimiseMesh;
+		float m_fCacheMissRatioBefore;
+		float m_fCacheMissRatioAfter;
 	};
 }
 
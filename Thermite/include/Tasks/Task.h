@@ -24,6 +24,7 @@ freely, subject to the following restrictions:
 #ifndef __THERMITE_TASK_H__
 #define __THERMITE_TASK_H__
 
+#include <QAtomicInt>
 #include <QObject>
 #include <QRunnable>
 
@@ -32,6 +33,20 @@ namespace Thermite
 	class Task : public QObject, public QRunnable
 	{
 		Q_OBJECT
+	public:
+		Task(void);
+
+		//Asks the task not to do its work, for when the result is no longer wanted. Can be called from any thread.
+		//A task which has already started may still finish, so whoever handles the result should check as well.
+		void cancel(void);
+		bool isCancelled(void) const;
+
+	public:
+		//How long run() spent doing the work, in milliseconds.
+		int m_iElapsedTime;
+
+	private:
+		QAtomicInt m_iCancelled;
 	};
 }
 
@@ -29,6 +29,7 @@ freely, subject to the following restrictions:
 #include "ThermiteForwardDeclarations.h"
 
 #include "PolyVoxCore/Array.h"
+#include "PolyVoxCore/DensityPyramid.h"
 #include "PolyVoxCore/PolyVoxForwardDeclarations.h"
 #include "PolyVoxCore/Region.h"
 #include "PolyVoxCore/SimpleVolume.h"
@@ -37,6 +38,8 @@ freely, subject to the following restrictions:
 #include "OgreTexture.h"
 
 #include <QVariantList>
+#include <QVariantMap>
+#include <QVector3D>
 
 #include <map>
 #include <set>
@@ -50,6 +53,26 @@ namespace Thermite
 		Q_OBJECT
 
 	public:
+		//Decides which regions have their meshes simplified after they have been extracted.
+		enum DecimationPolicy
+		{
+			DecimateNone,
+			DecimateAll,
+			DecimateDistantRegions, //Regions at least mDecimationDistance from the camera.
+			DecimateLargeMeshes //Meshes with at least mDecimationMinTriangles triangles.
+		};
+
+		//Running totals for one stage of the surface pipeline. Results which
+		//were thrown away because the region changed count as cancellations.
+		struct StageTiming
+		{
+			StageTiming() : mNoOfRuns(0), mNoOfCancellations(0), mTotalTime(0) {}
+
+			uint32_t mNoOfRuns;
+			uint32_t mNoOfCancellations;
+			qint64 mTotalTime; //In milliseconds.
+		};
+
 		Volume(uint32_t width, uint32_t height, uint32_t depth, Object* parent = 0);
 		~Volume(void);
 
@@ -68,10 +91,10 @@ namespace Thermite
 	public slots:
 
 		void uploadSurfaceMesh(const PolyVox::SurfaceMesh<PolyVox::PositionMaterial>& mesh, PolyVox::Region region, Volume& volume);		
-		void addSurfacePatchRenderable(std::string materialName, PolyVox::SurfaceMesh<PolyVox::PositionMaterial>& mesh, PolyVox::Region region);
+		void addSurfacePatchRenderable(std::string materialName, const PolyVox::SurfaceMesh<PolyVox::PositionMaterial>& mesh, PolyVox::Region region);
 
 		void uploadSurfaceMesh(const PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal>& mesh, PolyVox::Region region, Volume& volume);		
-		void addSurfacePatchRenderable(std::string materialName, PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal>& mesh, PolyVox::Region region);
+		void addSurfacePatchRenderable(std::string materialName, const PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal>& mesh, PolyVox::Region region);
 
 		//Deletes all children (both nodes and attached objects) but not the node itself.
 		void deleteSceneNodeChildren(Ogre::SceneNode* sceneNode);
@@ -92,6 +115,11 @@ namespace Thermite
 		void uploadSurfaceExtractorResult(SurfaceMeshExtractionTask* pTask);
 		void uploadSurfaceDecimatorResult(SurfaceMeshDecimationTask* pTask);
 
+		//The number of runs, cancellations and total time in milliseconds of the extraction, decimation and upload stages,
+		//and the average cache miss ratios of the meshes which have been optimised, from before and after optimisation.
+		QVariantMap getStageTimings(void) const;
+		void resetStageTimings(void);
+
 	public:
 		//static TaskProcessorThread* m_backgroundThread;
 
@@ -107,6 +135,7 @@ namespace Thermite
 		bool mMultiThreadedSurfaceExtraction;
 
 		PolyVox::SimpleVolume<PolyVox::Material16>* m_pPolyVoxVolume;
+		PolyVox::DensityPyramid<PolyVox::SimpleVolume, PolyVox::Material16>* m_pDensityPyramid;
 		uint16_t mRegionSideLength;
 		uint16_t mVolumeWidthInRegions;
 		uint16_t mVolumeHeightInRegions;
@@ -122,11 +151,33 @@ namespace Thermite
 		PolyVox::Array<3, bool> mRegionBeingExtracted;
 		PolyVox::Array<3, SurfaceMeshDecimationTask*> m_volSurfaceDecimators;
 
+		DecimationPolicy mDecimationPolicy;
+		float mDecimationDistance;
+		uint32_t mDecimationMinTriangles;
+		float mDecimationMaxError;
+		uint32_t mNoOfLodLevels;
+		float mLodDistance;
+		QVector3D mLastCameraPosition;
+
+		bool mOptimiseMeshes;
+		uint32_t mNoOfOptimisedMeshes;
+		double mTotalCacheMissRatioBefore;
+		double mTotalCacheMissRatioAfter;
+
+		StageTiming mExtractionTiming;
+		StageTiming mDecimationTiming;
+		StageTiming mUploadTiming;
+
 		bool mIsModified;
 
 	public:
 		bool isRegionBeingExtracted(const PolyVox::Region& regionToTest);
 		void updateLastModifedArray(const PolyVox::Region& regionToTest);
+
+	private:
+		bool isWorthDecimating(const PolyVox::SurfaceMesh<PolyVox::PositionMaterial>& mesh) const;
+		void cancelDecimation(uint16_t regionX, uint16_t regionY, uint16_t regionZ);
+		void addCacheMissRatios(float fBefore, float fAfter);
 	};	
 }
 
@@ -37,8 +37,54 @@ using namespace Ogre;
 
 namespace Thermite
 {
+	SurfacePatchIndexRange::SurfacePatchIndexRange(SurfacePatchRenderable* pParent)
+		:m_pParent(pParent)
+		,m_pIndexData(new IndexData())
+	{
+	}
+
+	SurfacePatchIndexRange::~SurfacePatchIndexRange(void)
+	{
+		//The index buffer is shared with the parent, but is reference counted.
+		delete m_pIndexData;
+	}
+
+	const Ogre::LightList& SurfacePatchIndexRange::getLights(void) const
+	{
+		return m_pParent->getLights();
+	}
+
+	const Ogre::MaterialPtr& SurfacePatchIndexRange::getMaterial(void) const
+	{
+		return m_pParent->getMaterial();
+	}
+
+	void SurfacePatchIndexRange::getRenderOperation(Ogre::RenderOperation& op)
+	{
+		op = *(m_pParent->m_RenderOp);
+		op.indexData = m_pIndexData;
+	}
+
+	Real SurfacePatchIndexRange::getSquaredViewDepth(const Camera *cam) const
+	{
+		return m_pParent->getSquaredViewDepth(cam);
+	}
+
+	void SurfacePatchIndexRange::getWorldTransforms( Ogre::Matrix4* xform ) const
+	{
+		m_pParent->getWorldTransforms(xform);
+	}
+
+	void SurfacePatchIndexRange::setRange(const PolyVox::LodRecord& range)
+	{
+		m_pIndexData->indexBuffer = m_pParent->m_RenderOp->indexData->indexBuffer;
+		m_pIndexData->indexStart = range.beginIndex;
+		m_pIndexData->indexCount = range.endIndex - range.beginIndex;
+	}
+
 	SurfacePatchRenderable::SurfacePatchRenderable(const String& strName)
 		:m_RenderOp(0)
+		,m_fLodDistance(0.0f)
 	{
 		mName = strName;
 		m_matWorldTransform = Ogre::Matrix4::IDENTITY;
@@ -53,6 +99,11 @@ namespace Thermite
 
 	SurfacePatchRenderable::~SurfacePatchRenderable(void)
 	{
+		for(std::vector<SurfacePatchIndexRange*>::iterator iter = m_vecIndexRanges.begin(); iter != m_vecIndexRanges.end(); iter++)
+		{
+			delete *iter;
+		}
+
 		if(m_RenderOp)
 		{
 			delete m_RenderOp->vertexData;
@@ -187,6 +238,22 @@ namespace Thermite
 		m_matWorldTransform = xform;
 	}
 
+	void SurfacePatchRenderable::_notifyCurrentCamera(Ogre::Camera* cam)
+	{
+		MovableObject::_notifyCurrentCamera(cam);
+
+		//The mesh is positioned relative to the lower corner of its region.
+		Ogre::Matrix4 matWorld;
+		getWorldTransforms(&matWorld);
+		Ogre::Vector3 v3dCameraPos = matWorld.inverseAffine() * cam->getDerivedPosition();
+		Vector3DFloat v3dViewPosition(v3dCameraPos.x, v3dCameraPos.y, v3dCameraPos.z);
+		v3dViewPosition += static_cast<Vector3DFloat>(m_regMesh.getLowerCorner());
+
+		uint32_t uLodLevel = selectLodLevel(m_regMesh, v3dViewPosition, m_vecLodRecords.size(), m_fLodDistance);
+		uint32_t uDirections = getVisibleFacingDirections(m_regMesh, v3dViewPosition);
+		getLodIndexRanges(m_vecFacingRecords, m_vecLodRecords, uLodLevel, uDirections, m_vecVisibleRanges);
+	}
+
 	void SurfacePatchRenderable::_updateRenderQueue(RenderQueue* queue)
 	{
 		if(m_RenderOp)
@@ -195,11 +262,30 @@ namespace Thermite
 			//patches can be added afterwards using additive blending.
 			if(isSingleMaterial())
 			{
-				PolyVox::LodRecord lodRecord = m_vecLodRecords[0];
+				//Only the faces which can point towards the camera are drawn. This renderable
+				//draws the first range which is needed, and any others have their own.
+				if(m_vecVisibleRanges.empty())
+				{
+					return;
+				}
+
+				PolyVox::LodRecord lodRecord = m_vecVisibleRanges[0];
 				m_RenderOp->indexData->indexStart = lodRecord.beginIndex;
 				m_RenderOp->indexData->indexCount = lodRecord.endIndex - lodRecord.beginIndex;
 
 				queue->addRenderable( this, mRenderQueueID, RENDER_QUEUE_MAIN); 
+
+				for(uint32_t uRange = 1; uRange < m_vecVisibleRanges.size(); uRange++)
+				{
+					if(m_vecIndexRanges.size() < uRange)
+					{
+						m_vecIndexRanges.push_back(new SurfacePatchIndexRange(this));
+					}
+
+					SurfacePatchIndexRange* pIndexRange = m_vecIndexRanges[uRange - 1];
+					pIndexRange->setRange(m_vecVisibleRanges[uRange]);
+					queue->addRenderable( pIndexRange, mRenderQueueID, RENDER_QUEUE_MAIN); 
+				}
 			}
 			else
 			{
@@ -211,6 +297,11 @@ namespace Thermite
 	void SurfacePatchRenderable::visitRenderables(Ogre::Renderable::Visitor* visitor, bool debugRenderables)
 	{
 		visitor->visit(this, 0, false);
+
+		for(std::vector<SurfacePatchIndexRange*>::iterator iter = m_vecIndexRanges.begin(); iter != m_vecIndexRanges.end(); iter++)
+		{
+			visitor->visit(*iter, 0, false);
+		}
 	}
 
 	Real* SurfacePatchRenderable::addVertex(const PositionMaterialNormal& vertex, float alpha, Real* prPos)
@@ -230,7 +321,7 @@ namespace Thermite
 		return prPos;
 	}
 
-	void SurfacePatchRenderable::buildRenderOperationFrom(SurfaceMesh<PositionMaterial>& mesh)
+	void SurfacePatchRenderable::buildRenderOperationFrom(const SurfaceMesh<PositionMaterial>& mesh)
 	{
 		if(mesh.isEmpty())
 		{
@@ -239,6 +330,8 @@ namespace Thermite
 		}
 
 		m_vecLodRecords = mesh.m_vecLodRecords;
+		m_vecFacingRecords = mesh.m_vecFacingRecords;
+		m_regMesh = mesh.m_Region;
 
 		m_bIsSingleMaterial = true;
 
@@ -267,6 +360,9 @@ namespace Thermite
 		renderOperation->vertexData->vertexCount = vecVertices.size();
 		renderOperation->indexData->indexCount = vecIndices.size();	
 
+		//Region meshes almost always have few enough vertices for 16 bit indices, which halves the size of the index buffer.
+		const bool b16BitIndices = canUse16BitIndices(vecVertices.size());
+
 		VertexBufferBinding *bind = renderOperation->vertexData->vertexBufferBinding;
 
 		HardwareVertexBufferSharedPtr vbuf =
@@ -280,7 +376,7 @@ namespace Thermite
 
 		HardwareIndexBufferSharedPtr ibuf =
 			HardwareBufferManager::getSingleton().createIndexBuffer(
-			HardwareIndexBuffer::IT_32BIT, // type of index
+			b16BitIndices ? HardwareIndexBuffer::IT_16BIT : HardwareIndexBuffer::IT_32BIT, // type of index
 			renderOperation->indexData->indexCount, // number of indexes
 			HardwareBuffer::HBU_STATIC_WRITE_ONLY, // usage
 			false); // no shadow buffer	
@@ -290,8 +386,15 @@ namespace Thermite
 		Real *prPos = static_cast<Real*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
 		memcpy(prPos, &vecVertices[0], sizeof(PositionMaterial) * vecVertices.size());
 
-		unsigned long* pIdx = static_cast<unsigned long*>(ibuf->lock(HardwareBuffer::HBL_DISCARD));
-		memcpy(pIdx, &vecIndices[0], sizeof(uint32_t) * vecIndices.size());
+		if(b16BitIndices)
+		{
+			packIndicesTo16Bit(vecIndices, static_cast<uint16_t*>(ibuf->lock(HardwareBuffer::HBL_DISCARD)));
+		}
+		else
+		{
+			uint32_t* pIdx = static_cast<uint32_t*>(ibuf->lock(HardwareBuffer::HBL_DISCARD));
+			memcpy(pIdx, &vecIndices[0], sizeof(uint32_t) * vecIndices.size());
+		}
 
 		ibuf->unlock();
 		vbuf->unlock();
@@ -299,7 +402,7 @@ namespace Thermite
 		m_RenderOp = renderOperation;
 	}
 
-	void SurfacePatchRenderable::buildRenderOperationFrom(SurfaceMesh<PositionMaterialNormal>& mesh, bool bSingleMaterial)
+	void SurfacePatchRenderable::buildRenderOperationFrom(const SurfaceMesh<PositionMaterialNormal>& mesh, bool bSingleMaterial)
 	{
 		if(mesh.isEmpty())
 		{
@@ -314,6 +417,8 @@ namespace Thermite
 		}
 
 		m_vecLodRecords = mesh.m_vecLodRecords;
+		m_vecFacingRecords = mesh.m_vecFacingRecords;
+		m_regMesh = mesh.m_Region;
 
 		m_bIsSingleMaterial = bSingleMaterial;
 
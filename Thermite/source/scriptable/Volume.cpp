@@ -31,7 +31,7 @@ freely, subject to the following restrictions:
 
 #include "PolyVoxCore/Material.h"
 
-#include "PolyVoxCore/Raycast.h"
+#include "PolyVoxCore/HierarchicalRaycast.h"
 
 #include "Utility.h"
 
@@ -44,10 +44,13 @@ freely, subject to the following restrictions:
 #include "OgreSceneManager.h"
 #include "OgreSceneNode.h"
 
+#include <QElapsedTimer>
 #include <QFile>
 #include <QSettings>
 #include <QThreadPool>
 
+#include <limits>
+
 using namespace PolyVox;
 
 namespace Thermite
@@ -57,6 +60,7 @@ namespace Thermite
 	Volume::Volume(uint32_t width, uint32_t height, uint32_t depth, Object* parent)
 		:QObject(parent)
 		,m_pPolyVoxVolume(0)
+		,m_pDensityPyramid(0)
 		,mVolumeWidthInRegions(0)
 		,mVolumeHeightInRegions(0)
 		,mVolumeDepthInRegions(0)
@@ -66,6 +70,16 @@ namespace Thermite
 		,mCachedVolumeDepthInRegions(0)
 
 		,mVolumeSceneNode(0)
+		,mDecimationPolicy(DecimateLargeMeshes)
+		,mDecimationDistance(128.0f)
+		,mDecimationMinTriangles(1000)
+		,mDecimationMaxError(1.0f)
+		,mNoOfLodLevels(3)
+		,mLodDistance(64.0f)
+		,mOptimiseMeshes(true)
+		,mNoOfOptimisedMeshes(0)
+		,mTotalCacheMissRatioBefore(0.0)
+		,mTotalCacheMissRatioAfter(0.0)
 		,mIsModified(true)
 	{
 		/*m_mapMaterialIds["ShadowMapReceiverForWorldMaterial"].insert(1);
@@ -89,6 +103,30 @@ namespace Thermite
 		//	m_backgroundThread->start();
 		//}
 
+		//Simplifying a mesh costs far less than extracting it, but small meshes aren't worth a task of their own.
+		//The error is in squared voxels, so the default lets the simplifier smooth over steps one voxel high.
+		QString decimationPolicy = qApp->settings()->value("Engine/DecimationPolicy", "TriangleCount").toString();
+		if(decimationPolicy == "None")
+		{
+			mDecimationPolicy = DecimateNone;
+		}
+		else if(decimationPolicy == "All")
+		{
+			mDecimationPolicy = DecimateAll;
+		}
+		else if(decimationPolicy == "Distance")
+		{
+			mDecimationPolicy = DecimateDistantRegions;
+		}
+		mDecimationDistance = qApp->settings()->value("Engine/DecimationDistance", mDecimationDistance).toFloat();
+		mDecimationMinTriangles = qApp->settings()->value("Engine/DecimationMinTriangles", mDecimationMinTriangles).toUInt();
+		mDecimationMaxError = qApp->settings()->value("Engine/DecimationMaxError", mDecimationMaxError).toFloat();
+		mNoOfLodLevels = qApp->settings()->value("Engine/NoOfLodLevels", mNoOfLodLevels).toUInt();
+		mLodDistance = qApp->settings()->value("Engine/LodDistance", mLodDistance).toFloat();
+
+		//Reordering the triangles for the vertex cache takes a few milliseconds for a typical region.
+		mOptimiseMeshes = qApp->settings()->value("Engine/OptimiseMeshes", mOptimiseMeshes).toBool();
+
 		uint16_t regionSideLength = qApp->settings()->value("Engine/RegionSideLength", 32).toInt();
 		PolyVox::SimpleVolume<PolyVox::Material16>* pPolyVoxVolume = new PolyVox::SimpleVolume<PolyVox::Material16>(Region(Vector3DInt32(0,0,0), Vector3DInt32(width-1, height-1, depth-1)));
 		//pPolyVoxVolume->setCompressionEnabled(false);
@@ -97,13 +135,38 @@ namespace Thermite
 
 	Volume::~Volume(void)
 	{
+		delete m_pDensityPyramid;
+
+		for(uint32_t ct = 0; ct < m_volSurfaceMeshes.getNoOfElements(); ct++)
+		{
+			delete m_volSurfaceMeshes.getRawData()[ct];
+		}
 	}
 
 	void Volume::setPolyVoxVolume(PolyVox::SimpleVolume<PolyVox::Material16>* pPolyVoxVolume, uint16_t regionSideLength)
 	{
+		//Any decimations still running are for the old volume.
+		for(uint32_t ct = 0; ct < m_volSurfaceDecimators.getNoOfElements(); ct++)
+		{
+			if(m_volSurfaceDecimators.getRawData()[ct])
+			{
+				m_volSurfaceDecimators.getRawData()[ct]->cancel();
+			}
+		}
+
+		//The meshes are owned by the volume (see uploadSurfaceExtractorResult()).
+		for(uint32_t ct = 0; ct < m_volSurfaceMeshes.getNoOfElements(); ct++)
+		{
+			delete m_volSurfaceMeshes.getRawData()[ct];
+		}
+
 		m_pPolyVoxVolume = pPolyVoxVolume;
 		mRegionSideLength = regionSideLength;		
 
+		//Used to skip over empty space when casting rays into the volume.
+		delete m_pDensityPyramid;
+		m_pDensityPyramid = new DensityPyramid<SimpleVolume, Material16>(m_pPolyVoxVolume);
+
 		mVolumeWidthInRegions = m_pPolyVoxVolume->getWidth() / regionSideLength;
 		mVolumeHeightInRegions = m_pPolyVoxVolume->getHeight() / regionSideLength;
 		mVolumeDepthInRegions = m_pPolyVoxVolume->getDepth() / regionSideLength;
@@ -174,7 +237,12 @@ namespace Thermite
 						{
 							SurfaceMesh<PositionMaterial>* mesh = m_volSurfaceMeshes[regionX][regionY][regionZ];
 							PolyVox::Region reg = mesh->m_Region;
+
+							QElapsedTimer timer;
+							timer.start();
 							uploadSurfaceMesh(*(m_volSurfaceMeshes[regionX][regionY][regionZ]), reg, *this);
+							mUploadTiming.mNoOfRuns++;
+							mUploadTiming.mTotalTime += timer.elapsed();
 						}
 					}
 				}
@@ -185,6 +253,9 @@ namespace Thermite
 
 	void Volume::updatePolyVoxGeometry(const QVector3D& cameraPos)
 	{
+		//Used by the decimation policy when the extracted meshes come back.
+		mLastCameraPosition = cameraPos;
+
 		if(m_pPolyVoxVolume)
 		{		
 			//Iterate over each region
@@ -234,7 +305,15 @@ namespace Thermite
 							std::uint32_t uPriority = std::numeric_limits<std::uint32_t>::max() - static_cast<std::uint32_t>(distanceFromCameraSquared);
 
 							//Extract the region
-							SurfaceMeshExtractionTask* surfaceMeshExtractionTask = new SurfaceMeshExtractionTask(m_pPolyVoxVolume, region, mLastModifiedArray[regionX][regionY][regionZ]);
+							SurfaceMeshExtractionTask* surfaceMeshExtractionTask = new SurfaceMeshExtractionTask(m_pPolyVoxVolume, region, mLastModifiedArray[regionX][regionY][regionZ], mOptimiseMeshes);
+
+							//The mesh from the last extraction of this region tells us roughly how big the new one will
+							//be, so the extractor can write into memory which is already allocated rather than growing it.
+							SurfaceMesh<PositionMaterial>* pPreviousMesh = m_volSurfaceMeshes[regionX][regionY][regionZ];
+							if(pPreviousMesh)
+							{
+								surfaceMeshExtractionTask->m_meshResult.reserve(pPreviousMesh->getNoOfVertices(), pPreviousMesh->getNoOfIndices());
+							}
 							surfaceMeshExtractionTask->setAutoDelete(false);
 							QObject::connect(surfaceMeshExtractionTask, SIGNAL(finished(SurfaceMeshExtractionTask*)), this, SLOT(uploadSurfaceExtractorResult(SurfaceMeshExtractionTask*)), Qt::QueuedConnection);
 							if(mMultiThreadedSurfaceExtraction)
@@ -259,69 +338,184 @@ namespace Thermite
 
 	void Volume::uploadSurfaceExtractorResult(SurfaceMeshExtractionTask* pTask)
 	{
-		SurfaceMesh<PositionMaterial>* pMesh = &(pTask->m_meshResult);
-
 		//Determine where it came from
-		uint16_t regionX = pMesh->m_Region.getLowerCorner().getX() / mRegionSideLength;
-		uint16_t regionY = pMesh->m_Region.getLowerCorner().getY() / mRegionSideLength;
-		uint16_t regionZ = pMesh->m_Region.getLowerCorner().getZ() / mRegionSideLength;
+		uint16_t regionX = pTask->m_meshResult.m_Region.getLowerCorner().getX() / mRegionSideLength;
+		uint16_t regionY = pTask->m_meshResult.m_Region.getLowerCorner().getY() / mRegionSideLength;
+		uint16_t regionZ = pTask->m_meshResult.m_Region.getLowerCorner().getZ() / mRegionSideLength;
+
+		mExtractionTiming.mTotalTime += pTask->m_iElapsedTime;
 
 		std::uint32_t uRegionTimeStamp = mLastModifiedArray[regionX][regionY][regionZ];
 		if(uRegionTimeStamp > pTask->m_uTimeStamp)
 		{
 			// The volume has changed since the command to generate this mesh was issued.
 			// Just ignore it, and a correct version should be along soon...
+			mExtractionTiming.mNoOfCancellations++;
+			delete pTask;
 			return;
 		}
+		mExtractionTiming.mNoOfRuns++;
+		if((pTask->m_bOptimiseMesh) && (pTask->m_meshResult.isEmpty() == false))
+		{
+			addCacheMissRatios(pTask->m_fCacheMissRatioBefore, pTask->m_fCacheMissRatioAfter);
+		}
 		
-		//pMesh->m_Region = result.getRegion();
-		m_volSurfaceMeshes[regionX][regionY][regionZ] = pMesh;
+		//The volume owns one mesh per region, which is created the first time the region is extracted. The new
+		//mesh is swapped into it, so the old one goes when the task is deleted at the end of this function.
+		SurfaceMesh<PositionMaterial>* pMesh = m_volSurfaceMeshes[regionX][regionY][regionZ];
+		if(pMesh == 0)
+		{
+			pMesh = new SurfaceMesh<PositionMaterial>;
+			m_volSurfaceMeshes[regionX][regionY][regionZ] = pMesh;
+		}
+		pMesh->swap(pTask->m_meshResult);
 		mExtractionFinishedArray[regionX][regionY][regionZ] = globals.timeStamp();
 
 		//uploadSurfaceMesh(result.getSurfaceMesh(), result.getRegion());
 
 		mRegionBeingExtracted[regionX][regionY][regionZ] = false;
 
+		//The unsimplified mesh is uploaded straight away, and replaced once the
+		//simplified one is ready. Any simplification of the previous mesh is now pointless.
+		cancelDecimation(regionX, regionY, regionZ);
+		if(isWorthDecimating(*pMesh))
+		{
+			//The task takes a copy of the mesh, as the next extraction of this region may replace it before the task runs.
+			SurfaceMeshDecimationTask* surfaceMeshDecimationTask = new SurfaceMeshDecimationTask(*pMesh, pTask->m_uTimeStamp, mDecimationMaxError, mNoOfLodLevels, mOptimiseMeshes);
+			surfaceMeshDecimationTask->setAutoDelete(false);
+			QObject::connect(surfaceMeshDecimationTask, SIGNAL(finished(SurfaceMeshDecimationTask*)), this, SLOT(uploadSurfaceDecimatorResult(SurfaceMeshDecimationTask*)), Qt::QueuedConnection);
 
-		SurfaceMeshDecimationTask* pOldSurfaceDecimator = m_volSurfaceDecimators[regionX][regionY][regionZ];
-
-		//m_backgroundThread->removeTask(pOldSurfaceDecimator);
-
-		SurfaceMeshDecimationTask* surfaceMeshDecimationTask = new SurfaceMeshDecimationTask(pMesh, pTask->m_uTimeStamp);
-		surfaceMeshDecimationTask->setAutoDelete(false);
-		QObject::connect(surfaceMeshDecimationTask, SIGNAL(finished(SurfaceMeshDecimationTask*)), this, SLOT(uploadSurfaceDecimatorResult(SurfaceMeshDecimationTask*)), Qt::QueuedConnection);
+			m_volSurfaceDecimators[regionX][regionY][regionZ] = surfaceMeshDecimationTask;
 
-		m_volSurfaceDecimators[regionX][regionY][regionZ] = surfaceMeshDecimationTask;
+			if(mMultiThreadedSurfaceExtraction)
+			{
+				//Below every extraction, as new geometry matters more than lighter geometry.
+				QThreadPool::globalInstance()->start(surfaceMeshDecimationTask, std::numeric_limits<int>::min());
+			}
+			else
+			{
+				surfaceMeshDecimationTask->run();
+			}
+		}
 
-		//m_backgroundThread->addTask(surfaceMeshDecimationTask);
+		delete pTask;
 	}
 
 	void Volume::uploadSurfaceDecimatorResult(SurfaceMeshDecimationTask* pTask)
 	{
-		SurfaceMesh<PositionMaterial>* pMesh = pTask->mMesh;
+		mDecimationTiming.mTotalTime += pTask->m_iElapsedTime;
+
+		//Cancelled tasks have already been forgotten about, and may even be for a previous volume.
+		if(pTask->isCancelled())
+		{
+			mDecimationTiming.mNoOfCancellations++;
+			delete pTask;
+			return;
+		}
 
 		//Determine where it came from
-		uint16_t regionX = pMesh->m_Region.getLowerCorner().getX() / mRegionSideLength;
-		uint16_t regionY = pMesh->m_Region.getLowerCorner().getY() / mRegionSideLength;
-		uint16_t regionZ = pMesh->m_Region.getLowerCorner().getZ() / mRegionSideLength;
+		uint16_t regionX = pTask->m_meshInput.m_Region.getLowerCorner().getX() / mRegionSideLength;
+		uint16_t regionY = pTask->m_meshInput.m_Region.getLowerCorner().getY() / mRegionSideLength;
+		uint16_t regionZ = pTask->m_meshInput.m_Region.getLowerCorner().getZ() / mRegionSideLength;
 
-		std::uint32_t uRegionTimeStamp = mLastModifiedArray[regionX][regionY][regionZ];
+		m_volSurfaceDecimators[regionX][regionY][regionZ] = 0;
 
+		std::uint32_t uRegionTimeStamp = mLastModifiedArray[regionX][regionY][regionZ];
 		if(uRegionTimeStamp > pTask->m_uTimeStamp)
 		{
 			// The volume has changed since the command to generate this mesh was issued.
 			// Just ignore it, and a correct version should be along soon...
+			mDecimationTiming.mNoOfCancellations++;
+			delete pTask;
 			return;
 		}
+		mDecimationTiming.mNoOfRuns++;
+		if((pTask->m_bOptimiseMesh) && (pTask->m_meshResult.isEmpty() == false))
+		{
+			addCacheMissRatios(pTask->m_fCacheMissRatioBefore, pTask->m_fCacheMissRatioAfter);
+		}
 
-		
-		m_volSurfaceMeshes[regionX][regionY][regionZ] = pMesh;
+		//A newer extraction of this region would have cancelled the task, so the region's mesh is still the one which
+		//was simplified. Replacing its contents causes the simplified mesh to be uploaded by update(). Swapping rather
+		//than copying, as the task is about to be deleted along with the unsimplified mesh.
+		SurfaceMesh<PositionMaterial>* pMesh = m_volSurfaceMeshes[regionX][regionY][regionZ];
+		pMesh->swap(pTask->m_meshResult);
 		mExtractionFinishedArray[regionX][regionY][regionZ] = globals.timeStamp();
 
 		delete pTask;
+	}
 
-		//uploadSurfaceMesh(result.getSurfaceMesh(), result.getRegion());
-	}	
+	bool Volume::isWorthDecimating(const SurfaceMesh<PositionMaterial>& mesh) const
+	{
+		switch(mDecimationPolicy)
+		{
+		case DecimateAll:
+			return mesh.isEmpty() == false;
+		case DecimateDistantRegions:
+			{
+				const Vector3DInt32& v3dLowerCorner = mesh.m_Region.getLowerCorner();
+				const Vector3DInt32& v3dUpperCorner = mesh.m_Region.getUpperCorner();
+				QVector3D centre(v3dLowerCorner.getX() + v3dUpperCorner.getX(), v3dLowerCorner.getY() + v3dUpperCorner.getY(), v3dLowerCorner.getZ() + v3dUpperCorner.getZ());
+				centre *= 0.5f;
+				return (mesh.isEmpty() == false) && ((mLastCameraPosition - centre).lengthSquared() >= mDecimationDistance * mDecimationDistance);
+			}
+		case DecimateLargeMeshes:
+			return mesh.getNoOfIndices() / 3 >= mDecimationMinTriangles;
+		default:
+			return false;
+		}
+	}
+
+	void Volume::cancelDecimation(uint16_t regionX, uint16_t regionY, uint16_t regionZ)
+	{
+		//The task is deleted by uploadSurfaceDecimatorResult() once the thread pool has finished with it.
+		SurfaceMeshDecimationTask* pTask = m_volSurfaceDecimators[regionX][regionY][regionZ];
+		if(pTask)
+		{
+			pTask->cancel();
+			m_volSurfaceDecimators[regionX][regionY][regionZ] = 0;
+		}
+	}
+
+	QVariantMap Volume::getStageTimings(void) const
+	{
+		const StageTiming* stageTimings[] = {&mExtractionTiming, &mDecimationTiming, &mUploadTiming};
+		const char* stageNames[] = {"extraction", "decimation", "upload"};
+
+		QVariantMap result;
+		for(int ct = 0; ct < 3; ct++)
+		{
+			QVariantMap stage;
+			stage["runs"] = stageTimings[ct]->mNoOfRuns;
+			stage["cancellations"] = stageTimings[ct]->mNoOfCancellations;
+			stage["milliseconds"] = stageTimings[ct]->mTotalTime;
+			result[stageNames[ct]] = stage;
+		}
+
+		QVariantMap optimisation;
+		optimisation["meshes"] = mNoOfOptimisedMeshes;
+		optimisation["cacheMissRatioBefore"] = (mNoOfOptimisedMeshes > 0) ? mTotalCacheMissRatioBefore / mNoOfOptimisedMeshes : 0.0;
+		optimisation["cacheMissRatioAfter"] = (mNoOfOptimisedMeshes > 0) ? mTotalCacheMissRatioAfter / mNoOfOptimisedMeshes : 0.0;
+		result["optimisation"] = optimisation;
+		return result;
+	}
+
+	void Volume::resetStageTimings(void)
+	{
+		mExtractionTiming = StageTiming();
+		mDecimationTiming = StageTiming();
+		mUploadTiming = StageTiming();
+		mNoOfOptimisedMeshes = 0;
+		mTotalCacheMissRatioBefore = 0.0;
+		mTotalCacheMissRatioAfter = 0.0;
+	}
+
+	void Volume::addCacheMissRatios(float fBefore, float fAfter)
+	{
+		mNoOfOptimisedMeshes++;
+		mTotalCacheMissRatioBefore += fBefore;
+		mTotalCacheMissRatioAfter += fAfter;
+	}
 
 	bool Volume::isRegionBeingExtracted(const PolyVox::Region& regionToTest)
 	{
@@ -381,9 +575,14 @@ namespace Thermite
 				{
 					//volRegionLastModified->setVoxelAt(xCt,yCt,zCt,m_uCurrentTime);
 					mLastModifiedArray[xCt][yCt][zCt] = globals.timeStamp();
+
+					//The region will be extracted again, so there's no point finishing the simplification of its current mesh.
+					cancelDecimation(xCt, yCt, zCt);
 				}
 			}
 		}
+
+		m_pDensityPyramid->regionChanged(regionToTest);
 	}
 
 	void Volume::createVerticalHole(int xStart, int yStart, int zStart, int yEnd)
@@ -512,7 +711,7 @@ namespace Thermite
 		direction *= 1000.0f;
 
 		RaycastResult raycastResult;
-		Raycast<SimpleVolume, Material16> raycast(m_pPolyVoxVolume, start, direction, raycastResult);
+		HierarchicalRaycast<SimpleVolume, Material16> raycast(m_pPolyVoxVolume, m_pDensityPyramid, start, direction, raycastResult);
 		raycast.execute();
 		
 		if(raycastResult.foundIntersection)
@@ -580,11 +779,10 @@ namespace Thermite
 			deleteSceneNodeChildren(pOgreSceneNode);
 		}
 
-		//Get the SurfaceMesh and check it's valid
-		SurfaceMesh<PositionMaterial> meshWhole = mesh;
-		if(meshWhole.isEmpty() == false)
+		//Check the SurfaceMesh is valid. It is uploaded directly, so there's no need to copy it first.
+		if(mesh.isEmpty() == false)
 		{			
-			addSurfacePatchRenderable(volume.m_mapMaterialIds.begin()->first, meshWhole, region); ///[0] is HACK!!
+			addSurfacePatchRenderable(volume.m_mapMaterialIds.begin()->first, mesh, region); ///[0] is HACK!!
 
 			//The SurfaceMesh needs to be broken into pieces - one for each material. Iterate over the materials...
 			/*for(std::map< std::string, std::set<uint8_t> >::iterator iter = volume.m_mapMaterialIds.begin(); iter != volume.m_mapMaterialIds.end(); iter++)
@@ -604,7 +802,7 @@ namespace Thermite
 		mVolLastUploadedTimeStamps[regionX][regionY][regionZ] = globals.timeStamp();
 	}
 
-	void Volume::addSurfacePatchRenderable(std::string materialName, SurfaceMesh<PositionMaterial>& mesh, PolyVox::Region region)
+	void Volume::addSurfacePatchRenderable(std::string materialName, const SurfaceMesh<PositionMaterial>& mesh, PolyVox::Region region)
 	{
 
 		std::uint16_t regionSideLength = qApp->settings()->value("Engine/RegionSideLength", 32).toInt();
@@ -627,6 +825,7 @@ namespace Thermite
 		pOgreSceneNode->attachObject(pSingleMaterialSurfacePatchRenderable);
 		pSingleMaterialSurfacePatchRenderable->m_v3dPos = pOgreSceneNode->getPosition();
 
+		pSingleMaterialSurfacePatchRenderable->m_fLodDistance = mLodDistance;
 		pSingleMaterialSurfacePatchRenderable->buildRenderOperationFrom(mesh);
 
 		Ogre::AxisAlignedBox aabb(Ogre::Vector3(0.0f,0.0f,0.0f), Ogre::Vector3(regionSideLength, regionSideLength, regionSideLength));
@@ -665,30 +864,27 @@ namespace Thermite
 		}
 		pOgreSceneNode->detachAllObjects();*/
 
-		//Get the SurfaceMesh and check it's valid
-		SurfaceMesh<PositionMaterialNormal> meshWhole = mesh;
-		if(meshWhole.isEmpty() == false)
+		//Check the SurfaceMesh is valid. It is uploaded directly, so there's no need to copy it first.
+		if(mesh.isEmpty() == false)
 		{			
 			//The SurfaceMesh needs to be broken into pieces - one for each material. Iterate over the materials...
 			for(std::map< std::string, std::set<uint8_t> >::iterator iter = volume.m_mapMaterialIds.begin(); iter != volume.m_mapMaterialIds.end(); iter++)
 			{
 				//Get the properties
 				std::string materialName = iter->first;
-				std::set<std::uint8_t> voxelValues = iter->second;
 
-				//Extract the part of the InexedSurfacePatch which corresponds to that material
-				//polyvox_shared_ptr< SurfaceMesh<PositionMaterialNormal> > meshSubset = meshWhole.extractSubset(voxelValues);
-				polyvox_shared_ptr< SurfaceMesh<PositionMaterialNormal> > meshSubset = extractSubset(meshWhole, voxelValues);
+				//The whole mesh is currently added for each material, so the subset which extractSubset()
+				//would build for the material was never used. Don't build it until it is.
 
 				//And add it to the SceneNode
-				addSurfacePatchRenderable(materialName, meshWhole, region);
+				addSurfacePatchRenderable(materialName, mesh, region);
 			}
 		}		
 
 		mVolLastUploadedTimeStamps[regionX][regionY][regionZ] = globals.timeStamp();
 	}
 
-	void Volume::addSurfacePatchRenderable(std::string materialName, SurfaceMesh<PositionMaterialNormal>& mesh, PolyVox::Region region)
+	void Volume::addSurfacePatchRenderable(std::string materialName, const SurfaceMesh<PositionMaterialNormal>& mesh, PolyVox::Region region)
 	{
 
 		std::uint16_t regionSideLength = qApp->settings()->value("Engine/RegionSideLength", 32).toInt();
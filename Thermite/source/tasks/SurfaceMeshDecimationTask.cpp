@@ -24,28 +24,53 @@ freely, subject to the following restrictions:
 #include "SurfaceMeshDecimationTask.h"
 
 #include "PolyVoxCore/SurfaceMesh.h"
-#include "PolyVoxCore/MeshDecimator.h"
+#include "PolyVoxCore/MeshOptimiser.h"
+#include "PolyVoxCore/MeshSimplifier.h"
 
+#include <QElapsedTimer>
 #include <QMutex>
 
 using namespace PolyVox;
 
 namespace Thermite
 {
-	SurfaceMeshDecimationTask::SurfaceMeshDecimationTask(SurfaceMesh<PositionMaterial>* mesh, uint32_t uTimeStamp)
-		:mMesh(mesh)
+	SurfaceMeshDecimationTask::SurfaceMeshDecimationTask(const SurfaceMesh<PositionMaterial>& mesh, uint32_t uTimeStamp, float fMaxError, uint32_t uNoOfLodLevels, bool bOptimiseMesh)
+		:m_meshInput(mesh)
 		,m_uTimeStamp(uTimeStamp)
+		,m_fMaxError(fMaxError)
+		,m_uNoOfLodLevels(uNoOfLodLevels)
+		,m_bOptimiseMesh(bOptimiseMesh)
+		,m_fCacheMissRatioBefore(0.0f)
+		,m_fCacheMissRatioAfter(0.0f)
 	{
 	}
 	
 	void SurfaceMeshDecimationTask::run(void)
 	{
-		//mMesh->decimate(0.95);
+		//The region may have changed again while this task was waiting in the queue,
+		//in which case nobody wants the result. finished() is still emitted so the task gets cleaned up.
+		if(!isCancelled())
+		{
+			QElapsedTimer timer;
+			timer.start();
 
-		PolyVox::SurfaceMesh<PolyVox::PositionMaterial> meshDecimated;
-		PolyVox::MeshDecimator<PositionMaterial> decimator(mMesh, &meshDecimated);
-		decimator.execute();
-		*mMesh = meshDecimated;
+			//The simplifier never moves the edges of the mesh on the faces of the
+			//region, so the simplified mesh still meets its neighbours without cracks.
+			PolyVox::MeshSimplifier<PositionMaterial> simplifier(&m_meshInput, &m_meshResult, 0, m_fMaxError);
+			simplifier.setNoOfLodLevels(m_uNoOfLodLevels);
+			simplifier.execute();
+
+			//Simplification leaves the triangles in no particular order, so this matters even more than after extraction.
+			if(m_bOptimiseMesh)
+			{
+				PolyVox::MeshOptimiser<PositionMaterial> optimiser(&m_meshResult, &m_meshResult);
+				optimiser.execute();
+				m_fCacheMissRatioBefore = optimiser.getCacheMissRatioBefore();
+				m_fCacheMissRatioAfter = optimiser.getCacheMissRatioAfter();
+			}
+
+			m_iElapsedTime = timer.elapsed();
+		}
 
 		emit finished(this);
 	}
@@ -28,25 +28,43 @@ freely, subject to the following restrictions:
 #include "PolyVoxCore/GradientEstimators.h"
 #include "PolyVoxCore/SurfaceMesh.h"
 #include "PolyVoxCore/CubicSurfaceExtractor.h"
+#include "PolyVoxCore/MeshOptimiser.h"
 
+#include <QElapsedTimer>
 #include <QMutex>
+#include <QThreadStorage>
 
 using namespace PolyVox;
 
 namespace Thermite
 {
-	SurfaceMeshExtractionTask::SurfaceMeshExtractionTask(PolyVox::SimpleVolume<PolyVox::Material16>* volume, PolyVox::Region regToProcess, uint32_t uTimeStamp)
+	//The extraction tasks are run by the threads of the global thread pool (or by the main thread),
+	//so each thread keeps one extractor context and reuses its buffers for every region it extracts.
+	//QThreadStorage deletes the context when the thread finishes.
+	static QThreadStorage<CubicSurfaceExtractor<SimpleVolume, Material16>::Context*> g_extractorContexts;
+
+	SurfaceMeshExtractionTask::SurfaceMeshExtractionTask(PolyVox::SimpleVolume<PolyVox::Material16>* volume, PolyVox::Region regToProcess, uint32_t uTimeStamp, bool bOptimiseMesh)
 		:m_regToProcess(regToProcess)
 		,m_uTimeStamp(uTimeStamp)
 		,mVolume(volume)
+		,m_bOptimiseMesh(bOptimiseMesh)
+		,m_fCacheMissRatioBefore(0.0f)
+		,m_fCacheMissRatioAfter(0.0f)
 	{
 	}
 	
 	void SurfaceMeshExtractionTask::run(void)
 	{
-		//This is bad - can we make SurfaceExtractor reenterant (?) and just have one which all runnables share?
-		//Or at least not use 'new'
+		QElapsedTimer timer;
+		timer.start();
+
+		if(!g_extractorContexts.hasLocalData())
+		{
+			g_extractorContexts.setLocalData(new CubicSurfaceExtractor<SimpleVolume, Material16>::Context);
+		}
+
 		PolyVox::CubicSurfaceExtractor<SimpleVolume, Material16> surfaceExtractor(mVolume, m_regToProcess, &m_meshResult);
+		surfaceExtractor.setContext(g_extractorContexts.localData());
 		
 		surfaceExtractor.execute();
 		//computeNormalsForVertices(m_pGameLogic->mMap->volumeResource->getVolume(),*(m_taskData.m_meshResult.get()), PolyVox::SOBEL_SMOOTHED);
@@ -57,6 +75,16 @@ namespace Thermite
 		decimator.execute();
 		m_meshResult = meshDecimated;*/
 
+		if(m_bOptimiseMesh)
+		{
+			PolyVox::MeshOptimiser<PositionMaterial> optimiser(&m_meshResult, &m_meshResult);
+			optimiser.execute();
+			m_fCacheMissRatioBefore = optimiser.getCacheMissRatioBefore();
+			m_fCacheMissRatioAfter = optimiser.getCacheMissRatioAfter();
+		}
+
+		m_iElapsedTime = timer.elapsed();
+
 		emit finished(this);
 	}
 }
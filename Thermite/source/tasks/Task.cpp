@@ -22,3 +22,22 @@ freely, subject to the following restrictions:
 *******************************************************************************/
 
 #include "Task.h"
+
+namespace Thermite
+{
+	Task::Task(void)
+		:m_iElapsedTime(0)
+		,m_iCancelled(0)
+	{
+	}
+
+	void Task::cancel(void)
+	{
+		m_iCancelled.store(1);
+	}
+
+	bool Task::isCancelled(void) const
+	{
+		return m_iCancelled.load() != 0;
+	}
+}